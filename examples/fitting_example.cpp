@@ -28,6 +28,7 @@ int main(int argc, char *argv[])
     real_t tolerance = 1e-02;
     index_t extension = 2;
     real_t refPercent = 0.1;
+    index_t solver = 0;
     std::string fn = "fitting/deepdrawingC.xml";
 
     // Reading options from the command line
@@ -45,6 +46,8 @@ int main(int argc, char *argv[])
     cmd.addInt("q", "extension", "extension size", extension);
     cmd.addInt("r", "urefine", "initial uniform refinement steps", numURef);
     cmd.addReal("e", "tolerance", "error tolerance (desired upper bound for pointwise error)", tolerance);
+    cmd.addInt("", "solver", "linear solver (0: BiCGStab/ILUT, 1: CG/diagonal, "
+               "2: CG/incomplete Cholesky, 3: Cholesky)", solver);
     cmd.addString("d", "data", "Input sample data", fn);
 
     try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
@@ -112,6 +115,7 @@ int main(int argc, char *argv[])
 
     // Create hierarchical refinement object
     gsHFitting<2, real_t> ref( uv, xyz, THB, refPercent, ext, lambda);
+    ref.setSolver( static_cast<gsFitting<>::solver>(solver) );
 
     const std::vector<real_t> & errors = ref.pointWiseErrors();
 
@@ -0,0 +1,103 @@
+/** @file mpiAssembly_example.cpp
+
+    @brief Assembles and solves a multipatch Poisson problem whose
+    patches are distributed over several processes.
+
+    Execute (eg. with 4 processes):
+       mpirun -np 4 ./bin/mpiAssembly_example
+
+    Without MPI, or on one process, the whole problem is assembled and
+    solved by the single process.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gismo.h>
+
+using namespace gismo;
+
+int main(int argc, char *argv[])
+{
+    index_t numPatches = 4;
+    index_t numRefine  = 3;
+    real_t tol = 1e-10;
+
+    gsCmdLine cmd("Distributed assembly and solution of a Poisson problem.");
+    cmd.addInt("p", "patches", "Number of patches per direction", numPatches);
+    cmd.addInt("r", "refine", "Number of uniform refinement steps", numRefine);
+    cmd.addReal("t", "tol", "Tolerance of the iterative solver", tol);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    const gsMpi & mpi = gsMpi::init(argc, argv);
+    gsMpiComm comm = mpi.worldComm();
+    const int rank = comm.rank();
+
+    //! [Problem setup]
+    gsFunctionExpr<> f("-4", 2);
+    gsFunctionExpr<> g("x^2+y^2", 2);
+
+    gsMultiPatch<> patches = gsNurbsCreator<>::BSplineSquareGrid(numPatches, numPatches, 1);
+
+    gsBoundaryConditions<> bcInfo;
+    for (gsMultiPatch<>::const_biterator bit = patches.bBegin(); bit != patches.bEnd(); ++bit)
+        bcInfo.addCondition(*bit, condition_type::dirichlet, &g);
+
+    gsMultiBasis<> bases(patches);
+    for (index_t i = 0; i < numRefine; ++i)
+        bases.uniformRefine();
+    //! [Problem setup]
+
+    //! [Distributed assembly]
+    // Every process assembles its own patches
+    gsPatchPartition part(bases, rank, comm.size());
+
+    gsPoissonAssembler<real_t> assembler(patches, bases, bcInfo, f,
+                                         dirichlet::elimination, iFace::glue);
+    part.addDofs(assembler.system().colMapper(0));
+    assembler.setPartition(part);
+    assembler.assemble();
+
+    // The owners of the degrees of freedom sum up the contributions
+    gsMatrix<> rhs;
+    gsDistributedOp<real_t>::Ptr op =
+        gsDistributedOp<real_t>::make(assembler.matrix(), assembler.rhs(), part, comm, rhs);
+    if ( 0 == rank )
+        gsInfo << "Distributed "<< part.numDofs() <<" degrees of freedom over "
+               << comm.size() <<" processes.\n";
+    gsInfo << "Process "<< rank <<" owns "<< op->rows() <<" degrees of freedom, halo "
+           << op->haloSize() <<".\n";
+    //! [Distributed assembly]
+
+    //! [Distributed solution]
+    // Jacobi preconditioner from the owned diagonal block
+    gsSparseMatrix<> diagBlock = op->localMatrix().leftCols(op->rows());
+    gsPipelinedConjugateGradient<> solver(op, makeJacobiOp(diagBlock));
+    solver.setCommunicator(comm);
+    solver.setTolerance(tol);
+    solver.setMaxIterations(10 * part.numDofs());
+
+    gsMatrix<> x, sol;
+    x.setZero(op->rows(), 1);
+    solver.solve(rhs, x);
+    op->gather(x, sol);
+    //! [Distributed solution]
+
+    // Compare with the system assembled by a single process
+    gsPoissonAssembler<real_t> full(patches, bases, bcInfo, f,
+                                    dirichlet::elimination, iFace::glue);
+    full.assemble();
+    gsSparseSolver<>::CGDiagonal cg;
+    cg.setTolerance(tol);
+    const gsMatrix<> ref = cg.compute(full.matrix()).solve(full.rhs());
+
+    const real_t diff = (sol - ref).norm() / ref.norm();
+    if ( 0 == rank )
+        gsInfo << "Iterations: "<< solver.iterations() <<", relative difference to "
+            "the serial solution: "<< diff <<"\n";
+
+    return diff < 100 * tol ? EXIT_SUCCESS : EXIT_FAILURE;
+}
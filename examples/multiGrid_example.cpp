@@ -39,6 +39,7 @@ int main(int argc, char *argv[])
     std::string smoother("GaussSeidel");
     real_t damping = -1;
     real_t scaling = 0.12;
+    std::string coarseSolver("LU");
     std::string iterativeSolver("cg");
     real_t tolerance = 1.e-8;
     index_t maxIterations = 100;
@@ -63,6 +64,7 @@ int main(int argc, char *argv[])
     cmd.addString("s", "MG.Smoother",           "Smoothing method", smoother);
     cmd.addReal  ("",  "MG.Damping",            "Damping factor for the smoother", damping);
     cmd.addReal  ("",  "MG.Scaling",            "Scaling factor for the subspace corrected mass smoother", scaling);
+    cmd.addString("",  "MG.CoarseSolver",       "Coarse solver: sparse LU (LU) or algebraic multigrid (AMG)", coarseSolver);
     cmd.addString("i", "IterativeSolver",       "Iterative solver: apply multigrid directly (d) or as a preconditioner for conjugate gradient (cg)", iterativeSolver);
     cmd.addReal  ("t", "Solver.Tolerance",      "Stopping criterion for linear solver", tolerance);
     cmd.addInt   ("",  "Solver.MaxIterations",  "Stopping criterion for linear solver", maxIterations);
@@ -243,6 +245,14 @@ int main(int argc, char *argv[])
     gsMultiGridOp<>::Ptr mg = gsMultiGridOp<>::make( assembler.matrix(), transferMatrices );
     mg->setOptions( opt.getGroup("MG") );
 
+    if (coarseSolver == "AMG")
+        mg->setCoarseSolver( gsAggregationAmgOp<>::make( mg->matrix(0) ) );
+    else if (coarseSolver != "LU")
+    {
+        gsInfo << "\n\nThe chosen coarse solver is unknown.\n\nKnown are:\n  LU\n  AMG\n\n";
+        return EXIT_FAILURE;
+    }
+
     std::vector<real_t> patchLocalDampingParameters;
 
     for (index_t i = 1; i < mg->numLevels(); ++i)
@@ -254,6 +264,10 @@ int main(int argc, char *argv[])
             smootherOp = makeJacobiOp(mg->matrix(i));
         else if ( smoother == "GaussSeidel" || smoother == "gs" )
             smootherOp = makeGaussSeidelOp(mg->matrix(i));
+        else if ( smoother == "MultiColorGaussSeidel" || smoother == "mcgs" )
+            smootherOp = makeMultiColorGaussSeidelOp(mg->matrix(i));
+        else if ( smoother == "Chebyshev" || smoother == "cheb" )
+            smootherOp = makeChebyshevOp(mg->matrix(i));
         else if ( smoother == "SubspaceCorrectedMassSmoother" || smoother == "scms" || smoother == "Hybrid" || smoother == "hyb" )
         {
             smootherOp = setupSubspaceCorrectedMassSmoother( i, mg->numLevels(), mg->matrix(i), multiBases[i], bc,
@@ -268,6 +282,7 @@ int main(int argc, char *argv[])
         else
         {
             gsInfo << "\n\nThe chosen smoother is unknown.\n\nKnown are:\n  Richardson (r)\n  Jacobi (j)\n  GaussSeidel (gs)"
+                      "\n  MultiColorGaussSeidel (mcgs)\n  Chebyshev (cheb)"
                       "\n  SubspaceCorrectedMassSmoother (scms)\n  Hybrid (hyb)\n\n";
             return EXIT_FAILURE;
         }
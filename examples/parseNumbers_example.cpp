@@ -0,0 +1,170 @@
+/** @file parseNumbers_example.cpp
+
+    @brief Compares the speed of reading numbers from text with
+    streams and with the character range parser used by the file
+    readers, and of reading a CSV and an OFF file with streams and
+    with gsFileData.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <iostream>
+#include <gismo.h>
+
+using namespace gismo;
+
+// Reads a CSV file line by line with streams
+void readCsvStream(const std::string & fn, gsMatrix<real_t> & result)
+{
+    std::ifstream file(fn.c_str());
+    std::string line, cell;
+    std::vector<real_t> vals;
+    index_t rows = 0;
+    while ( std::getline(file, line) )
+    {
+        std::istringstream lnstream(line);
+        while ( std::getline(lnstream, cell, ',') )
+        {
+            std::istringstream cellstream(cell);
+            real_t v;
+            gsGetReal(cellstream, v);
+            vals.push_back(v);
+        }
+        ++rows;
+    }
+    const index_t cols = rows ? vals.size() / rows : 0;
+    result.resize(rows, cols);
+    for (index_t i = 0; i != rows; ++i)
+        for (index_t j = 0; j != cols; ++j)
+            result(i,j) = vals[i*cols + j];
+}
+
+// Reads the vertex and face lines of an OFF file line by line with
+// streams, as gsFileData did before the memory-mapped reader
+bool readOffStream(const std::string & fn, std::string & result)
+{
+    std::ifstream file(fn.c_str());
+    std::string line;
+    std::ostringstream tmp;
+    std::getline(file, line);
+    if ( line.compare(0,3,"OFF") != 0 )
+        return false;
+    std::getline(file, line);
+    std::istringstream lnstream(line);
+    index_t nverts = 0, nfaces = 0;
+    lnstream >> nverts >> nfaces;
+    for (index_t i = 0; i != nverts + nfaces; ++i)
+        if ( std::getline(file, line) )
+            tmp << line << "\n";
+        else
+            return false;
+    result = tmp.str();
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    index_t n = 200000;
+
+    gsCmdLine cmd("Compares the speed of reading numbers from text.");
+    cmd.addInt("n", "numbers", "Number of values to read", n);
+    try { cmd.getValues(argc,argv); } catch (int rv) { return rv; }
+
+    // Random values, in the format written by gsFileData
+    gsMatrix<real_t> values(n, 3);
+    values.setRandom();
+    values.col(1).array() *= 1e5;
+    std::ostringstream os;
+    os.precision(16);
+    for (index_t i = 0; i != n; ++i)
+        os << values(i,0) <<" "<< values(i,1) <<" "<< values(i,2) <<"\n";
+    const std::string text = os.str();
+    const double mb = text.size() / 1048576.0;
+
+    gsStopwatch clock;
+    gsMatrix<real_t> res1(n, 3), res2(n, 3);
+
+    // Stream based
+    clock.restart();
+    std::istringstream str(text);
+    for (index_t i = 0; i != n; ++i)
+        for (index_t j = 0; j != 3; ++j)
+            gsGetReal(str, res1(i,j));
+    const double tStream = clock.stop();
+
+    // Character range based
+    clock.restart();
+    const char * p = text.data(), * end = p + text.size();
+    for (index_t i = 0; i != n; ++i)
+        for (index_t j = 0; j != 3; ++j)
+            gsGetReal(p, end, res2(i,j));
+    const double tRange = clock.stop();
+
+    gsInfo << "Reading "<< 3*n <<" numbers ("<< mb <<" MB):\n"
+           << "  istream:         "<< tStream <<" s, "<< mb / tStream <<" MB/s\n"
+           << "  character range: "<< tRange  <<" s, "<< mb / tRange  <<" MB/s\n";
+
+    if ( res1 != res2 )
+    {
+        gsInfo << "The results differ.\n";
+        return EXIT_FAILURE;
+    }
+
+    // A CSV file, read as a matrix
+    const std::string csv = gsFileManager::getTempPath() + "parseNumbers_example.csv";
+    {
+        std::ofstream file(csv.c_str());
+        file.precision(16);
+        for (index_t i = 0; i != n; ++i)
+            file << values(i,0) <<","<< values(i,1) <<","<< values(i,2) <<"\n";
+    }
+    clock.restart();
+    gsMatrix<> mat1;
+    readCsvStream(csv, mat1);
+    const double tCsvStream = clock.stop();
+    clock.restart();
+    gsFileData<> csvData(csv);
+    gsMatrix<> mat2;
+    csvData.getFirst(mat2);
+    const double tCsvRange = clock.stop();
+    std::remove(csv.c_str());
+
+    gsInfo << "Reading a CSV file:\n"
+           << "  istream:         "<< tCsvStream <<" s\n"
+           << "  gsFileData:      "<< tCsvRange  <<" s\n";
+
+    // A triangle mesh in OFF format
+    const std::string off = gsFileManager::getTempPath() + "parseNumbers_example.off";
+    const index_t nt = n / 2;
+    {
+        std::ofstream file(off.c_str());
+        file.precision(16);
+        file << "OFF\n"<< n <<" "<< nt <<" 0\n";
+        for (index_t i = 0; i != n; ++i)
+            file << values(i,0) <<" "<< values(i,1) <<" "<< values(i,2) <<"\n";
+        for (index_t i = 0; i != nt; ++i)
+            file << "3 "<< i <<" "<< i+1 <<" "<< (i+2) % n <<"\n";
+    }
+    clock.restart();
+    std::string offText;
+    const bool offOk = readOffStream(off, offText);
+    const double tOffStream = clock.stop();
+    clock.restart();
+    gsFileData<> offData(off);
+    const double tOffRange = clock.stop();
+    std::remove(off.c_str());
+
+    gsInfo << "Reading an OFF file:\n"
+           << "  istream:         "<< tOffStream <<" s\n"
+           << "  gsFileData:      "<< tOffRange  <<" s\n";
+
+    const bool ok = mat1.rows() == n && mat1.cols() == 3 && mat1 == mat2
+        && offOk && offData.has< gsMesh<> >();
+    if ( !ok )
+        gsInfo << "The results differ.\n";
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1368,6 +1368,7 @@ namespace rapidxml
     protected:
         int max_Id;
         unsigned m_float_precision;
+        bool m_binary;
 
     public:
         xml_node<Ch> * makeRoot()
@@ -1396,6 +1397,19 @@ namespace rapidxml
         inline unsigned getFloatPrecision() const {return m_float_precision;}
 
         inline void setFloatPrecision(const unsigned k) { m_float_precision = k; }
+
+        inline bool getBinaryEncoding() const {return m_binary;}
+
+        inline void setBinaryEncoding(const bool b) { m_binary = b; }
+
+        // Parses the element at text, which points to '<', without
+        // removing the current contents of the document
+        template<int Flags>
+        xml_node<Ch> * parseElement(Ch * text)
+        {
+            ++text;     // Skip '<'
+            return this->template parse_node<Flags>(text);
+        }
         //end G+Smo
     public:
 
@@ -1405,6 +1419,7 @@ namespace rapidxml
         //G+Smo
         , max_Id(-1)
         , m_float_precision(16)
+        , m_binary(false)
         //end G+Smo
         { }
 
@@ -132,6 +132,8 @@ namespace internal
 /* ----------- MultiGrid ----------- */
 #include <gsMultiGrid/gsMultiGrid.h>
 #include <gsMultiGrid/gsGridHierarchy.h>
+#include <gsMultiGrid/gsAggregationAmg.h>
+#include <gsMultiGrid/gsTensorTransfer.h>
 
 /* ----------- Quadrature ----------- */
 #include <gsAssembler/gsQuadRule.h>
@@ -143,6 +145,8 @@ namespace internal
 #include <gsAssembler/gsPoissonAssembler.h>
 #include <gsAssembler/gsCDRAssembler.h>
 #include <gsAssembler/gsHeatEquation.h>
+#include <gsAssembler/gsMatrixFreeOp.h>
+#include <gsAssembler/gsPatchPartition.h>
 
 #include <gsAssembler/gsExprHelper.h>
 #include <gsAssembler/gsExprAssembler.h>
@@ -154,6 +158,8 @@ namespace internal
 #include <gsSolver/gsGMRes.h>
 #include <gsSolver/gsGradientMethod.h>
 #include <gsSolver/gsConjugateGradient.h>
+#include <gsSolver/gsPipelinedConjugateGradient.h>
+#include <gsSolver/gsSStepConjugateGradient.h>
 #include <gsSolver/gsPreconditioner.h>
 #include <gsSolver/gsAdditiveOp.h>
 #include <gsSolver/gsBlockOp.h>
@@ -163,7 +169,10 @@ namespace internal
 #include <gsSolver/gsSumOp.h>
 #include <gsSolver/gsKroneckerOp.h>
 #include <gsSolver/gsPatchPreconditionersCreator.h>
+#include <gsSolver/gsMultiPatchPreconditionersCreator.h>
 #include <gsSolver/gsLanczosMatrix.h>
+#include <gsSolver/gsSellCSigmaOp.h>
+#include <gsSolver/gsDistributedOp.h>
 
 /* ----------- IO ----------- */
 #include <gsIO/gsOptionList.h>
@@ -172,6 +181,7 @@ namespace internal
 #include <gsIO/gsFileManager.h>
 #include <gsIO/gsWriteParaview.h>
 #include <gsIO/gsParaviewCollection.h>
+#include <gsIO/gsParaviewDataArrays.h>
 #include <gsIO/gsReadFile.h>
 #include <gsUtils/gsPointGrid.h>
 #include <gsIO/gsXmlUtils.h>
@@ -182,6 +192,7 @@ namespace internal
 /* ----------- Utilities ----------- */
 //#include <gsUtils/gsUtils.h> - in gsForwardDeclarations.h
 #include <gsUtils/gsStopwatch.h>
+#include <gsUtils/gsBoxTree.h>
 #include <gsUtils/gsFunctionWithDerivatives.h>
 
 /* ----------- Extension ----------- */
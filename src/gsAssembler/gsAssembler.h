@@ -29,6 +29,8 @@
 #include <gsAssembler/gsQuadRule.h>
 #include <gsAssembler/gsSparseSystem.h>
 #include <gsAssembler/gsRemapInterface.h>
+#include <gsAssembler/gsElementCache.h>
+#include <gsAssembler/gsPatchPartition.h>
 
 
 
@@ -282,6 +284,9 @@ protected: // *** Input data members ***
     /// Options
     gsOptionList m_options;
 
+    /// The patches assembled by this process (default: all)
+    gsPatchPartition m_partition;
+
 protected: // *** Output data members ***
 
     /// Global sparse linear system
@@ -292,6 +297,9 @@ protected: // *** Output data members ***
     /// must fit m_system.colBlocks().
     std::vector<gsMatrix<T> > m_ddof;
 
+    /// Element evaluations kept between assemblies (see option "ElementCache")
+    gsElementCache<T> m_elCache;
+
 public:
 
     gsAssembler() : m_options(defaultOptions())
@@ -331,6 +339,7 @@ public:
         m_pde_ptr = pde;
         m_bases = bases;
         m_options = opt;
+        m_elCache.clear();
         refresh(); // virtual call to derived
         GISMO_ASSERT( check(), "Something went wrong in assembler initialization");
     }
@@ -353,6 +362,7 @@ public:
         m_bases.clear();
         m_bases.push_back(bases);
         m_options = opt;
+        m_elCache.clear();
         refresh(); // virtual call to derived
         GISMO_ASSERT( check(), "Something went wrong in assembler initialization");
     }
@@ -374,6 +384,7 @@ public:
             m_bases.push_back(gsMultiBasis<T>(basis[c]));
 
         m_options = opt;
+        m_elCache.clear();
         refresh(); // virtual call to derived
         GISMO_ASSERT( check(), "Something went wrong in assembler initialization");
     }
@@ -402,6 +413,22 @@ public:
         return m_system.numColNz(m_bases.front()[0], m_options);
     }
 
+    /// @brief Reserves the memory of the sparse system before
+    /// assembly. If the option "ExactPattern" is set, the exact
+    /// sparsity pattern is computed by a symbolic pass on the first
+    /// call; subsequent assemblies re-use the pattern and only
+    /// overwrite its values.
+    void reserveSystem(const index_t numRhs)
+    {
+        if ( !m_system.hasPattern() && 0 != m_system.cols()
+             && m_options.askSwitch("ExactPattern", true)
+             && m_system.numRowBlocks() == m_system.numColBlocks()
+             && iFace::dg != m_options.askInt("InterfaceStrategy", iFace::conforming) )
+            m_system.computePattern(m_bases);
+
+        m_system.reserve(m_bases[0], m_options, numRhs);
+    }
+
 public:  /* Virtual assembly routines*/
 
     /// @brief Creates the mappers and setups the sparse system.
@@ -418,6 +445,20 @@ public:  /* Virtual assembly routines*/
 
     gsOptionList & options() {return m_options;}
 
+    const gsOptionList & options() const {return m_options;}
+
+    /// @brief Restricts the assembly to the patches of this process
+    ///
+    /// The element visitors are applied only on the local patches of
+    /// \a part, on the boundaries of these patches and on the
+    /// interfaces whose master side is local. The sum of the systems
+    /// assembled by all processes is the whole system, see
+    /// gsDistributedOp.
+    void setPartition(const gsPatchPartition & part) { m_partition = part; }
+
+    /// Returns the partition of the patches
+    const gsPatchPartition & partition() const { return m_partition; }
+
 public: /* Element visitors */
 
     /// @brief Iterates over all elements of the domain and applies
@@ -427,6 +468,8 @@ public: /* Element visitors */
     {
         for (size_t np = 0; np < m_pde_ptr->domain().nPatches(); ++np)
         {
+            if ( !m_partition.isLocal(np) )
+                continue;
             ElementVisitor visitor(*m_pde_ptr);
             //Assemble (fill m_matrix and m_rhs) on patch np
             apply(visitor, np);
@@ -441,6 +484,8 @@ public: /* Element visitors */
         for (typename bcContainer::const_iterator it
              = BCs.begin(); it!= BCs.end(); ++it)
         {
+            if ( !m_partition.isLocal(it->patch()) )
+                continue;
             BElementVisitor visitor(*m_pde_ptr, *it);
             //Assemble (fill m_matrix and m_rhs) contribution from this BC
             apply(visitor, it->patch(), it->side());
@@ -454,6 +499,8 @@ public: /* Element visitors */
     {
         for (size_t np = 0; np < m_pde_ptr->domain().nPatches(); ++np)
         {
+            if ( !m_partition.isLocal(np) )
+                continue;
             ElementVisitor curVisitor = visitor;
             //Assemble (fill m_matrix and m_rhs) on patch np
             apply(curVisitor, np);
@@ -464,6 +511,8 @@ public: /* Element visitors */
     template<class BElementVisitor>
     void push(const BElementVisitor & visitor, const boundary_condition<T> & BC)
     {
+        if ( !m_partition.isLocal(BC.patch()) )
+            return;
         BElementVisitor curVisitor = visitor;
         //Assemble (fill m_matrix and m_rhs) contribution from this BC
         apply(curVisitor, BC.patch(), BC.side());
@@ -485,6 +534,8 @@ public: /* Element visitors */
                   m_bases[0][it->second().patch].numElements(it->second().side() ) ?
                   it->getInverse() : *it );
 
+            if ( !m_partition.isLocal(iFace.first().patch) )
+                continue;
             this->apply(visitor, iFace);
         }
     }
@@ -620,6 +671,10 @@ public: // *** Accessors ***
     const gsSparseSystem<T> & system() const { return m_system; }
     gsSparseSystem<T> & system() { return m_system; }
 
+    /// @brief Removes the cached element evaluations. Needs to be
+    /// called if the geometry changes between assemblies
+    void clearElementCache() { m_elCache.clear(); }
+
     /// @brief Swaps the actual sparse system with the given one
     void setSparseSystem(gsSparseSystem<T> & sys)
     {
@@ -659,6 +714,38 @@ protected:
     template<class InterfaceVisitor>
     void apply(InterfaceVisitor & visitor,
                const boundaryInterface & bi);
+
+    /// @brief Assembly routine for volume or boundary integrals,
+    /// which pushes the elements color by color without locking
+    /// (see parallelScatter::coloring)
+    template<class ElementVisitor>
+    void applyColored(ElementVisitor & visitor,
+                      size_t patchIndex,
+                      boxSide side);
+
+    /// @brief Colors the elements of patch \a patchIndex (or of its
+    /// side \a side) such that no two elements of the same color
+    /// share a free degree of freedom. On output, \a colors[c]
+    /// contains the indices (in iteration order) of the elements
+    /// having color \a c. Memory for all couplings of the patch is
+    /// reserved in the system matrix, so that elements of the same
+    /// color can be pushed concurrently.
+    void colorElements(const index_t patchIndex, const boxSide side,
+                       std::vector<std::vector<index_t> > & colors);
+
+    /// @brief Returns the element cache, prepared for the volume
+    /// elements of patch \a patchIndex, if the option "ElementCache"
+    /// is positive and \a side is boundary::none. Otherwise returns
+    /// NULL.
+    gsElementCache<T> * elementCache(const index_t patchIndex, const boxSide side)
+    {
+        const index_t limit = m_options.askInt("ElementCache", 0);
+        if ( boundary::none != side || limit <= 0 )
+            return NULL;
+        m_elCache.setMemoryLimit( static_cast<size_t>(limit) << 20 );
+        m_elCache.prepare(patchIndex, m_bases[0][patchIndex]);
+        return &m_elCache;
+    }
 };
 
 template <class T>
@@ -669,7 +756,18 @@ void gsAssembler<T>::apply(ElementVisitor & visitor,
 {
     //gsDebug<< "Apply to patch "<< patchIndex <<"("<< side <<")\n";
 
+#ifdef _OPENMP
+    if ( parallelScatter::coloring == m_options.askInt("ParallelScatter",
+                                                       parallelScatter::critical)
+         && omp_get_max_threads() > 1 )
+    {
+        applyColored(visitor, patchIndex, side);
+        return;
+    }
+#endif
+
     const gsBasisRefs<T> bases(m_bases, patchIndex);
+    gsElementCache<T> * cache = elementCache(patchIndex, side);
 
 #pragma omp parallel
 {
@@ -683,8 +781,10 @@ void gsAssembler<T>::apply(ElementVisitor & visitor,
     visitor_(visitor);
     const int tid = omp_get_thread_num();
     const int nt  = omp_get_num_threads();
+    index_t elem = tid; // index of the current element
 #else
     &visitor_ = visitor;
+    index_t elem = 0;
 #endif
 
     // Initialize reference quadrature rule and visitor data
@@ -697,15 +797,17 @@ void gsAssembler<T>::apply(ElementVisitor & visitor,
 
     // Start iteration over elements
 #ifdef _OPENMP
-    for ( domIt->next(tid); domIt->good(); domIt->next(nt) )
+    for ( domIt->next(tid); domIt->good(); domIt->next(nt), elem += nt )
 #else
-    for (; domIt->good(); domIt->next() )
+    for (; domIt->good(); domIt->next(), ++elem )
 #endif
     {
         // Map the Quadrature rule to the element
         quRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(), quNodes, quWeights );
 
         // Perform required evaluations on the quadrature nodes
+        if ( NULL != cache )
+            setCachedElement(visitor_, cache, patchIndex, elem);
         visitor_.evaluate(bases, patch, quNodes);
 
         // Assemble on element
@@ -720,6 +822,82 @@ void gsAssembler<T>::apply(ElementVisitor & visitor,
 }
 
 
+template <class T>
+template<class ElementVisitor>
+void gsAssembler<T>::applyColored(ElementVisitor & visitor,
+                                  size_t patchIndex,
+                                  boxSide side)
+{
+    const gsBasisRefs<T> bases(m_bases, patchIndex);
+
+    // Elements of one color do not share DoFs
+    std::vector<std::vector<index_t> > colors;
+    colorElements(patchIndex, side, colors);
+    gsElementCache<T> * cache = elementCache(patchIndex, side);
+
+#pragma omp parallel
+{
+    gsQuadRule<T> quRule ; // Quadrature rule
+    gsMatrix<T> quNodes  ; // Temp variable for mapped nodes
+    gsVector<T> quWeights; // Temp variable for mapped weights
+
+    ElementVisitor
+#ifdef _OPENMP
+    // Create thread-private visitor
+    visitor_(visitor);
+    const int tid = omp_get_thread_num();
+    const int nt  = omp_get_num_threads();
+#else
+    &visitor_ = visitor;
+    const int tid = 0;
+    const int nt  = 1;
+#endif
+
+    // Initialize reference quadrature rule and visitor data
+    visitor_.initialize(bases, patchIndex, m_options, quRule);
+
+    const gsGeometry<T> & patch = m_pde_ptr->patches()[patchIndex];
+
+    for (size_t c = 0; c != colors.size(); ++c)
+    {
+        const std::vector<index_t> & elements = colors[c];
+
+        // Element indices of a color are increasing, therefore the
+        // iterator of the thread only moves forward
+        typename gsBasis<T>::domainIter domIt = bases[0].makeDomainIterator(side);
+        index_t cur = 0;
+
+        for (size_t e = tid; e < elements.size(); e += nt)
+        {
+            if ( elements[e] != cur )
+            {
+                domIt->next(elements[e] - cur);
+                cur = elements[e];
+            }
+
+            // Map the Quadrature rule to the element
+            quRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(), quNodes, quWeights );
+
+            // Perform required evaluations on the quadrature nodes
+            if ( NULL != cache )
+                setCachedElement(visitor_, cache, patchIndex, cur);
+            visitor_.evaluate(bases, patch, quNodes);
+
+            // Assemble on element
+            visitor_.assemble(*domIt, quWeights);
+
+            // Push to global matrix and right-hand side vector, no
+            // other thread touches the same rows and columns
+            visitor_.localToGlobal(patchIndex, m_ddof, m_system);
+        }
+
+        // Next color starts when all elements of this color are pushed
+#pragma omp barrier
+    }
+}//omp parallel
+
+}
+
 template <class T>
 template<class InterfaceVisitor>
 void gsAssembler<T>::apply(InterfaceVisitor & visitor,
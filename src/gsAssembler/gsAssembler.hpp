@@ -13,6 +13,7 @@
 
 #include <gsAssembler/gsAssembler.h>
 #include <gsAssembler/gsGaussRule.h>
+#include <gsAssembler/gsElementColoring.h>
 #include <gsCore/gsMultiBasis.h>
 #include <gsCore/gsDomainIterator.h>
 #include <gsCore/gsField.h>
@@ -38,6 +39,10 @@ gsOptionList gsAssembler<T>::defaultOptions()
     opt.addReal("bdA", "Estimated nonzeros per column of the matrix: bdA*deg + bdB", 2.0  );
     opt.addInt ("bdB", "Estimated nonzeros per column of the matrix: bdA*deg + bdB", 1    );
     opt.addReal("bdO", "Overhead of sparse mem. allocation: (1+bdO)(bdA*deg + bdB) [0..1]", 0.333);
+    opt.addInt ("ParallelScatter", "Method for pushing element contributions in parallel assembly [0..1]", 0);
+    opt.addSwitch("ExactPattern", "Compute the exact sparsity pattern of the matrix before the first assembly", true);
+    opt.addSwitch("SumFactorization", "Use sum factorization for element integrals on tensor-product bases", true);
+    opt.addInt ("ElementCache", "Memory limit (MB) for keeping element evaluations between assemblies, 0: disabled", 0);
     return opt;
 }
 
@@ -123,6 +128,48 @@ void gsAssembler<T>::scalarProblemGalerkinRefresh()
     m_system = gsSparseSystem<T>(mapper);//1,1
 }
 
+template <class T>
+void gsAssembler<T>::colorElements(const index_t patchIndex, const boxSide side,
+                                   std::vector<std::vector<index_t> > & colors)
+{
+    GISMO_ENSURE( m_system.numRowBlocks() == m_system.numColBlocks(),
+                  "Element coloring assumes the same row and column blocks");
+
+    const gsBasisRefs<T> bases(m_bases, patchIndex);
+    const index_t nBlocks = m_system.numColBlocks();
+    const index_t nDofs   = m_system.matrix().outerSize();
+
+    // 1. Collect the free (global) DoFs touched by each element
+    std::vector<index_t> elPtr(1, 0), elDofs;
+    gsMatrix<index_t> act;
+    index_t ii;
+    typename gsBasis<T>::domainIter domIt = bases[0].makeDomainIterator(side);
+    for (; domIt->good(); domIt->next() )
+    {
+        for (index_t c = 0; c != nBlocks; ++c)
+        {
+            const gsDofMapper & mapper = m_system.colMapper(c);
+            bases[m_system.colBasis(c)].active_into(domIt->centerPoint(), act);
+            for (index_t i = 0; i != act.rows(); ++i)
+                if ( mapper.is_free(act(i,0), patchIndex) )
+                {
+                    m_system.mapToGlobalColIndex(act(i,0), patchIndex, ii, c);
+                    elDofs.push_back(ii);
+                }
+        }
+        elPtr.push_back(elDofs.size());
+    }
+
+    // 2. Elements of the same color do not share DoFs
+    greedyElementColoring(elPtr, elDofs, nDofs, colors);
+
+    // 3. Reserve room for all couplings of the patch, so that no
+    // re-allocation of the matrix happens during the scatter
+    gsVector<index_t> nz;
+    elementCouplings(elPtr, elDofs, elPtr, elDofs, nDofs, nDofs, nz);
+    m_system.matrix().reserve(nz);
+}
+
 template<class T>
 void gsAssembler<T>::penalizeDirichletDofs(short_t unk)
 {
@@ -68,6 +68,21 @@ struct iFace
 
 };
 
+struct parallelScatter
+{
+    enum strategy
+    {
+        /// Local contributions of the elements are pushed to the
+        /// global system inside a critical section.
+        critical = 0,
+
+        /// Elements are colored such that no two elements of the same
+        /// color share a degree of freedom. The elements of a color
+        /// are then pushed concurrently, without any locking.
+        coloring = 1
+    };
+};
+
 /*
     enum iFaceTopology
     {
@@ -0,0 +1,240 @@
+/** @file gsElementCache.h
+
+    @brief Cache of element evaluations for repeated assemblies
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsFuncData.h>
+
+namespace gismo
+{
+
+/**
+   @brief Stores the basis and geometry evaluations of the elements of
+   a multi-patch domain, so that assembling again on the same mesh
+   (eg. in time steps or Newton iterations) skips the evaluation.
+
+   An entry is identified by the patch, the element index in
+   iteration order, and a tag chosen by the element visitor which
+   describes the kind of stored data. Entries are only returned if
+   they were computed on the same quadrature nodes. The entries of a
+   patch are dropped when the size or the number of elements of its
+   basis changes, eg. after refinement. Changes of the geometry are
+   not detected, clear() has to be called in that case.
+
+   New entries are rejected once the memory limit is reached.
+
+   \ingroup Assembler
+*/
+template <class T>
+class gsElementCache
+{
+public:
+
+    /// Cached data of one element
+    struct Entry
+    {
+        unsigned tag;
+        gsMatrix<index_t> actives;
+        std::vector<gsMatrix<T> > basisData;
+        gsMapData<T> md;
+    };
+
+public:
+
+    gsElementCache() : m_maxBytes(0), m_bytes(0) { }
+
+    /// Sets the memory limit in bytes
+    void setMemoryLimit(size_t bytes)
+    {
+        m_maxBytes = bytes;
+        if ( m_bytes > m_maxBytes )
+            clear();
+    }
+
+    /// Returns the memory used by the entries in bytes
+    size_t memoryUsage() const { return m_bytes; }
+
+    /// Removes all entries
+    void clear()
+    {
+        m_patches.clear();
+        m_bytes = 0;
+    }
+
+    /// Prepares the storage for the elements of patch \a patchIndex,
+    /// whose basis is \a basis. Must be called before find() and
+    /// store() for this patch, and not concurrently with them.
+    void prepare(const index_t patchIndex, const gsBasis<T> & basis)
+    {
+        if ( m_patches.size() <= static_cast<size_t>(patchIndex) )
+            m_patches.resize(patchIndex + 1);
+
+        Patch & pt = m_patches[patchIndex];
+        const index_t sz = basis.size();
+        const index_t ne = basis.numElements();
+        if ( pt.size != sz || static_cast<index_t>(pt.elements.size()) != ne )
+        {
+            for (size_t e = 0; e != pt.elements.size(); ++e)
+                for (size_t i = 0; i != pt.elements[e].size(); ++i)
+                    m_bytes -= bytes(pt.elements[e][i]);
+            pt.elements.clear();
+            pt.elements.resize(ne);
+            pt.size = sz;
+        }
+    }
+
+    /// Returns the tag of the evaluations described by the geometry
+    /// evaluation flags \a flags, where \a sfOnly indicates that no
+    /// basis values are stored (sum factorization)
+    static unsigned tag(const unsigned flags, const bool sfOnly)
+    { return 2 * flags + sfOnly; }
+
+    /// Returns the entry with tag \a tag of element \a element of
+    /// patch \a patchIndex computed on \a points, or NULL if there is
+    /// none
+    const Entry * find(const index_t patchIndex, const index_t element,
+                       const unsigned tag, const gsMatrix<T> & points) const
+    {
+        const std::vector<Entry> & el = m_patches[patchIndex].elements[element];
+        for (size_t i = 0; i != el.size(); ++i)
+            if ( el[i].tag == tag && el[i].md.points.cols() == points.cols()
+                 && el[i].md.points == points )
+                return &el[i];
+        return NULL;
+    }
+
+    /// Stores an entry for element \a element of patch \a
+    /// patchIndex. Different elements can be stored concurrently.
+    void store(const index_t patchIndex, const index_t element, const unsigned tag,
+               const gsMatrix<index_t> & actives,
+               const std::vector<gsMatrix<T> > & basisData,
+               const gsMapData<T> & md)
+    {
+        const size_t sz = bytes(actives, basisData, md);
+        bool accept;
+#       pragma omp critical (gsElementCache_store)
+        {
+            accept = m_bytes + sz <= m_maxBytes;
+            if ( accept )
+                m_bytes += sz;
+        }
+        if ( !accept )
+            return;
+
+        std::vector<Entry> & el = m_patches[patchIndex].elements[element];
+        el.push_back(Entry());
+        Entry & entry = el.back();
+        entry.tag       = tag;
+        entry.actives   = actives;
+        entry.basisData = basisData;
+        entry.md        = md;
+    }
+
+private:
+
+    static size_t bytes(const gsMatrix<T> & m) { return m.size() * sizeof(T); }
+
+    static size_t bytes(const gsMatrix<index_t> & actives,
+                        const std::vector<gsMatrix<T> > & basisData,
+                        const gsMapData<T> & md)
+    {
+        size_t sz = actives.size() * sizeof(index_t);
+        for (size_t i = 0; i != basisData.size(); ++i)
+            sz += bytes(basisData[i]);
+        for (size_t i = 0; i != md.values.size(); ++i)
+            sz += bytes(md.values[i]);
+        return sz + bytes(md.points) + bytes(md.measures) + bytes(md.fundForms)
+            + bytes(md.normals) + bytes(md.outNormals);
+    }
+
+    static size_t bytes(const Entry & entry)
+    { return bytes(entry.actives, entry.basisData, entry.md); }
+
+private:
+
+    struct Patch
+    {
+        Patch() : size(-1) { }
+
+        index_t size; // size of the basis
+        std::vector<std::vector<Entry> > elements;
+    };
+
+    std::vector<Patch> m_patches;
+
+    size_t m_maxBytes, m_bytes;
+};
+
+/**
+   @brief The current element of an element visitor in a
+   gsElementCache, if any.
+
+   Holds the lookup and storage of the evaluations of the element
+   visited next, so that element visitors only copy the data.
+
+   \ingroup Assembler
+*/
+template <class T>
+class gsCachedElement
+{
+public:
+
+    gsCachedElement() : m_cache(NULL), m_patch(0), m_element(0) { }
+
+    /// Sets the cache and the element \a element of patch \a
+    /// patchIndex
+    void set(gsElementCache<T> * cache, const index_t patchIndex, const index_t element)
+    {
+        m_cache   = cache;
+        m_patch   = patchIndex;
+        m_element = element;
+    }
+
+    /// Disables the cache
+    void reset() { m_cache = NULL; }
+
+    /// Returns the cached evaluations on \a md.points for the flags
+    /// \a md.flags, or NULL if there are none. \a sfOnly indicates
+    /// that the basis values are not needed.
+    const typename gsElementCache<T>::Entry *
+    find(const gsMapData<T> & md, const bool sfOnly) const
+    {
+        return NULL == m_cache ? NULL
+            : m_cache->find(m_patch, m_element,
+                            gsElementCache<T>::tag(md.flags, sfOnly), md.points);
+    }
+
+    /// Stores the evaluations of the element, if a cache is set
+    void store(const gsMatrix<index_t> & actives,
+               const std::vector<gsMatrix<T> > & basisData,
+               const gsMapData<T> & md, const bool sfOnly) const
+    {
+        if ( NULL != m_cache )
+            m_cache->store(m_patch, m_element, gsElementCache<T>::tag(md.flags, sfOnly),
+                           actives, basisData, md);
+    }
+
+private:
+
+    gsElementCache<T> * m_cache;
+    index_t m_patch, m_element;
+};
+
+/// @brief Sets the cache and the current element of an element
+/// visitor. This version is used for visitors that do not support
+/// caching and does nothing.
+///
+/// \relates gsElementCache
+template <class Visitor, class T>
+inline void setCachedElement(Visitor &, gsElementCache<T> *, index_t, index_t)
+{ }
+
+} // namespace gismo
@@ -0,0 +1,185 @@
+/** @file gsElementColoring.h
+
+    @brief Element connectivity: coloring for lock-free parallel
+    assembly and sparsity patterns
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+namespace gismo
+{
+
+/**
+   @brief Computes the incidence (transpose) of a list of
+   element-wise index sets.
+
+   The indices of element \a e are stored in
+   \a elIdx[\a elPtr[e]], ..., \a elIdx[\a elPtr[e+1]-1] and lie in
+   [0,\a n). On output, the elements containing index \a i are
+   \a incEl[\a incPtr[i]], ..., \a incEl[\a incPtr[i+1]-1], in
+   increasing order.
+
+   \ingroup Assembler
+*/
+inline void elementIncidence(const std::vector<index_t> & elPtr,
+                             const std::vector<index_t> & elIdx,
+                             const index_t n,
+                             std::vector<index_t> & incPtr,
+                             std::vector<index_t> & incEl)
+{
+    incPtr.assign(n+1, 0);
+    incEl.resize(elIdx.size());
+    for (size_t k = 0; k != elIdx.size(); ++k)
+        ++incPtr[elIdx[k]+1];
+    for (index_t i = 0; i != n; ++i)
+        incPtr[i+1] += incPtr[i];
+
+    std::vector<index_t> pos(incPtr.begin(), incPtr.end()-1);
+    const index_t nEl = elPtr.size() - 1;
+    for (index_t e = 0; e != nEl; ++e)
+        for (index_t k = elPtr[e]; k != elPtr[e+1]; ++k)
+            incEl[pos[elIdx[k]]++] = e;
+}
+
+/**
+   @brief Greedy coloring of elements such that no two elements of
+   the same color share a degree of freedom.
+
+   The DoFs of element \a e are \a elDofs[\a elPtr[e]], ...,
+   \a elDofs[\a elPtr[e+1]-1], and lie in [0,\a nDofs). Each element
+   takes the smallest color which is not used by an element sharing
+   a DoF with it. On output, \a colors[c] contains the indices of the
+   elements having color \a c, in increasing order.
+
+   \ingroup Assembler
+*/
+inline void greedyElementColoring(const std::vector<index_t> & elPtr,
+                                  const std::vector<index_t> & elDofs,
+                                  const index_t nDofs,
+                                  std::vector<std::vector<index_t> > & colors)
+{
+    std::vector<index_t> dofPtr, dofEls;
+    elementIncidence(elPtr, elDofs, nDofs, dofPtr, dofEls);
+
+    const index_t nEl = elPtr.size() - 1;
+    std::vector<index_t> elColor(nEl, -1), mark;
+    colors.clear();
+    for (index_t e = 0; e != nEl; ++e)
+    {
+        // Mark the colors of all elements sharing a DoF with e
+        for (index_t k = elPtr[e]; k != elPtr[e+1]; ++k)
+            for (index_t j = dofPtr[elDofs[k]]; j != dofPtr[elDofs[k]+1]; ++j)
+                if ( -1 != elColor[dofEls[j]] )
+                    mark[elColor[dofEls[j]]] = e;
+
+        index_t c = 0;
+        while ( c < static_cast<index_t>(mark.size()) && mark[c] == e ) ++c;
+        if ( c == static_cast<index_t>(colors.size()) )
+        {
+            colors.push_back(std::vector<index_t>());
+            mark.push_back(-1);
+        }
+        elColor[e] = c;
+        colors[c].push_back(e);
+    }
+}
+
+/**
+   @brief Counts, for every column, the number of distinct rows
+   which are coupled with it by some element.
+
+   The rows (resp. columns) of element \a e are given by
+   \a rowPtr, \a rowIdx (resp. \a colPtr, \a colIdx) in the same
+   format as in elementIncidence(). The result \a nz (of size \a nCols)
+   is an upper bound of the non-zero entries per column of the
+   assembled matrix, which can be used to reserve its memory.
+
+   \ingroup Assembler
+*/
+inline void elementCouplings(const std::vector<index_t> & rowPtr,
+                             const std::vector<index_t> & rowIdx,
+                             const std::vector<index_t> & colPtr,
+                             const std::vector<index_t> & colIdx,
+                             const index_t nRows,
+                             const index_t nCols,
+                             gsVector<index_t> & nz)
+{
+    std::vector<index_t> incPtr, incEl;
+    elementIncidence(colPtr, colIdx, nCols, incPtr, incEl);
+
+    nz.setZero(nCols);
+    std::vector<index_t> seen(nRows, -1);
+    for (index_t j = 0; j != nCols; ++j)
+        for (index_t k = incPtr[j]; k != incPtr[j+1]; ++k)
+        {
+            const index_t el = incEl[k];
+            for (index_t i = rowPtr[el]; i != rowPtr[el+1]; ++i)
+                if ( seen[rowIdx[i]] != j )
+                {
+                    seen[rowIdx[i]] = j;
+                    ++nz[j];
+                }
+        }
+}
+
+/**
+   @brief Computes the exact sparsity pattern of the matrix assembled
+   from the given element-wise rows and columns.
+
+   The element index sets are given in the same format as in
+   elementCouplings(). On output, \a pattern is a compressed
+   \a nRows x \a nCols matrix whose entries are explicit zeros at
+   every coupling. If \a lower is true, only the entries on and below
+   the diagonal are created.
+
+   \ingroup Assembler
+*/
+template<class T>
+void elementSparsityPattern(const std::vector<index_t> & rowPtr,
+                            const std::vector<index_t> & rowIdx,
+                            const std::vector<index_t> & colPtr,
+                            const std::vector<index_t> & colIdx,
+                            const index_t nRows,
+                            const index_t nCols,
+                            const bool lower,
+                            gsSparseMatrix<T> & pattern)
+{
+    std::vector<index_t> incPtr, incEl;
+    elementIncidence(colPtr, colIdx, nCols, incPtr, incEl);
+
+    gsVector<index_t> nz;
+    elementCouplings(rowPtr, rowIdx, colPtr, colIdx, nRows, nCols, nz);
+
+    pattern.resize(nRows, nCols);
+    pattern.reserve(nz.sum());
+
+    // Rows are inserted sorted, column by column
+    std::vector<index_t> seen(nRows, -1), rows;
+    for (index_t j = 0; j != nCols; ++j)
+    {
+        pattern.startVec(j);
+        rows.clear();
+        for (index_t k = incPtr[j]; k != incPtr[j+1]; ++k)
+        {
+            const index_t el = incEl[k];
+            for (index_t i = rowPtr[el]; i != rowPtr[el+1]; ++i)
+                if ( seen[rowIdx[i]] != j && (!lower || rowIdx[i] >= j) )
+                {
+                    seen[rowIdx[i]] = j;
+                    rows.push_back(rowIdx[i]);
+                }
+        }
+        std::sort(rows.begin(), rows.end());
+        for (size_t i = 0; i != rows.size(); ++i)
+            pattern.insertBack(rows[i], j) = 0;
+    }
+    pattern.finalize();
+}
+
+} // namespace gismo
@@ -16,6 +16,8 @@
 #include <gsUtils/gsPointGrid.h>
 #include <gsAssembler/gsQuadrature.h>
 #include <gsAssembler/gsExprHelper.h>
+#include <gsAssembler/gsElementColoring.h>
+#include <gsAssembler/gsPatchPartition.h>
 
 namespace gismo
 {
@@ -32,6 +34,8 @@ private:
 
     gsOptionList m_options;
 
+    gsPatchPartition m_partition;
+
     expr::gsFeElement<T> m_element;
 
     gsSparseMatrix<T> m_matrix;
@@ -301,6 +305,17 @@ public:
 
     /// Set the assembler options
     void setOptions(gsOptionList opt) { m_options = opt; } // gsOptionList opt
+
+    /// @brief Restricts the assembly to the patches of this process
+    ///
+    /// Only the elements of the local patches of \a part, the
+    /// boundaries of these patches and the interfaces whose first
+    /// side is local are assembled. The sum of the systems assembled
+    /// by all processes is the whole system, see gsDistributedOp.
+    void setPartition(const gsPatchPartition & part) { m_partition = part; }
+
+    /// Returns the partition of the patches
+    const gsPatchPartition & partition() const { return m_partition; }
     // .swap(opt) todo
 
 #   if(__cplusplus >= 201103L || _MSC_VER >= 1600 || defined(__DOXYGEN__))
@@ -308,6 +323,10 @@ public:
     ///
     /// The arguments are considered as integrals over the whole domain
     /// \sa gsExprAssembler::setIntegrationElements
+    ///
+    /// If OpenMP is enabled, the elements of every patch are colored
+    /// such that elements of the same color do not share degrees of
+    /// freedom, and each color is assembled by all threads in parallel
     template<class... expr> void assemble(expr... args);
 
     /// Adds the expressions \a args to the system matrix/rhs
@@ -424,7 +443,28 @@ private:
                                 space rvar, space cvar,
                                 const ifContainer & iFaces);
 
+    /// Colors the elements of patch \a patchInd such that elements
+    /// of the same color do not share rows or columns of the system,
+    /// and reserves the matrix memory for conflict-free insertion
+    void _colorElements(const index_t patchInd,
+                        std::vector<std::vector<index_t> > & colors);
+
+    /// Appends the free global indices of the DoFs of \a spaces
+    /// which are active at the point \a pt of patch \a patchInd
+    static void _activeDofs(const std::vector<expr::gsFeSpace<T>*> & spaces,
+                            const index_t patchInd, const gsMatrix<T> & pt,
+                            gsMatrix<index_t> & act, std::vector<index_t> & dofs);
+
 #if __cplusplus >= 201103L || _MSC_VER >= 1600 // c++11
+    /// Assembles the elements of patch \a patchInd color by color,
+    /// thread \a tid taking the elements tid, tid+nt, ... of every
+    /// color. The arguments are copied, since expressions contain
+    /// temporaries
+    template<class... expr>
+    void _assembleColors(const std::vector<std::vector<index_t> > & colors,
+                         const index_t patchInd, const int tid, const int nt,
+                         expr... args);
+
     template <class op, class E1>
     void _apply(op _op, const expr::_expr<E1> & firstArg) {_op(firstArg);}
     template <class op, class E1, class... Rest>
@@ -724,8 +764,36 @@ void gsExprAssembler<T>::assemble(expr... args)
 
     _eval ee(m_matrix, m_rhs, quWeights);
 
+#   if defined(_OPENMP) && (__cplusplus >= 201103L || _MSC_VER >= 1600)
+    // Number of threads, limited by the evaluation slots
+    const int nt = math::min(math::min(omp_get_max_threads(),
+                                       static_cast<int>(m_exprdata->numSlots())),
+                             static_cast<int>(m_element.numSlots()));
+#   endif
+
     for (unsigned patchInd = 0; patchInd < m_exprdata->multiBasis().nBases(); ++patchInd)
     {
+        if ( !m_partition.isLocal(patchInd) )
+            continue;
+
+#       if defined(_OPENMP) && (__cplusplus >= 201103L || _MSC_VER >= 1600)
+        if ( nt > 1 )
+        {
+            std::vector<std::vector<index_t> > colors;
+            _colorElements(patchInd, colors);
+            m_exprdata->syncSlots();
+
+#           pragma omp parallel num_threads(nt)
+            {
+                const int tid = omp_get_thread_num();
+                gismo::expr::_slot() = tid;
+                _assembleColors(colors, patchInd, tid, omp_get_num_threads(), args...);
+                gismo::expr::_slot() = 0;
+            }
+            continue;
+        }
+#       endif
+
         ee.setPatch(patchInd);
         QuRule = gsQuadrature::get(m_exprdata->multiBasis().basis(patchInd), m_options);
 
@@ -757,6 +825,113 @@ void gsExprAssembler<T>::assemble(expr... args)
     m_matrix.makeCompressed();
 }
 
+template<class T>
+void gsExprAssembler<T>::_activeDofs(const std::vector<expr::gsFeSpace<T>*> & spaces,
+                                     const index_t patchInd, const gsMatrix<T> & pt,
+                                     gsMatrix<index_t> & act, std::vector<index_t> & dofs)
+{
+    for (size_t s = 0; s != spaces.size(); ++s)
+    {
+        spaces[s]->source().piece(patchInd).active_into(pt, act);
+        const gsDofMapper & map = spaces[s]->mapper();
+        for (index_t c = 0; c != spaces[s]->dim(); ++c)
+            for (index_t i = 0; i != act.rows(); ++i)
+            {
+                const index_t ii = map.index(act.at(i), patchInd, c);
+                if ( map.is_free_index(ii) )
+                    dofs.push_back(ii);
+            }
+    }
+}
+
+template<class T>
+void gsExprAssembler<T>::_colorElements(const index_t patchInd,
+                                        std::vector<std::vector<index_t> > & colors)
+{
+    const index_t nRows = numTestDofs();
+    const index_t nCols = numDofs();
+
+    // 1. Collect the rows and columns of every element, as seen from
+    // the active functions at the element center
+    std::vector<index_t> rowPtr(1,0), rowIdx, colPtr(1,0), colIdx;
+    gsMatrix<index_t> act;
+    typename gsBasis<T>::domainIter domIt =
+        m_exprdata->multiBasis().basis(patchInd).makeDomainIterator();
+    for (; domIt->good(); domIt->next() )
+    {
+        _activeDofs(m_vrow, patchInd, domIt->centerPoint(), act, rowIdx);
+        rowPtr.push_back(rowIdx.size());
+        _activeDofs(m_vcol, patchInd, domIt->centerPoint(), act, colIdx);
+        colPtr.push_back(colIdx.size());
+    }
+
+    // 2. Elements of the same color share neither a row (entry of
+    // the rhs) nor a column (storage of the column-major matrix)
+    const index_t nEl = rowPtr.size() - 1;
+    std::vector<index_t> elPtr(1,0), elDofs;
+    elDofs.reserve(rowIdx.size() + colIdx.size());
+    for (index_t e = 0; e != nEl; ++e)
+    {
+        elDofs.insert(elDofs.end(), rowIdx.begin()+rowPtr[e], rowIdx.begin()+rowPtr[e+1]);
+        for (index_t k = colPtr[e]; k != colPtr[e+1]; ++k)
+            elDofs.push_back(nRows + colIdx[k]);
+        elPtr.push_back(elDofs.size());
+    }
+    greedyElementColoring(elPtr, elDofs, nRows + nCols, colors);
+
+    // 3. Reserve enough memory, so that coeffRef does not reallocate
+    if ( m_matrix.rows() == nRows && m_matrix.cols() == nCols )
+    {
+        gsVector<index_t> nz;
+        elementCouplings(rowPtr, rowIdx, colPtr, colIdx, nRows, nCols, nz);
+        m_matrix.reserve(nz);
+    }
+}
+
+#if __cplusplus >= 201103L || _MSC_VER >= 1600 // c++11
+template<class T>
+template<class... expr>
+void gsExprAssembler<T>::_assembleColors(const std::vector<std::vector<index_t> > & colors,
+                                         const index_t patchInd, const int tid, const int nt,
+                                         expr... args)
+{
+    const gsBasis<T> & basis = m_exprdata->multiBasis().basis(patchInd);
+    gsQuadRule<T> QuRule = gsQuadrature::get(basis, m_options);
+    gsVector<T> quWeights;
+
+    _eval ee(m_matrix, m_rhs, quWeights);
+    ee.setPatch(patchInd);
+
+    for (size_t c = 0; c != colors.size(); ++c)
+    {
+        const std::vector<index_t> & elements = colors[c];
+
+        // Element indices of a color are increasing, therefore the
+        // iterator of the thread only moves forward
+        typename gsBasis<T>::domainIter domIt = basis.makeDomainIterator();
+        m_element.set(*domIt);
+        index_t cur = 0;
+
+        for (size_t e = tid; e < elements.size(); e += nt)
+        {
+            if ( elements[e] != cur )
+            {
+                domIt->next(elements[e] - cur);
+                cur = elements[e];
+            }
+
+            QuRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(),
+                          m_exprdata->points(), quWeights);
+            m_exprdata->precompute(patchInd);
+            _apply(ee, args...);
+        }
+
+        // The next color starts when all elements of this one are done
+#       pragma omp barrier
+    }
+}
+#endif
+
 template<class T>
 #if __cplusplus >= 201103L || _MSC_VER >= 1600 // c++11
 template<class... expr>
@@ -782,6 +957,8 @@ void gsExprAssembler<T>::assemble(const bcRefList & BCs, const expr::_expr<E1> &
     for (typename bcRefList::const_iterator iit = BCs.begin(); iit!= BCs.end(); ++iit)
     {
         const boundary_condition<T> * it = &iit->get();
+        if ( !m_partition.isLocal(it->patch()) )
+            continue;
 
         QuRule = gsQuadrature::get(m_exprdata->multiBasis().basis(it->patch()), m_options, it->side().direction());
 
@@ -841,6 +1018,9 @@ void gsExprAssembler<T>::assembleLhsRhsBc_impl(const expr::_expr<E1> & exprLhs,
 
     for (typename bcContainer::const_iterator it = BCs.begin(); it!= BCs.end(); ++it)
     {
+        if ( !m_partition.isLocal(it->patch()) )
+            continue;
+
         QuRule = gsQuadrature::get(m_exprdata->multiBasis().basis(it->patch()), m_options, it->side().direction());
 
         m_exprdata->mapData.side = it->side();
@@ -902,6 +1082,8 @@ void gsExprAssembler<T>::assembleInterface_impl(const expr::_expr<E1> & exprLhs,
     {
         const boundaryInterface & iFace = *it;
         const index_t patch1 = iFace.first() .patch;
+        if ( !m_partition.isLocal(patch1) )
+            continue;
         //const index_t patch2 = iFace.second().patch;
         //const gsAffineFunction<T> interfaceMap(m_pde_ptr->patches().getMapForInterface(bi));
 
@@ -282,6 +282,13 @@ private:
     template<class E, bool storeElWise, class _op>
     T compute_impl(const expr::_expr<E> & expr);
 
+    /// Computes the values of the elements tid, tid+nt, ... of patch
+    /// \a patchInd, stored in \a elVals by element index. The
+    /// expression is copied, since it contains temporaries
+    template<class E, class _op>
+    void computeElements_impl(const expr::value_expr<E> ev, const index_t patchInd,
+                              const int tid, const int nt, std::vector<T> & elVals);
+
     template<class E, class _op>
     T computeBdr_impl(const expr::_expr<E> & expr);
 
@@ -337,8 +344,44 @@ T gsExprEvaluator<T>::compute_impl(const expr::_expr<E> & expr)
     m_elWise.clear();
     if ( storeElWise )
         m_elWise.reserve(m_exprdata->multiBasis().totalElements());
+
+#   ifdef _OPENMP
+    // Number of threads, limited by the evaluation slots
+    const int nt = math::min(math::min(omp_get_max_threads(),
+                                       static_cast<int>(m_exprdata->numSlots())),
+                             static_cast<int>(m_element.numSlots()));
+    std::vector<T> elVals;
+    if ( nt > 1 )
+        m_exprdata->syncSlots();
+#   endif
+
     for (unsigned patchInd=0; patchInd < m_exprdata->multiBasis().nBases(); ++patchInd)
     {
+#       ifdef _OPENMP
+        if ( nt > 1 )
+        {
+            elVals.resize(m_exprdata->multiBasis().basis(patchInd).numElements());
+#           pragma omp parallel num_threads(nt)
+            {
+                const int tid = omp_get_thread_num();
+                gismo::expr::_slot() = tid;
+                computeElements_impl<E,_op>(expr.val(), patchInd, tid,
+                                            omp_get_num_threads(), elVals);
+                gismo::expr::_slot() = 0;
+            }
+
+            // Accumulate in element order, so that the result does
+            // not depend on the number of threads
+            for (size_t e = 0; e != elVals.size(); ++e)
+            {
+                _op::acc(elVals[e], 1, m_value);
+                if ( storeElWise )
+                    m_elWise.push_back( elVals[e] );
+            }
+            continue;
+        }
+#       endif
+
         // Quadrature rule
         QuRule =  gsQuadrature::get(m_exprdata->multiBasis().basis(patchInd), m_options);
         //gsDebugVar(QuRule.numNodes());
@@ -373,6 +416,36 @@ T gsExprEvaluator<T>::compute_impl(const expr::_expr<E> & expr)
     return m_value;
 }
 
+template<class T>
+template<class E, class _op>
+void gsExprEvaluator<T>::computeElements_impl(const expr::value_expr<E> ev,
+                                              const index_t patchInd,
+                                              const int tid, const int nt,
+                                              std::vector<T> & elVals)
+{
+    gsQuadRule<T> QuRule =
+        gsQuadrature::get(m_exprdata->multiBasis().basis(patchInd), m_options);
+    gsVector<T> quWeights;
+
+    typename gsBasis<T>::domainIter domIt =
+        m_exprdata->multiBasis().piece(patchInd).makeDomainIterator();
+    m_element.set(*domIt);
+
+    T elVal;
+    size_t e = tid;
+    for ( domIt->next(tid); domIt->good(); domIt->next(nt), e += nt )
+    {
+        QuRule.mapTo( domIt->lowerCorner(), domIt->upperCorner(),
+                      m_exprdata->points(), quWeights);
+        m_exprdata->precompute(patchInd);
+
+        elVal = _op::init();
+        for (index_t k = 0; k != quWeights.rows(); ++k)
+            _op::acc(ev.eval(k), quWeights[k], elVal);
+        elVals[e] = elVal;
+    }
+}
+
 template<class T>
 template<class E, class _op>
 T gsExprEvaluator<T>::computeBdr_impl(const expr::_expr<E> & expr)
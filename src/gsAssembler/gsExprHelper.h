@@ -19,6 +19,11 @@ namespace gismo
 {
 /**
    Class holding an expression environment
+
+   The evaluation data are stored in a number of slots, so that
+   several threads can evaluate the same expressions on different
+   elements. The slot of the calling thread is given by
+   expr::_slot(), which is zero outside of parallel regions.
  */
 template<class T>
 class gsExprHelper
@@ -26,14 +31,20 @@ class gsExprHelper
 private:
     gsExprHelper(const gsExprHelper &);
 
-    gsExprHelper() : mesh_ptr(NULL)
-    { mutVar.setData(mutData); }
+    gsExprHelper()
+    : m_nslots(expr::_numSlots()), m_mapData(m_nslots), mapData(m_mapData.front()),
+      mutData(m_nslots), mesh_ptr(NULL)
+    { mutVar.setData(mutData.front()); }
 
 private:
-    typedef std::map<const gsFunctionSet<T>*,gsFuncData<T> > FunctionTable;
+    typedef std::vector<gsFuncData<T> > SlotData;
+    typedef std::map<const gsFunctionSet<T>*,SlotData> FunctionTable;
     typedef typename FunctionTable::iterator ftIterator;
     typedef typename FunctionTable::const_iterator const_ftIterator;
 
+    // number of evaluation data slots
+    index_t m_nslots;
+
     // variable/space list
     std::deque<expr::gsFeVariable<T> > m_vlist;
     std::deque<expr::gsFeSpace<T> >    m_slist;
@@ -45,14 +56,15 @@ private:
 
     // geometry map
     expr::gsGeometryMap<T> mapVar;
+    std::vector<gsMapData<T> > m_mapData;
 public:
-    gsMapData<T> mapData;
+    gsMapData<T> & mapData; // data of the first slot
 private:
 
     // mutable pair of variable and data,
     // ie. not uniquely assigned to a gsFunctionSet
     expr::gsFeVariable<T> mutVar ;
-    gsFuncData<T>         mutData;
+    SlotData              mutData;
     bool mutParametric;
 
     gsSortedVector<const gsFunctionSet<T>*> evList;
@@ -74,7 +86,10 @@ public:
     typedef memory::shared_ptr<gsExprHelper>  Ptr;
 public:
 
-    gsMatrix<T> & points() { return mapData.points; }
+    gsMatrix<T> & points() { return m_mapData[expr::_slot()].points; }
+
+    /// Returns the number of evaluation data slots
+    index_t numSlots() const { return m_nslots; }
 
     static uPtr make() { return uPtr(new gsExprHelper()); }
 
@@ -96,7 +111,7 @@ public:
             gsInfo << "mapVar: "<< &mapData <<"\n";
         }
 
-        if ( mutVar.isValid() && 0!=mutData.flags)
+        if ( mutVar.isValid() && 0!=mutData.front().flags)
         {
             gsInfo << "mutVar: "<< &mutVar <<"\n";
         }
@@ -116,12 +131,15 @@ public:
 
     void cleanUp()
     {
-        mapData.clear();
-        mutData.clear();
-        for (ftIterator it = m_ptable.begin(); it != m_ptable.end(); ++it)
-            it->second.clear();
-        for (ftIterator it = m_itable.begin(); it != m_itable.end(); ++it)
-            it->second.clear();
+        for (index_t s = 0; s != m_nslots; ++s)
+        {
+            m_mapData[s].clear();
+            mutData[s].clear();
+            for (ftIterator it = m_ptable.begin(); it != m_ptable.end(); ++it)
+                it->second[s].clear();
+            for (ftIterator it = m_itable.begin(); it != m_itable.end(); ++it)
+                it->second[s].clear();
+        }
     }
 
     void setMultiBasis(const gsMultiBasis<T> & mesh) { mesh_ptr = &mesh; }
@@ -159,7 +177,7 @@ public:
     {
         m_vlist.push_back( expr::gsFeVariable<T>() );
         expr::gsFeVariable<T> & var = m_vlist.back();
-        gsFuncData<T> & fd = m_ptable[&mp];
+        gsFuncData<T> & fd = slots(m_ptable[&mp]);
         //fd.dim = mp.dimensions();
         //gsDebugVar(&fd);
         var.registerData(mp, fd, dim);
@@ -172,7 +190,7 @@ public:
         GISMO_ASSERT(&G==&mapVar, "geometry map not known");
         m_vlist.push_back( expr::gsFeVariable<T>() );
         expr::gsFeVariable<T> & var = m_vlist.back();
-        gsFuncData<T> & fd = m_itable[&mp];
+        gsFuncData<T> & fd = slots(m_itable[&mp]);
         //fd.dim = mp.dimensions();
         //gsDebugVar(&fd);
         var.registerData(mp, fd, 1, mapData);
@@ -183,7 +201,7 @@ public:
     {
         m_slist.push_back( expr::gsFeSpace<T>() );
         expr::gsFeSpace<T> & var = m_slist.back();
-        gsFuncData<T> & fd = m_ptable[&mp];
+        gsFuncData<T> & fd = slots(m_ptable[&mp]);
         //fd.dim = mp.dimensions();
         var.registerData(mp, fd, dim);
         return var;
@@ -226,12 +244,32 @@ public:
     void initFlags(const unsigned fflag = 0,
                    const unsigned mflag = 0)
     {
-        mapData.flags = mflag;
-        mutData.flags = fflag;
-        for (ftIterator it = m_ptable.begin(); it != m_ptable.end(); ++it)
-            it->second.flags = fflag;
-        for (ftIterator it = m_itable.begin(); it != m_itable.end(); ++it)
-            it->second.flags = fflag;
+        for (index_t s = 0; s != m_nslots; ++s)
+        {
+            m_mapData[s].flags = mflag;
+            mutData[s].flags = fflag;
+            for (ftIterator it = m_ptable.begin(); it != m_ptable.end(); ++it)
+                it->second[s].flags = fflag;
+            for (ftIterator it = m_itable.begin(); it != m_itable.end(); ++it)
+                it->second[s].flags = fflag;
+        }
+    }
+
+    /// Copies the evaluation flags and the side of the first slot
+    /// to all other slots. To be called before a parallel element
+    /// loop, after the flags have been set
+    void syncSlots()
+    {
+        for (index_t s = 1; s < m_nslots; ++s)
+        {
+            m_mapData[s].flags = mapData.flags;
+            m_mapData[s].side  = mapData.side;
+            mutData[s].flags = mutData.front().flags;
+            for (ftIterator it = m_ptable.begin(); it != m_ptable.end(); ++it)
+                it->second[s].flags = it->second.front().flags;
+            for (ftIterator it = m_itable.begin(); it != m_itable.end(); ++it)
+                it->second[s].flags = it->second.front().flags;
+        }
     }
 
     template<class Expr> // to remove
@@ -253,6 +291,11 @@ public:
     {
         GISMO_ASSERT(0!=points().size(), "No points");
 
+        // Evaluation data of the current slot
+        const index_t s = expr::_slot();
+        gsMapData<T> & mapData = m_mapData[s];
+        gsFuncData<T> & mutData = this->mutData[s];
+
         //mapData.side
         if ( mapVar.isValid() ) // list ?
         {
@@ -275,11 +318,11 @@ public:
             //gsDebugVar("-------");
             //gsDebugVar(&it->second);
             //gsDebugVar(it->second.dim.first);
-            it->first->piece(patchIndex).compute(mapData.points, it->second); // ! piece(.) ?
+            it->first->piece(patchIndex).compute(mapData.points, it->second[s]); // ! piece(.) ?
             //gsDebugVar(&it->second);
             //gsDebugVar(it->second.dim.first);
             //gsDebugVar("-------");
-            it->second.patchId = patchIndex;
+            it->second[s].patchId = patchIndex;
         }
 
         GISMO_ASSERT( m_itable.empty() || 0!=mapData.values.size(), "Map values not computed");
@@ -289,12 +332,24 @@ public:
         {
             //gsDebugVar(&it->second);
             //gsDebugVar(it->second.dim.first);
-            it->first->piece(patchIndex).compute(mapData.values[0], it->second);
+            it->first->piece(patchIndex).compute(mapData.values[0], it->second[s]);
             //gsDebugVar(it->second.dim.first);
-            it->second.patchId = patchIndex;
+            it->second[s].patchId = patchIndex;
         }
     }
 
+private:
+
+    // Returns the first slot of the evaluation data of a table entry,
+    // allocating the slots on first use
+    gsFuncData<T> & slots(SlotData & sd)
+    {
+        if ( sd.empty() ) sd.resize(m_nslots);
+        return sd.front();
+    }
+
+public:
+
     template<class E>
     void parse(const expr::_expr<E> & expr)
     {
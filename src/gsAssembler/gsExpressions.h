@@ -79,6 +79,30 @@ namespace expr
 #  define AutoReturn_t typename util::conditional<ScalarValued,Scalar,MatExprType>::type
 #endif
 
+/*
+   Index of the evaluation data slot used by the calling thread. It
+   is zero, unless it is set inside a parallel element loop
+ */
+inline index_t & _slot()
+{
+    static index_t slot = 0;
+#   pragma omp threadprivate(slot)
+    return slot;
+}
+
+/*
+   Number of evaluation data slots of a newly created expression
+   environment, ie. the maximum number of threads
+ */
+inline index_t _numSlots()
+{
+#   ifdef _OPENMP
+    return omp_get_max_threads();
+#   else
+    return 1;
+#   endif
+}
+
 template<class T> class gsFeVariable;
 template<class T> class gsFeSolution;
 template<class E> class symm_expr;
@@ -375,7 +399,7 @@ template<class T>
 class gsGeometryMap : public _expr<gsGeometryMap<T> >
 {
     const gsFunctionSet<T> * m_fs; ///< Evaluation source for this geometry map
-    const gsMapData<T> *  m_fd;    ///< Temporary variable storing flags and evaluation data
+    const gsMapData<T> *  m_fd;    ///< Temporary variables storing flags and evaluation data, one per slot
     //index_t d, n;
 
 public:
@@ -383,8 +407,8 @@ public:
     /// Returns the function source
     const gsFunctionSet<T> & source() const {return *m_fs;}
 
-    /// Returns the function data
-    const gsMapData<T> & data() const  { return *m_fd; }
+    /// Returns the function data of the current slot
+    const gsMapData<T> & data() const  { return m_fd[_slot()]; }
 
 public:
     typedef T Scalar;
@@ -393,19 +417,19 @@ public:
 
     void print(std::ostream &os) const { os << "G"; }
 
-    MatExprType eval(const index_t k) const { return m_fd->values[0].col(k); }
+    MatExprType eval(const index_t k) const { return data().values[0].col(k); }
 
     void setFlag() const
     {
         GISMO_ASSERT(NULL!=m_fd, "GeometryMap not registered");
-        m_fd->flags |= NEED_VALUE;
+        data().flags |= NEED_VALUE;
     }
 
 protected:
 
     gsGeometryMap() : m_fs(NULL), m_fd(NULL) { }
 
-    /// Registers the source function and evaluation data
+    /// Registers the source function and evaluation data (first slot)
     void registerData(const gsFunctionSet<T> & fs, const gsMapData<T> & val)
     {
         m_fs = &fs;
@@ -415,7 +439,7 @@ protected:
     /// Returns true iff the source function has been set
     bool isValid() const { return NULL!=m_fs; }
 
-    index_t rows() const { return m_fd->dim.second; }
+    index_t rows() const { return data().dim.second; }
     index_t cols() const { return 1; }
 
     static bool rowSpan() {return false;}
@@ -428,7 +452,7 @@ protected:
     {
         GISMO_ASSERT(NULL!=m_fd, "GeometryMap not registered");
         evList.push_unique(m_fs);
-        m_fd->flags |= NEED_VALUE;
+        data().flags |= NEED_VALUE;
     }
 };
 
@@ -447,16 +471,21 @@ class gsFeElement
 {
     friend class cdiam_expr<T>;
 
-    const gsDomainIterator<T> * m_di; ///< Pointer to the domain iterator
+    /// Pointers to the domain iterator, one per slot
+    std::vector<const gsDomainIterator<T> *> m_di;
 
     cdiam_expr<T> cd;
 public:
     typedef T Scalar;
 
-    gsFeElement() : m_di(NULL), cd(*this) { }
+    gsFeElement() : m_di(_numSlots(), NULL), cd(*this) { }
 
+    /// Sets the domain iterator of the current slot
     void set(const gsDomainIterator<T> & di)
-    { m_di = &di; }
+    { m_di[_slot()] = &di; }
+
+    /// Returns the number of slots
+    index_t numSlots() const { return m_di.size(); }
 
     /// The diameter of the element
     const cdiam_expr<T> & diam() const
@@ -483,7 +512,7 @@ public:
 
     explicit cdiam_expr(const gsFeElement<T> & el) : _e(el) { }
 
-    T eval(const index_t ) const { return _e.m_di->getCellSize(); }
+    T eval(const index_t ) const { return _e.m_di[_slot()]->getCellSize(); }
 
     inline cdiam_expr<T> val() const { return *this; }
     inline index_t rows() const { return 0; }
@@ -550,7 +579,7 @@ class gsFeVariable  : public _expr<gsFeVariable<T> >
 protected:
     //const gsFuncData<T>    * m_fd2; // more data when needed
     const gsFunctionSet<T> * m_fs; ///< Evaluation source for this FE variable
-    const gsFuncData<T>    * m_fd; ///< Temporary variable storing flags and evaluation data
+    const gsFuncData<T>    * m_fd; ///< Temporary variables storing flags and evaluation data, one per slot
     index_t m_d;                   ///< Dimension of this (scalar or vector) variable
     const gsMapData<T>     * m_md; ///< If set, the variable is composed with a geometry map
     // comp(u,G)
@@ -561,11 +590,11 @@ public:
     /// Returns the function source
     const gsFunctionSet<T> & source() const {return *m_fs;}
 
-    /// Returns the function data
-    const gsFuncData<T> & data() const {return *m_fd;}
+    /// Returns the function data of the current slot
+    const gsFuncData<T> & data() const {return m_fd[_slot()];}
 
-    /// Returns the mapping data (precondition: composed()==true)
-    const gsMapData<T> & mapData() const {return *m_md;}
+    /// Returns the mapping data of the current slot (precondition: composed()==true)
+    const gsMapData<T> & mapData() const {return m_md[_slot()];}
 
     /// Returns true if the variable is a composition
     bool composed() const {return NULL!=m_md;}
@@ -611,7 +640,7 @@ public:
     // The evaluation return rows for (basis) functions and columns
     // for (coordinate) components
     MatExprType eval(const index_t k) const
-    { return m_fd->values[0].col(k).blockDiag(m_d); } //!!
+    { return data().values[0].col(k).blockDiag(m_d); } //!!
     //{ return m_fd->values[0].col(k); }
 
     const gsFeVariable<T> & rowVar() const {return *this;}
@@ -634,12 +663,13 @@ public:
         */
 
         // note: precomputation is needed
-        if (m_fd->flags & NEED_VALUE)
-        {return m_d * m_fd->values[0].rows();}
-        if (m_fd->flags & NEED_ACTIVE) // note: gsFunction coeff ??
-        {return m_d * m_fd->actives.rows();}
-        if (m_fd->flags & NEED_DERIV)
-        {return m_d * m_fd->values[0].rows();}
+        const gsFuncData<T> & fd = data();
+        if (fd.flags & NEED_VALUE)
+        {return m_d * fd.values[0].rows();}
+        if (fd.flags & NEED_ACTIVE) // note: gsFunction coeff ??
+        {return m_d * fd.actives.rows();}
+        if (fd.flags & NEED_DERIV)
+        {return m_d * fd.values[0].rows();}
         GISMO_ERROR("Cannot deduce row size.");
     }
 
@@ -648,16 +678,16 @@ public:
     void setFlag() const
     {
         GISMO_ASSERT(NULL!=m_fd, "FeVariable: FuncData member not registered");
-        m_fd->flags |= NEED_VALUE;
-        if (NULL!=m_md) m_md->flags |= NEED_VALUE;
+        data().flags |= NEED_VALUE;
+        if (NULL!=m_md) mapData().flags |= NEED_VALUE;
     }
 
     void parse(gsSortedVector<const gsFunctionSet<Scalar>*> & evList) const
     {
         GISMO_ASSERT(NULL!=m_fd, "FeVariable: FuncData member not registered");
         evList.push_sorted_unique(m_fs);
-        m_fd->flags |= NEED_VALUE;
-        if (NULL!=m_md) m_md->flags |= NEED_VALUE;
+        data().flags |= NEED_VALUE;
+        if (NULL!=m_md) mapData().flags |= NEED_VALUE;
     }
 
     void print(std::ostream &os) const { os << "u"; }
@@ -674,7 +704,7 @@ public:
         //return m_fd->dim.first;
     }
 
-    index_t cSize()  const { return m_fd->values[0].rows(); } // coordinate size
+    index_t cSize()  const { return data().values[0].rows(); } // coordinate size
 
 };
 
@@ -913,8 +943,8 @@ public:
     inline const gsMatrix<T> & fixedPart() const {return _u.m_fixedDofs;}
     gsMatrix<T> & fixedPart() {return _u.m_fixedDofs;}
 
-    gsFuncData<T> & data() {return *_u.m_fd;}
-    const gsFuncData<T> & data() const {return *_u.m_fd;}
+    gsFuncData<T> & data() {return const_cast<gsFuncData<T>&>(_u.data());}
+    const gsFuncData<T> & data() const {return _u.data();}
 
     void setSolutionVector(const gsMatrix<T>& solVector)
     { _Sv = & solVector; }
@@ -1990,43 +2020,46 @@ public:
     enum {ScalarValued = 0, ColBlocks = 1};
 
 private:
-    const gsFuncData<T> * m_data;
+    const gsGeometryMap<T> * m_G;
+    const gsFeVariable<T>  * m_u;
     mutable gsMatrix<Scalar> res;
 
+    // The data are looked up on evaluation, since they depend on the slot
+    const gsFuncData<T> & data() const
+    { return NULL!=m_G ? m_G->data() : m_u->data(); }
+
     //hess_expr(const hess_expr & );
 public:
     hess_expr(const gsGeometryMap<T> & G)
-    : m_data(&G.data()) { } //ColBlocks=0 ?
+    : m_G(&G), m_u(NULL) { } //ColBlocks=0 ?
 
     hess_expr(const gsFeVariable<T> & _u)
-    : m_data(&_u.data())
+    : m_G(NULL), m_u(&_u)
     {
         GISMO_ASSERT(1==_u.dim(),"hess(.) requires 1D variable");
     }
 
     const gsMatrix<Scalar> & eval(const index_t k) const
     {
+        const gsFuncData<T> & m_data = data();
         const index_t sz = cols();
-        res.resize(m_data->dim.first, sz*m_data->dim.first);
-        secDerToHessian(m_data->values[2].col(k), m_data->dim.first, res);
-        res.resize(m_data->dim.first, res.cols()*m_data->dim.first);
+        res.resize(m_data.dim.first, sz*m_data.dim.first);
+        secDerToHessian(m_data.values[2].col(k), m_data.dim.first, res);
+        res.resize(m_data.dim.first, res.cols()*m_data.dim.first);
         // Note: auto returns by value here
         return res;
     }
 
     index_t rows() const
     {
-        // gsDebugVar(m_data);
-        // gsDebugVar(m_data->dim.first);
-        // gsDebugVar(m_data->values[0].rows());
-        return m_data->dim.first;
+        return data().dim.first;
     }
     index_t cols() const
     {
-        return 2*m_data->values[2].rows() / (1+m_data->dim.first);
+        return 2*data().values[2].rows() / (1+data().dim.first);
     }
 
-    void setFlag() const { m_data->flags |= NEED_2ND_DER; }
+    void setFlag() const { data().flags |= NEED_2ND_DER; }
 
     void parse(gsSortedVector<const gsFunctionSet<Scalar>*> & evList) const
     {
@@ -208,7 +208,7 @@ void gsHeatEquation<T>::assembleMass()
 
     // Pre-allocate non-zero elements for each column of the
     // sparse matrix
-    m_system.reserve(m_bases[0], m_options, 0);// zero rhs's
+    this->reserveSystem(0);// zero rhs's
 
     // Assemble mass integrals
     gsVisitorMass<T> mass;
@@ -0,0 +1,146 @@
+/** @file gsMatrixFreeOp.h
+
+    @brief Matrix-free application of the stiffness operator
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsAssembler/gsAssembler.h>
+#include <gsAssembler/gsQuadrature.h>
+#include <gsAssembler/gsSumFactorization.h>
+#include <gsCore/gsFuncData.h>
+#include <gsSolver/gsPreconditioner.h>
+#include <gsSolver/gsMatrixOp.h>
+
+namespace gismo
+{
+
+/** @brief Applies the stiffness operator \f$(\nabla u,\nabla v)_\Omega\f$
+    of a scalar problem element by element, without storing the
+    system matrix.
+
+    The operator acts on the free degrees of freedom of the column
+    mapper of an initialized (but not necessarily assembled)
+    assembler, eg. a gsPoissonAssembler, and it coincides with the
+    matrix that the assembler would produce. On tensor-product bases
+    the element products are sum-factorised (see gsSumFactorization),
+    otherwise the element gradients are evaluated at the quadrature
+    nodes. Only the geometry, the bases and the dof mapper are kept in
+    memory, therefore the operator can be used within
+    gsIterativeSolver or gsMultiGridOp for problems whose matrix does
+    not fit into memory.
+
+    The patches and bases of the assembler are referenced and must
+    outlive the operator. Dirichlet conditions must be eliminated or
+    absent, and patch interfaces must be glued.
+
+    \ingroup Assembler
+*/
+template <class T>
+class gsMatrixFreeOp : public gsLinearOperator<T>
+{
+public:
+
+    /// Shared pointer for gsMatrixFreeOp
+    typedef memory::shared_ptr<gsMatrixFreeOp> Ptr;
+
+    /// Unique pointer for gsMatrixFreeOp
+    typedef memory::unique_ptr<gsMatrixFreeOp> uPtr;
+
+    /// Constructor taking an initialized assembler
+    explicit gsMatrixFreeOp(const gsAssembler<T> & assembler);
+
+    /// Make function returning a smart pointer
+    static uPtr make(const gsAssembler<T> & assembler)
+    { return uPtr( new gsMatrixFreeOp(assembler) ); }
+
+    void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+    {
+        GISMO_ASSERT( input.rows() == rows(), "Invalid size of the input" );
+        x.setZero(rows(), input.cols());
+        multiply(&input, NULL, x);
+    }
+
+    /// @brief Computes the coupling of the free dofs with the
+    /// eliminated dofs \a fixedDofs.
+    ///
+    /// The result has to be subtracted from the load vector, see
+    /// gsAssembler::computeDirichletDofs() and gsAssembler::fixedDofs()
+    void applyFixed(const gsMatrix<T> & fixedDofs, gsMatrix<T> & x) const
+    {
+        GISMO_ASSERT( fixedDofs.rows() == m_mapper.boundarySize(),
+                      "Invalid size of the fixed dofs" );
+        x.setZero(rows(), fixedDofs.cols());
+        multiply(NULL, &fixedDofs, x);
+    }
+
+    /// Computes the diagonal of the operator as a column vector
+    void diagonal(gsMatrix<T> & result) const;
+
+    /// Returns the dof mapper of the operator
+    const gsDofMapper & dofMapper() const { return m_mapper; }
+
+    index_t rows() const { return m_mapper.freeSize(); }
+    index_t cols() const { return m_mapper.freeSize(); }
+
+private:
+
+    // Adds the products of the element matrices with the free
+    // coefficients \a in and the fixed coefficients \a fixed to \a out,
+    // or their diagonals if both are NULL
+    void multiply(const gsMatrix<T> * in, const gsMatrix<T> * fixed,
+                  gsMatrix<T> & out) const;
+
+    // Evaluates the geometry and the gradients on an element, returns
+    // true if the sum-factorised kernels apply
+    bool evaluate(const gsBasis<T> & basis, const gsGeometry<T> & geo,
+                  const gsMatrix<T> & quNodes, const gsVector<T> & quWeights,
+                  bool sumFact) const;
+
+    // Adds the element matrix to m_localMat
+    void localMatrix(bool sf, const gsVector<T> & quWeights) const;
+
+private:
+
+    const gsMultiPatch<T> & m_patches;
+    const gsMultiBasis<T> & m_bases;
+    gsDofMapper  m_mapper;
+    gsOptionList m_options;
+
+    // Element workspace
+    mutable gsSumFactorization<T> m_sf;
+    mutable gsMapData<T> m_md;
+    mutable gsMatrix<index_t> m_actives;
+    mutable gsMatrix<T> m_G, m_grads, m_physGrad, m_localIn, m_localOut, m_localMat;
+};
+
+/// @brief Returns a Jacobi smoother for the matrix-free operator \a op,
+/// ie. \f$ x_{new} = x_{old} + \tau D^{-1}(f - Ax_{old}) \f$ where
+/// \a D is the diagonal of \a op
+///
+/// \relates gsMatrixFreeOp
+template <class T>
+typename gsPreconditionerFromOp<T>::uPtr
+makeMatrixFreeJacobiOp(const memory::shared_ptr< gsMatrixFreeOp<T> > & op, T tau = 1)
+{
+    gsMatrix<T> diag;
+    op->diagonal(diag);
+    gsSparseMatrix<T> invDiag(op->rows(), op->cols());
+    invDiag.reserve(gsVector<index_t>::Ones(op->cols()));
+    for (index_t i = 0; i != op->rows(); ++i)
+        invDiag.insert(i,i) = (T)(1) / diag(i,0);
+    invDiag.makeCompressed();
+    return gsPreconditionerFromOp<T>::make(op, makeMatrixOp(invDiag.moveToPtr()), tau);
+}
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsMatrixFreeOp.hpp)
+#endif
@@ -0,0 +1,163 @@
+/** @file gsMatrixFreeOp.hpp
+
+    @brief Matrix-free application of the stiffness operator
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+namespace gismo
+{
+
+template <class T>
+gsMatrixFreeOp<T>::gsMatrixFreeOp(const gsAssembler<T> & assembler)
+: m_patches(assembler.patches()),
+  m_bases(assembler.multiBasis(0)),
+  m_mapper(assembler.system().colMapper(0)),
+  m_options(assembler.options())
+{
+    GISMO_ENSURE( m_options.getInt("DirichletStrategy") != dirichlet::nitsche,
+                  "The matrix-free operator needs eliminated Dirichlet dofs" );
+    GISMO_ENSURE( m_options.getInt("InterfaceStrategy") != iFace::dg,
+                  "The matrix-free operator needs glued patch interfaces" );
+    GISMO_ENSURE( m_mapper.isFinalized(), "The assembler is not initialized" );
+    m_md.flags = NEED_MEASURE | NEED_GRAD_TRANSFORM;
+}
+
+template <class T>
+void gsMatrixFreeOp<T>::diagonal(gsMatrix<T> & result) const
+{
+    result.setZero(rows(), 1);
+    multiply(NULL, NULL, result);
+}
+
+template <class T>
+bool gsMatrixFreeOp<T>::evaluate(const gsBasis<T> & basis, const gsGeometry<T> & geo,
+                                 const gsMatrix<T> & quNodes, const gsVector<T> & quWeights,
+                                 bool sumFact) const
+{
+    m_md.points = quNodes;
+    geo.computeMap(m_md);
+
+    if ( sumFact && geo.domainDim() == geo.targetDim() && m_sf.evaluate(quNodes) )
+    {
+        GISMO_ASSERT(m_sf.numActive() == m_actives.rows(),
+                     "Inconsistent number of active functions");
+        gsSumFactorization<T>::stiffnessCoefs(m_md, quWeights, m_G);
+        return true;
+    }
+
+    basis.deriv_into(quNodes, m_grads);
+    return false;
+}
+
+template <class T>
+void gsMatrixFreeOp<T>::localMatrix(bool sf, const gsVector<T> & quWeights) const
+{
+    const index_t numActive = m_actives.rows();
+    m_localMat.setZero(numActive, numActive);
+    if ( sf )
+    {
+        m_sf.addStiffness(m_G, m_localMat);
+        return;
+    }
+
+    for (index_t k = 0; k < quWeights.rows(); ++k)
+    {
+        const T weight = quWeights[k] * m_md.measure(k);
+        transformGradients(m_md, k, m_grads, m_physGrad);
+        m_localMat.noalias() += weight * (m_physGrad.transpose() * m_physGrad);
+    }
+}
+
+template <class T>
+void gsMatrixFreeOp<T>::multiply(const gsMatrix<T> * in, const gsMatrix<T> * fixed,
+                                 gsMatrix<T> & out) const
+{
+    const bool diag = (NULL == in && NULL == fixed);
+    const bool sumFact = m_options.askSwitch("SumFactorization", true);
+    const index_t nc = out.cols();
+
+    gsQuadRule<T> quRule;
+    gsMatrix<T> quNodes;
+    gsVector<T> quWeights;
+
+    for (size_t p = 0; p != m_patches.nPatches(); ++p)
+    {
+        const gsBasis<T>    & basis = m_bases[p];
+        const gsGeometry<T> & geo   = m_patches.patch(p);
+
+        quRule = gsQuadrature::get(basis, m_options);
+        const bool patchSf = sumFact && m_sf.setBasis(basis);
+
+        typename gsBasis<T>::domainIter domIt = basis.makeDomainIterator();
+        for (; domIt->good(); domIt->next() )
+        {
+            quRule.mapTo(domIt->lowerCorner(), domIt->upperCorner(), quNodes, quWeights);
+            basis.active_into(quNodes.col(0), m_actives);
+            const index_t numActive = m_actives.rows();
+            m_mapper.localToGlobal(m_actives, p, m_actives);
+
+            // Gather the local coefficients
+            bool skip = !diag;
+            if ( !diag )
+            {
+                m_localIn.resize(numActive, nc);
+                for (index_t i = 0; i != numActive; ++i)
+                {
+                    const index_t ii = m_actives(i,0);
+                    const bool isFree = m_mapper.is_free_index(ii);
+                    if ( isFree && NULL != in )
+                        m_localIn.row(i) = in->row(ii);
+                    else if ( !isFree && NULL != fixed )
+                        m_localIn.row(i) = fixed->row(m_mapper.global_to_bindex(ii));
+                    else
+                    {
+                        m_localIn.row(i).setZero();
+                        continue;
+                    }
+                    skip = false;
+                }
+            }
+            if ( skip )
+                continue;
+
+            const bool sf = evaluate(basis, geo, quNodes, quWeights, patchSf);
+
+            if ( diag )
+            {
+                localMatrix(sf, quWeights);
+                for (index_t i = 0; i != numActive; ++i)
+                    if ( m_mapper.is_free_index(m_actives(i,0)) )
+                        out(m_actives(i,0), 0) += m_localMat(i,i);
+                continue;
+            }
+
+            m_localOut.setZero(numActive, nc);
+            if ( sf )
+                m_sf.applyStiffness(m_G, m_localIn, m_localOut);
+            else
+            {
+                for (index_t k = 0; k < quWeights.rows(); ++k)
+                {
+                    const T weight = quWeights[k] * m_md.measure(k);
+                    transformGradients(m_md, k, m_grads, m_physGrad);
+                    m_localOut.noalias() += weight *
+                        ( m_physGrad.transpose() * (m_physGrad * m_localIn) );
+                }
+            }
+
+            // Scatter to the free dofs
+            for (index_t i = 0; i != numActive; ++i)
+                if ( m_mapper.is_free_index(m_actives(i,0)) )
+                    out.row(m_actives(i,0)) += m_localOut.row(i);
+        }
+    }
+}
+
+} // namespace gismo
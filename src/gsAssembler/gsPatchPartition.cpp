@@ -0,0 +1,70 @@
+/** @file gsPatchPartition.cpp
+
+    @brief Provides a partition of the patches and of the degrees of
+    freedom of a multipatch problem over several processes.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gsAssembler/gsPatchPartition.h>
+
+namespace gismo
+{
+
+void gsPatchPartition::init(const std::vector<index_t> & weights, int rank, int size)
+{
+    GISMO_ENSURE(0 <= rank && rank < size, "Invalid rank "<< rank <<" of "<< size <<" processes.");
+    m_rank = rank;
+    m_size = size;
+    m_dofOwner.clear();
+    m_owned.clear();
+
+    const size_t np = weights.size();
+    double total = 0;
+    for (size_t k = 0; k != np; ++k)
+        total += weights[k];
+
+    // A patch goes to the process whose share contains its middle
+    m_patchOwner.resize(np);
+    double sum = 0;
+    for (size_t k = 0; k != np; ++k)
+    {
+        const double mid = ( total > 0 ? (sum + 0.5 * weights[k]) / total
+                                       : (k + 0.5) / np );
+        m_patchOwner[k] = std::min(static_cast<int>(mid * size), size - 1);
+        sum += weights[k];
+    }
+}
+
+void gsPatchPartition::addDofs(const gsDofMapper & mapper)
+{
+    GISMO_ASSERT(m_patchOwner.empty() || mapper.numPatches() == m_patchOwner.size(),
+                 "The mapper does not match the partition.");
+
+    const index_t n = mapper.lastIndex();
+    if ( static_cast<index_t>(m_dofOwner.size()) < n )
+        m_dofOwner.resize(n, m_size);
+
+    for (size_t c = 0; c != mapper.componentsSize(); ++c)
+        for (size_t k = 0; k != mapper.numPatches(); ++k)
+        {
+            const int owner = patchOwner(k);
+            for (size_t i = 0; i != mapper.patchSize(k, c); ++i)
+            {
+                const index_t ii = mapper.index(i, k, c);
+                if ( mapper.is_free_index(ii) && owner < m_dofOwner[ii] )
+                    m_dofOwner[ii] = owner;
+            }
+        }
+
+    m_owned.clear();
+    for (index_t i = 0; i != static_cast<index_t>(m_dofOwner.size()); ++i)
+        if ( m_rank == m_dofOwner[i] )
+            m_owned.push_back(i);
+}
+
+} // namespace gismo
@@ -0,0 +1,117 @@
+/** @file gsPatchPartition.h
+
+    @brief Provides a partition of the patches and of the degrees of
+    freedom of a multipatch problem over several processes.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsDofMapper.h>
+#include <gsCore/gsMultiBasis.h>
+
+namespace gismo
+{
+
+/**
+   \brief Partition of the patches and of the degrees of freedom of a
+   multipatch problem over several processes
+
+   The patches are distributed in contiguous blocks of about equal
+   weight, eg. of the number of elements. Every process assembles the
+   elements of its own patches (see gsAssembler::setPartition() and
+   gsExprAssembler::setPartition()).
+
+   A free degree of freedom of a gsDofMapper is owned by the process
+   of smallest rank among the processes whose patches contain it, so
+   that the degrees of freedom on the interfaces have a single owner.
+   The owner stores the matrix row of the degree of freedom, see
+   gsDistributedOp.
+
+   The partition does not communicate, the rank of the process and
+   the number of processes are given explicitly (eg. by
+   gsMpiComm::rank() and gsMpiComm::size()).
+
+   \ingroup Assembler
+*/
+class GISMO_EXPORT gsPatchPartition
+{
+public:
+
+    /// Empty partition, all patches and degrees of freedom are local
+    gsPatchPartition() : m_rank(0), m_size(1) { }
+
+    /// Distributes patches with weights \a weights over \a size
+    /// processes. The partition is seen from the process \a rank.
+    gsPatchPartition(const std::vector<index_t> & weights, int rank, int size)
+    { init(weights, rank, size); }
+
+    /// Distributes the patches of \a mb over \a size processes,
+    /// weighted by their numbers of elements. The partition is seen
+    /// from the process \a rank.
+    template<class T>
+    gsPatchPartition(const gsMultiBasis<T> & mb, int rank, int size)
+    {
+        std::vector<index_t> weights(mb.nBases());
+        for (size_t k = 0; k != weights.size(); ++k)
+            weights[k] = mb.basis(k).numElements();
+        init(weights, rank, size);
+    }
+
+    /// Adds the free degrees of freedom of \a mapper. Their indices,
+    /// including the shift of \a mapper, are the indices of the
+    /// matrix rows. Can be called for several mappers with different
+    /// shifts.
+    void addDofs(const gsDofMapper & mapper);
+
+    /// Returns the rank of the process
+    int rank() const { return m_rank; }
+
+    /// Returns the number of processes
+    int size() const { return m_size; }
+
+    /// Returns the number of patches, zero for an empty partition
+    size_t numPatches() const { return m_patchOwner.size(); }
+
+    /// Returns the process which assembles patch \a k
+    int patchOwner(index_t k) const
+    { return m_patchOwner.empty() ? m_rank : m_patchOwner[k]; }
+
+    /// Returns true if patch \a k is assembled by this process
+    bool isLocal(index_t k) const
+    { return m_patchOwner.empty() || m_rank == m_patchOwner[k]; }
+
+    /// Returns the number of degrees of freedom added
+    index_t numDofs() const { return m_dofOwner.size(); }
+
+    /// Returns the owner of the degree of freedom \a i
+    int dofOwner(index_t i) const { return m_dofOwner[i]; }
+
+    /// Returns the owners of all degrees of freedom
+    const std::vector<int> & dofOwners() const { return m_dofOwner; }
+
+    /// Returns the degrees of freedom owned by this process, in
+    /// increasing order
+    const std::vector<index_t> & ownedDofs() const { return m_owned; }
+
+private:
+
+    void init(const std::vector<index_t> & weights, int rank, int size);
+
+private:
+
+    int m_rank, m_size;
+
+    std::vector<int> m_patchOwner;
+
+    std::vector<int> m_dofOwner;
+
+    std::vector<index_t> m_owned;
+};
+
+} // namespace gismo
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <gsCore/gsStdVectorRef.h>
+#include <gsAssembler/gsElementColoring.h>
 
 namespace gismo
 {
@@ -321,6 +322,10 @@ public:
 
     /**
      * @brief reserve reserves the memory for the sparse matrix and the rhs.
+     *
+     * If the matrix already holds a sparsity pattern (see
+     * hasPattern()), the pattern is kept and its values are set to
+     * zero, so that the next assembly does not allocate.
      * @param[in] nz Non-zeros per column for the sparse matrix
      * @param [in] numRhs number of columns
      */
@@ -329,12 +334,73 @@ public:
         GISMO_ASSERT( 0 != m_mappers.size(), "Sparse system was not initialized");
         if ( 0 != m_matrix.cols() )
         {
-            m_matrix.reservePerColumn(nz);
+            if ( hasPattern() )
+                m_matrix.coeffs().setZero();
+            else
+                m_matrix.reservePerColumn(nz);
             if ( 0 != numRhs )
                 m_rhs.setZero(m_matrix.cols(), numRhs);
         }
     }
 
+    /// @brief Returns true if the matrix holds a (compressed)
+    /// sparsity pattern, computed by computePattern() or by a
+    /// previous assembly
+    bool hasPattern() const
+    {
+        return m_matrix.isCompressed() && 0 != m_matrix.nonZeros();
+    }
+
+    /**
+     * @brief Symbolic assembly: computes the exact sparsity pattern
+     * of the matrix from the element connectivity of \a bases and
+     * the dof mappers.
+     *
+     * The pattern consists of explicit zeros and the matrix is
+     * compressed, therefore the (numeric) assembly only writes into
+     * existing entries. Couplings which are not seen by the volume
+     * elements (eg. dG interface terms) are inserted on demand.
+     * @param[in] bases the bases of the unknowns, see colBasis()
+     */
+    void computePattern(const std::vector<gsMultiBasis<T> > & bases)
+    {
+        GISMO_ENSURE( numRowBlocks() == numColBlocks(),
+                      "The pattern assumes the same row and column blocks");
+
+        std::vector<index_t> rowPtr(1,0), rowIdx, colPtr(1,0), colIdx;
+        gsMatrix<index_t> act;
+        index_t ii;
+        for (size_t p = 0; p != bases.front().nBases(); ++p)
+        {
+            typename gsBasis<T>::domainIter domIt = bases.front()[p].makeDomainIterator();
+            for (; domIt->good(); domIt->next() )
+            {
+                for (index_t c = 0; c != numColBlocks(); ++c)
+                {
+                    bases[m_cvar[c]][p].active_into(domIt->centerPoint(), act);
+                    for (index_t i = 0; i != act.rows(); ++i)
+                    {
+                        if ( rowMapper(c).is_free(act(i,0), p) )
+                        {
+                            mapToGlobalRowIndex(act(i,0), p, ii, c);
+                            rowIdx.push_back(ii);
+                        }
+                        if ( colMapper(c).is_free(act(i,0), p) )
+                        {
+                            mapToGlobalColIndex(act(i,0), p, ii, c);
+                            colIdx.push_back(ii);
+                        }
+                    }
+                }
+                rowPtr.push_back(rowIdx.size());
+                colPtr.push_back(colIdx.size());
+            }
+        }
+
+        elementSparsityPattern(rowPtr, rowIdx, colPtr, colIdx,
+                               m_matrix.rows(), m_matrix.cols(), symm, m_matrix);
+    }
+
     /**
      * @brief Reserves the memory for the sparse matrix and the rhs,
      * based on the polynomial degree of the first basis-piece in
@@ -0,0 +1,365 @@
+/** @file gsSumFactorization.h
+
+    @brief Sum-factorised element integrals on tensor-product bases
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsTensor/gsTensorBasis.h>
+
+namespace gismo
+{
+
+/**
+   @brief Sum-factorised computation of element matrices and vectors
+   for tensor-product bases and tensor-product quadrature rules.
+
+   Instead of evaluating the d-variate basis functions at all
+   quadrature nodes, the univariate component bases are evaluated on
+   the coordinate nodes, and the element integrals are contracted one
+   parametric direction at a time. For degree \a p and \a p+1 nodes
+   per direction, an element matrix costs \f$O(p^{2d+1})\f$ operations
+   instead of \f$O(p^{3d})\f$.
+
+   The local indices follow the ordering of
+   gsTensorBasis::active_into(), ie. the first direction runs
+   fastest.
+
+   \ingroup Assembler
+*/
+template<class T>
+class gsSumFactorization
+{
+public:
+
+    gsSumFactorization() : m_numNodes(0), m_numActive(0) { }
+
+    /// Sets the basis of the patch. Returns false if \a basis is
+    /// not a tensor-product basis of dimension 2, 3 or 4
+    bool setBasis(const gsBasis<T> & basis)
+    {
+        m_comp.clear();
+        if ( const gsTensorBasis<2,T> * tb = dynamic_cast<const gsTensorBasis<2,T>*>(&basis) )
+            getComponents<2>(*tb);
+        else if ( const gsTensorBasis<3,T> * tb = dynamic_cast<const gsTensorBasis<3,T>*>(&basis) )
+            getComponents<3>(*tb);
+        else if ( const gsTensorBasis<4,T> * tb = dynamic_cast<const gsTensorBasis<4,T>*>(&basis) )
+            getComponents<4>(*tb);
+        return !m_comp.empty();
+    }
+
+    /// Evaluates the univariate bases and their derivatives at the
+    /// coordinates of the quadrature nodes \a quNodes of an element.
+    /// Returns false if the nodes do not form a tensor-product grid
+    /// in lexicographic order
+    bool evaluate(const gsMatrix<T> & quNodes);
+
+    /// Returns the number of active functions on the element
+    index_t numActive() const { return m_numActive; }
+
+    /// Returns the number of quadrature nodes of the element
+    index_t numNodes() const { return m_numNodes; }
+
+    /// Adds \f$\sum_q c_q N_i(x_q) N_j(x_q)\f$ to \a localMat(i,j)
+    void addMass(const T * c, gsMatrix<T> & localMat)
+    {
+        contract(c, m_val, m_val, localMat);
+    }
+
+    /// Adds \f$\sum_q \nabla N_i(x_q)^T G_q \nabla N_j(x_q)\f$ to
+    /// \a localMat(i,j). Column \a a+d*b of \a G contains the
+    /// entries \f$(G_q)_{ab}\f$ for all nodes \a q
+    void addStiffness(const gsMatrix<T> & G, gsMatrix<T> & localMat)
+    {
+        const index_t d = m_comp.size();
+        for (index_t a = 0; a != d; ++a)
+            for (index_t b = 0; b != d; ++b)
+            {
+                for (index_t k = 0; k != d; ++k)
+                {
+                    m_left [k] = (k == a ? m_der[k] : m_val[k]);
+                    m_right[k] = (k == b ? m_der[k] : m_val[k]);
+                }
+                contract(G.col(a+d*b).data(), m_left, m_right, localMat);
+            }
+    }
+
+    /// Adds \f$\sum_q c_{q,r} N_i(x_q)\f$ to \a localRhs(i,r)
+    void addRhs(const gsMatrix<T> & c, gsMatrix<T> & localRhs)
+    {
+        GISMO_ASSERT(c.rows() == m_numNodes && localRhs.rows() == m_numActive
+                     && localRhs.cols() == c.cols(), "Invalid sizes");
+        for (index_t r = 0; r != c.cols(); ++r)
+            integrate(m_val, c.col(r).data(), localRhs.col(r).data());
+    }
+
+    /// Adds the product of the element matrix of addStiffness()
+    /// with the local coefficients \a x to \a y, without forming
+    /// the element matrix
+    void applyStiffness(const gsMatrix<T> & G, const gsMatrix<T> & x, gsMatrix<T> & y);
+
+    /// Computes the coefficients \a G of addStiffness() for the
+    /// integral of \f$\nabla u\cdot\nabla v\f$ in physical
+    /// coordinates, ie. \f$ G_q = w_q |\det J_q| J_q^{-1}J_q^{-T}\f$
+    static void stiffnessCoefs(const gsMapData<T> & md,
+                               const gsVector<T> & quWeights,
+                               gsMatrix<T> & G)
+    {
+        const index_t d = md.dim.first;
+        G.resize(quWeights.rows(), d*d);
+        gsMatrix<T> Jinv, Gk;
+        for (index_t k = 0; k < quWeights.rows(); ++k)
+        {
+            Jinv = md.jacobian(k).cramerInverse();
+            Gk.noalias() = (quWeights[k] * md.measure(k)) * Jinv * Jinv.transpose();
+            for (index_t b = 0; b != d; ++b)
+                for (index_t a = 0; a != d; ++a)
+                    G(k, a+d*b) = Gk(a,b);
+        }
+    }
+
+private:
+
+    template<short_t d>
+    void getComponents(const gsTensorBasis<d,T> & tb)
+    {
+        m_comp.resize(d);
+        for (short_t k = 0; k != d; ++k)
+            m_comp[k] = &tb.component(k);
+        m_val  .resize(d);
+        m_der  .resize(d);
+        m_left .resize(d);
+        m_right.resize(d);
+        m_nq   .resize(d);
+        m_na   .resize(d);
+    }
+
+    // Computes u_q = sum_i x_i prod_k A_k(i_k,q_k)
+    void interpolate(const std::vector<const gsMatrix<T>*> & A,
+                     const T * x, gsMatrix<T> & u);
+
+    // Adds sum_q f_q prod_k A_k(i_k,q_k) to y_i
+    void integrate(const std::vector<const gsMatrix<T>*> & A,
+                   const T * f, T * y);
+
+    // Adds sum_q c_q prod_k A_k(i_k,q_k) B_k(j_k,q_k) to localMat(i,j)
+    void contract(const T * c,
+                  const std::vector<const gsMatrix<T>*> & A,
+                  const std::vector<const gsMatrix<T>*> & B,
+                  gsMatrix<T> & localMat);
+
+private:
+
+    // Univariate component bases
+    std::vector<const gsBasis<T>*> m_comp;
+
+    // Number of nodes and active functions per direction
+    std::vector<index_t> m_nq, m_na;
+    index_t m_numNodes, m_numActive;
+
+    // Univariate values and derivatives, m_na[k] x m_nq[k]
+    std::vector<const gsMatrix<T>*> m_val, m_der, m_left, m_right;
+    std::vector<std::vector<gsMatrix<T> > > m_ders;
+
+    // Position in the local matrix of every entry of a contraction
+    std::vector<index_t> m_scatter;
+
+    // Temporaries
+    gsMatrix<T> m_u, m_P, m_Y[2], m_grad, m_flux;
+};
+
+template<class T>
+bool gsSumFactorization<T>::evaluate(const gsMatrix<T> & quNodes)
+{
+    const index_t d = m_comp.size();
+    GISMO_ASSERT(quNodes.rows() == d, "Invalid quadrature nodes");
+    m_numNodes = quNodes.cols();
+    m_ders.resize(d);
+
+    bool changed = false;
+    index_t stride = 1, numActive = 1;
+    for (index_t k = 0; k != d; ++k)
+    {
+        // The next coordinate changes after all nodes of direction k
+        index_t next = m_numNodes;
+        if ( k + 1 != d )
+            for (index_t q = stride; q < m_numNodes; q += stride)
+                if ( quNodes(k+1,q) != quNodes(k+1,0) )
+                {
+                    next = q;
+                    break;
+                }
+        if ( 0 != next % stride )
+        {
+            m_scatter.clear(); // m_nq and m_na may be partially updated
+            return false;
+        }
+
+        const index_t nq = next / stride;
+        m_u.resize(1, nq);
+        for (index_t j = 0; j != nq; ++j)
+            m_u(0,j) = quNodes(k, j*stride);
+        for (index_t q = 0; q != m_numNodes; ++q)
+            if ( quNodes(k,q) != m_u(0, (q/stride) % nq) )
+            {
+                m_scatter.clear();
+                return false;
+            }
+        m_comp[k]->evalAllDers_into(m_u, 1, m_ders[k]);
+        m_val[k] = &m_ders[k][0];
+        m_der[k] = &m_ders[k][1];
+
+        changed = changed || m_nq[k] != nq || m_na[k] != m_val[k]->rows();
+        m_nq[k] = nq;
+        m_na[k] = m_val[k]->rows();
+        numActive *= m_na[k];
+        stride = next;
+    }
+    if ( stride != m_numNodes )
+    {
+        m_scatter.clear();
+        return false;
+    }
+    m_numActive = numActive;
+
+    if ( changed || m_scatter.empty() )
+    {
+        // Entry f = p_0 + n_0^2 (p_1 + n_1^2 (...)), with
+        // p_k = i_k + n_k j_k, goes to localMat(i,j)
+        index_t sz = 1;
+        for (index_t k = 0; k != d; ++k)
+            sz *= m_na[k] * m_na[k];
+        m_scatter.resize(sz);
+        for (index_t f = 0; f != sz; ++f)
+        {
+            index_t rem = f, i = 0, j = 0, str = 1;
+            for (index_t k = 0; k != d; ++k)
+            {
+                const index_t p = rem % (m_na[k]*m_na[k]);
+                rem /= m_na[k]*m_na[k];
+                i += (p % m_na[k]) * str;
+                j += (p / m_na[k]) * str;
+                str *= m_na[k];
+            }
+            m_scatter[f] = i + numActive * j;
+        }
+    }
+    return true;
+}
+
+template<class T>
+void gsSumFactorization<T>::contract(const T * c,
+                                     const std::vector<const gsMatrix<T>*> & A,
+                                     const std::vector<const gsMatrix<T>*> & B,
+                                     gsMatrix<T> & localMat)
+{
+    GISMO_ASSERT(localMat.rows() == m_numActive && localMat.cols() == m_numActive,
+                 "Invalid size of the local matrix");
+    const index_t d = m_comp.size();
+    const T * src = c;
+    index_t sz = m_numNodes;
+    for (index_t k = 0; k != d; ++k)
+    {
+        const index_t nq = m_nq[k], na = m_na[k];
+
+        // P(q, i + na*j) = A_k(i,q) B_k(j,q)
+        m_P.resize(nq, na*na);
+        for (index_t j = 0; j != na; ++j)
+            for (index_t i = 0; i != na; ++i)
+                m_P.col(i+na*j) = A[k]->row(i).cwiseProduct(B[k]->row(j)).transpose();
+
+        // Contract the nodes of direction k, which run fastest in src
+        const gsAsConstMatrix<T> X(src, nq, sz/nq);
+        gsMatrix<T> & Y = m_Y[k%2];
+        Y.noalias() = X.transpose() * m_P;
+        sz  = Y.size();
+        src = Y.data();
+    }
+
+    T * lm = localMat.data();
+    for (index_t f = 0; f != sz; ++f)
+        lm[m_scatter[f]] += src[f];
+}
+
+template<class T>
+void gsSumFactorization<T>::interpolate(const std::vector<const gsMatrix<T>*> & A,
+                                        const T * x, gsMatrix<T> & u)
+{
+    const index_t d = m_comp.size();
+    const T * src = x;
+    index_t sz = m_numActive;
+    for (index_t k = 0; k != d; ++k)
+    {
+        // Replace the fastest index i_k of src by q_k, now slowest
+        const gsAsConstMatrix<T> X(src, m_na[k], sz/m_na[k]);
+        gsMatrix<T> & Y = ( k + 1 == d ? u : m_Y[k%2] );
+        Y.noalias() = X.transpose() * (*A[k]);
+        sz  = Y.size();
+        src = Y.data();
+    }
+    u.resize(m_numNodes, 1);
+}
+
+template<class T>
+void gsSumFactorization<T>::integrate(const std::vector<const gsMatrix<T>*> & A,
+                                      const T * f, T * y)
+{
+    const index_t d = m_comp.size();
+    const T * src = f;
+    index_t sz = m_numNodes;
+    for (index_t k = 0; k != d; ++k)
+    {
+        // Replace the fastest index q_k of src by i_k, now slowest
+        const gsAsConstMatrix<T> X(src, m_nq[k], sz/m_nq[k]);
+        gsMatrix<T> & Y = m_Y[k%2];
+        Y.noalias() = X.transpose() * A[k]->transpose();
+        sz  = Y.size();
+        src = Y.data();
+    }
+    // The entries are ordered as the local indices
+    gsAsVector<T>(y, sz) += gsAsConstVector<T>(src, sz);
+}
+
+template<class T>
+void gsSumFactorization<T>::applyStiffness(const gsMatrix<T> & G,
+                                           const gsMatrix<T> & x, gsMatrix<T> & y)
+{
+    GISMO_ASSERT(x.rows() == m_numActive && y.rows() == m_numActive
+                 && x.cols() == y.cols(), "Invalid sizes");
+    const index_t d = m_comp.size();
+    m_grad.resize(m_numNodes, d);
+    m_flux.resize(m_numNodes, d);
+    for (index_t r = 0; r != x.cols(); ++r)
+    {
+        // Parametric gradient at the nodes
+        for (index_t a = 0; a != d; ++a)
+        {
+            for (index_t k = 0; k != d; ++k)
+                m_left[k] = (k == a ? m_der[k] : m_val[k]);
+            interpolate(m_left, x.col(r).data(), m_u);
+            m_grad.col(a) = m_u;
+        }
+
+        // Flux G_q * grad(u)_q
+        m_flux.setZero();
+        for (index_t b = 0; b != d; ++b)
+            for (index_t a = 0; a != d; ++a)
+                m_flux.col(b).array() += G.col(a+d*b).array() * m_grad.col(a).array();
+
+        // Test with the gradients of the basis functions
+        for (index_t b = 0; b != d; ++b)
+        {
+            for (index_t k = 0; k != d; ++k)
+                m_left[k] = (k == b ? m_der[k] : m_val[k]);
+            integrate(m_left, m_flux.col(b).data(), y.col(r).data());
+        }
+    }
+}
+
+} // namespace gismo
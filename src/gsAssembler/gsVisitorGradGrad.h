@@ -68,6 +68,10 @@ public:
 
         // Set Geometry evaluation flags
         md.flags = NEED_MEASURE|NEED_GRAD_TRANSFORM;
+
+        // Use sum factorization on tensor-product bases
+        sumFact = options.askSwitch("SumFactorization", true) && sf.setBasis(basis);
+        cache.reset();
     }
 
 
@@ -78,16 +82,29 @@ public:
                          gsMatrix<T>            & quNodes)
     {
         md.points = quNodes;
-        // Compute the active basis functions
-        // Assumes actives are the same for all quadrature points on the current element
-        basis.active_into(md.points.col(0), actives);
-        const index_t numActive = actives.rows();
 
-        // Evaluate basis functions on element
-        basis.deriv_into(md.points, basisData);
+        // Use the univariate components of tensor-product bases
+        useSf = sumFact && geo.domainDim() == geo.targetDim()
+            && sf.evaluate(md.points);
+
+        if ( !this->evaluateCached(useSf) )
+        {
+            // Compute the active basis functions
+            // Assumes actives are the same for all quadrature points on the current element
+            basis.active_into(md.points.col(0), actives);
 
-        // Compute geometry related values
-        geo.computeMap(md);
+            // Evaluate basis functions on element
+            if ( !useSf )
+                basis.deriv_into(md.points, basisData);
+
+            // Compute geometry related values
+            geo.computeMap(md);
+
+            this->storeCached(useSf);
+        }
+        const index_t numActive = actives.rows();
+        GISMO_ASSERT(!useSf || sf.numActive() == numActive,
+                     "Inconsistent number of active functions");
 
         // Initialize local matrix
         localMat.setZero(numActive, numActive);
@@ -96,6 +113,13 @@ public:
     inline void assemble(gsDomainIterator<T>    & /*element*/,
                          gsVector<T> const      & quWeights)
     {
+        if ( useSf )
+        {
+            gsSumFactorization<T>::stiffnessCoefs(md, quWeights, sfCoefs);
+            sf.addStiffness(sfCoefs, localMat);
+            return;
+        }
+
         for (index_t k = 0; k < quWeights.rows(); ++k) // loop over quadrature nodes
         {
             // Multiply quadrature weight by the geometry measure
@@ -117,6 +141,12 @@ private:
     gsMatrix<T>  basisPhGrads;
     using Base:: basisData;
     using Base::actives;
+
+    using Base::sf;
+    using Base::sfCoefs;
+    using Base::sumFact;
+    using Base::useSf;
+    using Base::cache;
     
     // Local matrix
     using Base::localMat;
@@ -124,6 +154,12 @@ private:
     using Base::md;
 };
 
+/// Sets the cached element of a gsVisitorGradGrad
+template <class T>
+inline void setCachedElement(gsVisitorGradGrad<T> & visitor, gsElementCache<T> * cache,
+                             const index_t patchIndex, const index_t element)
+{ visitor.setCachedElement(cache, patchIndex, element); }
+
 
 } // namespace gismo
 
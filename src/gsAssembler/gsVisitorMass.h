@@ -13,6 +13,9 @@
 
 #pragma once
 
+#include <gsAssembler/gsSumFactorization.h>
+#include <gsAssembler/gsElementCache.h>
+
 namespace gismo
 {
 /** 
@@ -28,14 +31,14 @@ class gsVisitorMass
 {
 public:
 
-    gsVisitorMass()
+    gsVisitorMass() : sumFact(false)
     { }
 
     /** \brief Visitor for assembling the mass matrix
      *  
      * \f[ (u, v) \f]  
      */
-    gsVisitorMass(const gsPde<T> & pde)
+    gsVisitorMass(const gsPde<T> & pde) : sumFact(false)
     { GISMO_UNUSED(pde); }
 
     void initialize(const gsBasis<T> & basis,
@@ -48,6 +51,18 @@ public:
 
         // Set Geometry evaluation flags
         md.flags = NEED_MEASURE;
+
+        // Use sum factorization on tensor-product bases
+        sumFact = options.askSwitch("SumFactorization", true) && sf.setBasis(basis);
+        cache.reset();
+    }
+
+    /// Uses the cached evaluations of element \a element of patch
+    /// \a patchIndex in the next call of evaluate()
+    void setCachedElement(gsElementCache<T> * elCache,
+                          const index_t patchIndex, const index_t element)
+    {
+        cache.set(elCache, patchIndex, element);
     }
 
     // Evaluate on element.
@@ -57,16 +72,28 @@ public:
                          gsMatrix<T>            & quNodes)
     {
         md.points = quNodes;
-        // Compute the active basis functions
-        // Assumes actives are the same for all quadrature points on the current element
-        basis.active_into(md.points.col(0), actives);
-        const index_t numActive = actives.rows();
 
-        // Evaluate basis functions on element
-        basis.eval_into(md.points, basisData);
+        // Use the univariate components of tensor-product bases
+        useSf = sumFact && sf.evaluate(md.points);
+
+        if ( !evaluateCached(useSf) )
+        {
+            // Compute the active basis functions
+            // Assumes actives are the same for all quadrature points on the current element
+            basis.active_into(md.points.col(0), actives);
+
+            // Evaluate basis functions on element
+            if ( !useSf )
+                basis.eval_into(md.points, basisData);
 
-        // Compute geometry related values
-        geo.computeMap(md);
+            // Compute geometry related values
+            geo.computeMap(md);
+
+            storeCached(useSf);
+        }
+        const index_t numActive = actives.rows();
+        GISMO_ASSERT(!useSf || sf.numActive() == numActive,
+                     "Inconsistent number of active functions");
 
         // Initialize local matrix/rhs
         localMat.setZero(numActive, numActive);
@@ -75,6 +102,13 @@ public:
     inline void assemble(gsDomainIterator<T>    & ,
                          gsVector<T> const      & quWeights)
     {
+        if ( useSf )
+        {
+            sfCoefs = quWeights.cwiseProduct(md.measures.row(0).transpose());
+            sf.addMass(sfCoefs.data(), localMat);
+            return;
+        }
+
         localMat.noalias() = 
             basisData * quWeights.asDiagonal() * 
             md.measures.asDiagonal() * basisData.transpose();
@@ -105,6 +139,7 @@ public:
 
         // Set Geometry evaluation flags
         md.flags = NEED_MEASURE;
+        sumFact = false;
     }
 
 
@@ -136,18 +171,54 @@ public:
     }
 
 
+protected:
+
+    // Restores the cached evaluations of the current element, if any
+    bool evaluateCached(const bool sfOnly)
+    {
+        const typename gsElementCache<T>::Entry * cached = cache.find(md, sfOnly);
+        if ( NULL == cached )
+            return false;
+        actives = cached->actives;
+        if ( !sfOnly )
+            basisData = cached->basisData.front();
+        md = cached->md;
+        return true;
+    }
+
+    // Stores the evaluations of the current element in the cache
+    void storeCached(const bool sfOnly)
+    {
+        cache.store(actives, std::vector<gsMatrix<T> >(sfOnly ? 0 : 1, basisData),
+                    md, sfOnly);
+    }
+
 protected:
 
     // Basis values
     gsMatrix<T>      basisData;
     gsMatrix<index_t> actives;
 
+    // Sum factorization on tensor-product bases
+    gsSumFactorization<T> sf;
+    gsMatrix<T> sfCoefs;
+    bool sumFact, useSf;
+
+    // Cached element evaluations
+    gsCachedElement<T> cache;
+
     // Local matrix
     gsMatrix<T> localMat;
 
     gsMapData<T> md;
 };
 
+/// Sets the cached element of a gsVisitorMass
+template <class T>
+inline void setCachedElement(gsVisitorMass<T> & visitor, gsElementCache<T> * cache,
+                             const index_t patchIndex, const index_t element)
+{ visitor.setCachedElement(cache, patchIndex, element); }
+
 
 } // namespace gismo
 
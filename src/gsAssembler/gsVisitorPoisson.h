@@ -14,6 +14,8 @@
 #pragma once
 
 #include <gsAssembler/gsQuadrature.h>
+#include <gsAssembler/gsSumFactorization.h>
+#include <gsAssembler/gsElementCache.h>
 
 namespace gismo
 {
@@ -51,6 +53,18 @@ public:
 
         // Set Geometry evaluation flags
         md.flags = NEED_VALUE | NEED_MEASURE | NEED_GRAD_TRANSFORM;
+
+        // Use sum factorization on tensor-product bases
+        sumFact = options.askSwitch("SumFactorization", true) && sf.setBasis(basis);
+        cache.reset();
+    }
+
+    /// Uses the cached evaluations of element \a element of patch
+    /// \a patchIndex in the next call of evaluate()
+    void setCachedElement(gsElementCache<T> * elCache,
+                          const index_t patchIndex, const index_t element)
+    {
+        cache.set(elCache, patchIndex, element);
     }
 
     // Evaluate on element.
@@ -59,16 +73,37 @@ public:
                          const gsMatrix<T>      & quNodes)
     {
         md.points = quNodes;
-        // Compute the active basis functions
-        // Assumes actives are the same for all quadrature points on the elements
-        basis.active_into(md.points.col(0), actives);
+
+        // Use the univariate components of tensor-product bases
+        useSf = sumFact && geo.domainDim() == geo.targetDim()
+            && sf.evaluate(md.points);
+
+        const typename gsElementCache<T>::Entry * cached = cache.find(md, useSf);
+        if ( NULL != cached )
+        {
+            actives   = cached->actives;
+            basisData = cached->basisData;
+            md        = cached->md;
+        }
+        else
+        {
+            // Compute the active basis functions
+            // Assumes actives are the same for all quadrature points on the elements
+            basis.active_into(md.points.col(0), actives);
+
+            // Evaluate basis functions on element
+            if ( !useSf )
+                basis.evalAllDers_into( md.points, 1, basisData);
+
+            // Compute image of Gauss nodes under geometry mapping as well as Jacobians
+            geo.computeMap(md);
+
+            cache.store(actives, useSf ? std::vector<gsMatrix<T> >() : basisData,
+                        md, useSf);
+        }
         numActive = actives.rows();
-        
-        // Evaluate basis functions on element
-        basis.evalAllDers_into( md.points, 1, basisData);
-        
-        // Compute image of Gauss nodes under geometry mapping as well as Jacobians
-        geo.computeMap(md);
+        GISMO_ASSERT(!useSf || sf.numActive() == numActive,
+                     "Inconsistent number of active functions");
         
         // Evaluate right-hand side at the geometry points paramCoef
         // specifies whether the right hand side function should be
@@ -83,6 +118,17 @@ public:
     inline void assemble(gsDomainIterator<T>    & ,
                          gsVector<T> const      & quWeights)
     {
+        if ( useSf )
+        {
+            gsSumFactorization<T>::stiffnessCoefs(md, quWeights, sfCoefs);
+            sf.addStiffness(sfCoefs, localMat);
+            sfCoefs = rhsVals.transpose();
+            for (index_t k = 0; k < quWeights.rows(); ++k)
+                sfCoefs.row(k) *= quWeights[k] * md.measure(k);
+            sf.addRhs(sfCoefs, localRhs);
+            return;
+        }
+
         gsMatrix<T> & bVals  = basisData[0];
         gsMatrix<T> & bGrads = basisData[1];
 
@@ -121,6 +167,14 @@ protected:
     gsMatrix<index_t> actives;
     index_t numActive;
 
+    // Sum factorization on tensor-product bases
+    gsSumFactorization<T> sf;
+    gsMatrix<T> sfCoefs;
+    bool sumFact, useSf;
+
+    // Cached element evaluations
+    gsCachedElement<T> cache;
+
 protected:
     // Right hand side ptr for current patch
     const gsFunction<T> * rhs_ptr;
@@ -136,6 +190,12 @@ protected:
     gsMapData<T> md;
 };
 
+/// Sets the cached element of a gsVisitorPoisson
+template <class T, bool paramCoef>
+inline void setCachedElement(gsVisitorPoisson<T,paramCoef> & visitor, gsElementCache<T> * cache,
+                             const index_t patchIndex, const index_t element)
+{ visitor.setCachedElement(cache, patchIndex, element); }
+
 
 } // namespace gismo
 
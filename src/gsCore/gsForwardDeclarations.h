@@ -267,11 +267,14 @@ template <class T=real_t>                class gsCompositePrecOp;
 template <class T=real_t>                class gsKroneckerOp;
 template <class T=real_t>                class gsBlockOp;
 template <class T=real_t>                class gsPatchPreconditionersCreator;
+template <class T=real_t>                class gsMultiPatchPreconditionersCreator;
 
 // gsMultiGrid
 
 template <class T=real_t>                class gsMultiGridOp;
 template <class T=real_t>                class gsGridHierarchy;
+template <class T=real_t>                class gsAggregationAmgOp;
+template <class T=real_t>                class gsTensorTransferOp;
 
 /// @endcond
 
@@ -148,6 +148,11 @@ public:
     typedef Eigen::ConjugateGradient<Eigen::SparseMatrix<T,0,index_t>, 
             Eigen::Lower|Eigen::Upper, Eigen::DiagonalPreconditioner<T> > CGDiagonal;
 
+    /// Congugate gradient with incomplete Cholesky factorization
+    typedef Eigen::ConjugateGradient<Eigen::SparseMatrix<T,0,index_t>,
+            Eigen::Lower|Eigen::Upper,
+            Eigen::IncompleteCholesky<T, Eigen::Lower, Eigen::AMDOrdering<index_t> > > CGIncompleteCholesky;
+
     /// BiCGSTAB with Incomplete LU factorization with dual-threshold strategy
     typedef Eigen::BiCGSTAB<Eigen::SparseMatrix<T,0,index_t>,
                             Eigen::IncompleteLUT<T, index_t> > BiCGSTABILUT;
@@ -296,6 +296,13 @@ public:
     void repairInterfaces();
 
     /// @brief For each point in \a points, locates the parametric coordinates of the point
+    ///
+    /// The candidate patches of a point are found in a hierarchy of
+    /// the bounding boxes of the control points of the elements
+    /// (see gsBoxTree). The Newton iteration on a candidate patch
+    /// starts at the center of the closest element. The points are
+    /// processed in parallel if OpenMP is enabled.
+    ///
     /// \param points
     /// \param pids vector containing for each point the patch id where it belongs (or -1 if not found)
     /// \param preim in each column,  the parametric coordinates of the corresponding point in the patch
@@ -319,6 +326,10 @@ private:
 private:
     // implementation functions
 
+    // locates the points on the patches other than skip (-1 for none)
+    void locatePoints_impl(const gsMatrix<T> & points, index_t skip,
+                           gsVector<index_t> & pids, gsMatrix<T> & preim) const;
+
     // match the vertices in ci1 starting from start to the end with the vertices
     // in ci2 that are still non matched
     // cc1 and cc2 are the physical coordinates of the vertices
@@ -17,8 +17,10 @@
 #include <gsCore/gsGeometry.h>
 #include <gsCore/gsDofMapper.h>
 #include <gsCore/gsAffineFunction.h>
+#include <gsCore/gsDomainIterator.h>
 
 #include <gsUtils/gsCombinatorics.h>
+#include <gsUtils/gsBoxTree.h>
 
 namespace gismo
 {
@@ -648,56 +650,114 @@ void gsMultiPatch<T>::locatePoints(const gsMatrix<T> & points,
                                    gsVector<index_t> & pids,
                                    gsMatrix<T> & preim) const
 {
-    pids.resize(points.cols());
+    locatePoints_impl(points, -1, pids, preim);
+}
+
+template<class T>
+void gsMultiPatch<T>::locatePoints(const gsMatrix<T> & points, index_t pid1,
+                                   gsVector<index_t> & pid2, gsMatrix<T> & preim) const
+{
+    // Assumes points are found on pid1 and possibly on one more patch
+    locatePoints_impl(points, pid1, pid2, preim);
+}
+
+template<class T>
+void gsMultiPatch<T>::locatePoints_impl(const gsMatrix<T> & points, index_t skip,
+                                        gsVector<index_t> & pids,
+                                        gsMatrix<T> & preim) const
+{
+    const index_t np = points.cols();
+    pids.resize(np);
     pids.setConstant(-1); // -1 implies not in the domain
-    preim.resize(parDim(), points.cols());//uninitialized by default
-    gsMatrix<T> pt, pr, tmp;
+    preim.resize(parDim(), np);//uninitialized by default
+    if ( 0 == np || m_patches.empty() )
+        return;
 
-    for (index_t i = 0; i!=pids.size(); ++i)
+    // The image of an element lies in the convex hull of the control
+    // points of the functions active on it. These boxes are the
+    // candidates, their element centers the initial guesses.
+    const index_t pd = parDim(), gd = geoDim();
+    index_t nb = 0;
+    for (size_t k = 0; k!= m_patches.size(); ++k)
+        if ( skip != static_cast<index_t>(k) )
+            nb += m_patches[k]->basis().numElements();
+
+    gsMatrix<T> lower(gd, nb), upper(gd, nb), centers(pd, nb), ctr;
+    std::vector<index_t> boxPatch(nb);
+    std::vector<gsMatrix<T> > ranges(m_patches.size());
+    gsMatrix<index_t> act;
+    index_t b = 0;
+    for (size_t k = 0; k!= m_patches.size(); ++k)
     {
-        pt = points.col(i);
+        if ( skip == static_cast<index_t>(k) )
+            continue;
+        const gsGeometry<T> & geo = *m_patches[k];
+        ranges[k] = geo.parameterRange();
+
+        const index_t b0 = b;
+        typename gsBasis<T>::domainIter domIt = geo.basis().makeDomainIterator();
+        for (; domIt->good(); domIt->next(), ++b)
+        {
+            centers.col(b) = domIt->centerPoint();
+            boxPatch[b] = k;
+        }
+        GISMO_ASSERT(b <= nb, "Wrong number of elements.");
 
-        for (size_t k = 0; k!= m_patches.size(); ++k)
+        ctr = centers.middleCols(b0, b - b0);
+        geo.basis().active_into(ctr, act);
+        const gsMatrix<T> & cp = geo.coefs();
+        for (index_t e = 0; e != act.cols(); ++e)
         {
-            pr = m_patches[k]->parameterRange();
-            m_patches[k]->invertPoints(pt, tmp);
-            if ( (tmp.array() >= pr.col(0).array()).all()
-                 && (tmp.array() <= pr.col(1).array()).all() )
+            lower.col(b0+e) = upper.col(b0+e) = cp.row(act(0,e)).transpose();
+            // the actives are sorted, trailing zeros are padding
+            for (index_t r = 1; r < act.rows() && 0 != act(r,e); ++r)
             {
-                pids[i] = k;
-                preim.col(i) = tmp;
-                break;
+                lower.col(b0+e) = lower.col(b0+e).cwiseMin(cp.row(act(r,e)).transpose());
+                upper.col(b0+e) = upper.col(b0+e).cwiseMax(cp.row(act(r,e)).transpose());
             }
         }
     }
-}
+    GISMO_ASSERT(b == nb, "Wrong number of elements.");
 
-template<class T>
-void gsMultiPatch<T>::locatePoints(const gsMatrix<T> & points, index_t pid1,
-                                   gsVector<index_t> & pid2, gsMatrix<T> & preim) const
-{
-    // Assumes points are found on pid1 and possibly on one more patch
-    pid2.resize(points.cols());
-    pid2.setConstant(-1); // -1 implies not in the domain
-    preim.resize(parDim(), points.cols());//uninitialized by default
-    gsMatrix<T> pt, pr, tmp;
+    const gsBoxTree<T> tree(lower, upper);
+    const T tol = 1e-6; // accuracy of the inversion
 
-    for (index_t i = 0; i!=pid2.size(); ++i)
+#   pragma omp parallel if (np > 16)
     {
-        pt = points.col(i);
+        std::vector<index_t> cand, tried;
+        std::vector<std::pair<T,index_t> > order;
+        gsMatrix<T> pt, tmp;
 
-        for (size_t k = 0; k!= m_patches.size(); ++k)
+#       pragma omp for schedule(dynamic, 16)
+        for (index_t i = 0; i < np; ++i)
         {
-            if (pid1==(index_t)k) continue; // skip pid1
-
-            pr = m_patches[k]->parameterRange();
-            m_patches[k]->invertPoints(pt, tmp);
-            if ( (tmp.array() >= pr.col(0).array()).all()
-                 && (tmp.array() <= pr.col(1).array()).all() )
+            tree.query(points.col(i), cand, tol);
+
+            // Try the patches in the order of their closest element
+            order.resize(cand.size());
+            for (size_t c = 0; c != cand.size(); ++c)
+                order[c] = std::make_pair( (lower.col(cand[c]) + upper.col(cand[c])
+                                            - 2 * points.col(i)).squaredNorm(), cand[c] );
+            std::sort(order.begin(), order.end());
+
+            pt = points.col(i);
+            tried.clear();
+            for (size_t c = 0; c != order.size(); ++c)
             {
-                pid2[i] = k;
-                preim.col(i) = tmp;
-                break;
+                const index_t e = order[c].second, k = boxPatch[e];
+                if ( std::find(tried.begin(), tried.end(), k) != tried.end() )
+                    continue;
+                tried.push_back(k);
+
+                tmp = centers.col(e);
+                m_patches[k]->invertPoints(pt, tmp, tol, true);
+                if ( (tmp.array() >= ranges[k].col(0).array()).all()
+                     && (tmp.array() <= ranges[k].col(1).array()).all() )
+                {
+                    pids[i] = k;
+                    preim.col(i) = tmp;
+                    break;
+                }
             }
         }
     }
@@ -86,6 +86,15 @@ private:
     struct numNodes_visitor;
     struct levelUp_visitor;
 
+    /// A node of the linearised tree
+    struct flatNode
+    {
+        int axis;  ///< Split axis, or -1 for a leaf
+        int level; ///< Level of a leaf
+        T   pos;   ///< Split coordinate of a split node
+        T   right; ///< Position of the right child of a split node
+    };
+
 private:
 
     /// Pointer to the root node of the tree
@@ -103,6 +112,12 @@ private:
 
     unsigned m_maxPath;
 
+    /// The tree linearised in depth-first order, so that the left
+    /// child of a split node follows it. It is built by
+    /// makeCompressed() and used by the queries. It is empty if the
+    /// tree was changed afterwards, then the queries use the tree.
+    std::vector<flatNode> m_flat;
+
 public:
 
     gsHDomain() : m_indexLevel(0)
@@ -133,7 +148,8 @@ public:
         m_upperIndex(o.m_upperIndex),
         m_indexLevel(o.m_indexLevel),
         m_maxInsLevel(o.m_maxInsLevel),
-        m_maxPath(o.m_maxPath)
+        m_maxPath(o.m_maxPath),
+        m_flat(o.m_flat)
     {
         m_root = new node(*o.m_root);
     }
@@ -150,6 +166,7 @@ public:
         m_indexLevel  = o.m_indexLevel;
         m_maxInsLevel = o.m_maxInsLevel;
         m_maxPath    = o.m_maxPath;
+        m_flat       = o.m_flat;
 
         return *this;
     }
@@ -160,7 +177,8 @@ public:
     m_upperIndex(std::move(o.m_upperIndex)),
     m_indexLevel(o.m_indexLevel),
     m_maxInsLevel(o.m_maxInsLevel),
-    m_maxPath(o.m_maxPath)
+    m_maxPath(o.m_maxPath),
+    m_flat(std::move(o.m_flat))
     {
         o.m_root = nullptr;
     }
@@ -172,6 +190,7 @@ public:
         m_indexLevel  = o.m_indexLevel;
         m_maxInsLevel = o.m_maxInsLevel;
         m_maxPath     = o.m_maxPath;
+        m_flat        = std::move(o.m_flat);
         return *this;
     }
 #endif
@@ -190,6 +209,7 @@ public:
 
         m_root = new node(m_upperIndex);
         m_maxPath = 1;
+        m_flat.clear();
     }
 
     /// Destructor deletes the whole tree
@@ -412,14 +432,39 @@ public:
     int query4(point const & lower, point const & upper,
                int level) const;
 
+    /** \brief Computes query3() for many boxes at once.
+     *
+     * \param lower the lower left corners of the boxes (columns)
+     * \param upper the upper right corners of the boxes (columns)
+     * \param level specifies which level \em lower and \em upper refer to.
+     * \param[out] result the lowest level of each box
+     */
+    void query3(gsMatrix<T> const & lower, gsMatrix<T> const & upper,
+                int level, gsVector<T> & result) const;
+
+    /** \brief Computes query4() for many boxes at once.
+     *
+     * \param lower the lower left corners of the boxes (columns)
+     * \param upper the upper right corners of the boxes (columns)
+     * \param level specifies which level \em lower and \em upper refer to.
+     * \param[out] result the highest level of each box
+     */
+    void query4(gsMatrix<T> const & lower, gsMatrix<T> const & upper,
+                int level, gsVector<T> & result) const;
+
     /// Returns the level of the point \a p
-    int levelOf(point const & p, int level) const
-    { return pointSearch(p,level,m_root)->level;}
+    int levelOf(point const & p, int level) const;
+
+    /// Returns the levels of the points given by the columns of \a
+    /// points in \a result
+    void levelOf(gsMatrix<T> const & points, int level,
+                 gsVector<T> & result) const;
 
     // to do: move to the hpp file do avoid need for instantization
     void incrementLevel()
     {
         m_maxInsLevel++;
+        m_flat.clear();
 
         GISMO_ASSERT( m_maxInsLevel <= m_indexLevel,
         "Problem with indices, increase number of levels (to do).");
@@ -431,6 +476,7 @@ public:
     void multiplyByTwo()
     {
         m_upperIndex *= 2;
+        m_flat.clear();
         nodeSearch< liftCoordsOneLevel_visitor >();
     }
 
@@ -438,11 +484,14 @@ public:
     void decrementLevel()
     {
         m_maxInsLevel--;
+        m_flat.clear();
         leafSearch< levelDown_visitor >(); 
     }
 
     literator beginLeafIterator()
     {
+        // The leaves may be changed through the iterator
+        m_flat.clear();
         return literator(m_root, m_indexLevel);
     }
 
@@ -451,6 +500,8 @@ public:
         return const_literator(m_root, m_indexLevel);
     }
 
+    /// Merges the siblings with the same level, and linearises the
+    /// tree for the queries
     void makeCompressed();
     
     /// Returns the number of nodes in the tree
@@ -654,11 +705,32 @@ private:
     typename visitor::return_type
     nodeSearch() const;
 
+    /// Applies \a visitor to the leaves overlapping each of the boxes
+    /// given by the columns of \a lower and \a upper, and stores the
+    /// results in \a result
+    template<typename visitor>
+    void batchBoxSearch(gsMatrix<T> const & lower, gsMatrix<T> const & upper,
+                        int level, gsVector<T> & result) const;
+
+    /// Applies \a visitor to the leaves of the linearised tree which
+    /// overlap \a qBox (given in index level). \a stack must have
+    /// room for m_maxPath + 2 entries.
+    template<typename visitor>
+    typename visitor::return_type
+    flatBoxSearch(box const & qBox, int level, T * stack) const;
+
     /// Returns the leaf node of the subtree starting at \a _node that
     /// contains the input point \a p. The cells in the tree are
     /// considered half-open, i.e. in 2D they are of the form
     /// [a_1,b_1) x [a_2,b_2)
     node * pointSearch(const point & p, int level, node  *_node) const;
+
+    /// Returns the level of the leaf of the linearised tree which
+    /// contains the point \a pp (given in index level)
+    int flatPointSearch(const point & pp) const;
+
+    /// Builds the linearised tree gsHDomain::m_flat
+    void linearize();
     
     // Increases the level by 1 for all leaves
     struct levelUp_visitor
@@ -48,12 +48,10 @@ namespace {
         // initialize result as true
         static const return_type init = true;
 
-        template<short_t d, class T >
-        static void visitLeaf(gismo::kdnode<d,T> * leafNode , int level, return_type & res)
+        static void visitLeaf(int leafLevel, int level, return_type & res)
         {
             //if ( (!isDegenerate(*leafNode->box)) && leafNode->level != level )
-            if ( leafNode->level != level )
-                // if (leafNode->level != level )
+            if ( leafLevel != level )
                 res = false;
         }
     };
@@ -66,11 +64,10 @@ namespace {
         // initialize result as true
         static const return_type init = true;
 
-        template<short_t d, class T >
-        static void visitLeaf(gismo::kdnode<d,T> * leafNode , int level, return_type & res)
+        static void visitLeaf(int leafLevel, int level, return_type & res)
         {
             //if ( (!isDegenerate(*leafNode->box)) && leafNode->level <= level )
-            if ( leafNode->level <= level )
+            if ( leafLevel <= level )
                 res = false;
         }
     };
@@ -84,12 +81,11 @@ namespace {
         // for a minimum
         static const return_type init = 1000000;
 
-        template<short_t d, class T >
-        static void visitLeaf(gismo::kdnode<d,T> * leafNode , int , return_type & res)
+        static void visitLeaf(int leafLevel, int , return_type & res)
         {
             //if ( (!isDegenerate(*leafNode->box)) && leafNode->level < res )
-            if ( leafNode->level < res )
-                res = leafNode->level;
+            if ( leafLevel < res )
+                res = leafLevel;
         }
     };
     
@@ -102,12 +98,11 @@ namespace {
         // looking for a maximum
         static const return_type init = -1;
 
-        template<short_t d, class T >
-        static void visitLeaf(gismo::kdnode<d,T> * leafNode , int , return_type & res)
+        static void visitLeaf(int leafLevel, int , return_type & res)
         {
             //if ( (!isDegenerate(*leafNode->box)) && leafNode->level > res )
-            if ( leafNode->level > res )
-                res = leafNode->level;
+            if ( leafLevel > res )
+                res = leafLevel;
         }
     };
 
@@ -217,6 +212,9 @@ gsHDomain<d,T>::insertBox ( point const & k1, point const & k2,
         return;
     }
     
+    // The linearised tree is built again by makeCompressed()
+    m_flat.clear();
+
     // Initialize stack
     std::vector<node*> stack;
     stack.reserve( 2 * (m_maxPath + d) );
@@ -317,6 +315,9 @@ gsHDomain<d,T>::sinkBox ( point const & k1,
         return;
     }
     
+    // The linearised tree is built again by makeCompressed()
+    m_flat.clear();
+
     // Initialize stack
     std::stack<node*, std::vector<node*> > stack;
     //stack.reserve( 2 * m_maxPath );
@@ -409,6 +410,43 @@ gsHDomain<d,T>::makeCompressed()
     
     // Store the max path length
     m_maxPath = minMaxPath().second;
+
+    linearize();
+}
+
+template<short_t d, class T > void
+gsHDomain<d,T>::linearize()
+{
+    m_flat.clear();
+    m_flat.reserve( size() );
+
+    // Depth-first, with the left child first. Each entry of the
+    // stack holds a node and the position of its parent, if it is
+    // a right child.
+    std::vector<std::pair<node*,T> > stack;
+    stack.reserve( 2 * m_maxPath + 2 );
+    stack.push_back( std::make_pair(m_root, T(-1)) );
+
+    flatNode fn;
+    while ( ! stack.empty() )
+    {
+        const node * curNode = stack.back().first;
+        if ( -1 != stack.back().second )
+            m_flat[stack.back().second].right = m_flat.size();
+        stack.pop_back();
+
+        fn.axis  = curNode->axis;
+        fn.level = curNode->level;
+        fn.pos   = ( curNode->isLeaf() ? 0 : curNode->pos );
+        fn.right = -1;
+        m_flat.push_back(fn);
+
+        if ( ! curNode->isLeaf() )
+        {
+            stack.push_back( std::make_pair(curNode->right, T(m_flat.size() - 1)) );
+            stack.push_back( std::make_pair(curNode->left , T(-1)) );
+        }
+    }
 }
 
 template<short_t d, class T >
@@ -451,6 +489,47 @@ int gsHDomain<d,T>::query4(point const & lower, point const & upper,
                int level) const
 { return boxSearch< query4_visitor >(lower,upper,level,m_root); }
 
+template<short_t d, class T >
+void gsHDomain<d,T>::query3(gsMatrix<T> const & lower, gsMatrix<T> const & upper,
+                            int level, gsVector<T> & result) const
+{ batchBoxSearch< query3_visitor >(lower,upper,level,result); }
+
+template<short_t d, class T >
+void gsHDomain<d,T>::query4(gsMatrix<T> const & lower, gsMatrix<T> const & upper,
+                            int level, gsVector<T> & result) const
+{ batchBoxSearch< query4_visitor >(lower,upper,level,result); }
+
+template<short_t d, class T >
+int gsHDomain<d,T>::levelOf(point const & p, int level) const
+{
+    if ( m_flat.empty() )
+        return pointSearch(p,level,m_root)->level;
+
+    point pp;
+    local2globalIndex(p, static_cast<unsigned>(level), pp);
+    return flatPointSearch(pp);
+}
+
+template<short_t d, class T >
+void gsHDomain<d,T>::levelOf(gsMatrix<T> const & points, int level,
+                             gsVector<T> & result) const
+{
+    GISMO_ASSERT( points.rows() == d, "Points of wrong dimension.");
+    result.resize( points.cols() );
+    point p, pp;
+    for ( index_t i = 0; i != points.cols(); ++i )
+    {
+        p = points.col(i);
+        if ( m_flat.empty() )
+            result[i] = pointSearch(p,level,m_root)->level;
+        else
+        {
+            local2globalIndex(p, static_cast<unsigned>(level), pp);
+            result[i] = flatPointSearch(pp);
+        }
+    }
+}
+
 template<short_t d, class T >
 std::pair<typename gsHDomain<d,T>::point, typename gsHDomain<d,T>::point>
 gsHDomain<d,T>::select_part(point const & k1, point const & k2,
@@ -495,6 +574,18 @@ gsHDomain<d,T>::boxSearch(point const & k1, point const & k2,
                   "boxSearch: Wrong order of points defining the box (or empty box): "
                   << qBox.first.transpose() <<", "<< qBox.second.transpose() <<".\n" );
 
+    // Use the linearised tree, if it is up to date
+    if ( _node == m_root && !m_flat.empty() )
+    {
+        if ( m_maxPath < 62 )
+        {
+            T stack[64];
+            return flatBoxSearch<visitor>(qBox, level, stack);
+        }
+        std::vector<T> stack(m_maxPath + 2);
+        return flatBoxSearch<visitor>(qBox, level, stack.data());
+    }
+
     typename visitor::return_type res = visitor::init;
 
 /*  // under construction
@@ -504,7 +595,7 @@ gsHDomain<d,T>::boxSearch(point const & k1, point const & k2,
     {   
         if ( curNode->isLeaf() ) 
         {
-            visitor::visitLeaf(curNode, level, res );
+            visitor::visitLeaf(curNode->level, level, res );
 
             //curNode->isRightChild();
             while ( curNode->parent != NULL &&
@@ -581,7 +672,7 @@ gsHDomain<d,T>::boxSearch(point const & k1, point const & k2,
         {
             // Visit the leaf
             GISMO_ASSERT( !isDegenerate(*curNode->box), "Encountered an empty leaf");
-            visitor::visitLeaf(curNode, level, res );
+            visitor::visitLeaf(curNode->level, level, res );
         }
         else // this is a split-node
         {
@@ -603,7 +694,89 @@ gsHDomain<d,T>::boxSearch(point const & k1, point const & k2,
     return res;
 }
 
+template<short_t d, class T>
+template<typename visitor>
+typename visitor::return_type
+gsHDomain<d,T>::flatBoxSearch(box const & qBox, int level, T * stack) const
+{
+    typename visitor::return_type res = visitor::init;
 
+    // Same traversal as boxSearch, on positions in m_flat
+    index_t top = 0;
+    stack[top++] = 0;
+    while ( top != 0 )
+    {
+        const T cur = stack[--top];
+        const flatNode & curNode = m_flat[cur];
+
+        if ( -1 == curNode.axis )
+            visitor::visitLeaf(curNode.level, level, res );
+        else if ( qBox.second[curNode.axis] <= curNode.pos)
+            // qBox overlaps only left child of this split-node
+            stack[top++] = cur + 1;
+        else if  ( qBox.first[curNode.axis] >= curNode.pos)
+            // qBox overlaps only right child of this split-node
+            stack[top++] = curNode.right;
+        else
+        {
+            // qBox overlaps both children of this split-node
+            stack[top++] = cur + 1;
+            stack[top++] = curNode.right;
+        }
+    }
+    return res;
+}
+
+template<short_t d, class T>
+template<typename visitor>
+void gsHDomain<d,T>::batchBoxSearch(gsMatrix<T> const & lower,
+                                    gsMatrix<T> const & upper,
+                                    int level, gsVector<T> & result) const
+{
+    GISMO_ASSERT( lower.rows() == d && upper.rows() == d &&
+                  lower.cols() == upper.cols(), "Invalid boxes.");
+    result.resize( lower.cols() );
+
+    point k1, k2;
+    if ( m_flat.empty() )
+    {
+        for ( index_t i = 0; i != lower.cols(); ++i )
+        {
+            k1 = lower.col(i);
+            k2 = upper.col(i);
+            result[i] = boxSearch<visitor>(k1, k2, level, m_root);
+        }
+        return;
+    }
+
+    // One stack for all the boxes
+    std::vector<T> stack(m_maxPath + 2);
+    box qBox(k1, k2);
+    for ( index_t i = 0; i != lower.cols(); ++i )
+    {
+        k1 = lower.col(i);
+        k2 = upper.col(i);
+        local2globalIndex( k1, static_cast<unsigned>(level), qBox.first );
+        local2globalIndex( k2, static_cast<unsigned>(level), qBox.second);
+        GISMO_ASSERT( !isDegenerate(qBox),
+                      "batchBoxSearch: Wrong order of points defining the box (or empty box): "
+                      << qBox.first.transpose() <<", "<< qBox.second.transpose() <<".\n" );
+        result[i] = flatBoxSearch<visitor>(qBox, level, stack.data());
+    }
+}
+
+template<short_t d, class T>
+int gsHDomain<d,T>::flatPointSearch(const point & pp) const
+{
+    GISMO_ASSERT( ( pp.array() <= m_upperIndex.array() ).all(),
+        "pointSearch: Wrong input: "<< pp.transpose()<<".\n" );
+
+    const flatNode * curNode = &m_flat.front();
+    while ( -1 != curNode->axis )
+        curNode = ( pp[curNode->axis] < curNode->pos ? curNode + 1
+                    : &m_flat[curNode->right] );
+    return curNode->level;
+}
 
 template<short_t d, class T>
 typename gsHDomain<d,T>::node *
@@ -466,7 +466,9 @@ public:
         os<<"\n";
     }
 
-    // Look at gsBasis.h for the documentation of this function
+    // Look at gsBasis.h for the documentation of this function.
+    // The points are grouped by element and the active functions are
+    // found once per element.
     void active_into(const gsMatrix<T> & u, gsMatrix<index_t>& result) const;
 
 
@@ -856,6 +858,19 @@ protected:
     /// to be given to refineElements().
     void getBoxesAlongSlice( int dir, T par,std::vector<index_t>& boxes ) const;
 
+    /// @brief Groups the points \a u (one per column) by the element
+    /// that contains them. The points perm[groups[k]], ...,
+    /// perm[groups[k+1]-1] lie in the same element, which has level
+    /// \a levels[k].
+    void groupPoints(const gsMatrix<T> & u, std::vector<index_t> & perm,
+                     std::vector<index_t> & groups, gsVector<index_t> & levels) const;
+
+    /// @brief Appends to \a result the indices of the functions
+    /// which are active on the element of level \a lvl that contains
+    /// the point \a u, in increasing order.
+    void elementActive_into(const gsMatrix<T> & u, int lvl,
+                            std::vector<index_t> & result) const;
+
 private:
 
     /// \brief Inserts a domain into the basis
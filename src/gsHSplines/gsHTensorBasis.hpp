@@ -21,6 +21,28 @@
 namespace gismo
 {
 
+namespace internal
+{
+
+// Lexicographic comparison of the columns of a matrix, given by
+// their indices
+struct columnLess
+{
+    explicit columnLess(const gsMatrix<index_t> & m) : mat(m) { }
+
+    bool operator() (index_t a, index_t b) const
+    {
+        for (index_t i = 0; i != mat.rows(); ++i)
+            if ( mat(i,a) != mat(i,b) )
+                return mat(i,a) < mat(i,b);
+        return false;
+    }
+
+    const gsMatrix<index_t> & mat;
+};
+
+} // namespace internal
+
 template<short_t d, class T>
 gsMatrix<T> gsHTensorBasis<d,T>::support() const
 {
@@ -57,16 +79,18 @@ void gsHTensorBasis<d,T>::getLevelUniqueSpanAtPoints(const  gsMatrix<T> & Pt,
                                                      gsVector<index_t> & lvl,
                                                      gsMatrix<index_t> & loIdx ) const
 {
-    lvl.resize( Pt.cols() );
     loIdx.resize( Pt.rows(), Pt.cols() );
-    lvl.setZero();
-    loIdx.setZero();
+
+    // Find the levels of all points at once
+    const int maxLevel = m_tree.getMaxInsLevel();
+    for( index_t i = 0; i < Pt.cols(); i++)
+        for( index_t j = 0; j < Pt.rows(); j++)
+            loIdx(j,i) = m_bases[maxLevel]->knots(j).uFind( Pt(j,i) ).uIndex();
+    m_tree.levelOf(loIdx, maxLevel, lvl);
+
     for( index_t i = 0; i < Pt.cols(); i++)
-    {
-        lvl[i] = getLevelAtPoint( Pt.col(i) );
         for( index_t j = 0; j < Pt.rows(); j++)
             loIdx(j,i) = m_bases[ lvl[i] ]->knots(j).uFind( Pt(j,i) ).uIndex() ;
-    }
 }
 
 template<short_t d, class T> inline
@@ -916,70 +940,100 @@ void gsHTensorBasis<d,T>::initialize_class(gsBasis<T> const&  tbasis)
 
 
 template<short_t d, class T>
-void gsHTensorBasis<d,T>::active_into(const gsMatrix<T> & u, gsMatrix<index_t>& result) const
+void gsHTensorBasis<d,T>::groupPoints(const gsMatrix<T> & u,
+                                      std::vector<index_t> & perm,
+                                      std::vector<index_t> & groups,
+                                      gsVector<index_t> & levels) const
 {
-    gsMatrix<T> currPoint;
-    point low, upp, cur;
-    const int maxLevel = m_tree.getMaxInsLevel();
+    const index_t np = u.cols();
+    perm.resize(np);
+    groups.clear();
+    if ( 0 == np )
+    {
+        groups.push_back(0);
+        levels.resize(0);
+        return;
+    }
 
-    std::vector<std::vector<index_t> > temp_output;//collects the outputs
-    temp_output.resize( u.cols() );
-    size_t sz = 0;
+    // The key of a point is its level followed by its element
+    gsVector<index_t> lvl;
+    gsMatrix<index_t> cell;
+    getLevelUniqueSpanAtPoints(u, lvl, cell);
+    gsMatrix<index_t> key(d + 1, np);
+    key.row(0) = lvl.transpose();
+    key.bottomRows(d) = cell;
+
+    for (index_t p = 0; p != np; ++p)
+        perm[p] = p;
+    // Usually the points are given element by element
+    const internal::columnLess cmp(key);
+    for (index_t p = 1; p != np; ++p)
+        if ( cmp(p, p-1) )
+        {
+            std::sort(perm.begin(), perm.end(), cmp);
+            break;
+        }
 
-    //gsMatrix<index_t> activesLvl;
+    groups.push_back(0);
+    for (index_t p = 1; p != np; ++p)
+        if ( key.col(perm[p]) != key.col(perm[p-1]) )
+            groups.push_back(p);
+    groups.push_back(np);
 
-    for(index_t p = 0; p < u.cols(); p++) //for all input points
-    {
-        currPoint = u.col(p);
-        
-        for(short_t i = 0; i != d; ++i)
-            low[i] = m_bases[maxLevel]->knots(i).uFind( currPoint(i,0) ).uIndex();
-        
-        // Identify the level of the point
-        const int lvl = m_tree.levelOf(low, maxLevel);
+    const index_t ng = groups.size() - 1;
+    levels.resize(ng);
+    for (index_t k = 0; k != ng; ++k)
+        levels[k] = lvl[ perm[groups[k]] ];
+}
 
-        for(int i = 0; i <= lvl; i++)
+template<short_t d, class T>
+void gsHTensorBasis<d,T>::elementActive_into(const gsMatrix<T> & u, int lvl,
+                                             std::vector<index_t> & result) const
+{
+    point low, upp, cur;
+    for(int i = 0; i <= lvl; i++)
+    {
+        m_bases[i]->active_cwise(u, low, upp);
+        cur = low;
+        do
         {
-            /*
-              m_bases[i]->active_into(currPoint, activesLvl);
-              
-              std::set_intersection(m_xmatrix[i].begin(), m_xmatrix[i].end(),
-              activesLvl.data(), activesLvl.data() + activesLvl.size(),
-              std::back_inserter( temp_output[p] ) );
-              +++ Renumbering to H-basis indexing
-            // */                                 
-
-            // /*
-            m_bases[i]->active_cwise(currPoint, low, upp);
-            cur = low;
-            do
-            {
-                CMatrix::const_iterator it =
-                    m_xmatrix[i].find_it_or_fail( m_bases[i]->index(cur) );
+            CMatrix::const_iterator it =
+                m_xmatrix[i].find_it_or_fail( m_bases[i]->index(cur) );
 
-                if( it != m_xmatrix[i].end() )// if index is found
-                {
-                    temp_output[p].push_back(
-                        this->m_xmatrix_offset[i] + (it - m_xmatrix[i].begin() )
-                        );
-                }
+            if( it != m_xmatrix[i].end() )// if index is found
+            {
+                result.push_back(
+                    this->m_xmatrix_offset[i] + (it - m_xmatrix[i].begin() )
+                    );
             }
-            while( nextCubePoint(cur,low,upp) );
-            //*/
         }
-
-        // update result size
-        if ( temp_output[p].size() > sz )
-            sz = temp_output[p].size();
+        while( nextCubePoint(cur,low,upp) );
     }
+}
 
-    result.resize(sz, u.cols() );
-    for(index_t i = 0; i < result.cols(); i++)
-    {
-        result.col(i).topRows(temp_output[i].size())
-            = gsAsConstVector<index_t>(temp_output[i]);
-        result.col(i).bottomRows(sz-temp_output[i].size()).setZero();
-    }
+template<short_t d, class T>
+void gsHTensorBasis<d,T>::active_into(const gsMatrix<T> & u, gsMatrix<index_t>& result) const
+{
+    std::vector<index_t> perm, groups;
+    gsVector<index_t> levels;
+    groupPoints(u, perm, groups, levels);
+
+    // The active functions of each element
+    const index_t ng = levels.size();
+    std::vector<std::vector<index_t> > temp_output(ng);
+#   pragma omp parallel for if (ng > 64)
+    for(index_t k = 0; k < ng; k++)
+        elementActive_into(u.col(perm[groups[k]]), levels[k], temp_output[k]);
+
+    size_t sz = 0;
+    for(index_t k = 0; k != ng; k++)
+        sz = std::max(sz, temp_output[k].size());
+
+    result.setZero(sz, u.cols());
+    for(index_t k = 0; k != ng; k++)
+        for(index_t p = groups[k]; p != groups[k+1]; p++)
+            result.col(perm[p]).topRows(temp_output[k].size())
+                = gsAsConstVector<index_t>(temp_output[k]);
 }
 
 template<short_t d, class T>
@@ -137,209 +137,27 @@ public:
                              const gsMatrix<T> & u,
                           gsMatrix<T>& result) const;
 
-    // look at eval_into
+    /// Same as eval_into, kept for compatibility
     void fastEval_into(const gsMatrix<T>& u,
                        gsMatrix<T>& result) const
-    {
-        gsMatrix<index_t> indices;
-        this->active_into(u, indices);
-
-        result.setZero(indices.rows(), u.cols());
-
-        const unsigned maxLvl = this->m_tree.getMaxInsLevel() + 1;
-        std::vector< gsMatrix<T> > tmpResults(maxLvl, gsMatrix<T>());
-        std::vector< gsMatrix<index_t> > tmpActive(maxLvl, gsMatrix<index_t>());
-        gsVector<int> processed(maxLvl);
-
-        for (int pt = 0; pt != u.cols(); pt++)
-        {
-            processed.setZero();
-
-            for (int ind = 0; ind != indices.rows(); ind++)
-            {
-                unsigned index = indices(ind, pt);
-                if (ind != 0 && index == 0)
-                    break;
-
-                unsigned lvl = getPresLevelOfBasisFun(index);
-
-                if (processed(lvl) == 0)
-                {
-                    this->m_bases[lvl]->eval_into(u.col(pt), tmpResults[lvl]);
-                    this->m_bases[lvl]->active_into(u.col(pt), tmpActive[lvl]);
-                    processed(lvl) = 1;
-                }
-
-                if (m_is_truncated[index] == -1)
-                {
-                    index_t flatTenIndx = this->flatTensorIndexOf(index, lvl);
-                    int localIndex = -1;
-                    for (int row = 0; row != tmpActive[lvl].rows(); ++row)
-                    {
-                        if (tmpActive[lvl](row, 0) == flatTenIndx)
-                        {
-                            localIndex = row;
-                            break;
-                        }
-                    }
-                    result(ind, pt) = tmpResults[lvl](localIndex, 0);
-                }
-                else // basis function is truncated
-                {
-                    const gsMatrix<T>& basis = tmpResults[lvl];
-                    const gsMatrix<index_t>& active = tmpActive[lvl];
-
-
-                    const gsSparseVector<T>& coefs = getCoefs(index);
-                    T tmp = coefs(active(0, 0)) * basis(0, 0);
-                    for (int i = 1; i < active.rows(); i++)
-                    {
-                        tmp += coefs(active(i, 0)) * basis(i, 0);
-                    }
-                    result(ind, pt) = tmp;
-                }
-            }
-        }
-    }
+    { eval_into(u, result); }
 
-    // look at deriv_into
+    /// Same as deriv_into, kept for compatibility
     void fastDeriv_into(const gsMatrix<T>& u,
                         gsMatrix<T>& result) const
-    {
-        gsMatrix<index_t> indices;
-        this->active_into(u, indices);
-
-        result.setZero(indices.rows() * d, u.cols());
+    { deriv_into(u, result); }
 
-        const unsigned maxLvl = this->m_tree.getMaxInsLevel() + 1;
-        std::vector< gsMatrix<T> > tmpDeriv( maxLvl, gsMatrix<T>());
-        std::vector< gsMatrix<index_t> > tmpActive(maxLvl, gsMatrix<index_t>());
-        gsVector<int> processed(maxLvl);
-
-        for (index_t pt = 0; pt != u.cols(); pt++)
-        {
-            processed.setZero();
-
-            for (int ind = 0; ind != indices.rows(); ind++)
-            {
-                index_t index = indices(ind, pt);
-                if (ind != 0 && index == 0)
-                    break;
-
-                unsigned lvl = getPresLevelOfBasisFun(index);
-
-                if (processed(lvl) == 0)
-                {
-                    this->m_bases[lvl]->deriv_into(u.col(pt), tmpDeriv[lvl]);
-                    this->m_bases[lvl]->active_into(u.col(pt), tmpActive[lvl]);
-                    processed(lvl) = 1;
-                }
-
-                if (m_is_truncated[index] == -1)
-                {
-                    index_t flatTenIndx = this->flatTensorIndexOf(index, lvl);
-                    int localIndex = -1;
-                    for (int row = 0; row != tmpActive[lvl].rows(); ++row)
-                    {
-                        if (tmpActive[lvl](row, 0) == flatTenIndx)
-                        {
-                            localIndex = row;
-                            break;
-                        }
-                    }
-
-                    result.block(ind * d, pt, d, 1) =
-                            tmpDeriv[lvl].block(localIndex * d, 0, d, 1);
-                }
-                else // basis function is truncated
-                {
-                    const gsMatrix<T>& basis = tmpDeriv[lvl];
-                    const gsMatrix<index_t>& active = tmpActive[lvl];
-                    const gsSparseVector<T>& coefs = getCoefs(index);
-
-                    for (unsigned dim = 0; dim != d; dim++) // for all deric
-                    {
-                        for (index_t i = 0; i != active.rows(); ++i)
-                        {
-                            result(ind * d + dim, pt) +=
-                                    coefs(active(i, 0)) * basis(i * d + dim, 0);
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-    // look at deriv2_into
+    /// Same as deriv2_into, kept for compatibility
     void fastDeriv2_into(const gsMatrix<T>& u,
                          gsMatrix<T>& result) const
-    {
-        gsMatrix<index_t> indices;
-        this->active_into(u, indices);
-        const unsigned numDers = (d * (d + 1)) / 2;
+    { deriv2_into(u, result); }
 
-        result.setZero(indices.rows() * numDers, u.cols());
-
-        const unsigned maxLvl = this->m_tree.getMaxInsLevel() + 1;
-        std::vector< gsMatrix<T> > tmpDeriv2(maxLvl, gsMatrix<T>());
-        std::vector< gsMatrix<index_t> > tmpActive(maxLvl, gsMatrix<index_t>());
-        gsVector<int> processed(maxLvl);
-
-        for (int pt = 0; pt != u.cols(); pt++)
-        {
-            processed.setZero();
-
-            for (int ind = 0; ind != indices.rows(); ind++)
-            {
-
-                unsigned index = indices(ind, pt);
-                if (ind != 0 && index == 0)
-                    break;
-
-                unsigned lvl = getPresLevelOfBasisFun(index);
-
-                if (processed(lvl) == 0)
-                {
-                    this->m_bases[lvl]->deriv2_into(u.col(pt), tmpDeriv2[lvl]);
-                    this->m_bases[lvl]->active_into(u.col(pt), tmpActive[lvl]);
-                    processed(lvl) = 1;
-                }
-
-                if (m_is_truncated[index] == -1)
-                {
-                    index_t flatTenIndx = this->flatTensorIndexOf(index, lvl);
-                    int localIndx = -1;
-                    for (int row = 0; row != tmpActive[lvl].rows(); ++row)
-                    {
-                        if (tmpActive[lvl](row, 0) == flatTenIndx)
-                        {
-                            localIndx = row;
-                            break;
-                        }
-                    }
-
-                    result.block(ind * numDers, pt, numDers, 1) =
-                            tmpDeriv2[lvl].block(localIndx * numDers, 0, numDers, 1);
-                }
-                else // basis function is truncated
-                {
-                    const gsMatrix<T>& basis = tmpDeriv2[lvl];
-                    const gsMatrix<index_t>& active = tmpActive[lvl];
-                    const gsSparseVector<T>& coefs = getCoefs(index);
-
-                    for (unsigned der = 0; der != numDers; der++)
-                    {
-                        for (index_t i = 0; i != active.rows(); ++i)
-                        {
-                            result(ind * numDers + der, pt) +=
-                                    coefs(active(i, 0)) *
-                                    basis(i * numDers + der, 0);
-                        }
-                    }
-                }
-            }
-        }
-    }
+    // Look at gsBasis class for documentation. The points are grouped
+    // by element, and on each element the tensor-product bases of the
+    // levels involved are evaluated once for all its points. The
+    // elements are processed in parallel.
+    void evalAllDers_into(const gsMatrix<T> & u, int n,
+                          std::vector<gsMatrix<T> >& result) const;
 
     // Look at gsBasis class for documentation
     void eval_into(const gsMatrix<T> & u, gsMatrix<T>& result) const;
@@ -406,6 +224,39 @@ private:
     /// @brief Computes and saves representation of all basis functions.
     void representBasis(); // rename: precompute coeffs
 
+    /// @brief Updates the representation of the basis functions after
+    /// a change of the hierarchy, given the characteristic matrices
+    /// before the change.
+    ///
+    /// Only the functions whose support contains the support of a
+    /// function which was activated or deactivated, or whose
+    /// presentation level has changed, are computed again. The other
+    /// representations are kept. If the tensor levels have changed,
+    /// all functions are computed again.
+    void updateRepresentation(
+        const std::vector<typename gsHTensorBasis<d,T>::CMatrix> & old_xmatrix);
+
+    /// @brief Returns the level at which the j-th basis function is
+    /// presented, and the indices of its support on the finest grid
+    /// (if it is truncated).
+    unsigned _presentationLevel(const unsigned j,
+                                gsVector<index_t, d>& finest_low,
+                                gsVector<index_t, d>& finest_high) const;
+
+    /// @brief Copies the representations to the compact layout used by
+    /// the fast evaluation, and records the tensor levels they refer
+    /// to.
+    void _compactPresentation();
+
+    /// @brief Returns the positions \a rows in [\a abeg, \a aend), the
+    /// sorted active functions of level \a lvl at a point, and the
+    /// coefficients \a coefs which give the function \a index at this
+    /// point. \a lvl is the presentation level of \a index.
+    void _elementPresentation(const index_t index, const unsigned lvl,
+                              const index_t * abeg, const index_t * aend,
+                              std::vector<index_t>& rows,
+                              std::vector<T>& coefs) const;
+
 
     /// @brief Computes representation of j-th basis function on pres_level and
     /// saves it.
@@ -602,8 +453,10 @@ private:
     **/
     void update_structure() 
     {
+        std::vector<typename gsHTensorBasis<d,T>::CMatrix> old_xmatrix;
+        old_xmatrix.swap(m_xmatrix);
         gsHTensorBasis<d,T>::update_structure(); 
-        representBasis();
+        updateRepresentation(old_xmatrix);
     }
 
     /**
@@ -718,6 +571,18 @@ private:
     // m_presentation[j]
     std::map<index_t, gsSparseVector<T> > m_presentation;
 
+    // The same presentations in a compact layout: the indices and the
+    // coefficients of m_presentation[j] are stored in positions
+    // m_trunc_offset[j] to m_trunc_offset[j+1] of m_trunc_index and
+    // m_trunc_coef. The range is empty if j is not truncated.
+    std::vector<index_t> m_trunc_offset;
+    std::vector<index_t> m_trunc_index;
+    std::vector<T>       m_trunc_coef;
+
+    // Knot vectors of the levels (level * d + direction) at the time
+    // the presentations were computed
+    std::vector<gsKnotVector<T> > m_trunc_knots;
+
     using gsHTensorBasis<d,T>::m_bases;
     using gsHTensorBasis<d,T>::m_xmatrix;
     using gsHTensorBasis<d,T>::m_xmatrix_offset;
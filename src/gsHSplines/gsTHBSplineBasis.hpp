@@ -53,30 +53,14 @@ void gsTHBSplineBasis<d,T>::representBasis()
     this->m_is_truncated.resize(this->size());
     m_presentation.clear();
 
+    gsVector<index_t, d> low, high;
     for (index_t j = 0; j < this->size(); ++j)
     {
-        unsigned level = this->levelOf(j);
-        index_t tensor_index = this->flatTensorIndexOf(j, level);
-
-        // element indices
-        gsMatrix<index_t, d, 2> element_ind(d, 2);
-        this->m_bases[level]->elementSupport_into(tensor_index, element_ind);
-
-        // I tried with block, I can not trick the compiler to use references
-        gsVector<index_t, d> low = element_ind.col(0); //block<d, 1>(0, 0);
-        gsVector<index_t, d> high = element_ind.col(1); //block<d, 1>(0, 1);gsMatrix<index_t> element_ind =
-
-        // Finds coarsest level that function, with supports given with
-        // support indices of the coarsest level (low & high), has presentation
-        // based only on B-Splines (and not THB-Splines).
-        // this is not the same as query 3
-        unsigned clevel = this->m_tree.query4(low, high, level);
+        const unsigned level  = this->levelOf(j);
+        const unsigned clevel = _presentationLevel(j, low, high);
 
         if (level != clevel) // we must compute its presentation
         {
-            this->m_tree.computeFinestIndex(low, level, low);
-            this->m_tree.computeFinestIndex(high, level, high);
-
             this->m_is_truncated[j] = clevel;
             _representBasisFunction(j, clevel, low, high);
         }
@@ -85,6 +69,199 @@ void gsTHBSplineBasis<d,T>::representBasis()
             this->m_is_truncated[j] = -1;
         }
     }
+
+    _compactPresentation();
+}
+
+template<short_t d, class T>
+void gsTHBSplineBasis<d,T>::updateRepresentation(
+    const std::vector<typename gsHTensorBasis<d,T>::CMatrix> & old_xmatrix)
+{
+    typedef typename gsHTensorBasis<d,T>::CMatrix CMatrix;
+    const size_t old_levels = old_xmatrix.size();
+
+    // Offsets of the levels in the previous numbering
+    std::vector<index_t> old_offset(old_levels + 1, 0);
+    for (size_t l = 0; l != old_levels; ++l)
+        old_offset[l + 1] = old_offset[l] + old_xmatrix[l].size();
+
+    // The previous presentations can be kept only if the tensor
+    // levels they refer to are the same
+    bool valid = 0 != old_levels &&
+        old_offset.back() == this->m_is_truncated.size() &&
+        m_trunc_knots.size() <= d * m_bases.size();
+    for (size_t i = 0; valid && i != m_trunc_knots.size(); ++i)
+        valid = ( m_trunc_knots[i] == m_bases[i / d]->knots(i % d) );
+    if (!valid)
+    {
+        representBasis();
+        return;
+    }
+
+    // Mark the functions whose support contains the support of a
+    // function which was activated or deactivated. Since the
+    // truncation of a function only depends on the active functions
+    // contained in its support, the others are not affected.
+    std::vector<bool> changed(this->size(), false);
+    const CMatrix empty;
+    std::vector<index_t> diff;
+    gsMatrix<index_t, d, 2> supp;
+    gsVector<index_t, d> low, high, clow, chigh;
+    gsMatrix<T> center;
+    gsMatrix<index_t> act;
+    for (size_t k = 1; k < m_xmatrix.size(); ++k)
+    {
+        const CMatrix & old_k = k < old_levels ? old_xmatrix[k] : empty;
+        diff.clear();
+        std::set_symmetric_difference(old_k.begin(), old_k.end(),
+                                      m_xmatrix[k].begin(), m_xmatrix[k].end(),
+                                      std::back_inserter(diff));
+
+        for (size_t i = 0; i != diff.size(); ++i)
+        {
+            m_bases[k]->elementSupport_into(diff[i], supp);
+            this->m_tree.computeFinestIndex(supp.col(0), k, low);
+            this->m_tree.computeFinestIndex(supp.col(1), k, high);
+            center = m_bases[k]->support(diff[i]).rowwise().mean();
+
+            // The functions of the coarser levels containing the support
+            // are active at its center
+            for (size_t l = 0; l != k; ++l)
+            {
+                m_bases[l]->active_into(center, act);
+                for (index_t a = 0; a != act.rows(); ++a)
+                {
+                    const typename CMatrix::const_iterator it =
+                        std::lower_bound(m_xmatrix[l].begin(), m_xmatrix[l].end(),
+                                         act(a, 0));
+                    if (it == m_xmatrix[l].end() || *it != act(a, 0))
+                        continue;
+                    const index_t j = m_xmatrix_offset[l] + (it - m_xmatrix[l].begin());
+                    if (changed[j])
+                        continue;
+
+                    m_bases[l]->elementSupport_into(act(a, 0), supp);
+                    this->m_tree.computeFinestIndex(supp.col(0), l, clow);
+                    this->m_tree.computeFinestIndex(supp.col(1), l, chigh);
+                    changed[j] = ( (clow.array() <= low.array()).all() &&
+                                   (high.array() <= chigh.array()).all() );
+                }
+            }
+        }
+    }
+
+    // Keep the presentations which are still valid
+    gsVector<int> is_truncated(this->size());
+    std::map<index_t, gsSparseVector<T> > presentation;
+    std::vector<index_t> todo;
+    for (size_t l = 0; l != m_xmatrix.size(); ++l)
+    {
+        const CMatrix & old_l = l < old_levels ? old_xmatrix[l] : empty;
+        typename CMatrix::const_iterator it = old_l.begin();
+        for (size_t i = 0; i != m_xmatrix[l].size(); ++i)
+        {
+            const index_t j = m_xmatrix_offset[l] + i;
+            const int clevel = _presentationLevel(j, low, high);
+            if (static_cast<size_t>(clevel) == l)
+            {
+                is_truncated[j] = -1;
+                continue;
+            }
+            is_truncated[j] = clevel;
+
+            it = std::lower_bound(it, old_l.end(), m_xmatrix[l][i]);
+            if (!changed[j] && it != old_l.end() && *it == m_xmatrix[l][i])
+            {
+                const index_t old_j = old_offset[l] + (it - old_l.begin());
+                if (this->m_is_truncated[old_j] == clevel)
+                {
+                    presentation[j].swap(m_presentation[old_j]);
+                    continue;
+                }
+            }
+            todo.push_back(j);
+        }
+    }
+    this->m_is_truncated.swap(is_truncated);
+    m_presentation.swap(presentation);
+
+    // Compute the others
+    for (size_t i = 0; i != todo.size(); ++i)
+    {
+        const unsigned clevel = _presentationLevel(todo[i], low, high);
+        _representBasisFunction(todo[i], clevel, low, high);
+    }
+    _compactPresentation();
+}
+
+template<short_t d, class T>
+unsigned gsTHBSplineBasis<d,T>::_presentationLevel(
+    const unsigned j,
+    gsVector<index_t, d>& finest_low,
+    gsVector<index_t, d>& finest_high) const
+{
+    unsigned level = this->levelOf(j);
+    index_t tensor_index = this->flatTensorIndexOf(j, level);
+
+    // element indices
+    gsMatrix<index_t, d, 2> element_ind(d, 2);
+    this->m_bases[level]->elementSupport_into(tensor_index, element_ind);
+
+    // I tried with block, I can not trick the compiler to use references
+    gsVector<index_t, d> low = element_ind.col(0); //block<d, 1>(0, 0);
+    gsVector<index_t, d> high = element_ind.col(1); //block<d, 1>(0, 1);gsMatrix<index_t> element_ind =
+
+    // Finds coarsest level that function, with supports given with
+    // support indices of the coarsest level (low & high), has presentation
+    // based only on B-Splines (and not THB-Splines).
+    // this is not the same as query 3
+    unsigned clevel = this->m_tree.query4(low, high, level);
+
+    if (level != clevel)
+    {
+        this->m_tree.computeFinestIndex(low, level, finest_low);
+        this->m_tree.computeFinestIndex(high, level, finest_high);
+    }
+
+    return clevel;
+}
+
+template<short_t d, class T>
+void gsTHBSplineBasis<d,T>::_compactPresentation()
+{
+    const index_t n = this->size();
+    m_trunc_offset.assign(n + 1, 0);
+
+    index_t nnz = 0;
+    for (typename std::map<index_t, gsSparseVector<T> >::const_iterator
+             it = m_presentation.begin(); it != m_presentation.end(); ++it)
+        nnz += it->second.nonZeros();
+    m_trunc_index.resize(nnz);
+    m_trunc_coef .resize(nnz);
+
+    typename std::map<index_t, gsSparseVector<T> >::const_iterator
+        it = m_presentation.begin();
+    for (index_t j = 0; j != n; ++j)
+    {
+        index_t pos = m_trunc_offset[j];
+        if (it != m_presentation.end() && it->first == j)
+        {
+            for (typename gsSparseVector<T>::InnerIterator
+                     c(it->second); c; ++c, ++pos)
+            {
+                m_trunc_index[pos] = c.index();
+                m_trunc_coef [pos] = c.value();
+            }
+            ++it;
+        }
+        m_trunc_offset[j + 1] = pos;
+    }
+
+    m_trunc_knots.clear();
+    m_trunc_knots.reserve(d * m_bases.size());
+    for (size_t l = 0; l != m_bases.size(); ++l)
+        for (short_t dim = 0; dim != d; ++dim)
+            m_trunc_knots.push_back(m_bases[l]->knots(dim));
 }
 
 template<short_t d, class T>
@@ -1064,79 +1241,151 @@ void gsTHBSplineBasis<d,T>::deriv2Single_into(index_t i,
 }
 
 template<short_t d, class T>
-void gsTHBSplineBasis<d,T>::eval_into(const gsMatrix<T> & u, gsMatrix<T>& result) const
+void gsTHBSplineBasis<d,T>::_elementPresentation(const index_t index,
+                                                 const unsigned lvl,
+                                                 const index_t * abeg,
+                                                 const index_t * aend,
+                                                 std::vector<index_t>& rows,
+                                                 std::vector<T>& coefs) const
 {
-    gsMatrix<index_t> indices;
-    gsMatrix<T> res(1, 1);
-    this->active_into(u, indices);
+    rows.clear();
+    coefs.clear();
 
-    result.setZero(indices.rows(), u.cols());
+    if (m_is_truncated[index] == -1)
+    {
+        const index_t flatTenIndx = this->flatTensorIndexOf(index, lvl);
+        const index_t * it = std::lower_bound(abeg, aend, flatTenIndx);
+        GISMO_ASSERT(it != aend && *it == flatTenIndx,
+                     "Function "<< index <<" is not active on the element.");
+        rows.push_back(it - abeg);
+        coefs.push_back(1);
+        return;
+    }
 
-    for (index_t i = 0; i < indices.cols(); i++)
+    // Both the active functions and the stored indices are sorted
+    const index_t * ti   = m_trunc_index.data() + m_trunc_offset[index];
+    const index_t * tend = m_trunc_index.data() + m_trunc_offset[index + 1];
+    const T * coef = m_trunc_coef.data() + m_trunc_offset[index];
+    for (const index_t * it = abeg; it != aend && ti != tend; ++it)
     {
-        for (index_t j = 0; j < indices.rows(); j++)
+        for (; ti != tend && *ti < *it; ++ti, ++coef) ;
+        if (ti != tend && *ti == *it)
         {
-            const index_t index = indices(j, i);
-            if (j != 0 && index == 0)
-                break;
-            
-            evalSingle_into(index, u.col(i), res);
-            result(j, i) = res.value();
+            rows.push_back(it - abeg);
+            coefs.push_back(*coef);
         }
     }
 }
 
-
 template<short_t d, class T>
-void gsTHBSplineBasis<d,T>::deriv2_into(const gsMatrix<T>& u, gsMatrix<T>& result)const
+void gsTHBSplineBasis<d,T>::evalAllDers_into(const gsMatrix<T> & u, int n,
+                                             std::vector<gsMatrix<T> >& result) const
 {
-    gsMatrix<index_t> indices;
-    this->active_into(u, indices);
-
-    static const short_t numDers = (d * (d + 1)) / 2;
-    gsMatrix<T> res(numDers, 1); // result of deriv2Single_into
-
-    result.setZero(indices.rows() * numDers, u.cols());
-
-    for (int i = 0; i < indices.cols(); i++)
+    std::vector<index_t> perm, groups;
+    gsVector<index_t> levels;
+    this->groupPoints(u, perm, groups, levels);
+
+    const index_t ng = levels.size();
+    std::vector<std::vector<index_t> > act(ng);
+#   pragma omp parallel for if (ng > 64)
+    for (index_t g = 0; g < ng; ++g)
+        this->elementActive_into(u.col(perm[groups[g]]), levels[g], act[g]);
+
+    size_t numAct = 0;
+    for (index_t g = 0; g != ng; ++g)
+        numAct = std::max(numAct, act[g].size());
+
+    // Number of derivatives of each order
+    std::vector<index_t> numDers(n + 1, 1);
+    for (int k = 1; k <= n; ++k)
+        numDers[k] = numDers[k-1] * (d + k - 1) / k;
+
+    result.resize(n + 1);
+    for (int k = 0; k <= n; ++k)
+        result[k].setZero(numAct * numDers[k], u.cols());
+
+    const unsigned maxLvl = this->m_tree.getMaxInsLevel() + 1;
+#   pragma omp parallel if (ng > 16)
     {
-        for (int j = 0; j < indices.rows(); j++)
+        std::vector< std::vector<gsMatrix<T> > > tmpResults(maxLvl);
+        std::vector< gsMatrix<index_t> > tmpActive(maxLvl);
+        std::vector<index_t> processed(maxLvl, -1);
+        std::vector<index_t> rows;
+        std::vector<T> coefs;
+        gsMatrix<T> pts;
+
+#       pragma omp for schedule(dynamic, 8)
+        for (index_t g = 0; g < ng; ++g)
         {
-            const index_t index = indices(j, i);
-            if (j != 0 && index == 0)
-                break;
+            const index_t first = groups[g];
+            const index_t np = groups[g+1] - first;
+            pts.resize(d, np);
+            for (index_t j = 0; j != np; ++j)
+                pts.col(j) = u.col(perm[first + j]);
 
-            this->deriv2Single_into(index, u.col(i), res);
+            for (size_t r = 0; r != act[g].size(); ++r)
+            {
+                const index_t index = act[g][r];
+                const unsigned lvl = getPresLevelOfBasisFun(index);
 
-            result.template block<numDers, 1>(j * numDers, i) = res;
+                // The tensor-product functions of level lvl, evaluated
+                // once for all points of the element
+                if (processed[lvl] != g)
+                {
+                    this->m_bases[lvl]->evalAllDers_into(pts, n, tmpResults[lvl]);
+                    this->m_bases[lvl]->active_into(pts, tmpActive[lvl]);
+                    processed[lvl] = g;
+                }
+                const gsMatrix<index_t> & tact = tmpActive[lvl];
+
+                // A truncated function may be presented on a finer level
+                // than the element, then the active functions of this
+                // level differ from point to point
+                const index_t step = ( static_cast<index_t>(lvl) <= levels[g] ? np : 1 );
+                for (index_t j0 = 0; j0 != np; j0 += step)
+                {
+                    const index_t * abeg = tact.data() + j0 * tact.rows();
+                    _elementPresentation(index, lvl, abeg, abeg + tact.rows(),
+                                         rows, coefs);
+                    for (int k = 0; k <= n; ++k)
+                    {
+                        const index_t nd = numDers[k];
+                        const gsMatrix<T> & vals = tmpResults[lvl][k];
+                        for (size_t c = 0; c != rows.size(); ++c)
+                            for (index_t j = j0; j != j0 + step; ++j)
+                                result[k].block(r * nd, perm[first + j], nd, 1) +=
+                                    coefs[c] * vals.block(rows[c] * nd, j, nd, 1);
+                    }
+                }
+            }
         }
     }
 }
 
-
 template<short_t d, class T>
-void gsTHBSplineBasis<d,T>::deriv_into(const gsMatrix<T>& u, gsMatrix<T>& result) const
+void gsTHBSplineBasis<d,T>::eval_into(const gsMatrix<T> & u, gsMatrix<T>& result) const
 {
+    std::vector<gsMatrix<T> > tmp;
+    evalAllDers_into(u, 0, tmp);
+    result.swap(tmp[0]);
+}
 
-    gsMatrix<index_t> indices;
-    this->active_into(u, indices);
-    gsMatrix<T> res(d, 1);
-
-    result.setZero(indices.rows() * d, u.cols());
 
-    for (int i = 0; i < indices.cols(); i++)
-    {
-        for (int j = 0; j < indices.rows(); j++)
-        {
+template<short_t d, class T>
+void gsTHBSplineBasis<d,T>::deriv2_into(const gsMatrix<T>& u, gsMatrix<T>& result)const
+{
+    std::vector<gsMatrix<T> > tmp;
+    evalAllDers_into(u, 2, tmp);
+    result.swap(tmp[2]);
+}
 
-            const unsigned index = indices(j, i);
-            if (j != 0 && index == 0)
-                break;
 
-            this->derivSingle_into(index, u.col(i), res);
-            result.template block<d,1>(j * d, i) = res;
-        }
-    }
+template<short_t d, class T>
+void gsTHBSplineBasis<d,T>::deriv_into(const gsMatrix<T>& u, gsMatrix<T>& result) const
+{
+    std::vector<gsMatrix<T> > tmp;
+    evalAllDers_into(u, 1, tmp);
+    result.swap(tmp[1]);
 }
 
 
@@ -17,6 +17,7 @@
 #include <string>
 
 #include <gsIO/gsXml.h>
+#include <gsIO/gsXmlIndex.h>
 
 namespace gismo
 {
@@ -46,17 +47,25 @@ public:
      * Initializes a gsFileData object with the contents of a file
      *
      * @param fn filename string
+     * @param lazy parse the objects of an XML file on demand, see read()
      */
-    explicit gsFileData(String const & fn);
+    explicit gsFileData(String const & fn, bool lazy = false);
 
     /**
      * Loads the contents of a file into a gsFileData object
      *
      * @param fn filename string
+     * @param lazy if true and \a fn is an (uncompressed) XML file, the
+     * file is memory-mapped and only an index of its top-level
+     * objects is built. The objects are parsed when they are
+     * requested by getId(), getFirst() or getAnyFirst(), together with
+     * the objects they refer to by id (eg. the patches of a
+     * MultiPatch). Functions that need the whole data, like getAll(),
+     * count() or save(), parse all objects.
      *
      * Returns true on success, false on failure.
      */
-    bool read(String const & fn) ;
+    bool read(String const & fn, bool lazy = false) ;
 
     ~gsFileData();
 
@@ -93,6 +102,16 @@ public:
     /// to a 64-bit double.
     unsigned getFloatPrecision() const { return data->getFloatPrecision(); }
 
+    /// Sets whether the floating point values of matrices, sparse
+    /// matrices and knot vectors are written base64 encoded (with
+    /// attribute format="base64"), instead of as text. The encoding
+    /// is exact and much faster to read. It applies to the objects
+    /// added afterwards; reading detects it automatically.
+    void setBinaryEncoding(const bool b) { data->setBinaryEncoding(b); }
+
+    /// Returns true if floating point values are written base64 encoded
+    bool getBinaryEncoding() const { return data->getBinaryEncoding(); }
+
 private:
     /// File data as an xml tree
     FileData * data;
@@ -100,6 +119,9 @@ private:
     // Used to hold parsed data of native gismo XML files
     std::vector<char> m_buffer;
 
+    // Index of the objects of a lazily read XML file
+    mutable internal::gsXmlIndex m_index;
+
     // Holds the last path that was used in an I/O operation
     mutable String m_lastPath;
 
@@ -112,6 +134,9 @@ protected:
     /// Reads a file with xml extension
     bool readXmlFile( String const & fn );
 
+    /// Indexes a file with xml extension, the objects are parsed on demand
+    bool readXmlFileLazy( String const & fn );
+
     /// Reads a file with xml.gz extension
     bool readXmlGzFile( String const & fn );
 
@@ -171,6 +196,8 @@ public:
     template<class Object>
     inline memory::unique_ptr<Object> getId( const int & id)  const
     {
+        if ( m_index.isOpen() )
+            materializeId(id);
         return memory::make_unique( internal::gsXml<Object>::getId( getXmlRoot(), id ) );
     }
 
@@ -213,6 +240,7 @@ public:
     template<class Object>
     inline int count() const
     {
+        materializeAll();
         int i(0);
         for (gsXmlNode * child = getFirstNode( internal::gsXml<Object>::tag(),
                                                internal::gsXml<Object>::type() ) ;
@@ -341,6 +369,7 @@ public:
     inline std::vector< memory::unique_ptr<Object> > getAll()  const
     {
         std::vector< memory::unique_ptr<Object> > result;
+        materializeAll();
 
         for (gsXmlNode * child = getFirstNode( internal::gsXml<Object>::tag(),
                                                internal::gsXml<Object>::type() ) ;
@@ -417,6 +446,16 @@ public:
 private:
 
     gsXmlNode * getXmlRoot() const;
+
+    // Parses all objects of a lazily read file
+    void materializeAll() const
+    {
+        if ( m_index.isOpen() )
+            m_index.materializeAll(*data);
+    }
+
+    // Parses the object with the given id of a lazily read file
+    void materializeId(const int id) const;
     static void deleteXmlSubtree (gsXmlNode* node);
 
     // getFirst ? (tag and or type)
@@ -427,6 +466,11 @@ private:
     gsXmlNode * getAnyFirstNode( const String & name = "",
                                  const String & type = "" ) const;
 
+    // Searches node and its descendants up to the third level
+    static gsXmlNode * getAnyNode( gsXmlNode * node,
+                                   const String & name,
+                                   const String & type );
+
     // getNext
     static gsXmlNode * getNextSibling( gsXmlNode* const & node,
                                        const String & name = "",
@@ -39,9 +39,31 @@
 
 #include <gzstream/gzstream.h>
 #include <gsIO/gsFileManager.h>
+#include <gsIO/gsMappedFile.h>
 
 namespace gismo {
 
+namespace internal
+{
+
+// Returns the beginning of the line after the one containing p
+inline const char * nextLine(const char * p, const char * end)
+{
+    p = std::find(p, end, '\n');
+    return p == end ? end : p + 1;
+}
+
+// Returns true if [begin,end) is the lower case keyword key, ignoring case
+inline bool isKeyword(const char * begin, const char * end, const char * key)
+{
+    for (; begin != end && *key; ++begin, ++key)
+        if ( std::tolower(static_cast<unsigned char>(*begin)) != *key )
+            return false;
+    return begin == end && !*key;
+}
+
+}
+
 template<class T>
 gsFileData<T>::gsFileData()
 {
@@ -50,11 +72,11 @@ gsFileData<T>::gsFileData()
 }
 
 template<class T>
-gsFileData<T>::gsFileData(String const & fn)
+gsFileData<T>::gsFileData(String const & fn, bool lazy)
 {
     data = new FileData;
     data->makeRoot();
-    this->read(fn);
+    this->read(fn, lazy);
 }
 
 template<class T>
@@ -69,6 +91,7 @@ template<class T> void
 gsFileData<T>::clear()
 {
     data->clear();
+    m_index.close();
     data->makeRoot(); // ready to re-use
 }
 
@@ -77,6 +100,7 @@ template<class T>
 std::ostream & gsFileData<T>::print(std::ostream &os) const
 {
     //rapidxml::print_no_indenting
+    materializeAll();
     os<< *data;
     return os;
 }
@@ -97,6 +121,7 @@ gsFileData<T>::addComment(std::string const & message)
 template<class T> void
 gsFileData<T>::save(std::string const & fname, bool compress)  const
 {
+    materializeAll();
     gsXmlNode * comment = internal::makeComment("This file was created by G+Smo "
                                                 GISMO_VERSION, *data);
     data->prepend_node(comment);
@@ -126,6 +151,7 @@ gsFileData<T>::save(std::string const & fname, bool compress)  const
 template<class T> void
 gsFileData<T>::saveCompressed(std::string const & fname)  const
 {
+    materializeAll();
     String tmp = gsFileManager::getExtension(fname);
     if (tmp != "gz" )
     {
@@ -155,8 +181,15 @@ gsFileData<T>::ioError(int lineNumber, const std::string& str)
 }
 
 template<class T>
-bool gsFileData<T>::read(String const & fn)
+bool gsFileData<T>::read(String const & fn, bool lazy)
 {
+    // The readers of the other formats add to the present data, so the
+    // objects of a mapped file are parsed before its index is dropped
+    if ( m_index.isOpen() )
+    {
+        m_index.materializeAll(*data);
+        m_index.clearEntries();
+    }
 
     m_lastPath = gsFileManager::find(fn);
     if ( m_lastPath.empty() )
@@ -170,7 +203,7 @@ bool gsFileData<T>::read(String const & fn)
     String ext = gsFileManager::getExtension(fn);
 
     if (ext== "xml")
-        return readXmlFile(m_lastPath);
+        return lazy ? readXmlFileLazy(m_lastPath) : readXmlFile(m_lastPath);
     else if (ext== "gz" && util::ends_with(m_lastPath, ".xml.gz") )
         return readXmlGzFile(m_lastPath);
     else if (ext== "txt")
@@ -233,6 +266,24 @@ bool gsFileData<T>::readXmlFile( String const & fn )
     return readGismoXmlStream(file);
 }
 
+template<class T>
+bool gsFileData<T>::readXmlFileLazy( String const & fn )
+{
+    data->clear();
+    if ( m_index.open(fn) )
+    {
+        data->makeRoot();
+        gsXmlNode * root = data->getRoot();
+        const internal::gsXmlIndex::attributes & attrs = m_index.rootAttributes();
+        for (size_t i = 0; i != attrs.size(); ++i)
+            root->append_attribute( internal::makeAttribute(attrs[i].first, attrs[i].second, *data) );
+        return true;
+    }
+
+    // The file cannot be mapped, read it as a whole
+    return readXmlFile(fn);
+}
+
 template<class T>
 bool gsFileData<T>::readXmlGzFile( String const & fn )
 {
@@ -253,6 +304,7 @@ bool gsFileData<T>::readGismoXmlStream(std::istream & is)
         std::istreambuf_iterator<char>() );
     buffer.push_back('\0');
     m_buffer.swap(buffer);
+    m_index.close();
 
     // Load file contents
     data->parse<0>(&m_buffer[0]);
@@ -1146,49 +1198,39 @@ template<class T>
 bool gsFileData<T>::readOffFile( String const & fn )
 {
     //Input file
-    std::ifstream file(fn.c_str(),std::ios::in);
-    if ( !file.good() )
+    gsMappedFile file;
+    if ( !file.open(fn) )
     { gsWarn<<"gsFileData: Problem with file "<<fn<<": Cannot open file stream.\n"; return false; }
 
     gsXmlNode* g = internal::makeNode("Mesh", *data);
     g->append_attribute( internal::makeAttribute("type", "off", *data) );
     data->appendToRoot(g);
 
-    String line;
-    std::istringstream lnstream;
-    lnstream.unsetf(std::ios_base::skipws);
-    std::ostringstream tmp;
-
-    getline(file, line);
-    if ( line.compare(0,3,"OFF") != 0)
+    const char * line = file.data(), * end = file.end();
+    if ( file.size() < 3 || strncmp(line, "OFF", 3) != 0 )
         return false;
+    line = internal::nextLine(line, end);
 
-    getline(file, line);
-    int nverts, nfaces, nedges(0);
-    lnstream.str(line);
-    lnstream >> std::ws >>  nverts >>
-        std::ws >> nfaces >>
-        std::ws >> nedges ;
+    int nverts(0), nfaces(0), nedges(0);
+    const char * eol = std::find(line, end, '\n');
+    gsGetInt(line, eol, nverts);
+    gsGetInt(line, eol, nfaces);
+    gsGetInt(line, eol, nedges);
+    line = internal::nextLine(eol, end);
 
     g->append_attribute( internal::makeAttribute("vertices", nverts, *data) );
     g->append_attribute( internal::makeAttribute("faces"   , nfaces, *data) );
     g->append_attribute( internal::makeAttribute("edges"   , nedges, *data) );
 
-    for (int i = 0; i < nverts; i++)
-        if ( getline(file, line) )
-            tmp << line.substr(0,line.size()) << std::endl;
+    // The vertex and the face lines are the value of the node
+    const char * start = line;
+    for (int i = 0; i < nverts + nfaces; i++)
+        if ( line != end )
+            line = internal::nextLine(line, end);
         else
             return false;
 
-    for (int i = 0; i < nfaces; i++)
-        if ( getline(file, line) )
-            tmp << line.substr(0,line.size()) << std::endl;
-        else
-            return false;
-
-    g->value( internal::makeValue( tmp.str(), *data) );
-    tmp.clear();
-
+    g->value( internal::makeValue(start, line, *data) );
     return true;
 }
 
@@ -1199,79 +1241,116 @@ bool gsFileData<T>::readStlFile( String const & fn )
 {
     bool solid(false),facet(false),loop(false);
     //Input file
-    std::ifstream file(fn.c_str(),std::ios::in);
-    if ( !file.good() )
+    gsMappedFile file;
+    if ( !file.open(fn) )
     { gsWarn<<"gsFileData: Problem with file "<<fn<<": Cannot open file stream.\n"; return false; }
 
     gsXmlNode* g = internal::makeNode("Mesh", *data);
     g->append_attribute( internal::makeAttribute("type", "off", *data) );
     data->appendToRoot(g);
 
-    std::ostringstream triangles;
-    triangles.unsetf(std::ios_base::skipws);
-    std::ostringstream vertices;
-    vertices.unsetf(std::ios_base::skipws);
+    std::string vertices, triangles;
     unsigned nvert(0), nfaces(0), tmp(0);
-
-    unsigned lineNumber(0);
-    std::string str;
-
-    while( !file.eof() && getline(file, str) )
+    char buf[96];
+
+    // Binary file: 80 bytes header, number of triangles (uint32) and
+    // 50 bytes per triangle: normal, three vertices (float32) and
+    // attribute (uint16), all little endian
+    const unsigned char * b = reinterpret_cast<const unsigned char*>(file.data());
+    const size_t ntri = ( file.size() < 84 ? 0 :
+                          b[80] | b[81] << 8 | b[82] << 16 | static_cast<size_t>(b[83]) << 24 );
+    if ( file.size() >= 84 && file.size() == 84 + 50 * ntri )
     {
-        std::transform(str.begin(),str.end(),str.begin(),::tolower);
-        if(str.find("solid")!=String::npos && str.find("endsolid")==String::npos)
-        {
-            if(solid) ioError(lineNumber,"startSolid");
-            solid=true;
-        }
-        else if(str.find("endsolid")!=String::npos)
+        // Copy the vertices of each triangle at once
+        std::vector<float> xyz(9 * ntri);
+        for (size_t t = 0; t != ntri; ++t)
+            std::memcpy(&xyz[9*t], file.data() + 84 + 50*t + 12, 9 * sizeof(float));
+        const uint16_t one = 1;
+        if ( 1 != *reinterpret_cast<const unsigned char*>(&one) ) // big endian
         {
-            if(!solid || facet || loop) ioError(lineNumber,"endSolid");
-            solid=false;
+            char * c = reinterpret_cast<char*>(xyz.data());
+            for (size_t i = 0; i != xyz.size(); ++i, c += sizeof(float))
+                std::reverse(c, c + sizeof(float));
         }
-        else if(str.find("facet")!=String::npos && str.find("endfacet")==String::npos)
-        {
-            if(!solid || facet || loop) ioError(lineNumber,"startFacet");
-            facet=true;
-        }
-        else if(str.find("endfacet")!=String::npos)
-        {
-            if(!solid || !facet || loop) ioError(lineNumber,"endFacet");
-            facet=false;
-        }
-        else if(str.find("outer")!=String::npos)
-        {
-            if(!solid || !facet || loop) ioError(lineNumber,"startLoop");
-            loop=true;
-        }
-        else if(str.find("endloop")!=String::npos)
-        {
-            if(!solid || !facet || !loop )
-                ioError(lineNumber,"endLoop");
-            triangles<< tmp;
-            for (unsigned i= nvert-tmp; i!=nvert; ++i)
-                triangles<<" "<< i;
-            triangles<<"\n";
-            nfaces++;
-            loop=false;
-            tmp = 0;
-        }
-        else if(str.find("vertex")!=String::npos)
+
+        // The coordinates are stored as binary payload; every three
+        // consecutive vertices form a triangle
+        internal::putBinaryValue(g, reinterpret_cast<const char*>(xyz.data()),
+                                 xyz.size() * sizeof(float), sizeof(float), *data);
+        g->append_attribute( internal::makeAttribute("vertices", static_cast<unsigned>(3 * ntri), *data) );
+        g->append_attribute( internal::makeAttribute("faces"   , static_cast<unsigned>(ntri), *data) );
+        return true;
+    }
+    else
+    {
+        const char * end = file.end();
+        unsigned lineNumber(1);
+        for (const char * line = file.data(); line != end;
+             line = internal::nextLine(line, end), ++lineNumber)
         {
-            if(!solid || !facet || !loop )
-                ioError(lineNumber,"vertex");
-            tmp++;
-            nvert++;
-            size_t pos=str.rfind("vertex")+7;
-            assert(pos!=String::npos);
-            vertices << str.substr(pos, str.size()-pos) <<"\n";
+            // The keyword is the first word of the line
+            const char * eol = std::find(line, end, '\n');
+            const char * key = line;
+            while ( key != eol && std::isspace(static_cast<unsigned char>(*key)) )
+                ++key;
+            line = key;
+            while ( line != eol && !std::isspace(static_cast<unsigned char>(*line)) )
+                ++line;
+
+            if ( internal::isKeyword(key, line, "solid") )
+            {
+                if(solid) ioError(lineNumber,"startSolid");
+                solid=true;
+            }
+            else if ( internal::isKeyword(key, line, "endsolid") )
+            {
+                if(!solid || facet || loop) ioError(lineNumber,"endSolid");
+                solid=false;
+            }
+            else if ( internal::isKeyword(key, line, "facet") )
+            {
+                if(!solid || facet || loop) ioError(lineNumber,"startFacet");
+                facet=true;
+            }
+            else if ( internal::isKeyword(key, line, "endfacet") )
+            {
+                if(!solid || !facet || loop) ioError(lineNumber,"endFacet");
+                facet=false;
+            }
+            else if ( internal::isKeyword(key, line, "outer") )
+            {
+                if(!solid || !facet || loop) ioError(lineNumber,"startLoop");
+                loop=true;
+            }
+            else if ( internal::isKeyword(key, line, "endloop") )
+            {
+                if(!solid || !facet || !loop )
+                    ioError(lineNumber,"endLoop");
+                triangles.append(buf, sprintf(buf, "%u", tmp));
+                for (unsigned i= nvert-tmp; i!=nvert; ++i)
+                    triangles.append(buf, sprintf(buf, " %u", i));
+                triangles += '\n';
+                nfaces++;
+                loop=false;
+                tmp = 0;
+            }
+            else if ( internal::isKeyword(key, line, "vertex") )
+            {
+                if(!solid || !facet || !loop )
+                    ioError(lineNumber,"vertex");
+                tmp++;
+                nvert++;
+                vertices.append(line, eol);
+                vertices += '\n';
+            }
+            line = eol;
         }
     }
 
     g->append_attribute( internal::makeAttribute("vertices", nvert,  *data) );
     g->append_attribute( internal::makeAttribute("faces"   , nfaces, *data) );
-    vertices << triangles.str() ;
-    g->value( internal::makeValue( vertices.str(), *data) );
+    vertices += triangles;
+    g->value( internal::makeValue( vertices, *data) );
 
     return true;
 }
@@ -1787,24 +1866,27 @@ bool gsFileData<T>::readParasolidFile( String const & fn )
 template<class T>
 bool gsFileData<T>::readCsvFile( String const & fn )
 {
-    std::ifstream indata;
-    indata.open(fn.c_str());
-    std::string cell, line, mstr;
+    gsMappedFile file;
+    if ( !file.open(fn) )
+    { gsWarn<<"gsFileData: Problem with file "<<fn<<": Cannot open file stream.\n"; return false; }
+
+    // The cells are the entries of the matrix, in row major order
+    const char * end = file.end();
     index_t rows = 0, nv = 0;
-    std::istringstream lnstream;
-    lnstream.unsetf(std::ios_base::skipws);
-    while (std::getline(indata, line))
+    for (const char * line = file.data(); line != end;
+         line = internal::nextLine(line, end), ++rows)
     {
-        lnstream.clear();
-        lnstream.str(line);
-        while (std::getline(lnstream, cell, ','))
-        {
-            ++nv;
-            mstr += cell + " ";
-        }
-        ++rows;
+        const char * eol = std::find(line, end, '\n');
+        // An empty line or a trailing comma add no cell
+        if ( eol != line )
+            nv += std::count(line, eol, ',') + ( ',' != eol[-1] );
+        line = eol;
     }
-    gsXmlNode * nd =  internal::makeNode("Matrix", mstr, *data);
+    char * mstr = internal::makeValue(file.data(), end, *data);
+    std::replace(mstr, mstr + file.size(), ',', ' ');
+
+    gsXmlNode * nd =  internal::makeNode("Matrix", *data);
+    nd->value(mstr, file.size());
     nd->append_attribute( internal::makeAttribute("format","ascii",*data) );
     nd->append_attribute( internal::makeAttribute("rows",rows,*data) );
     nd->append_attribute( internal::makeAttribute("cols",nv/rows,*data) );
@@ -1818,6 +1900,7 @@ std::string
 gsFileData<T>::contents () const
 {
     std::ostringstream os;
+    materializeAll();
     os << "--- \n";
     int i(1);
     for (gsXmlNode * child = data->first_node("xml")->first_node();
@@ -1836,6 +1919,7 @@ gsFileData<T>::contents () const
 template<class T> inline
 int gsFileData<T>::numTags() const
 {
+    materializeAll();
     int i(0);
     for (gsXmlNode * child = data->first_node("xml")->first_node() ;
          child; child = child->next_sibling() )
@@ -1850,6 +1934,14 @@ gsFileData<T>::getXmlRoot() const
     return data->getRoot();
 }
 
+template<class T>
+void gsFileData<T>::materializeId(const int id) const
+{
+    const size_t k = m_index.findId(id);
+    if ( k != m_index.size() )
+        m_index.materialize(k, *data);
+}
+
 template<class T> inline
 void gsFileData<T>::deleteXmlSubtree(gsXmlNode * node)
 {
@@ -1870,6 +1962,15 @@ gsFileData<T>::getFirstNode(const std::string & name, const std::string & type)
         assert( root ) ;
     }
 
+    // Parse the first matching object of a lazily read file. If there
+    // is none, an added object may still match.
+    if ( m_index.isOpen() )
+    {
+        const size_t k = m_index.find(name, type);
+        if ( k != m_index.size() )
+            return m_index.materialize(k, *data);
+    }
+
     if ( type == "" )
         return root->first_node( name.c_str() );
     else
@@ -1888,49 +1989,64 @@ gsFileData<T>::getAnyFirstNode(const std::string & name, const std::string & typ
 {
     gsXmlNode * root = data->first_node("xml");
     assert( root ) ;
+
+    // Parse only the objects of a lazily read file which may contain
+    // the tag
+    if ( m_index.isOpen() )
+        for (size_t k = 0; k != m_index.size(); ++k)
+            if ( m_index.mayContain(k, name) )
+                if ( gsXmlNode * node = getAnyNode(m_index.materialize(k, *data), name, type) )
+                    return node;
+
+    for (gsXmlNode * child = root->first_node() ;
+         child; child = child->next_sibling() )
+        if ( gsXmlNode * node = getAnyNode(child, name, type) )
+            return node;
+    return NULL;
+}
+
+template<class T> inline
+typename gsFileData<T>::gsXmlNode *
+gsFileData<T>::getAnyNode(gsXmlNode * node, const std::string & name,
+                          const std::string & type)
+{
     if ( type == "" )
-        // Searching up to third level of the XML tree
-        for (gsXmlNode * child = root->first_node() ;
-             child; child = child->next_sibling() )
+    {
+        if (!strcmp( node->name(), name.c_str() ) )
+            return node;
+        // Level 2
+        for (gsXmlNode * child2 = node->first_node() ;
+             child2; child2 = child2->next_sibling() )
         {
-            if (!strcmp( child->name(), name.c_str() ) )
-                return child;
-            // Level 2
-            for (gsXmlNode * child2 = child->first_node() ;
-                 child2; child2 = child2->next_sibling() )
-            {
-                if ( !strcmp( child2->name(), name.c_str() ) )
-                    return child2;
-                // Level 3
-                for (gsXmlNode * child3 = child2->first_node() ;
-                     child3; child3 = child3->next_sibling() )
-                    if ( !strcmp( child3->name(), name.c_str() ) )
-                        return child3;
-            }
+            if ( !strcmp( child2->name(), name.c_str() ) )
+                return child2;
+            // Level 3
+            for (gsXmlNode * child3 = child2->first_node() ;
+                 child3; child3 = child3->next_sibling() )
+                if ( !strcmp( child3->name(), name.c_str() ) )
+                    return child3;
         }
+    }
     else
-        // Searching up to third level of the XML tree
-        for (gsXmlNode * child = root->first_node() ;
-             child; child = child->next_sibling() )
+    {
+        if (!strcmp( node->name(), name.c_str() ) &&
+            !strcmp( node->first_attribute("type")->value(), type.c_str() ) )
+            return node;
+        // Level 2
+        for (gsXmlNode * child2 = node->first_node() ;
+             child2; child2 = child2->next_sibling() )
         {
-            if (!strcmp( child->name(), name.c_str() ) &&
-                !strcmp( child->first_attribute("type")->value(), type.c_str() ) )
-                return child;
-            // Level 2
-            for (gsXmlNode * child2 = child->first_node() ;
-                 child2; child2 = child2->next_sibling() )
-            {
-                if ( !strcmp( child2->name(), name.c_str() ) &&
-                     !strcmp( child2->first_attribute("type")->value(), type.c_str() ))
-                    return child2;
-                // Level 3
-                for (gsXmlNode * child3 = child2->first_node() ;
-                     child3; child3 = child3->next_sibling() )
-                    if ( !strcmp( child3->name(), name.c_str() ) &&
-                         !strcmp( child3->first_attribute("type")->value(), type.c_str()))
-                        return child3;
-            }
+            if ( !strcmp( child2->name(), name.c_str() ) &&
+                 !strcmp( child2->first_attribute("type")->value(), type.c_str() ))
+                return child2;
+            // Level 3
+            for (gsXmlNode * child3 = child2->first_node() ;
+                 child3; child3 = child3->next_sibling() )
+                if ( !strcmp( child3->name(), name.c_str() ) &&
+                     !strcmp( child3->first_attribute("type")->value(), type.c_str()))
+                    return child3;
         }
+    }
     return NULL;
 }
 
@@ -0,0 +1,89 @@
+/** @file gsMappedFile.cpp
+
+    @brief Provides a file mapped into memory.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gsIO/gsMappedFile.h>
+
+#if defined _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace gismo
+{
+
+void gsMappedFile::close()
+{
+    if ( !m_data )
+        return;
+#if defined _WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle(static_cast<HANDLE>(m_mapping));
+    CloseHandle(static_cast<HANDLE>(m_file));
+#else
+    munmap(m_data, m_size);
+#endif
+    m_data = NULL;
+    m_size = 0;
+    m_file = m_mapping = NULL;
+}
+
+bool gsMappedFile::open(const std::string & fn)
+{
+    close();
+
+#if defined _WIN32
+    HANDLE file = CreateFileA(fn.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if ( INVALID_HANDLE_VALUE == file )
+        return false;
+    LARGE_INTEGER fsize;
+    if ( !GetFileSizeEx(file, &fsize) || 0 == fsize.QuadPart )
+    {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    void * addr = mapping ? MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0) : NULL;
+    if ( !addr )
+    {
+        if ( mapping )
+            CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    m_file    = file;
+    m_mapping = mapping;
+    m_size    = static_cast<size_t>(fsize.QuadPart);
+#else
+    const int fd = ::open(fn.c_str(), O_RDONLY);
+    if ( -1 == fd )
+        return false;
+    struct stat st;
+    if ( -1 == fstat(fd, &st) || 0 == st.st_size )
+    {
+        ::close(fd);
+        return false;
+    }
+    void * addr = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if ( MAP_FAILED == addr )
+        return false;
+    m_size = st.st_size;
+#endif
+    m_data = static_cast<char*>(addr);
+    return true;
+}
+
+} // namespace gismo
@@ -0,0 +1,73 @@
+/** @file gsMappedFile.h
+
+    @brief Provides a file mapped into memory.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsExport.h>
+
+#include <string>
+#include <cstddef>
+
+namespace gismo
+{
+
+/**
+   \brief A file mapped into memory
+
+   The mapping is private (copy-on-write): the data can be modified,
+   eg. by an in-place parser, but the changes are not written to the
+   file. Only the pages which are modified are copied.
+
+   \ingroup IO
+*/
+class GISMO_EXPORT gsMappedFile
+{
+public:
+
+    gsMappedFile() : m_data(NULL), m_size(0), m_file(NULL), m_mapping(NULL) { }
+
+    ~gsMappedFile() { close(); }
+
+    /// Maps the file \a fn. Returns false if the file cannot be
+    /// opened or mapped, or if it is empty.
+    bool open(const std::string & fn);
+
+    /// Unmaps the file
+    void close();
+
+    /// Returns true if a file is mapped
+    bool isOpen() const { return NULL != m_data; }
+
+    /// Returns the mapped data
+    char * data() const { return m_data; }
+
+    /// Returns the size of the file in bytes
+    size_t size() const { return m_size; }
+
+    /// Returns the end of the mapped data
+    char * end() const { return m_data + m_size; }
+
+private:
+
+    // Non-copyable
+    gsMappedFile(const gsMappedFile &);
+    gsMappedFile & operator=(const gsMappedFile &);
+
+private:
+
+    char * m_data;
+    size_t m_size;
+
+    /// Handles of the mapping on Windows
+    void * m_file, * m_mapping;
+};
+
+} // namespace gismo
@@ -0,0 +1,274 @@
+/** @file gsParaviewDataArrays.cpp
+
+    @brief Provides a helper class to write the data arrays of
+    Paraview files as text or as (compressed) binary data.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gsIO/gsParaviewDataArrays.h>
+
+#include <zlib/zlib.h>
+
+#include <iomanip>
+
+namespace gismo
+{
+
+namespace
+{
+gsParaviewFormat::format s_globalFormat = gsParaviewFormat::ascii;
+
+// Uncompressed size of the blocks in compressed mode
+const size_t s_blockSize = 32768;
+
+// Width of the offset attributes of streamed arrays
+const int s_offsetWidth = 20;
+
+inline void appendUInt64(std::string & out, uint64_t val)
+{
+    out.append(reinterpret_cast<const char*>(&val), sizeof(uint64_t));
+}
+
+inline void writeUInt64(std::ostream & os, uint64_t val)
+{
+    os.write(reinterpret_cast<const char*>(&val), sizeof(uint64_t));
+}
+
+// Compresses one block and appends it to \a out, returns the compressed size
+uint64_t compressBlock(const char * data, size_t len, std::string & out)
+{
+    std::vector<Bytef> buf( compressBound(len) );
+    uLongf clen = buf.size();
+    const int status = compress2(&buf[0], &clen, reinterpret_cast<const Bytef*>(data),
+                                 len, Z_DEFAULT_COMPRESSION);
+    GISMO_ENSURE(Z_OK == status, "Compression of Paraview data failed (zlib error "<< status <<").");
+    out.append(reinterpret_cast<const char*>(&buf[0]), clen);
+    return clen;
+}
+}
+
+void gsParaviewFormat::setGlobal(format fmt)
+{
+    GISMO_ENSURE(global != fmt, "The global Paraview format must be a specific format.");
+    s_globalFormat = fmt;
+}
+
+gsParaviewFormat::format gsParaviewFormat::getGlobal()
+{
+    return s_globalFormat;
+}
+
+gsParaviewDataArrays::gsParaviewDataArrays(gsParaviewFormat::format fmt)
+: m_format(gsParaviewFormat::resolve(fmt)), m_cur(0), m_started(false),
+  m_begin(0), m_header(0), m_written(0)
+{ }
+
+std::string gsParaviewDataArrays::fileAttributes() const
+{
+    std::string res(" byte_order=\"");
+    const uint16_t one = 1;
+    res += ( 1 == *reinterpret_cast<const unsigned char*>(&one) ? "LittleEndian\"" : "BigEndian\"" );
+    if ( gsParaviewFormat::ascii != m_format )
+        res += " header_type=\"UInt64\"";
+    if ( gsParaviewFormat::compressed == m_format )
+        res += " compressor=\"vtkZLibDataCompressor\"";
+    return res;
+}
+
+void gsParaviewDataArrays::write(std::ostream & os, const std::vector<index_t> & data,
+                                 const std::string & name)
+{
+    const char * type = ( 8 == sizeof(index_t) ? "Int64" : "Int32" );
+    beginArray(os, type, 1, name);
+    if ( gsParaviewFormat::ascii == m_format )
+    {
+        os <<">\n";
+        for ( std::vector<index_t>::const_iterator it = data.begin(); it!=data.end(); ++it)
+            os<< *it <<" ";
+        os <<"\n</DataArray>\n";
+        return;
+    }
+    append(os, reinterpret_cast<const char*>(data.data()), data.size() * sizeof(index_t));
+}
+
+void gsParaviewDataArrays::declareStream(std::ostream & os, index_t ncomp, size_t numTuples,
+                                         const std::string & name)
+{
+    streamInfo info;
+    info.ncomp = ncomp;
+    info.bytes = numTuples * ncomp * sizeof(float);
+    beginArray(os, "Float32", ncomp, name);
+    if ( gsParaviewFormat::ascii == m_format )
+    {
+        m_cur = m_streams.size();
+        os <<">\n";
+    }
+    else
+    {
+        // The offset is filled in when the data is written
+        os <<" offset=\"";
+        info.offsetPos = os.tellp();
+        os << std::string(s_offsetWidth, ' ') <<"\"/>\n";
+    }
+    m_streams.push_back(info);
+}
+
+void gsParaviewDataArrays::endStream(std::ostream & os)
+{
+    GISMO_ASSERT(m_cur < m_streams.size(), "No streamed array declared.");
+    if ( gsParaviewFormat::ascii == m_format )
+    {
+        os <<"\n</DataArray>\n";
+        ++m_cur;
+        return;
+    }
+
+    if ( !m_started )
+        startStream(os);
+    GISMO_ENSURE(m_written == m_streams[m_cur].bytes,
+                 "Streamed array has "<< m_written <<" bytes instead of "<< m_streams[m_cur].bytes);
+
+    if ( gsParaviewFormat::compressed == m_format )
+    {
+        std::string out;
+        if ( !m_block.empty() )
+            m_csizes.push_back( compressBlock(m_block.data(), m_block.size(), out) );
+        os.write(out.data(), out.size());
+        m_block.clear();
+
+        // Fill in the compressed sizes of the blocks
+        const std::streamoff end = os.tellp();
+        os.seekp(m_header);
+        for ( size_t b = 0; b != m_csizes.size(); ++b )
+            writeUInt64(os, m_csizes[b]);
+        os.seekp(end);
+    }
+    m_started = false;
+    ++m_cur;
+}
+
+void gsParaviewDataArrays::beginAppended(std::ostream & os)
+{
+    if ( gsParaviewFormat::ascii == m_format )
+        return;
+    os <<"<AppendedData encoding=\"raw\">\n_";
+    m_begin = os.tellp();
+    os.write(m_appended.data(), m_appended.size());
+    m_appended.clear();
+    m_cur = 0;
+}
+
+void gsParaviewDataArrays::endAppended(std::ostream & os)
+{
+    if ( gsParaviewFormat::ascii == m_format )
+        return;
+    GISMO_ENSURE(m_cur == m_streams.size(), "Not all streamed arrays were written.");
+    os <<"\n</AppendedData>\n";
+    m_streams.clear();
+    m_cur = 0;
+}
+
+void gsParaviewDataArrays::beginArray(std::ostream & os, const char * type, index_t ncomp,
+                                      const std::string & name) const
+{
+    os <<"<DataArray type=\""<< type <<"\"";
+    if ( !name.empty() )
+        os <<" Name=\""<< name <<"\"";
+    if ( ncomp > 1 )
+        os <<" NumberOfComponents=\""<< ncomp <<"\"";
+    os <<" format=\""<< ( gsParaviewFormat::ascii == m_format ? "ascii" : "appended" ) <<"\"";
+}
+
+void gsParaviewDataArrays::append(std::ostream & os, const char * data, size_t bytes)
+{
+    os <<" offset=\""<< m_appended.size() <<"\"/>\n";
+
+    if ( gsParaviewFormat::binary == m_format )
+    {
+        appendUInt64(m_appended, bytes);
+        m_appended.append(data, bytes);
+        return;
+    }
+
+    // Header: number of blocks, block size, size of the last block
+    // (0 if it is full), compressed sizes of the blocks
+    const size_t nBlocks = ( bytes + s_blockSize - 1 ) / s_blockSize;
+    const size_t header = m_appended.size();
+    appendUInt64(m_appended, nBlocks);
+    appendUInt64(m_appended, s_blockSize);
+    appendUInt64(m_appended, bytes % s_blockSize);
+    m_appended.append(nBlocks * sizeof(uint64_t), '\0');
+
+    for ( size_t b = 0; b != nBlocks; ++b )
+    {
+        const size_t len = math::min(s_blockSize, bytes - b * s_blockSize);
+        const uint64_t csize = compressBlock(data + b * s_blockSize, len, m_appended);
+        m_appended.replace(header + (3 + b) * sizeof(uint64_t), sizeof(uint64_t),
+                           reinterpret_cast<const char*>(&csize), sizeof(uint64_t));
+    }
+}
+
+void gsParaviewDataArrays::startStream(std::ostream & os)
+{
+    GISMO_ASSERT(m_cur < m_streams.size(), "No streamed array declared.");
+    const streamInfo & info = m_streams[m_cur];
+
+    // Fill in the offset of the array
+    const std::streamoff start = os.tellp();
+    os.seekp(info.offsetPos);
+    os << std::setw(s_offsetWidth) << (start - m_begin);
+    os.seekp(start);
+
+    if ( gsParaviewFormat::binary == m_format )
+        writeUInt64(os, info.bytes);
+    else
+    {
+        const size_t nBlocks = ( info.bytes + s_blockSize - 1 ) / s_blockSize;
+        writeUInt64(os, nBlocks);
+        writeUInt64(os, s_blockSize);
+        writeUInt64(os, info.bytes % s_blockSize);
+        m_header = os.tellp();
+        for ( size_t b = 0; b != nBlocks; ++b )
+            writeUInt64(os, 0);
+        m_csizes.clear();
+        m_block.clear();
+    }
+    m_written = 0;
+    m_started = true;
+}
+
+void gsParaviewDataArrays::streamBytes(std::ostream & os, const char * data, size_t bytes)
+{
+    if ( !m_started )
+        startStream(os);
+    m_written += bytes;
+
+    if ( gsParaviewFormat::binary == m_format )
+    {
+        os.write(data, bytes);
+        return;
+    }
+
+    // Compress every full block
+    std::string out;
+    while ( bytes != 0 )
+    {
+        const size_t len = math::min(bytes, s_blockSize - m_block.size());
+        m_block.append(data, len);
+        data  += len;
+        bytes -= len;
+        if ( s_blockSize == m_block.size() )
+        {
+            m_csizes.push_back( compressBlock(m_block.data(), s_blockSize, out) );
+            m_block.clear();
+        }
+    }
+    os.write(out.data(), out.size());
+}
+
+} // namespace gismo
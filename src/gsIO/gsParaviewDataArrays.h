@@ -0,0 +1,228 @@
+/** @file gsParaviewDataArrays.h
+
+    @brief Provides a helper class to write the data arrays of
+    Paraview files as text or as (compressed) binary data.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+#include <gsCore/gsExport.h>
+
+namespace gismo
+{
+
+/**
+    \brief Formats of the data arrays in the files written by gsWriteParaview
+
+    The format is chosen per call by the last argument of the writers,
+    which defaults to gsParaviewFormat::global, the format set by
+    setGlobal(). The initial global format is text.
+
+    \ingroup IO
+*/
+struct GISMO_EXPORT gsParaviewFormat
+{
+    enum format
+    {
+        global     = -1, ///< The format set by gsParaviewFormat::setGlobal()
+        ascii      =  0, ///< Data as text inside the XML elements
+        binary     =  1, ///< Raw binary data appended to the file
+        compressed =  2  ///< Binary data compressed by zlib, appended to the file
+    };
+
+    /// Sets the format used by the writers called with gsParaviewFormat::global
+    static void setGlobal(format fmt);
+
+    /// Returns the format used by the writers called with gsParaviewFormat::global
+    static format getGlobal();
+
+    /// Returns \a fmt, or the global format if \a fmt is gsParaviewFormat::global
+    static format resolve(format fmt) { return global == fmt ? getGlobal() : fmt; }
+};
+
+/**
+    \brief Writes the data arrays of a VTK XML file.
+
+    In text mode, the arrays are written in place. In the binary
+    modes, the DataArray elements only refer to an offset in the
+    AppendedData element, which is written by writeAppended() after
+    the dataset element has been closed. The compressed blocks are
+    decoded by vtkZLibDataCompressor. The root element has to carry
+    the attributes returned by fileAttributes().
+
+    Typical usage is
+    \verbatim
+    gsParaviewDataArrays data(fmt);
+    file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\""<< data.fileAttributes() <<">\n";
+    ...
+    data.write(file, points, 3);
+    ...
+    file <<"</StructuredGrid>\n";
+    data.writeAppended(file);
+    file <<"</VTKFile>\n";
+    \endverbatim
+
+    Float32 arrays of known size can also be streamed in chunks, so
+    that they never have to be kept in memory as a whole:
+    declareStream() writes the DataArray element, stream() passes the
+    values and endStream() completes the array. In text mode, these
+    calls have to follow declareStream() directly. In the binary
+    modes, they are made between beginAppended() and endAppended(),
+    in the order in which the arrays were declared; the output stream
+    has to be seekable, since the offsets and the sizes of the
+    compressed blocks are filled in afterwards. streamsInPlace()
+    tells which of the two cases applies.
+
+    \ingroup IO
+*/
+class GISMO_EXPORT gsParaviewDataArrays
+{
+public:
+
+    /// Constructor using the format \a fmt
+    explicit gsParaviewDataArrays(gsParaviewFormat::format fmt = gsParaviewFormat::global);
+
+    /// Returns the format of the arrays
+    gsParaviewFormat::format format() const { return m_format; }
+
+    /// Returns the attributes of the VTKFile element (with a leading space)
+    std::string fileAttributes() const;
+
+    /// Writes a Float32 array with \a ncomp components per point. The
+    /// columns of \a data are the points, missing components are
+    /// written as zeros.
+    template<class T>
+    void write(std::ostream & os, const gsMatrix<T> & data, index_t ncomp,
+               const std::string & name = "")
+    {
+        const index_t nr = math::min(ncomp, data.rows());
+        if ( gsParaviewFormat::ascii == m_format )
+        {
+            beginArray(os, "Float32", ncomp, name);
+            os <<">\n";
+            for ( index_t j=0; j<data.cols(); ++j)
+            {
+                for ( index_t i=0; i!=nr; ++i)
+                    os<< data(i,j) <<" ";
+                for ( index_t i=nr; i<ncomp; ++i)
+                    os<<"0 ";
+            }
+            os <<"\n</DataArray>\n";
+            return;
+        }
+
+        std::vector<float> buf(data.cols() * ncomp, 0.0f);
+        for ( index_t j=0; j<data.cols(); ++j)
+            for ( index_t i=0; i!=nr; ++i)
+                buf[j*ncomp+i] = static_cast<float>(data(i,j));
+        beginArray(os, "Float32", ncomp, name);
+        append(os, reinterpret_cast<const char*>(buf.data()), buf.size() * sizeof(float));
+    }
+
+    /// Writes an integer array with one component, eg. connectivity or offsets
+    void write(std::ostream & os, const std::vector<index_t> & data,
+               const std::string & name = "");
+
+    /// Writes the AppendedData element in the binary modes; does
+    /// nothing in text mode
+    void writeAppended(std::ostream & os)
+    {
+        beginAppended(os);
+        endAppended(os);
+    }
+
+    /// Writes the DataArray element of a streamed Float32 array with
+    /// \a numTuples tuples of \a ncomp components
+    void declareStream(std::ostream & os, index_t ncomp, size_t numTuples,
+                       const std::string & name = "");
+
+    /// Returns true if the values of streamed arrays follow their
+    /// declaration, and false if they follow beginAppended()
+    bool streamsInPlace() const { return gsParaviewFormat::ascii == m_format; }
+
+    /// Writes the next chunk of values of the current streamed
+    /// array. The columns of \a data are tuples, missing components
+    /// are written as zeros.
+    template<class T>
+    void stream(std::ostream & os, const gsMatrix<T> & data)
+    {
+        GISMO_ASSERT(m_cur < m_streams.size(), "No streamed array declared.");
+        const index_t ncomp = m_streams[m_cur].ncomp;
+        const index_t nr = math::min(ncomp, data.rows());
+        if ( gsParaviewFormat::ascii == m_format )
+        {
+            for ( index_t j=0; j<data.cols(); ++j)
+            {
+                for ( index_t i=0; i!=nr; ++i)
+                    os<< data(i,j) <<" ";
+                for ( index_t i=nr; i<ncomp; ++i)
+                    os<<"0 ";
+            }
+            return;
+        }
+
+        std::vector<float> buf(data.cols() * ncomp, 0.0f);
+        for ( index_t j=0; j<data.cols(); ++j)
+            for ( index_t i=0; i!=nr; ++i)
+                buf[j*ncomp+i] = static_cast<float>(data(i,j));
+        streamBytes(os, reinterpret_cast<const char*>(buf.data()), buf.size() * sizeof(float));
+    }
+
+    /// Completes the current streamed array
+    void endStream(std::ostream & os);
+
+    /// Starts the AppendedData element, writing the arrays passed to
+    /// write(); does nothing in text mode
+    void beginAppended(std::ostream & os);
+
+    /// Ends the AppendedData element; does nothing in text mode
+    void endAppended(std::ostream & os);
+
+private:
+
+    void beginArray(std::ostream & os, const char * type, index_t ncomp,
+                    const std::string & name) const;
+
+    /// Ends the DataArray element and stores the data for writeAppended()
+    void append(std::ostream & os, const char * data, size_t bytes);
+
+    /// Writes bytes of the current streamed array to the appended data
+    void streamBytes(std::ostream & os, const char * data, size_t bytes);
+
+    /// Writes the header of the current streamed array and fills in its offset
+    void startStream(std::ostream & os);
+
+private:
+
+    gsParaviewFormat::format m_format;
+
+    /// Encoded arrays, including their headers
+    std::string m_appended;
+
+    struct streamInfo
+    {
+        index_t ncomp;
+        size_t  bytes;
+        std::streamoff offsetPos; ///< Position of the offset attribute
+    };
+
+    /// Declared streamed arrays and the index of the current one
+    std::vector<streamInfo> m_streams;
+    size_t m_cur;
+
+    /// State of the current streamed array in the binary modes
+    bool m_started;
+    std::streamoff m_begin, m_header;
+    size_t m_written;
+    std::string m_block;
+    std::vector<uint64_t> m_csizes;
+};
+
+} // namespace gismo
@@ -14,6 +14,7 @@
 #include <gsCore/gsGeometry.h>
 #include <gsCore/gsForwardDeclarations.h>
 #include <gsCore/gsExport.h>
+#include <gsIO/gsParaviewDataArrays.h>
 
 #include <sstream>
 #include <fstream>
@@ -33,19 +34,23 @@ namespace gismo {
 /// \param npts number of points used for sampling each patch
 /// \param mesh if true, the parameter mesh is plotted as well
 /// \param ctrlNet if true, the control net is plotted as well
+/// \param fmt format of the data arrays, see gsParaviewFormat
 ///
 /// \ingroup IO
 template<class T>
 void gsWriteParaview(const gsGeometry<T> & Geo, std::string const & fn, 
-                     unsigned npts=NS, bool mesh = false, bool ctrlNet = false);
+                     unsigned npts=NS, bool mesh = false, bool ctrlNet = false,
+                     gsParaviewFormat::format fmt = gsParaviewFormat::global);
 
 /// \brief Export a mesh to paraview file
 ///
 /// \param sl a gsMesh object
 /// \param fn filename where paraview file is written
 /// \param pvd if true, a .pvd file is generated (for compatibility)
+/// \param fmt format of the data arrays, see gsParaviewFormat
 template <class T>
-void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd = true);
+void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd = true,
+                     gsParaviewFormat::format fmt = gsParaviewFormat::global);
 
 /// \brief Export a vector of meshes, each mesh in its own file.
 ///
@@ -61,9 +66,11 @@ void gsWriteParaview(const std::vector<gsMesh<T> >& meshes, std::string const& f
 /// \param fn filename where paraview file is written
 /// \param npts number of points used for sampling each patch
 /// \param mesh if true, the parameter mesh is plotted as well
+/// \param fmt format of the data arrays, see gsParaviewFormat
 template<class T>
 void gsWriteParaview(const gsField<T> & field, std::string const & fn, 
-                     unsigned npts=NS, bool mesh = false);
+                     unsigned npts=NS, bool mesh = false,
+                     gsParaviewFormat::format fmt = gsParaviewFormat::global);
 
 /// \brief Export a multipatch Geometry (without scalar information) to paraview file
 ///
@@ -72,11 +79,13 @@ void gsWriteParaview(const gsField<T> & field, std::string const & fn,
 /// \param npts number of points used for sampling each patch
 /// \param mesh if true, the parameter mesh is plotted as well
 /// \param ctrlNet if true, the control net is plotted as well
+/// \param fmt format of the data arrays, see gsParaviewFormat
 template<class T>
 void gsWriteParaview(const gsMultiPatch<T> & Geo, std::string const & fn, 
-                     unsigned npts=NS, bool mesh = false, bool ctrlNet = false)
+                     unsigned npts=NS, bool mesh = false, bool ctrlNet = false,
+                     gsParaviewFormat::format fmt = gsParaviewFormat::global)
 {
-    gsWriteParaview( Geo.patches(), fn, npts, mesh, ctrlNet);
+    gsWriteParaview( Geo.patches(), fn, npts, mesh, ctrlNet, fmt);
 }
 
 /// \brief Export a multipatch Geometry (without scalar information) to paraview file
@@ -86,15 +95,18 @@ void gsWriteParaview(const gsMultiPatch<T> & Geo, std::string const & fn,
 /// \param npts number of points used for sampling each geometry
 /// \param mesh if true, the parameter mesh is plotted as well
 /// \param ctrlNet if true, the control net is plotted as well
+/// \param fmt format of the data arrays, see gsParaviewFormat
 template<class T>
 void gsWriteParaview( std::vector<gsGeometry<T> *> const & Geo, 
                       std::string const & fn, unsigned npts=NS,
-                      bool mesh = false, bool ctrlNet = false);
+                      bool mesh = false, bool ctrlNet = false,
+                      gsParaviewFormat::format fmt = gsParaviewFormat::global);
 
 /// \brief Export a computational mesh to paraview file
 template<class T>
 void gsWriteParaview(const gsMultiBasis<T> & mb, const gsMultiPatch<T> & domain,
-                     std::string const & fn, unsigned npts);
+                     std::string const & fn, unsigned npts,
+                     gsParaviewFormat::format fmt = gsParaviewFormat::global);
 
 /// \brief Export a composite Geometry to paraview file
 ///
@@ -190,11 +202,13 @@ void gsWriteParaviewPoints(gsMatrix<T> const& points, std::string const & fn);
 /// \param data
 /// \param np
 /// \param fn filename where paraview file is written
+/// \param fmt format of the data arrays, see gsParaviewFormat
 template<class T>
 void gsWriteParaviewTPgrid(gsMatrix<T> const& points,
                            gsMatrix<T> const& data,
                            const gsVector<index_t> & np,
-                           std::string const & fn);
+                           std::string const & fn,
+                           gsParaviewFormat::format fmt = gsParaviewFormat::global);
 
 /// \brief Depicting edge graph of each volume of one gsSolid with a segmenting loop
 ///
@@ -282,7 +296,8 @@ template<class T>
 void writeSinglePatchField(const gsFunction<T> & geometry,
                            const gsFunction<T> & parField,
                            const bool isParam,
-                           std::string const & fn, unsigned npts);
+                           std::string const & fn, unsigned npts,
+                           gsParaviewFormat::format fmt = gsParaviewFormat::global);
 
 // Please document
 template <class T>
@@ -16,12 +16,14 @@
 
 #include <gsIO/gsWriteParaview.h>
 #include <gsIO/gsParaviewCollection.h>
+#include <gsIO/gsParaviewDataArrays.h>
 #include <gsIO/gsIOUtils.h>
 
 #include <gsCore/gsGeometry.h>
 #include <gsCore/gsGeometrySlice.h>
 #include <gsCore/gsField.h>
 #include <gsCore/gsDebug.h>
+#include <gsTensor/gsGridIterator.h>
 
 #include <gsModeling/gsTrimSurface.h>
 #include <gsModeling/gsSolid.h>
@@ -229,7 +231,8 @@ void writeSingleBasisMesh(const gsBasis<T> & basis,
 /// Export a computational mesh
 template<class T>
 void writeSingleCompMesh(const gsBasis<T> & basis, const gsGeometry<T> & Geo,
-                         std::string const & fn, unsigned resolution = 8)
+                         std::string const & fn, unsigned resolution = 8,
+                         gsParaviewFormat::format fmt = gsParaviewFormat::global)
 {
     gsMesh<T> msh(basis, resolution);
     Geo.evaluateMesh(msh);
@@ -239,13 +242,14 @@ void writeSingleCompMesh(const gsBasis<T> & basis, const gsGeometry<T> & Geo,
     // else if ( basis.dim() == 2)
     //     writeSingleBasisMesh2D(msh,fn);
     // else
-        gsWriteParaview(msh, fn, false);
+        gsWriteParaview(msh, fn, false, fmt);
 }
 
 /// Export a control net
 template<class T>
 void writeSingleControlNet(const gsGeometry<T> & Geo,
-                           std::string const & fn)
+                           std::string const & fn,
+                           gsParaviewFormat::format fmt = gsParaviewFormat::global)
 {
     const int d = Geo.parDim();
     gsMesh<T> msh;
@@ -269,122 +273,167 @@ void writeSingleControlNet(const gsGeometry<T> & Geo,
         return;
     }
 
-    gsWriteParaview(msh, fn, false);
+    gsWriteParaview(msh, fn, false, fmt);
 }
 
 template<class T>
 void gsWriteParaviewTPgrid(const gsMatrix<T> & eval_geo  ,
                            const gsMatrix<T> & eval_field,
                            const gsVector<index_t> & np,
-                           std::string const & fn)
+                           std::string const & fn,
+                           gsParaviewFormat::format fmt)
 {
-    const int n = eval_geo.rows();
     GISMO_ASSERT(eval_geo.cols()==eval_field.cols()
                  && static_cast<index_t>(np.prod())==eval_geo.cols(),
                  "Data do not match");
 
     std::string mfn(fn);
     mfn.append(".vts");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::binary);
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
 
+    gsParaviewDataArrays data(fmt);
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\">\n";
+    file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\""<< data.fileAttributes() <<">\n";
     file <<"<StructuredGrid WholeExtent=\"0 "<< np(0)-1<<" 0 "<<np(1)-1<<" 0 "
          << (np.size()>2 ? np(2)-1 : 0) <<"\">\n";
     file <<"<Piece Extent=\"0 "<< np(0)-1<<" 0 "<<np(1)-1<<" 0 "
          << (np.size()>2 ? np(2)-1 : 0) <<"\">\n";
     file <<"<PointData "<< ( eval_field.rows()==1 ?"Scalars":"Vectors")<<"=\"SolutionField\">\n";
-    file <<"<DataArray type=\"Float32\" Name=\"SolutionField\" format=\"ascii\" NumberOfComponents=\""<< ( eval_field.rows()==1 ? 1 : 3) <<"\">\n";
-    if ( eval_field.rows()==1 )
-        for ( index_t j=0; j<eval_field.cols(); ++j)
-            file<< eval_field.at(j) <<" ";
-    else
-    {
-        for ( index_t j=0; j<eval_field.cols(); ++j)
-        {
-            for ( index_t i=0; i!=eval_field.rows(); ++i)
-                file<< eval_field(i,j) <<" ";
-            for ( index_t i=eval_field.rows(); i<3; ++i)
-                file<<"0 ";
-        }
-    }
-    file <<"</DataArray>\n";
+    data.write(file, eval_field, ( eval_field.rows()==1 ? 1 : 3), "SolutionField");
     file <<"</PointData>\n";
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\"3\">\n";
-    for ( index_t j=0; j<eval_geo.cols(); ++j)
-    {
-        for ( index_t i=0; i!=n; ++i)
-            file<< eval_geo(i,j) <<" ";
-        for ( index_t i=n; i<3; ++i)
-            file<<"0 ";
-    }
-    file <<"</DataArray>\n";
+    data.write(file, eval_geo, 3);
     file <<"</Points>\n";
     file <<"</Piece>\n";
     file <<"</StructuredGrid>\n";
+    data.writeAppended(file);
     file <<"</VTKFile>\n";
 
     file.close();
 }
 
+namespace internal
+{
+/// Streams the values of \a field, or the points of \a geometry if
+/// \a field is null, on the uniform grid given by \a a, \a b and
+/// \a np. The grid is sampled in chunks, so that only a chunk of
+/// points and values is kept in memory.
+template<class T>
+void streamPatchSamples(gsParaviewDataArrays & data, std::ostream & os,
+                        const gsFunction<T> & geometry, const gsFunction<T> * field,
+                        const bool isParam, const gsVector<T> & a,
+                        const gsVector<T> & b, const gsVector<index_t> & np)
+{
+    const index_t chunk = 4096;
+    const index_t numPts = np.prod();
+    gsGridIterator<T,CUBE> pt(a, b, np);
+    gsMatrix<T> pts, eval_geo, eval_field;
+    for ( index_t k = 0; k < numPts; k += chunk )
+    {
+        const index_t len = math::min(chunk, numPts - k);
+        pts.resize(a.size(), len);
+        for ( index_t c = 0; c != len; ++c, ++pt )
+            pts.col(c) = *pt;
+
+        if ( NULL == field )
+        {
+            geometry.eval_into(pts, eval_geo);
+            data.stream(os, eval_geo);
+        }
+        else if ( isParam )
+        {
+            field->eval_into(pts, eval_field);
+            data.stream(os, eval_field);
+        }
+        else
+        {
+            geometry.eval_into(pts, eval_geo);
+            field->eval_into(eval_geo, eval_field);
+            data.stream(os, eval_field);
+        }
+    }
+    data.endStream(os);
+}
+}
+
 template<class T>
 void writeSinglePatchField(const gsFunction<T> & geometry,
                            const gsFunction<T> & parField,
                            const bool isParam,
-                           std::string const & fn, unsigned npts)
+                           std::string const & fn, unsigned npts,
+                           gsParaviewFormat::format fmt)
 {
     const int n = geometry.targetDim();
     const int d = geometry.domainDim();
 
-    gsMatrix<T> ab = geometry.support();
-    gsVector<T> a = ab.col(0);
-    gsVector<T> b = ab.col(1);
-
-    gsVector<unsigned> np = uniformSampleCount(a, b, npts);
-    gsMatrix<T> pts = gsPointGrid(a, b, np);
-
-    gsMatrix<T> eval_geo = geometry.eval(pts);//pts
-    gsMatrix<T>  eval_field = isParam ? parField.eval(pts) : parField.eval(eval_geo);
-
-    if ( 3 - d > 0 )
-    {
-        np.conservativeResize(3);
-        np.bottomRows(3-d).setOnes();
-    }
-    else if (d > 3)
+    if (d > 3)
     {
         gsWarn<< "Cannot plot 4D data.\n";
         return;
     }
-
-    if ( 3 - n > 0 )
-    {
-        eval_geo.conservativeResize(3,eval_geo.cols() );
-        eval_geo.bottomRows(3-n).setZero();
-    }
     else if (n > 3)
     {
         gsWarn<< "Data is more than 3 dimensions.\n";
     }
 
-   if ( eval_field.rows() == 2)
+    gsMatrix<T> ab = geometry.support();
+    gsVector<T> a = ab.col(0);
+    gsVector<T> b = ab.col(1);
+
+    const gsVector<index_t> np = uniformSampleCount(a, b, npts).template cast<index_t>();
+    const index_t numPts = np.prod();
+    const index_t nf     = parField.targetDim();
+
+    std::string mfn(fn);
+    mfn.append(".vts");
+    std::ofstream file(mfn.c_str(), std::ios::binary);
+    if ( ! file.is_open() )
+        gsWarn<<"writeSinglePatchField: Problem opening file \""<<fn<<"\""<<std::endl;
+    file << std::fixed; // no exponents
+    file << std::setprecision (PLOT_PRECISION);
+
+    // The values and the points are streamed while sampling, either
+    // in place or as appended data
+    gsParaviewDataArrays data(fmt);
+    file <<"<?xml version=\"1.0\"?>\n";
+    file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\""<< data.fileAttributes() <<">\n";
+    file <<"<StructuredGrid WholeExtent=\"0 "<< np(0)-1<<" 0 "<< (d>1 ? np(1)-1 : 0) <<" 0 "
+         << (d>2 ? np(2)-1 : 0) <<"\">\n";
+    file <<"<Piece Extent=\"0 "<< np(0)-1<<" 0 "<< (d>1 ? np(1)-1 : 0) <<" 0 "
+         << (d>2 ? np(2)-1 : 0) <<"\">\n";
+    file <<"<PointData "<< ( nf==1 ?"Scalars":"Vectors")<<"=\"SolutionField\">\n";
+    data.declareStream(file, ( nf==1 ? 1 : 3), numPts, "SolutionField");
+    if ( data.streamsInPlace() )
+        internal::streamPatchSamples(data, file, geometry, &parField, isParam, a, b, np);
+    file <<"</PointData>\n";
+    file <<"<Points>\n";
+    data.declareStream(file, 3, numPts);
+    if ( data.streamsInPlace() )
+        internal::streamPatchSamples<T>(data, file, geometry, NULL, isParam, a, b, np);
+    file <<"</Points>\n";
+    file <<"</Piece>\n";
+    file <<"</StructuredGrid>\n";
+    if ( !data.streamsInPlace() )
     {
-        eval_field.conservativeResize(3,eval_geo.cols() );
-        eval_field.bottomRows(1).setZero(); // 3-field.dim()
+        data.beginAppended(file);
+        internal::streamPatchSamples(data, file, geometry, &parField, isParam, a, b, np);
+        internal::streamPatchSamples<T>(data, file, geometry, NULL, isParam, a, b, np);
+        data.endAppended(file);
     }
+    file <<"</VTKFile>\n";
 
-    gsWriteParaviewTPgrid(eval_geo, eval_field, np.template cast<index_t>(), fn);
+    file.close();
 }
 
 /// Write a file containing a solution field over a single geometry
 template<class T>
 void writeSinglePatchField(const gsField<T> & field, int patchNr,
-                           std::string const & fn, unsigned npts)
+                           std::string const & fn, unsigned npts,
+                           gsParaviewFormat::format fmt = gsParaviewFormat::global)
 {
-    writeSinglePatchField(field.patch(patchNr), field.function(patchNr), field.isParametric(), fn, npts);
+    writeSinglePatchField(field.patch(patchNr), field.function(patchNr), field.isParametric(), fn, npts, fmt);
 /*
     const int n = field.geoDim();
     const int d = field.parDim();
@@ -464,7 +513,8 @@ void writeSinglePatchField(const gsField<T> & field, int patchNr,
 template<class T>
 void writeSingleGeometry(gsFunction<T> const& func,
                          gsMatrix<T> const& supp,
-                         std::string const & fn, unsigned npts)
+                         std::string const & fn, unsigned npts,
+                         gsParaviewFormat::format fmt = gsParaviewFormat::global)
 {
     const int n = func.targetDim();
     const int d = func.domainDim();
@@ -497,13 +547,14 @@ void writeSingleGeometry(gsFunction<T> const& func,
 
     std::string mfn(fn);
     mfn.append(".vts");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::binary);
     if ( ! file.is_open() )
         gsWarn<<"writeSingleGeometry: Problem opening file \""<<fn<<"\""<<std::endl;
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsParaviewDataArrays data(fmt);
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\">\n";
+    file <<"<VTKFile type=\"StructuredGrid\" version=\"0.1\""<< data.fileAttributes() <<">\n";
     file <<"<StructuredGrid WholeExtent=\"0 "<<np(0)-1<<" 0 "<<np(1)-1<<" 0 "<<np(2)-1<<"\">\n";
     file <<"<Piece Extent=\"0 "<< np(0)-1<<" 0 "<<np(1)-1<<" 0 "<<np(2)-1<<"\">\n";
     // Add norm of the point as data
@@ -520,23 +571,18 @@ void writeSingleGeometry(gsFunction<T> const& func,
     {
         //gsWarn<< "4th dimension as scalar data.\n";
         file <<"<PointData "<< "Scalars=\"Coordinate4\">\n";
-        file <<"<DataArray type=\"Float32\" Name=\"Coordinate4\" format=\"ascii\" NumberOfComponents=\"1\">\n";
-        for ( index_t j=0; j!=eval_func.cols(); ++j)
-            file<< eval_func(3,j) <<" ";
-        file <<"</DataArray>\n";
+        const gsMatrix<T> coord4 = eval_func.row(3);
+        data.write(file, coord4, 1, "Coordinate4");
         file <<"</PointData>\n";
     }
     //---------
 
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\"3\">\n";
-    for ( index_t j=0; j<eval_func.cols(); ++j)
-        for ( index_t i=0; i!=3; ++i)
-            file<< eval_func(i,j) <<" ";
-    file <<"</DataArray>\n";
+    data.write(file, eval_func, 3);
     file <<"</Points>\n";
     file <<"</Piece>\n";
     file <<"</StructuredGrid>\n";
+    data.writeAppended(file);
     file <<"</VTKFile>\n";
     file.close();
 }
@@ -545,7 +591,8 @@ void writeSingleGeometry(gsFunction<T> const& func,
 template<class T>
 void writeSingleCurve(gsFunction<T> const& func,
                       gsMatrix<T> const& supp,
-                      std::string const & fn, unsigned npts)
+                      std::string const & fn, unsigned npts,
+                      gsParaviewFormat::format fmt = gsParaviewFormat::global)
 {
     const unsigned n = func.targetDim();
     const unsigned d = func.domainDim();
@@ -576,59 +623,56 @@ void writeSingleCurve(gsFunction<T> const& func,
 
     std::string mfn(fn);
     mfn.append(".vtp");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::binary);
     if ( ! file.is_open() )
         gsWarn<<"writeSingleCurve: Problem opening file \""<<fn<<"\""<<std::endl;
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
+    gsParaviewDataArrays data(fmt);
+    const index_t numPts = eval_func.cols();
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+    file <<"<VTKFile type=\"PolyData\" version=\"0.1\""<< data.fileAttributes() <<">\n";
     file <<"<PolyData>\n";
     // Accounting
-    file <<"<Piece NumberOfPoints=\""<< npts
-         <<"\" NumberOfVerts=\"0\" NumberOfLines=\""<< npts-1
+    file <<"<Piece NumberOfPoints=\""<< numPts
+         <<"\" NumberOfVerts=\"0\" NumberOfLines=\""<< numPts-1
          <<"\" NumberOfStrips=\"0\" NumberOfPolys=\"0\">\n";
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\""<<eval_func.rows()<<"\">\n";
-    for ( index_t j=0; j<eval_func.cols(); ++j)
-        for ( index_t i=0; i<eval_func.rows(); ++i)
-            file<< eval_func(i,j) <<" ";
-    file <<"\n</DataArray>\n";
+    data.write(file, eval_func, 3);
     file <<"</Points>\n";
     // Lines
     file <<"<Lines>\n";
-    file <<"<DataArray type=\"Int64\" Name=\"connectivity\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<npts-1<<"\">\n";
-    for (unsigned i=0; i< npts-1; ++i )
-    {
-        file << i << " " << i+1 << " ";
-    }
-    // offsets
-    file <<"\n</DataArray>\n";
-    unsigned offset(0);
-    file <<"<DataArray type=\"Int64\" Name=\"offsets\" format=\"ascii\" RangeMin=\"0\" RangeMax=\""<<npts-1<<"\">\n";
-    for (unsigned i=0; i< npts-1; ++i )
+    std::vector<index_t> conn, offsets;
+    conn.reserve(2*numPts);
+    offsets.reserve(numPts);
+    for (index_t i=0; i< numPts-1; ++i )
     {
-        offset +=2;
-        file << offset << " ";
+        conn.push_back(i);
+        conn.push_back(i+1);
+        offsets.push_back(2*i+2);
     }
-    file <<"\n</DataArray>\n";
+    data.write(file, conn, "connectivity");
+    data.write(file, offsets, "offsets");
     file <<"</Lines>\n";
     // Closing
     file <<"</Piece>\n";
     file <<"</PolyData>\n";
+    data.writeAppended(file);
     file <<"</VTKFile>\n";
     file.close();
 }
 
 template<class T>
-void writeSingleCurve(const gsGeometry<T> & Geo, std::string const & fn, unsigned npts)
+void writeSingleCurve(const gsGeometry<T> & Geo, std::string const & fn, unsigned npts,
+                      gsParaviewFormat::format fmt = gsParaviewFormat::global)
 {
     gsMatrix<T> ab = Geo.parameterRange();
-    writeSingleCurve( Geo, ab, fn, npts);
+    writeSingleCurve( Geo, ab, fn, npts, fmt);
 }
 
 template<class T>
-void writeSingleGeometry(const gsGeometry<T> & Geo, std::string const & fn, unsigned npts)
+void writeSingleGeometry(const gsGeometry<T> & Geo, std::string const & fn, unsigned npts,
+                         gsParaviewFormat::format fmt = gsParaviewFormat::global)
 {
     /*
       gsMesh<T> msh;
@@ -637,7 +681,7 @@ void writeSingleGeometry(const gsGeometry<T> & Geo, std::string const & fn, unsi
       return;
     //*/
     gsMatrix<T> ab = Geo.parameterRange();
-    writeSingleGeometry( Geo, ab, fn, npts);
+    writeSingleGeometry( Geo, ab, fn, npts, fmt);
 }
 
 template<class T>
@@ -653,7 +697,8 @@ void writeSingleTrimSurface(const gsTrimSurface<T> & surf,
 template<class T>
 void gsWriteParaview(const gsField<T> & field,
                      std::string const & fn,
-                     unsigned npts, bool mesh)
+                     unsigned npts, bool mesh,
+                     gsParaviewFormat::format fmt)
 {
     /*
     if (mesh && (!field.isParametrized()) )
@@ -663,26 +708,43 @@ void gsWriteParaview(const gsField<T> & field,
     }
     */
 
-    const unsigned n = field.nPieces();
-    gsParaviewCollection collection(fn);
-    std::string fileName;
+    const index_t n = field.nPieces();
 
-    for ( unsigned i=0; i < n; ++i )
+    // The patches are sampled concurrently, each one streamed to its
+    // own file. An exception must not leave the parallel region, the
+    // first error is reported afterwards.
+    std::string error;
+#   pragma omp parallel for schedule(dynamic, 1)
+    for ( index_t i=0; i < n; ++i )
     {
-        const gsBasis<T> & dom = field.isParametrized() ?
-            field.igaFunction(i).basis() : field.patch(i).basis();
-
-        fileName = fn + util::to_string(i);
-        writeSinglePatchField( field, i, fileName, npts );
-        collection.addPart(fileName, ".vts");
-        if ( mesh )
+        try
         {
-            fileName+= "_mesh";
-            writeSingleCompMesh(dom, field.patch(i), fileName);
-
-            collection.addPart(fileName, ".vtp");
+            const std::string fileName = fn + util::to_string(i);
+            writeSinglePatchField( field, i, fileName, npts, fmt );
+            if ( mesh )
+            {
+                const gsBasis<T> & dom = field.isParametrized() ?
+                    field.igaFunction(i).basis() : field.patch(i).basis();
+                writeSingleCompMesh(dom, field.patch(i), fileName + "_mesh", 8, fmt);
+            }
+        }
+        catch (const std::exception & e)
+        {
+#           pragma omp critical (gsWriteParaview_error)
+            if ( error.empty() )
+                error = e.what();
         }
+    }
+    if ( !error.empty() )
+        throw std::runtime_error(error);
 
+    gsParaviewCollection collection(fn);
+    for ( index_t i=0; i < n; ++i )
+    {
+        const std::string fileName = fn + util::to_string(i);
+        collection.addPart(fileName, ".vts");
+        if ( mesh )
+            collection.addPart(fileName + "_mesh", ".vtp");
     }
     collection.save();
 }
@@ -691,7 +753,8 @@ void gsWriteParaview(const gsField<T> & field,
 /// Export a Geometry without scalar information
 template<class T>
 void gsWriteParaview(const gsGeometry<T> & Geo, std::string const & fn,
-                     unsigned npts, bool mesh, bool ctrlNet)
+                     unsigned npts, bool mesh, bool ctrlNet,
+                     gsParaviewFormat::format fmt)
 {
     const bool curve = ( Geo.domainDim() == 1 );
 
@@ -699,12 +762,12 @@ void gsWriteParaview(const gsGeometry<T> & Geo, std::string const & fn,
 
     if ( curve )
     {
-        writeSingleCurve(Geo, fn, npts);
+        writeSingleCurve(Geo, fn, npts, fmt);
         collection.addPart(fn, ".vtp");
     }
     else
     {
-        writeSingleGeometry(Geo, fn, npts);
+        writeSingleGeometry(Geo, fn, npts, fmt);
         collection.addPart(fn, ".vts");
     }
 
@@ -731,14 +794,14 @@ void gsWriteParaview(const gsGeometry<T> & Geo, std::string const & fn,
 	    ptsPerEdge = npts;
 	}
 
-        writeSingleCompMesh(Geo.basis(), Geo, fileName, ptsPerEdge);
+        writeSingleCompMesh(Geo.basis(), Geo, fileName, ptsPerEdge, fmt);
         collection.addPart(fileName, ".vtp");
     }
 
     if ( ctrlNet ) // Output the control net
     {
         const std::string fileName = fn + "_cnet";
-        writeSingleControlNet(Geo, fileName);
+        writeSingleControlNet(Geo, fileName, fmt);
         collection.addPart(fileName, ".vtp");
     }
 
@@ -749,7 +812,8 @@ void gsWriteParaview(const gsGeometry<T> & Geo, std::string const & fn,
 // Export a multibasis mesh
 template<class T>
 void gsWriteParaview(const gsMultiBasis<T> & mb, const gsMultiPatch<T> & domain,
-                     std::string const & fn, unsigned npts)
+                     std::string const & fn, unsigned npts,
+                     gsParaviewFormat::format fmt)
 {
     // GISMO_ASSERT sizes
 
@@ -758,7 +822,7 @@ void gsWriteParaview(const gsMultiBasis<T> & mb, const gsMultiPatch<T> & domain,
     for (size_t i = 0; i != domain.nPatches(); ++i)
     {
         const std::string fileName = fn + util::to_string(i) + "_mesh";
-        writeSingleCompMesh(mb[i], domain.patch(i), fileName, npts);
+        writeSingleCompMesh(mb[i], domain.patch(i), fileName, npts, fmt);
         collection.addPart(fileName, ".vtp");
     }
 
@@ -783,7 +847,8 @@ void gsWriteParaview(const gsGeometrySlice<T> & Geo,
 template<class T>
 void gsWriteParaview( std::vector<gsGeometry<T> *> const & Geo,
                       std::string const & fn,
-                      unsigned npts, bool mesh, bool ctrlNet)
+                      unsigned npts, bool mesh, bool ctrlNet,
+                      gsParaviewFormat::format fmt)
 {
     const size_t n = Geo.size();
 
@@ -796,26 +861,26 @@ void gsWriteParaview( std::vector<gsGeometry<T> *> const & Geo,
 
         if ( Geo.at(i)->domainDim() == 1 )
         {
-            writeSingleCurve(*Geo[i], fnBase, npts);
+            writeSingleCurve(*Geo[i], fnBase, npts, fmt);
             collection.addPart(fnBase, ".vtp");
         }
         else
         {
-            writeSingleGeometry( *Geo[i], fnBase, npts ) ;
+            writeSingleGeometry( *Geo[i], fnBase, npts, fmt ) ;
             collection.addPart(fnBase, ".vts");
         }
 
         if ( mesh )
         {
             const std::string fileName = fnBase + "_mesh";
-            writeSingleCompMesh(Geo[i]->basis(), *Geo[i], fileName);
+            writeSingleCompMesh(Geo[i]->basis(), *Geo[i], fileName, 8, fmt);
             collection.addPart(fileName, ".vtp");
         }
 
         if ( ctrlNet ) // Output the control net
         {
             const std::string fileName = fnBase + "_cnet";
-            writeSingleControlNet(*Geo[i], fileName);
+            writeSingleControlNet(*Geo[i], fileName, fmt);
             collection.addPart(fileName, ".vtp");
         }
     }
@@ -1412,18 +1477,20 @@ void gsWriteParaviewSolid(gsSolid<T> const& sl,
 
 /// Visualizing a mesh
 template <class T>
-void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd)
+void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd,
+                     gsParaviewFormat::format fmt)
 {
     std::string mfn(fn);
     mfn.append(".vtp");
-    std::ofstream file(mfn.c_str());
+    std::ofstream file(mfn.c_str(), std::ios::binary);
     if ( ! file.is_open() )
         gsWarn<<"gsWriteParaview: Problem opening file \""<<fn<<"\""<<std::endl;
     file << std::fixed; // no exponents
     file << std::setprecision (PLOT_PRECISION);
 
+    gsParaviewDataArrays data(fmt);
     file <<"<?xml version=\"1.0\"?>\n";
-    file <<"<VTKFile type=\"PolyData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+    file <<"<VTKFile type=\"PolyData\" version=\"0.1\""<< data.fileAttributes() <<">\n";
     file <<"<PolyData>\n";
 
     /// Number of vertices and number of faces
@@ -1432,92 +1499,48 @@ void gsWriteParaview(gsMesh<T> const& sl, std::string const & fn, bool pvd)
 
     /// Coordinates of vertices
     file <<"<Points>\n";
-    file <<"<DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"ascii\">\n";
-    for (typename std::vector< gsVertex<T>* >::const_iterator it=sl.vertices().begin(); it!=sl.vertices().end(); ++it)
-    {
-        const gsVertex<T>& vertex = **it;
-        file << vertex[0] << " ";
-        file << vertex[1] << " ";
-        file << vertex[2] << " \n";
-    }
-
-    file << "\n";
-    file <<"</DataArray>\n";
+    gsMatrix<T> coords(3, sl.numVertices());
+    index_t k = 0;
+    for (typename std::vector< gsVertex<T>* >::const_iterator it=sl.vertices().begin(); it!=sl.vertices().end(); ++it, ++k)
+        coords.col(k) = **it;
+    data.write(file, coords, 3);
     file <<"</Points>\n";
 
-    // Scalar field attached to each face
-    // file << "<PointData Scalars=\"point_scalars\">\n";
-    // file << "<DataArray type=\"Int32\" Name=\"point_scalars\" format=\"ascii\">\n";
-    // for (typename std::vector< gsVertex<T>* >::const_iterator it=sl.vertex.begin();
-    //      it!=sl.vertex.end(); ++it)
-    // {
-    //     file << 0 << " ";
-    // }
-    // file << "\n";
-    // file << "</DataArray>\n";
-    // file << "</PointData>\n";
-
     // Write out edges
+    std::vector<index_t> conn, offsets;
     file << "<Lines>\n";
-    file << "<DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">\n";
     for (typename std::vector< gsEdge<T> >::const_iterator it=sl.edges().begin();
          it!=sl.edges().end(); ++it)
     {
-            file << it->source->getId() << " " << it->target->getId() << "\n";
+        conn.push_back(it->source->getId());
+        conn.push_back(it->target->getId());
+        offsets.push_back(conn.size());
     }
-    file << "</DataArray>\n";
-    file << "<DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">\n";
-    int count=0;
-    for (typename std::vector< gsEdge<T> >::const_iterator it=sl.edges().begin();
-         it!=sl.edges().end(); ++it)
-    {
-        count+=2;
-        file << count << " ";
-    }
-    file << "\n";
-    file << "</DataArray>\n";
+    data.write(file, conn, "connectivity");
+    data.write(file, offsets, "offsets");
     file << "</Lines>\n";
 
-    // Scalar field attached to each face (* if edges exists, this has a problem)
-    // file << "<CellData Scalars=\"cell_scalars\">\n";
-    // file << "<DataArray type=\"Int32\" Name=\"cell_scalars\" format=\"ascii\">\n";
-    // for (typename std::vector< gsFace<T>* >::const_iterator it=sl.face.begin();
-    //      it!=sl.face.end(); ++it)
-    // {
-    //     file << 1 << " ";
-    // }
-    // file << "\n";
-    // file << "</DataArray>\n";
-    // file << "</CellData>\n";
-
     /// Which vertices belong to which faces
+    conn.clear();
+    offsets.clear();
     file << "<Polys>\n";
-    file << "<DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">\n";
     for (typename std::vector< gsFace<T>* >::const_iterator it=sl.faces().begin();
          it!=sl.faces().end(); ++it)
     {
         for (typename std::vector< gsVertex<T>* >::const_iterator vit= (*it)->vertices.begin();
              vit!=(*it)->vertices.end(); ++vit)
         {
-            file << (*vit)->getId() << " ";
+            conn.push_back((*vit)->getId());
         }
-        file << "\n";
+        offsets.push_back(conn.size());
     }
-    file << "</DataArray>\n";
-    file << "<DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">\n";
-    count=0;
-    for (typename std::vector< gsFace<T>* >::const_iterator it=sl.faces().begin();
-         it!=sl.faces().end(); ++it)
-    {
-        count += (*it)->vertices.size();
-        file << count << " ";
-    }
-    file << "\n";
-    file << "</DataArray>\n";
+    data.write(file, conn, "connectivity");
+    data.write(file, offsets, "offsets");
     file << "</Polys>\n";
 
     file << "</Piece>\n";
     file <<"</PolyData>\n";
+    data.writeAppended(file);
     file <<"</VTKFile>\n";
     file.close();
 
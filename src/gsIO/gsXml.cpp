@@ -34,6 +34,14 @@ char * makeValue( const std::string & value, gsXmlTree & data)
     return data.allocate_string( value.c_str() );
 }
 
+char * makeValue( const char * begin, const char * end, gsXmlTree & data)
+{
+    char * value = data.allocate_string(0, end - begin + 1);
+    std::copy(begin, end, value);
+    value[end - begin] = '\0';
+    return value;
+}
+
 gsXmlAttribute * makeAttribute( const std::string & name, const std::string & value, gsXmlTree & data)
 {
     return data.allocate_attribute( 
@@ -78,6 +86,123 @@ std::string to_string(const unsigned & i)
     return tmp;
 }
 
+/* Base64 encoded values */
+
+namespace
+{
+const char s_base64Chars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Values of the characters, -1 for invalid ones
+struct base64Table
+{
+    signed char v[256];
+    base64Table()
+    {
+        std::fill(v, v + 256, -1);
+        for (int i = 0; i != 64; ++i)
+            v[ static_cast<unsigned char>(s_base64Chars[i]) ] = static_cast<signed char>(i);
+    }
+};
+}
+
+std::string encodeBase64(const char * bytes, size_t size)
+{
+    const unsigned char * in = reinterpret_cast<const unsigned char*>(bytes);
+    std::string result;
+    result.reserve( 4 * ((size + 2) / 3) );
+    size_t i = 0;
+    for (; i + 2 < size; i += 3)
+    {
+        const unsigned v = (in[i] << 16) | (in[i+1] << 8) | in[i+2];
+        result.push_back( s_base64Chars[ v >> 18        ] );
+        result.push_back( s_base64Chars[(v >> 12) & 0x3F] );
+        result.push_back( s_base64Chars[(v >>  6) & 0x3F] );
+        result.push_back( s_base64Chars[ v        & 0x3F] );
+    }
+    if (i < size) // one or two bytes left, pad with '='
+    {
+        const unsigned v = (in[i] << 16) | (i + 1 < size ? in[i+1] << 8 : 0);
+        result.push_back( s_base64Chars[ v >> 18        ] );
+        result.push_back( s_base64Chars[(v >> 12) & 0x3F] );
+        result.push_back( i + 1 < size ? s_base64Chars[(v >> 6) & 0x3F] : '=' );
+        result.push_back( '=' );
+    }
+    return result;
+}
+
+bool decodeBase64(const char * str, std::vector<char> & result)
+{
+    static const base64Table table;
+
+    result.clear();
+    result.reserve( 3 * strlen(str) / 4 );
+    unsigned v = 0;
+    int n = 0;
+    for (const unsigned char * c = reinterpret_cast<const unsigned char*>(str); *c; ++c)
+    {
+        if ( '=' == *c )
+            break;
+        const signed char d = table.v[*c];
+        if (d < 0)
+        {
+            if ( isspace(*c) ) // line breaks are allowed
+                continue;
+            return false;
+        }
+        v = (v << 6) | d;
+        if (4 == ++n)
+        {
+            result.push_back( static_cast<char>(v >> 16) );
+            result.push_back( static_cast<char>(v >>  8) );
+            result.push_back( static_cast<char>(v      ) );
+            v = n = 0;
+        }
+    }
+    if (n > 1) // last group was padded
+    {
+        v <<= 6 * (4 - n);
+        result.push_back( static_cast<char>(v >> 16) );
+        if (3 == n)
+            result.push_back( static_cast<char>(v >> 8) );
+    }
+    return 1 != n;
+}
+
+bool isBinaryValue(const gsXmlNode * node)
+{
+    const gsXmlAttribute * fmt = node->first_attribute("format");
+    return fmt && !strcmp(fmt->value(), "base64");
+}
+
+void putBinaryValue(gsXmlNode * node, const char * bytes, size_t size,
+                    int scalarSize, gsXmlTree & data)
+{
+    node->value( makeValue(encodeBase64(bytes, size), data) );
+    node->append_attribute( makeAttribute("format", "base64", data) );
+    node->append_attribute( makeAttribute("scalar", 8 == scalarSize ? "float64" : "float32", data) );
+}
+
+int getBinaryValue(const gsXmlNode * node, std::vector<char> & bytes)
+{
+    const gsXmlAttribute * scalar = node->first_attribute("scalar");
+    int scalarSize = 8;
+    if ( scalar && !strcmp(scalar->value(), "float32") )
+        scalarSize = 4;
+    else if ( scalar && strcmp(scalar->value(), "float64") )
+    {
+        gsWarn<<"XML Warning: Unknown scalar type \""<< scalar->value() <<"\".\n";
+        return 0;
+    }
+
+    if ( !decodeBase64(node->value(), bytes) )
+    {
+        gsWarn<<"XML Warning: Invalid base64 value in tag "<< node->name() <<".\n";
+        return 0;
+    }
+    return scalarSize;
+}
+
 int countByTag(const std::string & tag, 
                       gsXmlNode * root )
 {
@@ -305,4 +430,126 @@ void getBoundaries(gsXmlNode * node, std::map<int, int> & ids,
 
 }// end namespace internal
 
+/* Reading numbers from characters */
+
+namespace
+{
+
+// Powers of ten which are exact in double precision
+const double s_pow10[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                           1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                           1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+inline bool isDigit(const char c) { return c >= '0' && c <= '9'; }
+
+// Converts the number at p by strtod
+bool parseByStrtod(const char * & p, const char * end, double & var)
+{
+    const char * e = p;
+    while ( e != end && '/' != *e && !std::isspace(static_cast<unsigned char>(*e)) )
+        ++e;
+    const std::string token(p, e);
+    char * stop;
+    var = strtod(token.c_str(), &stop);
+    if ( stop == token.c_str() )
+        return false;
+    p += stop - token.c_str();
+    return true;
+}
+
+// Converts the decimal number at p. If it has at most 19
+// significant digits and is an integer times a power of ten up to
+// 1e22, the result is a single correctly rounded floating point
+// operation, so it equals the one of strtod. Other numbers, as well
+// as inf, nan and hexadecimal numbers, are passed to strtod.
+bool parseDecimal(const char * & p, const char * end, double & var)
+{
+    const char * s = p;
+    const bool neg = ( s != end && '-' == *s );
+    if ( s != end && ('-' == *s || '+' == *s) )
+        ++s;
+
+    uint64_t mant = 0;
+    int ndig = 0, exp10 = 0;
+    bool digits = false, exact = true;
+    for (; s != end && isDigit(*s); ++s)
+    {
+        digits = true;
+        if ( ndig < 19 )
+        {
+            mant = 10 * mant + (*s - '0');
+            if ( 0 != mant ) ++ndig;
+        }
+        else
+        {
+            ++exp10;
+            exact = exact && '0' == *s;
+        }
+    }
+    if ( s != end && '.' == *s )
+        for (++s; s != end && isDigit(*s); ++s)
+        {
+            digits = true;
+            if ( ndig < 19 )
+            {
+                mant = 10 * mant + (*s - '0');
+                if ( 0 != mant ) ++ndig;
+                --exp10;
+            }
+            else
+                exact = exact && '0' == *s;
+        }
+
+    if ( !digits || (s != end && ('x' == *s || 'X' == *s)) )
+        return parseByStrtod(p, end, var);
+
+    if ( s != end && ('e' == *s || 'E' == *s) )
+    {
+        const char * e = s + 1;
+        const bool eneg = ( e != end && '-' == *e );
+        if ( e != end && ('-' == *e || '+' == *e) )
+            ++e;
+        if ( e != end && isDigit(*e) )
+        {
+            int ev = 0;
+            for (; e != end && isDigit(*e); ++e)
+                if ( ev < 100000 ) ev = 10 * ev + (*e - '0');
+            exp10 += eneg ? -ev : ev;
+            s = e;
+        }
+    }
+
+    if ( !exact || mant > (uint64_t(1) << 53) || exp10 < -22 || exp10 > 22 )
+        return parseByStrtod(p, end, var);
+
+    double val = static_cast<double>(mant);
+    val = exp10 < 0 ? val / s_pow10[-exp10] : val * s_pow10[exp10];
+    var = neg ? -val : val;
+    p = s;
+    return true;
+}
+
+} // namespace
+
+bool gsParseReal(const char * & p, const char * end, double & var)
+{
+    const char * s = p;
+    while ( s != end && std::isspace(static_cast<unsigned char>(*s)) )
+        ++s;
+    if ( s == end || !parseDecimal(s, end, var) )
+        return false;
+
+    // A fraction a/b
+    if ( s != end && '/' == *s )
+    {
+        double den;
+        ++s;
+        if ( !parseDecimal(s, end, den) )
+            return false;
+        var /= den;
+    }
+    p = s;
+    return true;
+}
+
 }// end namespace gismo
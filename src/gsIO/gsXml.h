@@ -16,6 +16,9 @@
 #include <gsCore/gsForwardDeclarations.h>
 #include <gsCore/gsExport.h>
 
+#include <cstring>
+#include <cctype>
+
 // Default memory sizes
 // #define RAPIDXML_STATIC_POOL_SIZE  ( 64*1024 )
 // #define RAPIDXML_DYNAMIC_POOL_SIZE ( 64*1024 )
@@ -176,6 +179,71 @@ typename util::enable_if<!std::numeric_limits<T>::is_integer, bool>::type
 gsGetValue(std::istream & is, T & var)
 { return gsGetReal<T>(is,var); }
 
+/// Reads a real number, or a fraction a/b, from the characters
+/// [p,end), skipping leading whitespace, and moves \a p past it.
+/// The result is the same as by strtod, but numbers of up to 19
+/// digits with small exponents are converted without allocating or
+/// copying. Returns false if there is no number.
+GISMO_EXPORT bool gsParseReal(const char * & p, const char * end, double & var);
+
+/// Reads a real number from the characters [p,end), see gsParseReal
+template<class T>
+inline bool gsGetReal(const char * & p, const char * end, T & var)
+{
+    GISMO_STATIC_ASSERT(!std::numeric_limits<T>::is_integer,
+        "The third parameter needs to be a floating point type.");
+    double val;
+    if ( !gsParseReal(p, end, val) ) return false;
+    var = val;
+    return true;
+}
+
+/// Reads an integer from the characters [p,end), skipping leading
+/// whitespace, and moves \a p past it
+template<class Z>
+inline bool gsGetInt(const char * & p, const char * end, Z & var)
+{
+    GISMO_STATIC_ASSERT(std::numeric_limits<Z>::is_integer,
+        "The third parameter needs to be an integer type.");
+    const char * s = p;
+    while ( s != end && std::isspace(static_cast<unsigned char>(*s)) ) ++s;
+    const bool neg = ( s != end && '-' == *s );
+    if ( s != end && ('-' == *s || '+' == *s) ) ++s;
+    if ( s == end || *s < '0' || *s > '9' ) return false;
+    Z val = 0;
+    for (; s != end && *s >= '0' && *s <= '9'; ++s)
+        val = 10 * val + (*s - '0');
+    var = neg ? -val : val;
+    p = s;
+    return true;
+}
+
+#ifdef GISMO_WITH_MPQ
+template<>
+inline bool gsGetReal(const char * & p, const char * end, mpq_class & var)
+{
+    // Rationals are read exactly from the token
+    const char * s = p;
+    while ( s != end && std::isspace(static_cast<unsigned char>(*s)) ) ++s;
+    const char * e = s;
+    while ( e != end && !std::isspace(static_cast<unsigned char>(*e)) ) ++e;
+    std::istringstream str( std::string(s, e) );
+    if ( !gsGetReal(str, var) ) return false;
+    p = e;
+    return true;
+}
+#endif
+
+template <typename Z>
+typename util::enable_if<std::numeric_limits<Z>::is_integer, bool>::type
+gsGetValue(const char * & p, const char * end, Z & var)
+{ return gsGetInt<Z>(p,end,var); }
+
+template <typename T>
+typename util::enable_if<!std::numeric_limits<T>::is_integer, bool>::type
+gsGetValue(const char * & p, const char * end, T & var)
+{ return gsGetReal<T>(p,end,var); }
+
 namespace internal {
 
 typedef rapidxml::xml_node<char>        gsXmlNode;
@@ -252,6 +320,9 @@ inline gsXmlNode * searchId(const int id, gsXmlNode * root)
 /// Helper to allocate XML value
 GISMO_EXPORT char * makeValue( const std::string & value, gsXmlTree & data);
 
+/// Helper to allocate XML value from the characters [begin,end)
+GISMO_EXPORT char * makeValue( const char * begin, const char * end, gsXmlTree & data);
+
 /// Helper to allocate matrix in XML pool
 template<class T>
 char * makeValue(const gsMatrix<T> & value, gsXmlTree & data,
@@ -278,6 +349,50 @@ GISMO_EXPORT gsXmlNode *  makeComment(const std::string &, gsXmlTree & data);
 /// Helper to convert small unsigned to string
 GISMO_EXPORT std::string to_string(const unsigned & i);
 
+/// Helper to encode bytes as base64
+GISMO_EXPORT std::string encodeBase64(const char * bytes, size_t size);
+
+/// Helper to decode a base64 string, returns false if \a str is not
+/// valid base64
+GISMO_EXPORT bool decodeBase64(const char * str, std::vector<char> & result);
+
+/// Returns true if the value of \a node is base64 encoded
+GISMO_EXPORT bool isBinaryValue(const gsXmlNode * node);
+
+/// Helper to set the value of \a node to the base64 encoding of \a
+/// bytes, whose floating point values have \a scalarSize bytes
+GISMO_EXPORT void putBinaryValue(gsXmlNode * node, const char * bytes, size_t size,
+                                 int scalarSize, gsXmlTree & data);
+
+/// Helper to decode the base64 value of \a node into \a bytes;
+/// returns the size of its floating point values (4 or 8), or 0 on failure
+GISMO_EXPORT int getBinaryValue(const gsXmlNode * node, std::vector<char> & bytes);
+
+/// Returns true if values of type \a T are to be written base64
+/// encoded into \a data; this is the case for float and double,
+/// if binary encoding is enabled.
+template<class T>
+inline bool useBinaryValue(const gsXmlTree & data)
+{
+    return data.getBinaryEncoding() && std::numeric_limits<T>::is_iec559
+        && ( 4 == sizeof(T) || 8 == sizeof(T) );
+}
+
+/// Helper to read a floating point value of \a scalarSize bytes
+template<class T>
+inline T binaryScalar(const char * bytes, const int scalarSize)
+{
+    if ( 8 == scalarSize )
+    {
+        double v;
+        std::memcpy(&v, bytes, sizeof(double));
+        return static_cast<T>(v);
+    }
+    float v;
+    std::memcpy(&v, bytes, sizeof(float));
+    return static_cast<T>(v);
+}
+
 /// Helper to count the number of Objects (by tag) that exist in the
 /// XML tree
 GISMO_EXPORT int countByTag(const std::string & tag, gsXmlNode * root );
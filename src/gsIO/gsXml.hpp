@@ -95,14 +95,30 @@ void getMatrixFromXml ( gsXmlNode * node, unsigned const & rows,
                         unsigned const & cols, gsMatrix<T> & result )
 {
     //gsWarn<<"Reading "<< node->name() <<" matrix of size "<<rows<<"x"<<cols<<"Geometry..\n";
-    std::istringstream str;
-    str.str( node->value() );
+    if ( isBinaryValue(node) )
+    {
+        std::vector<char> bytes;
+        const int sz = getBinaryValue(node, bytes);
+        if ( 0 == sz || bytes.size() != static_cast<size_t>(rows) * cols * sz )
+        {
+            gsWarn<<"XML Warning: Reading binary matrix of size "<<rows<<"x"<<cols<<" failed.\n";
+            gsWarn<<"Tag: "<< node->name() <<".\n";
+            return;
+        }
+        result.resize(rows,cols);
+        const char * p = bytes.data();
+        for (unsigned i=0; i<rows; ++i) // Read is RowMajor
+            for (unsigned j=0; j<cols; ++j, p += sz)
+                result(i,j) = binaryScalar<T>(p, sz);
+        return;
+    }
+
+    const char * str = node->value(), * end = str + node->value_size();
     result.resize(rows,cols);
 
     for (unsigned i=0; i<rows; ++i) // Read is RowMajor
         for (unsigned j=0; j<cols; ++j)
-            //if ( !(str >> result(i,j) ) )
-              if (! gsGetValue(str,result(i,j)) )
+            if (! gsGetValue(str, end, result(i,j)) )
             {
                 gsWarn<<"XML Warning: Reading matrix of size "<<rows<<"x"<<cols<<" failed.\n";
                 gsWarn<<"Tag: "<< node->name() <<", Matrix entry: ("<<i<<", "<<j<<").\n";
@@ -113,6 +129,16 @@ void getMatrixFromXml ( gsXmlNode * node, unsigned const & rows,
 template<class T>
 gsXmlNode * putMatrixToXml ( gsMatrix<T> const & mat, gsXmlTree & data, std::string name)
 {
+    if ( useBinaryValue<T>(data) )
+    {
+        // Write is RowMajor
+        const gsMatrix<T> tr = mat.transpose();
+        gsXmlNode* new_node = internal::makeNode(name, data);
+        putBinaryValue(new_node, reinterpret_cast<const char*>(tr.data()),
+                       tr.size() * sizeof(T), sizeof(T), data);
+        return new_node;
+    }
+
     // Create XML tree node
     gsXmlNode* new_node = internal::makeNode(name, mat, data);
     return new_node;
@@ -124,6 +150,28 @@ gsXmlNode * putSparseMatrixToXml ( gsSparseMatrix<T> const & mat,
 {
     typedef typename gsSparseMatrix<T>::InnerIterator cIter;
 
+    if ( useBinaryValue<T>(data) )
+    {
+        // Row indices, column indices and values of the non-zeros
+        const size_t nnz = mat.nonZeros();
+        std::vector<int64_t> ind(2 * nnz);
+        std::vector<T> val(nnz);
+        size_t k = 0;
+        for (index_t j=0; j != mat.cols(); ++j)
+            for ( cIter it(mat,j); it; ++it, ++k )
+            {
+                ind[k]       = it.index();
+                ind[nnz + k] = j;
+                val[k]       = it.value();
+            }
+        std::string bytes(reinterpret_cast<const char*>(ind.data()), ind.size() * sizeof(int64_t));
+        bytes.append(reinterpret_cast<const char*>(val.data()), nnz * sizeof(T));
+
+        gsXmlNode* new_node = internal::makeNode(name, data);
+        putBinaryValue(new_node, bytes.data(), bytes.size(), sizeof(T), data);
+        return new_node;
+    }
+
     std::ostringstream str;
     str << std::setprecision(data.getFloatPrecision());
     const index_t nCol = mat.cols();
@@ -146,13 +194,30 @@ void getSparseEntriesFromXml ( gsXmlNode * node,
 {
     result.clear();
 
-    std::istringstream str;
-    str.str( node->value() );
+    if ( isBinaryValue(node) )
+    {
+        std::vector<char> bytes;
+        const int sz = getBinaryValue(node, bytes);
+        const size_t nnz = bytes.size() / (2 * sizeof(int64_t) + sz);
+        if ( 0 == sz || bytes.size() != nnz * (2 * sizeof(int64_t) + sz) )
+        {
+            gsWarn<<"XML Warning: Reading binary sparse matrix failed.\n";
+            return;
+        }
+        result.reserve(nnz);
+        std::vector<int64_t> ind(2 * nnz);
+        std::memcpy(ind.data(), bytes.data(), ind.size() * sizeof(int64_t));
+        const char * p = bytes.data() + ind.size() * sizeof(int64_t);
+        for (size_t k = 0; k != nnz; ++k, p += sz)
+            result.add(ind[k], ind[nnz + k], binaryScalar<T>(p, sz));
+        return;
+    }
+
+    const char * str = node->value(), * end = str + node->value_size();
     index_t r,c;
     T val;
 
-    //while( (str >> r) && (str >> c) && (str >> val) )
-    while( (str >> r) && (str >> c) && ( gsGetValue(str,val)) )
+    while( gsGetInt(str, end, r) && gsGetInt(str, end, c) && gsGetValue(str, end, val) )
         result.add(r,c,val);
 }
 
@@ -0,0 +1,365 @@
+/** @file gsXmlIndex.cpp
+
+    @brief Provides an index of the objects of a memory-mapped XML
+    file, which are parsed on demand.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gsIO/gsXmlIndex.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cctype>
+
+namespace gismo
+{
+
+namespace internal
+{
+
+namespace
+{
+
+inline bool isSpace(char c)
+{
+    return 0 != std::isspace(static_cast<unsigned char>(c));
+}
+
+// Returns the first occurrence of \a s in [p,end), or end
+inline const char * findStr(const char * p, const char * end, const char * s)
+{
+    return std::search(p, end, s, s + strlen(s));
+}
+
+// Skips the comment, processing instruction, declaration or CDATA
+// section starting at p, which points to '<'. Returns the position
+// after it, p if it is a tag, or NULL if it is not terminated.
+const char * skipSpecial(const char * p, const char * end)
+{
+    const char * q;
+    if ( end - p < 2 )
+        return NULL;
+    if ( '?' == p[1] )
+    {
+        q = findStr(p, end, "?>");
+        return q == end ? NULL : q + 2;
+    }
+    if ( '!' != p[1] )
+        return p;
+    if ( end - p >= 4 && !strncmp(p, "<!--", 4) )
+    {
+        q = findStr(p + 4, end, "-->");
+        return q == end ? NULL : q + 3;
+    }
+    if ( end - p >= 9 && !strncmp(p, "<![CDATA[", 9) )
+    {
+        q = findStr(p + 9, end, "]]>");
+        return q == end ? NULL : q + 3;
+    }
+    // <!DOCTYPE ...>, possibly with an internal subset in brackets
+    int depth = 0;
+    for (q = p + 2; q != end; ++q)
+    {
+        if ( '[' == *q )
+            ++depth;
+        else if ( ']' == *q )
+            --depth;
+        else if ( '>' == *q && depth <= 0 )
+            return q + 1;
+    }
+    return NULL;
+}
+
+// Skips the start tag at p, which points to '<'. Returns the
+// position after it, or NULL if it is not terminated.
+const char * skipStartTag(const char * p, const char * end, bool & closed)
+{
+    for (++p; p != end; ++p)
+    {
+        if ( '"' == *p || '\'' == *p )
+        {
+            p = std::find(p + 1, end, *p);
+            if ( p == end )
+                return NULL;
+        }
+        else if ( '>' == *p )
+        {
+            closed = ( '/' == p[-1] );
+            return p + 1;
+        }
+    }
+    return NULL;
+}
+
+// Reads the name and the attributes type and id of the start tag at
+// p, which points to '<', and all attributes into \a attrs if given.
+// Returns the position after the tag, or NULL if it is not terminated.
+const char * readStartTag(const char * p, const char * end, gsXmlIndex::entry & e,
+                          bool & closed, gsXmlIndex::attributes * attrs = NULL)
+{
+    const char * q = ++p;
+    while ( q != end && !isSpace(*q) && '>' != *q && '/' != *q )
+        ++q;
+    e.tag.assign(p, q);
+    e.type.clear();
+    e.id = -1;
+
+    while ( q != end )
+    {
+        if ( isSpace(*q) )
+        {
+            ++q;
+            continue;
+        }
+        if ( '>' == *q || '/' == *q )
+            return skipStartTag(q - 1, end, closed);
+
+        // name="value"
+        const char * a = q;
+        while ( q != end && '=' != *q && !isSpace(*q) && '>' != *q )
+            ++q;
+        const std::string attr(a, q);
+        while ( q != end && isSpace(*q) )
+            ++q;
+        if ( q == end || '=' != *q )
+            continue;
+        for (++q; q != end && isSpace(*q); ++q) ;
+        if ( q == end || ('"' != *q && '\'' != *q) )
+            return NULL;
+        const char * v = q + 1;
+        q = std::find(v, end, *q);
+        if ( q == end )
+            return NULL;
+        if ( attrs )
+            attrs->push_back( std::make_pair(attr, std::string(v, q)) );
+        if ( "type" == attr )
+            e.type.assign(v, q);
+        else if ( "id" == attr )
+            e.id = atoi( std::string(v, q).c_str() );
+        ++q;
+    }
+    return NULL;
+}
+
+// Skips the contents and the end tag of the element whose start tag
+// ends before p. Returns the position after it, or NULL if it is not
+// terminated.
+const char * skipElement(const char * p, const char * end)
+{
+    bool closed;
+    for (int depth = 1; depth != 0; )
+    {
+        p = std::find(p, end, '<');
+        if ( p == end )
+            return NULL;
+        if ( end - p > 1 && '/' == p[1] )
+        {
+            p = std::find(p, end, '>');
+            if ( p == end )
+                return NULL;
+            ++p;
+            --depth;
+            continue;
+        }
+        const char * q = skipSpecial(p, end);
+        if ( q != p )
+        {
+            if ( !q )
+                return NULL;
+            p = q;
+            continue;
+        }
+        if ( !(p = skipStartTag(p, end, closed)) )
+            return NULL;
+        if ( !closed )
+            ++depth;
+    }
+    return p;
+}
+
+} // namespace
+
+void gsXmlIndex::close()
+{
+    clearEntries();
+    m_file.close();
+}
+
+void gsXmlIndex::clearEntries()
+{
+    m_entries.clear();
+    m_ids.clear();
+    m_rootAttributes.clear();
+}
+
+bool gsXmlIndex::open(const std::string & fn)
+{
+    close();
+    if ( !m_file.open(fn) )
+        return false;
+
+    const char * p = m_file.data(), * end = m_file.end();
+    entry e;
+    bool closed = false;
+
+    // Find the root tag
+    for (;;)
+    {
+        p = std::find(p, end, '<');
+        const char * q = ( p == end ? NULL : skipSpecial(p, end) );
+        if ( q != p )
+        {
+            if ( !q )
+                break;
+            p = q;
+            continue;
+        }
+        p = readStartTag(p, end, e, closed, &m_rootAttributes);
+        break;
+    }
+    if ( !p || "xml" != e.tag )
+    {
+        gsWarn<<"gsXmlIndex: Invalid XML file "<< fn <<", no root tag <xml> found.\n";
+        close();
+        return false;
+    }
+    if ( closed )
+        return true;
+
+    // Index the children of the root
+    for (;;)
+    {
+        p = std::find(p, end, '<');
+        if ( p == end )
+            break;
+        if ( end - p > 1 && '/' == p[1] ) // </xml>
+            return true;
+        const char * q = skipSpecial(p, end);
+        if ( q != p )
+        {
+            if ( !q )
+                break;
+            p = q;
+            continue;
+        }
+
+        e.begin = p - m_file.data();
+        e.node  = NULL;
+        if ( !(p = readStartTag(p, end, e, closed)) ||
+             ( !closed && !(p = skipElement(p, end)) ) )
+            break;
+        e.end = p - m_file.data();
+        if ( -1 != e.id )
+            m_ids.insert( std::make_pair(e.id, m_entries.size()) );
+        m_entries.push_back(e);
+    }
+
+    gsWarn<<"gsXmlIndex: Invalid XML file "<< fn <<", the root tag <xml> is not closed.\n";
+    close();
+    return false;
+}
+
+size_t gsXmlIndex::find(const std::string & tag, const std::string & type) const
+{
+    for (size_t k = 0; k != m_entries.size(); ++k)
+        if ( tag == m_entries[k].tag && (type.empty() || type == m_entries[k].type) )
+            return k;
+    return m_entries.size();
+}
+
+size_t gsXmlIndex::findId(int id) const
+{
+    std::map<int,size_t>::const_iterator it = m_ids.find(id);
+    return it == m_ids.end() ? m_entries.size() : it->second;
+}
+
+bool gsXmlIndex::mayContain(size_t k, const std::string & tag) const
+{
+    // The parser has modified the text of parsed objects
+    if ( m_entries[k].node )
+        return true;
+    const std::string pattern = "<" + tag;
+    const char * p   = m_file.data() + m_entries[k].begin;
+    const char * end = m_file.data() + m_entries[k].end;
+    while ( (p = std::search(p, end, pattern.begin(), pattern.end())) != end )
+    {
+        p += pattern.size();
+        if ( p != end && (isSpace(*p) || '>' == *p || '/' == *p) )
+            return true;
+    }
+    return false;
+}
+
+gsXmlNode * gsXmlIndex::materialize(size_t k, gsXmlTree & data)
+{
+    GISMO_ASSERT(k < m_entries.size(), "Invalid object index.");
+    if ( m_entries[k].node )
+        return m_entries[k].node;
+
+    gsXmlNode * node = data.parseElement<0>(m_file.data() + m_entries[k].begin);
+    m_entries[k].node = node;
+
+    // Insert before the next parsed object, or after the previous one,
+    // to keep the order of the file. The objects of the file precede
+    // the ones which have been added to the tree.
+    gsXmlNode * root = data.getRoot();
+    gsXmlNode * next = NULL;
+    for (size_t j = k + 1; j != m_entries.size() && !next; ++j)
+        next = m_entries[j].node;
+    if ( !next )
+    {
+        size_t j = k;
+        while ( j != 0 && !m_entries[j-1].node )
+            --j;
+        next = ( 0 != j ? m_entries[j-1].node->next_sibling() : root->first_node() );
+    }
+    root->insert_node(next, node);
+
+    materializeReferences(node, data);
+    return node;
+}
+
+void gsXmlIndex::materializeAll(gsXmlTree & data)
+{
+    // Backwards, so that the next parsed object is found at once
+    for (size_t k = m_entries.size(); k-- != 0; )
+        materialize(k, data);
+}
+
+void gsXmlIndex::materializeReferences(gsXmlNode * node, gsXmlTree & data)
+{
+    for (gsXmlNode * child = node->first_node(); child; child = child->next_sibling())
+    {
+        const gsXmlAttribute * type = child->first_attribute("type");
+        const bool range = type && !strcmp(type->value(), "id_range");
+        if ( range || (type && !strcmp(type->value(), "id_index")) )
+        {
+            std::vector<long> ids;
+            char * p = child->value(), * q;
+            for (long i = strtol(p, &q, 10); q != p; i = strtol(p, &q, 10))
+            {
+                ids.push_back(i);
+                p = q;
+            }
+            if ( range && 2 == ids.size() )
+                for (long i = ids[0] + 1; i < ids[1]; ++i)
+                    ids.push_back(i);
+            for (size_t i = 0; i != ids.size(); ++i)
+            {
+                const size_t k = findId(static_cast<int>(ids[i]));
+                if ( k != m_entries.size() )
+                    materialize(k, data);
+            }
+        }
+        materializeReferences(child, data);
+    }
+}
+
+} // namespace internal
+
+} // namespace gismo
@@ -0,0 +1,127 @@
+/** @file gsXmlIndex.h
+
+    @brief Provides an index of the objects of a memory-mapped XML
+    file, which are parsed on demand.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsIO/gsXml.h>
+#include <gsIO/gsMappedFile.h>
+
+#include <map>
+
+namespace gismo
+{
+
+namespace internal
+{
+
+/**
+   \brief Index of the top-level objects of a G+Smo XML file
+
+   The file is mapped into memory and scanned once for the children
+   of the root tag \<xml\>, recording their tag, type, id and
+   position. No XML tree is built by the scan. An object is parsed
+   into the tree only by materialize(), together with the objects it
+   refers to by an id range or an id index (eg. the patches of a
+   MultiPatch). The parsed objects keep the order of the file.
+
+   The mapping is private (copy-on-write), since the XML parser works
+   in place, and it has to outlive the parsed nodes.
+
+   \ingroup IO
+*/
+class GISMO_EXPORT gsXmlIndex
+{
+public:
+
+    /// A top-level object of the file
+    struct entry
+    {
+        std::string tag;   ///< Name of the element
+        std::string type;  ///< Value of the type attribute, or empty
+        int id;            ///< Value of the id attribute, or -1
+        size_t begin, end; ///< Positions of the element in the file
+        gsXmlNode * node;  ///< The parsed element, or NULL
+    };
+
+    /// Attributes of an element, as name and value
+    typedef std::vector< std::pair<std::string,std::string> > attributes;
+
+public:
+
+    gsXmlIndex() { }
+
+    /// Maps the file \a fn and indexes its objects. Returns false if
+    /// the file cannot be mapped or is not a valid G+Smo XML file.
+    bool open(const std::string & fn);
+
+    /// Unmaps the file. The nodes parsed from it become invalid.
+    void close();
+
+    /// Clears the index, but keeps the file mapped, since the nodes
+    /// parsed from it refer to it
+    void clearEntries();
+
+    /// Returns true if a file is mapped
+    bool isOpen() const { return m_file.isOpen(); }
+
+    /// Returns the number of top-level objects of the file
+    size_t size() const { return m_entries.size(); }
+
+    /// Returns the attributes of the root tag \<xml\>
+    const attributes & rootAttributes() const { return m_rootAttributes; }
+
+    /// Returns the top-level object \a k
+    const entry & operator[](size_t k) const { return m_entries[k]; }
+
+    /// Returns the first object with tag \a tag and type \a type (any
+    /// type if empty), or size() if there is none
+    size_t find(const std::string & tag, const std::string & type) const;
+
+    /// Returns the object with id \a id, or size() if there is none
+    size_t findId(int id) const;
+
+    /// Returns false if the object \a k does not contain any element
+    /// with tag \a tag, including itself. Always true for parsed
+    /// objects.
+    bool mayContain(size_t k, const std::string & tag) const;
+
+    /// Parses the object \a k into \a data, if not done yet, and
+    /// returns its node
+    gsXmlNode * materialize(size_t k, gsXmlTree & data);
+
+    /// Parses all objects into \a data
+    void materializeAll(gsXmlTree & data);
+
+private:
+
+    // Parses the objects referred to by id inside \a node
+    void materializeReferences(gsXmlNode * node, gsXmlTree & data);
+
+    // Non-copyable
+    gsXmlIndex(const gsXmlIndex &);
+    gsXmlIndex & operator=(const gsXmlIndex &);
+
+private:
+
+    gsMappedFile m_file;
+
+    std::vector<entry> m_entries;
+
+    /// Position of the first object with a given id
+    std::map<int,size_t> m_ids;
+
+    attributes m_rootAttributes;
+};
+
+} // namespace internal
+
+} // namespace gismo
@@ -272,16 +272,36 @@ public:
                 &&  ( !strcmp(node->first_attribute("type")->value(),"off") ) );
       
         gsMesh<T> * m = new gsMesh<T>;
-        std::istringstream str;
-        str.str( node->value() );
-      
         unsigned n  = atoi ( node->first_attribute("vertices")->value() ) ;
+
+        // Binary payload of the vertex coordinates, every three
+        // consecutive vertices form a triangle
+        if ( isBinaryValue(node) )
+        {
+            std::vector<char> bytes;
+            const int sz = getBinaryValue(node, bytes);
+            if ( 0 == sz || 0 != n % 3 || bytes.size() != static_cast<size_t>(n) * 3 * sz )
+            {
+                gsWarn<<"XML Warning: Reading binary mesh with "<<n<<" vertices failed.\n";
+                return m;
+            }
+            const char * p = bytes.data();
+            for (unsigned i=0; i<n; ++i, p += 3 * sz)
+                m->addVertex(binaryScalar<T>(p, sz), binaryScalar<T>(p + sz, sz),
+                             binaryScalar<T>(p + 2 * sz, sz));
+            for (unsigned i=0; i<n; i += 3)
+                m->addFace(i, i+1, i+2);
+            m->cleanMesh();
+            return m;
+        }
+
+        const char * str = node->value(), * end = str + node->value_size();
         T x,y, z;
         for (unsigned i=0; i<n; ++i)
         {
-            gsGetReal(str, x);
-            gsGetReal(str, y);
-            gsGetReal(str, z);
+            gsGetReal(str, end, x);
+            gsGetReal(str, end, y);
+            gsGetReal(str, end, z);
             m->addVertex(x,y,z);
         }
       
@@ -290,10 +310,10 @@ public:
         std::vector<int> face;
         for (unsigned i=0; i<n; ++i)
         {
-            gsGetInt(str, c);
+            gsGetInt(str, end, c);
             face.resize(c);
             for (unsigned j=0; j<c; ++j)
-                gsGetInt(str, face[j]);
+                gsGetInt(str, end, face[j]);
             m->addFace(face);
         }
         m->cleanMesh();
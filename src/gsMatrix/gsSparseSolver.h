@@ -18,6 +18,7 @@ namespace gismo {
 // forward declarations
 template<typename T> class gsEigenCGIdentity;
 template<typename T> class gsEigenCGDiagonal;
+template<typename T> class gsEigenCGIncompleteCholesky;
 template<typename T> class gsEigenBiCGSTABIdentity;
 template<typename T> class gsEigenBiCGSTABDiagonal;
 template<typename T> class gsEigenBiCGSTABILUT;
@@ -67,6 +68,7 @@ class gsSparseSolver
 public:
     typedef gsEigenCGIdentity<T>           CGIdentity;
     typedef gsEigenCGDiagonal<T>           CGDiagonal;
+    typedef gsEigenCGIncompleteCholesky<T> CGIncompleteCholesky;
     typedef gsEigenBiCGSTABDiagonal<T>     BiCGSTABDiagonal;
     typedef gsEigenBiCGSTABIdentity<T>     BiCGSTABIdentity;
     typedef gsEigenBiCGSTABILUT<T>         BiCGSTABILUT;
@@ -161,6 +163,7 @@ std::ostream &operator<<(std::ostream &os, const gsSparseSolver<T>& b)
 
 GISMO_EIGEN_SPARSE_SOLVER (gsEigenCGIdentity,     CGIdentity)
 GISMO_EIGEN_SPARSE_SOLVER (gsEigenCGDiagonal,     CGDiagonal)
+GISMO_EIGEN_SPARSE_SOLVER (gsEigenCGIncompleteCholesky, CGIncompleteCholesky)
 GISMO_EIGEN_SPARSE_SOLVER (gsEigenBiCGSTABIdentity, BiCGSTABIdentity)
 GISMO_EIGEN_SPARSE_SOLVER (gsEigenBiCGSTABDiagonal, BiCGSTABDiagonal)
 GISMO_EIGEN_SPARSE_SOLVER (gsEigenBiCGSTABILUT,     BiCGSTABILUT)
@@ -23,6 +23,9 @@ namespace gismo
 /**
   @brief 
    Class for performing a least squares fit of a parametrized point cloud with a gsGeometry.
+
+   The system is assembled in parallel if OpenMP is enabled, see
+   assembleSystem(). The linear solver can be chosen by setSolver().
     
    \ingroup Modeling
 **/
@@ -30,11 +33,22 @@ template<class T>
 class gsFitting
 {
 public:
+
+    /// Linear solvers for the least squares system, see setSolver()
+    enum solver
+    {
+        bicgstabILUT         = 0, ///< BiCGStab with incomplete LU factorization
+        cgDiagonal           = 1, ///< Conjugate gradients with Jacobi preconditioner
+        cgIncompleteCholesky = 2, ///< Conjugate gradients with incomplete Cholesky factorization
+        cholesky             = 3  ///< Sparse direct solver (LDL^T factorization)
+    };
+
     /// default constructor
     gsFitting()
     {
         m_basis = NULL;
         m_result= NULL ;
+        m_solver = bicgstabILUT;
     }
 
     /// constructor
@@ -90,9 +104,27 @@ public:
     /// with parameter lambda.
     void applySmoothing(T lambda, gsSparseMatrix<T> & A_mat);
     
-    /// Assembles system for the least square fit.
+    /// @brief Assembles system for the least square fit.
+    ///
+    /// The points are grouped by the elements that contain them, and
+    /// the contributions of each group are summed up in a small dense
+    /// matrix before they are added to the sparse matrix of the
+    /// thread. The grouping is kept for the next call; if the basis
+    /// was refined meanwhile (see gsHFitting), the groups are still
+    /// valid for the unrefined elements and are updated during the
+    /// assembly.
     void assembleSystem(gsSparseMatrix<T>& A_mat, gsMatrix<T>& B);
 
+    /// @brief Sets the linear solver used by compute()
+    ///
+    /// The conjugate gradient methods and the direct solver require
+    /// the normal matrix to be positive definite, which is the case
+    /// without constraints; otherwise, \a bicgstabILUT is used.
+    void setSolver(solver s) { m_solver = s; }
+
+    /// Returns the linear solver used by compute()
+    solver getSolver() const { return m_solver; }
+
 
 public:
 
@@ -131,6 +163,9 @@ private:
     /// Extends the system of equations by taking constraints into account.
     void extendSystem(gsSparseMatrix<T>& A_mat, gsMatrix<T>& m_B);
 
+    /// Sorts the points by the given keys (counting sort into m_pointOrder)
+    void sortPoints(const std::vector<index_t>& keys, index_t numKeys);
+
 protected:
 
     /// the parameter values of the point cloud
@@ -166,6 +201,12 @@ protected:
     /// Bezier and B-spline techniques, Section 4.7.
     gsMatrix<T>       m_constraintsRHS;
 
+    /// The linear solver
+    solver m_solver;
+
+    /// The points, ordered by the elements that contain them
+    std::vector<index_t> m_pointOrder;
+
 private:
     //void applySmoothing(T lambda, gsMatrix<T> & A_mat);
 
@@ -17,6 +17,7 @@
 #include <gsCore/gsGeometry.h>
 #include <gsCore/gsLinearAlgebra.h>
 #include <gsTensor/gsTensorDomainIterator.h>
+#include <gsSolver/gsParallelKernels.h>
 
 
 namespace gismo
@@ -39,6 +40,7 @@ gsFitting<T>::  gsFitting(gsMatrix<T> const & param_values,
     m_result = NULL;
     m_basis = &basis;
     m_points.transposeInPlace();
+    m_solver = bicgstabILUT;
 }
 
 template<class T>
@@ -87,17 +89,59 @@ void gsFitting<T>::compute(T lambda)
     //gsDebugVar( A_mat.nonZerosPerCol().minCoeff() );
     A_mat.makeCompressed();
 
-    typename gsSparseSolver<T>::BiCGSTABILUT solver( A_mat );
-
-    if ( solver.preconditioner().info() != Eigen::Success )
+    solver choice = m_solver;
+    if ( m_constraintsLHS.rows() > 0 && choice != bicgstabILUT )
     {
-        gsWarn<<  "The preconditioner failed. Aborting.\n";
-        m_result = NULL;
-        return;
+        gsWarn << "The system with constraints is not positive definite, using BiCGStab.\n";
+        choice = bicgstabILUT;
     }
+
     // Solves for many right hand side  columns
     gsMatrix<T> x;
-    x = solver.solve(m_B); //toDense()
+    switch (choice)
+    {
+    case cgDiagonal:
+    {
+        typename gsSparseSolver<T>::CGDiagonal solver( A_mat );
+        x = solver.solve(m_B);
+        break;
+    }
+    case cgIncompleteCholesky:
+    {
+        typename gsSparseSolver<T>::CGIncompleteCholesky solver( A_mat );
+        if ( solver.preconditioner().info() != Eigen::Success )
+        {
+            gsWarn<<  "The preconditioner failed. Aborting.\n";
+            m_result = NULL;
+            return;
+        }
+        x = solver.solve(m_B);
+        break;
+    }
+    case cholesky:
+    {
+        typename gsSparseSolver<T>::SimplicialLDLT solver( A_mat );
+        if ( solver.info() != Eigen::Success )
+        {
+            gsWarn<<  "The factorization failed. Aborting.\n";
+            m_result = NULL;
+            return;
+        }
+        x = solver.solve(m_B);
+        break;
+    }
+    default:
+    {
+        typename gsSparseSolver<T>::BiCGSTABILUT solver( A_mat );
+        if ( solver.preconditioner().info() != Eigen::Success )
+        {
+            gsWarn<<  "The preconditioner failed. Aborting.\n";
+            m_result = NULL;
+            return;
+        }
+        x = solver.solve(m_B); //toDense()
+    }
+    }
 
     // If there were constraints, we obtained too many coefficients.
     x.conservativeResize(num_basis, Eigen::NoChange);
@@ -110,36 +154,129 @@ void gsFitting<T>::compute(T lambda)
 }
 
 
+template <class T>
+void gsFitting<T>::sortPoints(const std::vector<index_t>& keys, index_t numKeys)
+{
+    std::vector<index_t> start(numKeys + 1, 0);
+    for (size_t k = 0; k != keys.size(); ++k)
+        ++start[keys[k] + 1];
+    for (index_t i = 0; i != numKeys; ++i)
+        start[i + 1] += start[i];
+
+    m_pointOrder.resize(keys.size());
+    for (size_t k = 0; k != keys.size(); ++k)
+        m_pointOrder[ start[keys[k]]++ ] = k;
+}
+
 template <class T>
 void gsFitting<T>::assembleSystem(gsSparseMatrix<T>& A_mat,
                                   gsMatrix<T>& m_B)
 {
-    const int num_points = m_points.rows();
+    const index_t num_points = m_points.rows();
+    const index_t num_basis  = m_basis->size();
+    const index_t blockSize  = 256; // number of points evaluated at once
+
+    // The points are grouped by their first active function, which
+    // identifies the element
+    std::vector<index_t> keys(num_points);
+    if ( (index_t)m_pointOrder.size() != num_points )
+    {
+#       pragma omp parallel for schedule(static) if (num_points > 1000)
+        for (index_t b = 0; b < num_points; b += blockSize)
+        {
+            const index_t nb = math::min(blockSize, num_points - b);
+            gsMatrix<index_t> actives;
+            m_basis->active_into(m_param_values.middleCols(b, nb), actives);
+            for (index_t j = 0; j != nb; ++j)
+                keys[b + j] = actives(0, j);
+        }
+        sortPoints(keys, num_basis);
+    }
 
-    //for computing the value of the basis function
-    gsMatrix<T> value, curr_point;
-    gsMatrix<index_t> actives;
+#   ifdef _OPENMP
+    const index_t maxThreads = omp_get_max_threads();
+#   else
+    const index_t maxThreads = 1;
+#   endif
+    std::vector< gsSparseMatrix<T> > partA(maxThreads);
+    std::vector< gsMatrix<T> >       partB(maxThreads);
 
-    for(index_t k = 0; k != num_points; ++k)
+#   pragma omp parallel if (num_points > 1000)
     {
-        curr_point = m_param_values.col(k);
-
-        //computing the values of the basis functions at the current point
-        m_basis->eval_into(curr_point, value);
+#       ifdef _OPENMP
+        const index_t tid = omp_get_thread_num();
+#       else
+        const index_t tid = 0;
+#       endif
+        index_t i0, i1;
+        internal::threadRange(num_points, i0, i1);
+
+        gsMatrix<T> & B = partB[tid];
+        B.setZero(m_B.rows(), m_B.cols());
+        gsSparseEntries<T> entries;
+
+        gsMatrix<T> params, values, localA;
+        gsMatrix<index_t> actives, elActives;
+
+        for (index_t b = i0; b < i1; b += blockSize)
+        {
+            const index_t nb = math::min(blockSize, i1 - b);
+            params.resize(m_param_values.rows(), nb);
+            for (index_t j = 0; j != nb; ++j)
+                params.col(j) = m_param_values.col(m_pointOrder[b + j]);
+
+            //computing the values of the basis functions at the points
+            m_basis->eval_into(params, values);
+
+            // which functions have been computed i.e. which are active
+            m_basis->active_into(params, actives);
+            GISMO_ASSERT( values.rows() == actives.rows(), "Values and actives do not match." );
+
+            const index_t numActive = actives.rows();
+            for (index_t j = 0; j != nb; ++j)
+            {
+                const index_t k = m_pointOrder[b + j];
+                keys[k] = actives(0, j);
+
+                // A new element: add the contributions of the previous one
+                if ( elActives.rows() != numActive || elActives != actives.col(j) )
+                {
+                    for (index_t c = 0; c != localA.cols(); ++c)
+                        for (index_t r = 0; r != localA.rows(); ++r)
+                            if ( localA(r, c) != 0 )
+                                entries.add(elActives(r, 0), elActives(c, 0), localA(r, c));
+                    elActives = actives.col(j);
+                    localA.setZero(numActive, numActive);
+                }
 
-        // which functions have been computed i.e. which are active
-        m_basis->active_into(curr_point, actives);
+                localA.noalias() += values.col(j) * values.col(j).transpose();
+                for (index_t i = 0; i != numActive; ++i)
+                    B.row(actives(i, j)) += values(i, j) * m_points.row(k);
+            }
+        }
+        for (index_t c = 0; c != localA.cols(); ++c)
+            for (index_t r = 0; r != localA.rows(); ++r)
+                if ( localA(r, c) != 0 )
+                    entries.add(elActives(r, 0), elActives(c, 0), localA(r, c));
 
-        const index_t numActive = actives.rows();
+        partA[tid].resize(A_mat.rows(), A_mat.cols());
+        partA[tid].setFrom(entries);
+    }
 
-        for (index_t i = 0; i != numActive; ++i)
+    // Summed up in the order of the threads, for reproducible results.
+    // The entries are added one by one, so that A_mat keeps the reserved
+    // space for the smoothing term
+    for (index_t t = 0; t != maxThreads; ++t)
+        if ( partB[t].rows() == m_B.rows() )
         {
-            const index_t ii = actives.at(i);
-            m_B.row(ii) += value.at(i) * m_points.row(k);
-            for (index_t j = 0; j != numActive; ++j)
-                A_mat(ii, actives.at(j)) += value.at(i) * value.at(j);
+            for (index_t c = 0; c != partA[t].outerSize(); ++c)
+                for (typename gsSparseMatrix<T>::InnerIterator it(partA[t], c); it; ++it)
+                    A_mat.coeffRef(it.row(), it.col()) += it.value();
+            m_B += partB[t];
         }
-    }
+
+    // The grouping for the next assembly
+    sortPoints(keys, num_basis);
 }
 
 template <class T>
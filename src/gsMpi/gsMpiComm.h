@@ -351,6 +351,17 @@ public:
         return 0;
     }
 
+    /** @brief Compute the sum over all processes for each component
+        of an array and return the result in every process
+        (non-blocking). The result is available after waiting for
+        the request \a req.
+    */
+    template<typename T>
+    static int isum (T* inout, int len, const MPI_Request* req)
+    {
+        return 0;
+    }
+
     /** @brief Compute the product of the argument over all processes
         and return the result in every process. Assumes that T has an
         operator*
@@ -454,11 +465,11 @@ public:
      * @param[in] in The send buffer with the data to send
      * @param[in] len The number of elements which will be sent
      * @param[in] dest The rank of the process which should receive the message
-     * @param[out] request communication request
+     * @param[out] req communication request
      * @param[in] tag Specifies the message ID
      */
     template<typename T>
-    static int isend (T* in, int len, int dest, MPI_Request request, int tag = 0)
+    static int isend (T* in, int len, int dest, const MPI_Request* req, int tag = 0)
     {
         return 0;
     }
@@ -485,11 +496,11 @@ public:
      * @param[out] out The buffer to store the received data in
      * @param[in] len The number of elements which will be received
      * @param[in] source The rank of the process which sended the message
-     * @param[out] request communication request
+     * @param[out] req communication request
      * @param[in] tag Specifies the message ID
      */
     template<typename T>
-    static int irecv (T* out, int len, int source, MPI_Request request, int tag = 0)
+    static int irecv (T* out, int len, int source, const MPI_Request* req, int tag = 0)
     {
         return 0;
     }
@@ -643,6 +654,39 @@ public:
         return 0;
     }
 
+    /**
+     * @brief Sends \a sendcount elements to every process and receives
+     * \a recvcount elements from every process.
+     *
+     * The block of data sent to the jth process is taken from the jth
+     * block of the buffer send and received in the ith block of the
+     * buffer recv of the jth process, where i is the rank of the sender.
+     */
+    template<typename T>
+    static int alltoall (T* send, T* recv, int sendcount, int)
+    {
+        for (int i=0; i<sendcount; i++)
+            recv[i] = send[i];
+        return 0;
+    }
+
+    /**
+     * @brief Sends data of variable length to every process and
+     * receives data of variable length from every process.
+     *
+     * The block sent to process j has sendcount[j] elements starting
+     * at send+senddispl[j], the block received from process j has
+     * recvcount[j] elements starting at recv+recvdispl[j].
+     */
+    template<typename T>
+    static int alltoallv (T* send, int* sendcount, int* senddispl,
+                          T* recv, int*, int* recvdispl)
+    {
+        for (int i=0; i<*sendcount; i++)
+            recv[*recvdispl+i] = send[*senddispl+i];
+        return 0;
+    }
+
     /**
      * @brief Compute something over all processes
      * for each component of an array and return the result
@@ -1299,8 +1343,7 @@ public:
                             root,m_comm);
     }
 
-    /// @copydoc gsSerialComm::scatter()
-    /// @note out must have space for P*len elements
+    /// @copydoc gsSerialComm::alltoall()
     template<typename T>
     int alltoall (T* send, T* recv, int sendcount, int recvcount) const
     {
@@ -1309,7 +1352,7 @@ public:
                             m_comm);
     }
 
-    /// @copydoc gsSerialComm::scatterv()
+    /// @copydoc gsSerialComm::alltoallv()
     template<typename T>
     int alltoallv (T* send, int* sendcount, int* senddispl, T* recv, int* recvcount, int* recvdispl) const
     {
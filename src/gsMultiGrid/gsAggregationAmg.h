@@ -0,0 +1,165 @@
+/** @file gsAggregationAmg.h
+
+    @brief Aggregation-based algebraic multigrid.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsMultiGrid/gsMultiGrid.h>
+
+namespace gismo
+{
+
+/** @brief
+    Smoothed aggregation algebraic multigrid.
+
+    The hierarchy is set up from the matrix only: the unknowns are
+    grouped into aggregates of strongly connected unknowns, the
+    piecewise constant prolongation of the aggregates is smoothed by
+    one damped Jacobi step (with the matrix filtered by the strength
+    of the connections), and the coarse matrices are the Galerkin
+    products. The coarsening stops at the size \a CoarseSize, where a
+    sparse direct solver is used.
+
+    One step of the operator is one cycle of the underlying
+    gsMultiGridOp with symmetric Gauss-Seidel smoothing. It is meant
+    for symmetric positive definite matrices, eg. as a coarse solver
+    for a geometric multigrid method:
+
+    \code{.cpp}
+    mg->setCoarseSolver( gsAggregationAmgOp<>::make(mg->matrix(0)) );
+    \endcode
+
+    The aggregates and prolongations can be kept when the values of
+    the matrix change, see updateMatrix().
+
+    \ingroup Solver
+*/
+template<class T>
+class gsAggregationAmgOp GISMO_FINAL : public gsPreconditionerOp<T>
+{
+public:
+
+    /// Shared pointer for gsAggregationAmgOp
+    typedef memory::shared_ptr<gsAggregationAmgOp> Ptr;
+
+    /// Unique pointer for gsAggregationAmgOp
+    typedef memory::unique_ptr<gsAggregationAmgOp> uPtr;
+
+    /// Base class
+    typedef gsPreconditionerOp<T> Base;
+
+    /// Shared pointer to gsLinearOperator
+    typedef typename gsLinearOperator<T>::Ptr OpPtr;
+
+    /// Matrix type
+    typedef gsSparseMatrix<T> SpMatrix;
+
+    /// Matrix type of the transfers
+    typedef gsSparseMatrix<T, RowMajor> SpMatrixRowMajor;
+
+    /// Smart pointer to matrix type
+    typedef memory::shared_ptr<SpMatrix> SpMatrixPtr;
+
+    /// @brief Constructor
+    ///
+    /// @param mat   The (symmetric positive definite) matrix
+    /// @param opt   Options, see defaultOptions()
+    explicit gsAggregationAmgOp(const SpMatrix& mat, const gsOptionList& opt = defaultOptions())
+    { init(SpMatrixPtr(new SpMatrix(mat)), opt); }
+
+    /// @brief Constructor with shared pointer to matrix
+    ///
+    /// @param mat   The (symmetric positive definite) matrix
+    /// @param opt   Options, see defaultOptions()
+    explicit gsAggregationAmgOp(const SpMatrixPtr& mat, const gsOptionList& opt = defaultOptions())
+    { init(mat, opt); }
+
+    /// Make function
+    static uPtr make(const SpMatrix& mat, const gsOptionList& opt = defaultOptions())
+    { return uPtr( new gsAggregationAmgOp(mat, opt) ); }
+
+    /// Make function taking a shared pointer
+    static uPtr make(const SpMatrixPtr& mat, const gsOptionList& opt = defaultOptions())
+    { return uPtr( new gsAggregationAmgOp(mat, opt) ); }
+
+    void step(const gsMatrix<T>& rhs, gsMatrix<T>& x) const;
+
+    void stepT(const gsMatrix<T>& rhs, gsMatrix<T>& x) const;
+
+    OpPtr underlyingOp() const                  { return m_op;              }
+
+    index_t rows() const                        { return m_op->rows();      }
+    index_t cols() const                        { return m_op->cols();      }
+
+    /// Number of levels of the hierarchy
+    index_t numLevels() const                   { return m_mg ? m_mg->numLevels() : 1; }
+
+    /// The underlying multigrid method (null if the matrix was not coarsened)
+    const typename gsMultiGridOp<T>::Ptr & multiGrid() const { return m_mg; }
+
+    /// @brief Updates the hierarchy after the values of the matrix changed
+    ///
+    /// The aggregates and the prolongations are kept, the coarse
+    /// matrices are recomputed for the unchanged sparsity patterns
+    /// (see gsMultiGridOp::updateMatrix).
+    ///
+    /// @param mat   The matrix, with the same sparsity pattern as before
+    void updateMatrix(const SpMatrix& mat);
+
+    /// @brief Groups the unknowns into aggregates
+    ///
+    /// The unknowns i and j are strongly connected if
+    /// \f$ |a_{ij}| > \theta \sqrt{|a_{ii} a_{jj}|} \f$. Unknowns with no
+    /// strong connections form aggregates on their own.
+    ///
+    /// @param mat    A symmetric matrix
+    /// @param theta  Threshold for the strength of the connections
+    /// @param agg    The aggregate of each unknown
+    /// @returns the number of aggregates
+    static index_t aggregate(const SpMatrix& mat, T theta, std::vector<index_t>& agg);
+
+    /// @brief Provides the (smoothed) prolongation of the aggregates
+    ///
+    /// @param mat       A symmetric matrix
+    /// @param theta     Threshold for the strength of the connections
+    /// @param agg       The aggregate of each unknown
+    /// @param nAgg      The number of aggregates
+    /// @param damping   Damping of the smoothing step, relative to the
+    ///                  inverse of the spectral radius of the Jacobi
+    ///                  preconditioned matrix; 0 gives the piecewise
+    ///                  constant prolongation
+    static SpMatrixRowMajor prolongation(const SpMatrix& mat, T theta,
+                                         const std::vector<index_t>& agg, index_t nAgg,
+                                         T damping = T(4)/T(3));
+
+    /// Returns a list of default options
+    static gsOptionList defaultOptions();
+
+private:
+
+    void init(const SpMatrixPtr& mat, const gsOptionList& opt);
+
+private:
+
+    // The matrix
+    OpPtr m_op;
+
+    // The multigrid method on the hierarchy
+    typename gsMultiGridOp<T>::Ptr m_mg;
+
+    // Direct solver if the matrix is not coarsened
+    OpPtr m_direct;
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsAggregationAmg.hpp)
+#endif
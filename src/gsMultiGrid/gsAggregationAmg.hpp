@@ -0,0 +1,250 @@
+/** @file gsAggregationAmg.hpp
+
+    @brief Aggregation-based algebraic multigrid.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gsMultiGrid/gsAggregationAmg.h>
+#include <gsSolver/gsMatrixOp.h>
+#include <gsSolver/gsSimplePreconditioners.h>
+
+namespace gismo
+{
+
+template<class T>
+void gsAggregationAmgOp<T>::init(const SpMatrixPtr& mat, const gsOptionList& opt)
+{
+    GISMO_ASSERT( mat->rows() == mat->cols(), "gsAggregationAmgOp needs a quadratic matrix." );
+    this->setOptions(opt);
+
+    const T       theta      = opt.askReal("StrengthThreshold"  , T(8)/T(100));
+    const T       damping    = opt.askReal("ProlongationDamping", T(4)/T(3)  );
+    const index_t coarseSize = opt.askInt ("CoarseSize"         , 200        );
+    const index_t maxLevels  = opt.askInt ("MaxLevels"          , 20         );
+
+    m_op = makeMatrixOp(mat);
+
+    // Matrices and transfers, from the finest to the coarsest level
+    std::vector<SpMatrixPtr> mats(1, mat);
+    std::vector< memory::shared_ptr<SpMatrixRowMajor> > transfers;
+    std::vector<index_t> agg;
+    while ( mats.back()->rows() > coarseSize && (index_t)mats.size() < maxLevels )
+    {
+        const SpMatrix & A = *mats.back();
+        const index_t nAgg = aggregate(A, theta, agg);
+        if ( 10 * nAgg > 9 * A.rows() ) // no coarsening
+            break;
+
+        memory::shared_ptr<SpMatrixRowMajor> P( new SpMatrixRowMajor(
+            prolongation(A, theta, agg, nAgg, damping) ) );
+        mats.push_back( SpMatrixPtr( new SpMatrix( P->transpose() * A * *P ) ) );
+        transfers.push_back(P);
+    }
+
+    if ( transfers.empty() )
+    {
+        m_mg.reset();
+        m_direct = makeSparseLUSolver(*mat);
+        return;
+    }
+
+    // gsMultiGridOp counts the levels from the coarsest one
+    const index_t nLevels = mats.size();
+    std::vector<OpPtr> ops(nLevels), prolong(nLevels-1), restrict(nLevels-1);
+    for (index_t i = 0; i < nLevels; ++i)
+        ops[i] = makeMatrixOp(mats[nLevels-1-i]);
+    for (index_t i = 0; i < nLevels-1; ++i)
+    {
+        const memory::shared_ptr<SpMatrixRowMajor> & P = transfers[nLevels-2-i];
+        typename gsMatrixOp<SpMatrixRowMajor>::Ptr prolongOp = makeMatrixOp(P);
+        prolong [i] = prolongOp;
+        // The transpose refers to the matrix kept alive by prolong[i]
+        restrict[i] = makeMatrixOp(prolongOp->matrix().transpose());
+    }
+
+    m_mg = memory::make_shared( new gsMultiGridOp<T>(ops, prolong, restrict) );
+    m_mg->setOptions(opt);
+    for (index_t i = 1; i < nLevels; ++i)
+        m_mg->setSmoother(i, makeGaussSeidelOp(mats[nLevels-1-i]));
+    m_direct.reset();
+}
+
+template<class T>
+void gsAggregationAmgOp<T>::step(const gsMatrix<T>& rhs, gsMatrix<T>& x) const
+{
+    if (m_mg)
+        m_mg->step(rhs, x);
+    else
+        m_direct->apply(rhs, x);
+}
+
+template<class T>
+void gsAggregationAmgOp<T>::stepT(const gsMatrix<T>& rhs, gsMatrix<T>& x) const
+{
+    if (m_mg)
+        m_mg->stepT(rhs, x);
+    else
+        m_direct->apply(rhs, x);
+}
+
+template<class T>
+void gsAggregationAmgOp<T>::updateMatrix(const SpMatrix& mat)
+{
+    if (m_mg)
+    {
+        m_mg->updateMatrix(mat);
+        return;
+    }
+
+    const gsMatrixOp<SpMatrix>* matrOp = static_cast< const gsMatrixOp<SpMatrix>* >( m_op.get() );
+    SpMatrix & A = *matrOp->matrixPtr();
+    if ( &A != &mat )
+        A = mat;
+    m_direct = makeSparseLUSolver(A);
+}
+
+template<class T>
+index_t gsAggregationAmgOp<T>::aggregate(const SpMatrix& mat, T theta, std::vector<index_t>& agg)
+{
+    const index_t n = mat.rows();
+    const gsVector<T> diag = mat.diagonal();
+    const T theta2 = theta * theta;
+
+    // Strong connections; as the matrix is symmetric, the column i
+    // holds the neighbours of i
+    std::vector<index_t> begin(n+1, 0), nbr;
+    std::vector<T> weight;
+    nbr.reserve(mat.nonZeros());
+    weight.reserve(mat.nonZeros());
+    for (index_t i = 0; i < n; ++i)
+    {
+        for (typename SpMatrix::InnerIterator it(mat, i); it; ++it)
+            if ( it.index() != i &&
+                 it.value() * it.value() > theta2 * math::abs(diag[i] * diag[it.index()]) )
+            {
+                nbr.push_back(it.index());
+                weight.push_back(math::abs(it.value()));
+            }
+        begin[i+1] = nbr.size();
+    }
+
+    agg.assign(n, -1);
+    index_t nAgg = 0;
+
+    // 1. Unknowns without aggregated neighbours start new aggregates
+    for (index_t i = 0; i < n; ++i)
+    {
+        if ( agg[i] != -1 )
+            continue;
+        index_t k = begin[i];
+        while ( k < begin[i+1] && agg[nbr[k]] == -1 )
+            ++k;
+        if ( k < begin[i+1] )
+            continue;
+        agg[i] = nAgg;
+        for (k = begin[i]; k < begin[i+1]; ++k)
+            agg[nbr[k]] = nAgg;
+        ++nAgg;
+    }
+
+    // 2. The remaining unknowns join the aggregate of their strongest neighbour
+    const std::vector<index_t> agg1 = agg;
+    for (index_t i = 0; i < n; ++i)
+    {
+        if ( agg1[i] != -1 )
+            continue;
+        T strongest = 0;
+        for (index_t k = begin[i]; k < begin[i+1]; ++k)
+            if ( agg1[nbr[k]] != -1 && weight[k] > strongest )
+            {
+                strongest = weight[k];
+                agg[i] = agg1[nbr[k]];
+            }
+    }
+
+    // 3. Leftovers are aggregated with their unaggregated neighbours
+    for (index_t i = 0; i < n; ++i)
+    {
+        if ( agg[i] != -1 )
+            continue;
+        agg[i] = nAgg;
+        for (index_t k = begin[i]; k < begin[i+1]; ++k)
+            if ( agg[nbr[k]] == -1 )
+                agg[nbr[k]] = nAgg;
+        ++nAgg;
+    }
+
+    return nAgg;
+}
+
+template<class T>
+typename gsAggregationAmgOp<T>::SpMatrixRowMajor gsAggregationAmgOp<T>::prolongation(
+    const SpMatrix& mat, T theta, const std::vector<index_t>& agg, index_t nAgg, T damping)
+{
+    const index_t n = mat.rows();
+    GISMO_ASSERT( (index_t)agg.size() == n, "The aggregates do not fit to the matrix." );
+
+    gsSparseEntries<T> se;
+    if ( damping == 0 )
+    {
+        for (index_t i = 0; i < n; ++i)
+            se.add(i, agg[i], 1);
+        SpMatrixRowMajor result(n, nAgg);
+        result.setFrom(se);
+        return result;
+    }
+
+    // Filtered matrix: the weak connections are lumped into the diagonal
+    const gsVector<T> diag = mat.diagonal();
+    const T theta2 = theta * theta;
+    gsVector<T> fdiag = diag;
+    T rho = 0; // Bound for the spectral radius of the filtered Jacobi matrix
+    for (index_t i = 0; i < n; ++i)
+    {
+        T rowSum = 0;
+        for (typename SpMatrix::InnerIterator it(mat, i); it; ++it)
+        {
+            if ( it.index() == i )
+                continue;
+            if ( it.value() * it.value() > theta2 * math::abs(diag[i] * diag[it.index()]) )
+                rowSum += math::abs(it.value());
+            else
+                fdiag[i] += it.value();
+        }
+        GISMO_ASSERT( fdiag[i] != 0, "The filtered matrix has a zero diagonal entry." );
+        rho = math::max(rho, 1 + rowSum / math::abs(fdiag[i]));
+    }
+    const T omega = damping / rho;
+
+    // P = (I - omega D_F^{-1} A_F) P_tent
+    for (index_t i = 0; i < n; ++i)
+    {
+        se.add(i, agg[i], 1 - omega);
+        for (typename SpMatrix::InnerIterator it(mat, i); it; ++it)
+            if ( it.index() != i &&
+                 it.value() * it.value() > theta2 * math::abs(diag[i] * diag[it.index()]) )
+                se.add(i, agg[it.index()], - omega * it.value() / fdiag[i]);
+    }
+    SpMatrixRowMajor result(n, nAgg);
+    result.setFrom(se);
+    result.prune(T(0));
+    return result;
+}
+
+template<class T>
+gsOptionList gsAggregationAmgOp<T>::defaultOptions()
+{
+    gsOptionList opt = gsMultiGridOp<T>::defaultOptions();
+    opt.addReal("StrengthThreshold"  , "Threshold for strongly connected unknowns",              T(8)/T(100) );
+    opt.addReal("ProlongationDamping", "Damping of the prolongation smoothing (0: unsmoothed)",  T(4)/T(3)   );
+    opt.addInt ("CoarseSize"         , "Size below which the matrix is not coarsened further",  200         );
+    opt.addInt ("MaxLevels"          , "Maximum number of levels",                               20          );
+    return opt;
+}
+
+} // namespace gismo
@@ -0,0 +1,19 @@
+/** @file gsAggregationAmg_.cpp
+
+    @brief Aggregation-based algebraic multigrid.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gsMultiGrid/gsAggregationAmg.hpp>
+
+namespace gismo
+{
+
+CLASS_TEMPLATE_INST gsAggregationAmgOp<real_t>;
+
+}
@@ -16,6 +16,7 @@
 #include <gsCore/gsDofMapper.h>
 #include <gsNurbs/gsKnotVector.h>
 #include <gsIO/gsOptionList.h>
+#include <gsSolver/gsLinearOperator.h>
 
 namespace gismo
 {
@@ -26,6 +27,13 @@ namespace gismo
     This class allows to construct a grid hierarchy and stors a grid hierarchy (vector of
     bases, local transfer matrices and transfer matrices).
 
+    If all patches are tensor B-spline bases, the transfers are set up from the
+    transfers of the univariate bases (see gsTensorTransferOp), unless the option
+    \a TensorTransfers is switched off. If the option \a AssembleTransfers is
+    switched off, the transfer matrices are not formed; then only the transfer
+    operators are provided (see getProlongations() and getRestrictions()), which
+    can be passed to gsMultiGridOp.
+
     \ingroup Solver
 */
 template< typename T >
@@ -127,6 +135,8 @@ public:
         opt.addInt( "DegreesOfFreedom",   "Number of dofs in the coarsest grid in the grid hierarchy (only buildByCoarsening)", 0 );
         opt.addInt( "NumberOfKnotsToBeInserted", "The number of knots to be inserted (only buildByRefinement)", 1 );
         opt.addInt( "MultiplicityOfKnotsToBeInserted",   "The multiplicity of the knots to be inserted (only buildByRefinement)", 1 );
+        opt.addSwitch( "TensorTransfers", "Set up the transfers of tensor B-spline bases from the univariate transfers", true );
+        opt.addSwitch( "AssembleTransfers", "Assemble the transfer matrices; otherwise, only the transfer operators are provided (requires tensor B-spline bases)", true );
         return opt;
     }
 
@@ -141,6 +151,8 @@ public:
         //m_options.clear();
         m_mBases.clear();
         m_transferMatrices.clear();
+        m_prolongations.clear();
+        m_restrictions.clear();
     }
 
     /// Get the vector of multi bases (by reference)
@@ -157,16 +169,41 @@ public:
     gsGridHierarchy& moveTransferMatricesTo( std::vector< gsSparseMatrix<T, RowMajor> >& o )
     { o = give(m_transferMatrices); return *this; }
 
+    /// Get the vector of prolongation operators (only if the transfer matrices are not assembled)
+    const std::vector< typename gsLinearOperator<T>::Ptr >& getProlongations() const
+    { return m_prolongations; }
+    /// Get the vector of prolongation operators
+    gsGridHierarchy& moveProlongationsTo( std::vector< typename gsLinearOperator<T>::Ptr >& o )
+    { o = give(m_prolongations); return *this; }
+
+    /// Get the vector of restriction operators (only if the transfer matrices are not assembled)
+    const std::vector< typename gsLinearOperator<T>::Ptr >& getRestrictions() const
+    { return m_restrictions; }
+    /// Get the vector of restriction operators
+    gsGridHierarchy& moveRestrictionsTo( std::vector< typename gsLinearOperator<T>::Ptr >& o )
+    { o = give(m_restrictions); return *this; }
+
     /// Get the boundary conditions
     const gsBoundaryConditions<T>& getBoundaryConditions() const
     { return m_boundaryConditions; }
 
+private:
+    // Sets up the transfer between the given bases from the univariate transfers
+    void addTensorTransfer(
+        std::vector< std::vector< gsSparseMatrix<T, RowMajor> > > localTransfers,
+        const gsMultiBasis<T>& coarseMBasis,
+        const gsMultiBasis<T>& fineMBasis,
+        bool assemble
+        );
+
 private:
     gsBoundaryConditions<T> m_boundaryConditions;
     gsOptionList m_options;
 
     std::vector< gsMultiBasis<T> > m_mBases;
     std::vector< gsSparseMatrix<T, RowMajor> > m_transferMatrices;
+    std::vector< typename gsLinearOperator<T>::Ptr > m_prolongations;
+    std::vector< typename gsLinearOperator<T>::Ptr > m_restrictions;
 };
 
 } // namespace gismo
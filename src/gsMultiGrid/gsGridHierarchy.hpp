@@ -21,10 +21,49 @@
 #include <gsIO/gsOptionList.h>
 #include <gsAssembler/gsAssemblerOptions.h>
 #include <gsCore/gsMultiBasis.h>
+#include <gsMultiGrid/gsTensorTransfer.h>
 
 namespace gismo
 {
 
+template <typename T>
+void gsGridHierarchy<T>::addTensorTransfer(
+    std::vector< std::vector< gsSparseMatrix<T, RowMajor> > > localTransfers,
+    const gsMultiBasis<T>& coarseMBasis,
+    const gsMultiBasis<T>& fineMBasis,
+    bool assemble
+    )
+{
+    gsDofMapper coarseMapper, fineMapper;
+    coarseMBasis.getMapper(
+        (dirichlet::strategy)m_options.askInt("DirichletStrategy",11),
+        (iFace    ::strategy)m_options.askInt("InterfaceStrategy", 1),
+        m_boundaryConditions,
+        coarseMapper,
+        0
+    );
+    fineMBasis.getMapper(
+        (dirichlet::strategy)m_options.askInt("DirichletStrategy",11),
+        (iFace    ::strategy)m_options.askInt("InterfaceStrategy", 1),
+        m_boundaryConditions,
+        fineMapper,
+        0
+    );
+
+    typename gsTensorTransferOp<T>::uPtr transfer
+        = gsTensorTransferOp<T>::make(give(localTransfers), coarseMapper, fineMapper);
+    if (assemble)
+    {
+        m_transferMatrices.push_back(gsSparseMatrix<T, RowMajor>());
+        transfer->transferMatrix(m_transferMatrices.back());
+    }
+    else
+    {
+        m_restrictions.push_back(transfer->transposed());
+        m_prolongations.push_back(give(transfer));
+    }
+}
+
 template <typename T>
 gsGridHierarchy<T> gsGridHierarchy<T>::buildByRefinement(
     gsMultiBasis<T> mBasis,
@@ -35,22 +74,44 @@ gsGridHierarchy<T> gsGridHierarchy<T>::buildByRefinement(
     index_t multiplicityOfKnotsToBeInserted
     )
 {
+    const bool tensor   = options.askSwitch("TensorTransfers", true)
+                          && gsTensorTransferOp<T>::isTensorBSpline(mBasis);
+    const bool assemble = options.askSwitch("AssembleTransfers", true);
+    GISMO_ENSURE( tensor || assemble,
+                  "Transfers which are not assembled require tensor B-spline bases." );
+
     gsGridHierarchy<T> result;
     result.m_boundaryConditions = boundaryConditions,
     result.m_options = options,
     result.m_mBases.resize(levels);
-    result.m_transferMatrices.resize(levels-1);
+    result.m_transferMatrices.reserve(levels-1);
     result.m_mBases[0] = give(mBasis);
     for ( index_t i=1; i<levels; ++i )
     {
         result.m_mBases[i] = result.m_mBases[i-1];
-        result.m_mBases[i].uniformRefine_withTransfer(
-            result.m_transferMatrices[i-1],
-            result.m_boundaryConditions,
-            result.m_options,
-            numberOfKnotsToBeInserted,
-            multiplicityOfKnotsToBeInserted
-        );
+        if (tensor)
+        {
+            std::vector< std::vector< gsSparseMatrix<T, RowMajor> > > localTransfers;
+            gsTensorTransferOp<T>::uniformRefine(
+                result.m_mBases[i],
+                localTransfers,
+                numberOfKnotsToBeInserted,
+                multiplicityOfKnotsToBeInserted
+            );
+            result.addTensorTransfer(give(localTransfers), result.m_mBases[i-1], result.m_mBases[i], assemble);
+        }
+        else
+        {
+            gsSparseMatrix<T, RowMajor> transferMatrix;
+            result.m_mBases[i].uniformRefine_withTransfer(
+                transferMatrix,
+                result.m_boundaryConditions,
+                result.m_options,
+                numberOfKnotsToBeInserted,
+                multiplicityOfKnotsToBeInserted
+            );
+            result.m_transferMatrices.push_back(give(transferMatrix));
+        }
     }
     return result;
 }
@@ -64,6 +125,12 @@ gsGridHierarchy<T> gsGridHierarchy<T>::buildByCoarsening(
     index_t degreesOfFreedom
     )
 {
+    const bool tensor   = options.askSwitch("TensorTransfers", true)
+                          && gsTensorTransferOp<T>::isTensorBSpline(mBasis);
+    const bool assemble = options.askSwitch("AssembleTransfers", true);
+    GISMO_ENSURE( tensor || assemble,
+                  "Transfers which are not assembled require tensor B-spline bases." );
+
     gsGridHierarchy<T> result;
     result.m_boundaryConditions = boundaryConditions,
     result.m_options = options,
@@ -75,12 +142,16 @@ gsGridHierarchy<T> gsGridHierarchy<T>::buildByCoarsening(
     for (index_t i = 0; i < levels-1 && lastSize > degreesOfFreedom; ++i)
     {
         gsSparseMatrix<T, RowMajor> transferMatrix;
+        std::vector< std::vector< gsSparseMatrix<T, RowMajor> > > localTransfers;
         gsMultiBasis<T> coarseMBasis = result.m_mBases[i];
-        coarseMBasis.uniformCoarsen_withTransfer(
-            transferMatrix,
-            boundaryConditions,
-            options
-        );
+        if (tensor)
+            gsTensorTransferOp<T>::uniformCoarsen(coarseMBasis, localTransfers);
+        else
+            coarseMBasis.uniformCoarsen_withTransfer(
+                transferMatrix,
+                boundaryConditions,
+                options
+            );
 
 
         index_t newSize = coarseMBasis.totalSize();
@@ -91,12 +162,17 @@ gsGridHierarchy<T> gsGridHierarchy<T>::buildByCoarsening(
              break;
         lastSize = newSize;
 
+        if (tensor)
+            result.addTensorTransfer(give(localTransfers), coarseMBasis, result.m_mBases[i], assemble);
+        else
+            result.m_transferMatrices.push_back(give(transferMatrix));
         result.m_mBases.push_back(give(coarseMBasis));
-        result.m_transferMatrices.push_back(give(transferMatrix));
     }
 
     std::reverse( result.m_mBases.begin(), result.m_mBases.end() );
     std::reverse( result.m_transferMatrices.begin(), result.m_transferMatrices.end() );
+    std::reverse( result.m_prolongations.begin(), result.m_prolongations.end() );
+    std::reverse( result.m_restrictions.begin(), result.m_restrictions.end() );
 
     return result;
 }
@@ -193,6 +193,25 @@ public:
     const SpMatrix& matrix(index_t lvl) const;                                  ///< Stiffness matrix for given level.
     const SpMatrix& matrix() const        { return matrix(finestLevel());     } ///< Stiffness matrix for finest level.
 
+    /// @brief Updates the matrices on all levels after the values of the
+    /// fine grid matrix changed, eg., within a Newton method or a time
+    /// stepping scheme.
+    ///
+    /// The coarse grid matrices are updated in place. If the sparsity
+    /// pattern is unchanged, only their values are recomputed, using the
+    /// patterns of the Galerkin products which are set up by the first
+    /// call. A sparse LU coarse solver is refactorized for the known
+    /// pattern, a gsAggregationAmgOp coarse solver is updated; other
+    /// coarse solvers have to be updated by the caller. Smoothers which
+    /// refer to the matrices of the levels see the new values.
+    ///
+    /// Only available if the matrices are provided. If \a fineMatrix is
+    /// the fine grid matrix of the object (see matrix()), its values may
+    /// have been changed, but not its sparsity pattern.
+    ///
+    /// @param fineMatrix                Stiffness matrix on the finest grid
+    void updateMatrix(const SpMatrix& fineMatrix);
+
     index_t nDofs(index_t lvl) const      { return underlyingOp(lvl)->cols(); } ///< Number of dofs for the given level.
     index_t nDofs()            const      { return nDofs( finestLevel() );    } ///< Number of dofs for the finest level.
 
@@ -237,6 +256,13 @@ private:
     // solver for the coarsest-grid problem
     OpPtr m_coarseSolver;
 
+    // Patterns for updateMatrix: the prolongations and restrictions in
+    // column-major format and the products of the matrices with the
+    // prolongations
+    std::vector< SpMatrix > m_prolongCM;
+    std::vector< SpMatrix > m_restrictCM;
+    std::vector< SpMatrix > m_matProlong;
+
     mutable index_t m_numPreSmooth;
     mutable index_t m_numPostSmooth;
     index_t m_numCycles;
@@ -12,11 +12,51 @@
 */
 
 #include <gsMultiGrid/gsMultiGrid.h>
+#include <gsMultiGrid/gsAggregationAmg.h>
 #include <gsSolver/gsMatrixOp.h>
 
 namespace gismo
 {
 
+namespace internal
+{
+
+/// Computes the values of \f$ C = A B \f$ for the given sparsity
+/// pattern of C, which has to contain the pattern of the product
+template<class T>
+void sparseProductValues(const gsSparseMatrix<T> & A, const gsSparseMatrix<T> & B,
+                         gsSparseMatrix<T> & C)
+{
+    GISMO_ASSERT( C.isCompressed() && C.rows() == A.rows() && C.cols() == B.cols(),
+                  "The pattern of the product is not available." );
+
+    const index_t * outer = C.outerIndexPtr();
+    const index_t * inner = C.innerIndexPtr();
+    T * value = C.valuePtr();
+    const index_t nCols = C.cols();
+
+#   pragma omp parallel
+    {
+        // Position of the entries of the current column in the pattern
+        std::vector<index_t> pos(C.rows());
+
+#       pragma omp for schedule(dynamic, 64)
+        for (index_t j = 0; j < nCols; ++j)
+        {
+            for (index_t k = outer[j]; k < outer[j+1]; ++k)
+            {
+                pos[inner[k]] = k;
+                value[k] = 0;
+            }
+            for (typename gsSparseMatrix<T>::InnerIterator bit(B, j); bit; ++bit)
+                for (typename gsSparseMatrix<T>::InnerIterator ait(A, bit.index()); ait; ++ait)
+                    value[pos[ait.index()]] += ait.value() * bit.value();
+        }
+    }
+}
+
+} // namespace internal
+
 template<class T>
 gsMultiGridOp<T>::gsMultiGridOp(SpMatrix fineMatrix, std::vector< SpMatrixRowMajor > transferMatrices, OpPtr coarseSolver )
 {
@@ -276,6 +316,82 @@ const typename gsMultiGridOp<T>::SpMatrix& gsMultiGridOp<T>::matrix(index_t lvl)
     return *(matrOp->matrixPtr());
 }
 
+template<class T>
+void gsMultiGridOp<T>::updateMatrix(const SpMatrix& fineMatrix)
+{
+    std::vector<SpMatrix*> mats(n_levels);
+    for (index_t i = 0; i < n_levels; ++i)
+    {
+        const gsMatrixOp<SpMatrix>* matrOp = dynamic_cast< const gsMatrixOp<SpMatrix>* >( m_ops[i].get() );
+        GISMO_ENSURE( matrOp, "gsMultiGridOp::updateMatrix is not available for matrix-free multigrid solvers." );
+        mats[i] = matrOp->matrixPtr().get();
+    }
+
+    // Copy the values if the pattern is unchanged
+    SpMatrix & fine = *mats[finestLevel()];
+    bool samePattern = true;
+    if ( &fine != &fineMatrix )
+    {
+        GISMO_ASSERT( fineMatrix.rows() == fine.rows() && fineMatrix.cols() == fine.cols(),
+                      "The dimensions of the matrix changed." );
+        samePattern = fine.isCompressed() && fineMatrix.isCompressed()
+            && fine.nonZeros() == fineMatrix.nonZeros()
+            && std::equal(fine.outerIndexPtr(), fine.outerIndexPtr() + fine.cols() + 1,
+                          fineMatrix.outerIndexPtr())
+            && std::equal(fine.innerIndexPtr(), fine.innerIndexPtr() + fine.nonZeros(),
+                          fineMatrix.innerIndexPtr());
+        if ( samePattern )
+            std::copy(fineMatrix.valuePtr(), fineMatrix.valuePtr() + fineMatrix.nonZeros(),
+                      fine.valuePtr());
+        else
+            fine = fineMatrix;
+    }
+
+    // The first call or a new pattern requires the symbolic products
+    const bool symbolic = !samePattern || (index_t)m_matProlong.size() != n_levels - 1;
+    if ( symbolic )
+    {
+        m_prolongCM .resize(n_levels - 1);
+        m_restrictCM.resize(n_levels - 1);
+        m_matProlong.resize(n_levels - 1);
+    }
+
+    for ( index_t i = n_levels - 2; i >= 0; --i )
+    {
+        const SpMatrix & mat = *mats[i+1];
+        if ( symbolic )
+        {
+            if ( m_prolongCM[i].size() == 0 )
+            {
+                const gsMatrixOp<SpMatrixRowMajor>* prolongOp =
+                    dynamic_cast< const gsMatrixOp<SpMatrixRowMajor>* >( m_prolong[i].get() );
+                GISMO_ENSURE( prolongOp, "gsMultiGridOp::updateMatrix requires the transfer matrices." );
+                m_prolongCM [i] = prolongOp->matrix();
+                m_restrictCM[i] = prolongOp->matrix().transpose();
+            }
+            m_matProlong[i] = mat * m_prolongCM[i];
+            *mats[i] = m_restrictCM[i] * m_matProlong[i];
+        }
+        else
+        {
+            internal::sparseProductValues(mat, m_prolongCM[i], m_matProlong[i]);
+            internal::sparseProductValues(m_restrictCM[i], m_matProlong[i], *mats[i]);
+        }
+    }
+
+    // Coarse solver
+    typedef gsSolverOp< typename gsSparseSolver<T>::LU > SparseLUOp;
+    if ( SparseLUOp* lu = dynamic_cast< SparseLUOp* >( m_coarseSolver.get() ) )
+    {
+        if ( symbolic )
+            lu->solver().compute( *mats[0] );
+        else
+            lu->solver().factorize( *mats[0] );
+    }
+    else if ( gsAggregationAmgOp<T>* amg = dynamic_cast< gsAggregationAmgOp<T>* >( m_coarseSolver.get() ) )
+        amg->updateMatrix( *mats[0] );
+}
+
 template<class T>
 gsOptionList gsMultiGridOp<T>::defaultOptions()
 {
@@ -0,0 +1,144 @@
+/** @file gsTensorTransfer.h
+
+    @brief Transfers between tensor B-spline bases, given by the
+    univariate transfers.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsDofMapper.h>
+#include <gsCore/gsMultiBasis.h>
+#include <gsSolver/gsLinearOperator.h>
+
+namespace gismo
+{
+
+/** @brief
+    Transfer between two levels of a multipatch tensor B-spline basis
+
+    On each patch, the transfer matrix is the Kronecker product of the
+    univariate transfers of the component bases. The operator keeps
+    only these univariate matrices and, for each patch, the global
+    indices of the free coarse and fine unknowns, so the transfer
+    matrix restricted to the free unknowns (as provided by
+    gsMultiBasis::uniformRefine_withTransfer) is never formed. It is
+    applied patch by patch by gsKroneckerOp, in parallel if OpenMP is
+    enabled. The transposed operator (the restriction) shares the data.
+
+    The matrix can also be assembled by transferMatrix(), which writes
+    the rows of the compressed matrix directly and in parallel.
+
+    An unknown shared by several patches takes its row from the patch
+    with the smallest index, which is exact for conforming interfaces.
+
+    \ingroup Solver
+*/
+template<class T>
+class gsTensorTransferOp GISMO_FINAL : public gsLinearOperator<T>
+{
+public:
+
+    /// Shared pointer for gsTensorTransferOp
+    typedef memory::shared_ptr<gsTensorTransferOp> Ptr;
+
+    /// Unique pointer for gsTensorTransferOp
+    typedef memory::unique_ptr<gsTensorTransferOp> uPtr;
+
+    /// Matrix type of the transfers
+    typedef gsSparseMatrix<T, RowMajor> SpMatrixRowMajor;
+
+    /// @brief Constructor
+    ///
+    /// @param localTransfers  For each patch, the univariate transfers (fine times
+    ///                        coarse) for each of the directions
+    /// @param coarseMapper    The DofMapper on the coarse grid
+    /// @param fineMapper      The DofMapper on the fine grid
+    gsTensorTransferOp(std::vector< std::vector<SpMatrixRowMajor> > localTransfers,
+                       const gsDofMapper& coarseMapper, const gsDofMapper& fineMapper);
+
+    /// Make function
+    static uPtr make(std::vector< std::vector<SpMatrixRowMajor> > localTransfers,
+                     const gsDofMapper& coarseMapper, const gsDofMapper& fineMapper)
+    { return uPtr( new gsTensorTransferOp(give(localTransfers), coarseMapper, fineMapper) ); }
+
+    /// Applies the transfer (or its transpose, see transposed())
+    void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const;
+
+    index_t rows() const { return m_transposed ? m_data->nCoarse : m_data->nFine;   }
+    index_t cols() const { return m_transposed ? m_data->nFine   : m_data->nCoarse; }
+
+    /// Returns the transposed operator, sharing the data with this one
+    uPtr transposed() const
+    { return uPtr( new gsTensorTransferOp(m_data, !m_transposed) ); }
+
+    /// @brief Assembles the transfer matrix
+    ///
+    /// The result is the prolongation (fine times coarse), also if the
+    /// operator is the transposed one.
+    void transferMatrix(SpMatrixRowMajor& result) const;
+
+    /// Returns true if all patches are tensor B-spline bases
+    static bool isTensorBSpline(const gsMultiBasis<T>& mb);
+
+    /// @brief Refines the component bases of all patches uniformly
+    ///
+    /// @param mb                The multipatch basis (tensor B-splines)
+    /// @param localTransfers    The univariate transfers per patch and direction
+    /// @param numKnots          The number of knots to be inserted
+    /// @param mul               The multiplicity of the inserted knots
+    static void uniformRefine(gsMultiBasis<T>& mb,
+                              std::vector< std::vector<SpMatrixRowMajor> >& localTransfers,
+                              int numKnots = 1, int mul = 1);
+
+    /// @brief Coarsens the component bases of all patches uniformly
+    ///
+    /// @param mb                The multipatch basis (tensor B-splines)
+    /// @param localTransfers    The univariate transfers per patch and direction
+    /// @param numKnots          The number of knots to be removed
+    static void uniformCoarsen(gsMultiBasis<T>& mb,
+                               std::vector< std::vector<SpMatrixRowMajor> >& localTransfers,
+                               int numKnots = 1);
+
+private:
+
+    struct Data
+    {
+        index_t nFine, nCoarse;
+        // Univariate transfers and their transposes, per patch, in the order
+        // of the factors of gsKroneckerOp (ie., the last direction first)
+        std::vector< std::vector<typename gsLinearOperator<T>::Ptr> > prolong, restrict;
+        // Global row of each fine function (-1 if it is not free or
+        // belongs to an earlier patch) and global column of each coarse
+        // function (-1 if it is not free)
+        std::vector< std::vector<index_t> > fineIdx, coarseIdx;
+        // Univariate transfers and sizes of the univariate bases, per
+        // patch, first direction first
+        std::vector< std::vector< memory::shared_ptr<SpMatrixRowMajor> > > local;
+        std::vector< std::vector<index_t> > fineSz, coarseSz;
+    };
+
+    gsTensorTransferOp(const memory::shared_ptr<const Data>& data, bool transposed)
+    : m_data(data), m_transposed(transposed) {}
+
+    // Provides the entries of the row of the fine function j of patch k,
+    // sorted by the global column indices
+    void rowEntries(index_t k, index_t j, std::vector<index_t>& pos,
+                    std::vector< std::pair<index_t,T> >& entries) const;
+
+private:
+
+    memory::shared_ptr<const Data> m_data;
+    bool m_transposed;
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsTensorTransfer.hpp)
+#endif
@@ -0,0 +1,319 @@
+/** @file gsTensorTransfer.hpp
+
+    @brief Transfers between tensor B-spline bases, given by the
+    univariate transfers.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsMultiGrid/gsTensorTransfer.h>
+#include <gsNurbs/gsBSplineBasis.h>
+#include <gsNurbs/gsTensorBSplineBasis.h>
+#include <gsSolver/gsKroneckerOp.h>
+#include <gsSolver/gsMatrixOp.h>
+
+namespace gismo
+{
+
+template<class T>
+gsTensorTransferOp<T>::gsTensorTransferOp(
+    std::vector< std::vector<SpMatrixRowMajor> > localTransfers,
+    const gsDofMapper& coarseMapper,
+    const gsDofMapper& fineMapper
+    )
+: m_transposed(false)
+{
+    const index_t nPatches = localTransfers.size();
+    GISMO_ASSERT( (index_t)coarseMapper.numPatches() == nPatches
+                  && (index_t)fineMapper.numPatches() == nPatches,
+                  "The mappers do not fit to the transfers." );
+
+    memory::shared_ptr<Data> data(new Data);
+    data->nFine   = fineMapper.freeSize();
+    data->nCoarse = coarseMapper.freeSize();
+    data->prolong  .resize(nPatches);
+    data->restrict .resize(nPatches);
+    data->fineIdx  .resize(nPatches);
+    data->coarseIdx.resize(nPatches);
+    data->local    .resize(nPatches);
+    data->fineSz   .resize(nPatches);
+    data->coarseSz .resize(nPatches);
+
+    std::vector<bool> taken(data->nFine, false);
+    for (index_t k = 0; k < nPatches; ++k)
+    {
+        const index_t d = localTransfers[k].size();
+        data->prolong [k].resize(d);
+        data->restrict[k].resize(d);
+        data->local   [k].resize(d);
+        data->fineSz  [k].resize(d);
+        data->coarseSz[k].resize(d);
+
+        index_t nFine = 1, nCoarse = 1;
+        for (index_t i = 0; i < d; ++i)
+        {
+            SpMatrixRowMajor & B = localTransfers[k][i];
+            B.makeCompressed();
+            data->fineSz  [k][i] = B.rows();
+            data->coarseSz[k][i] = B.cols();
+            nFine   *= B.rows();
+            nCoarse *= B.cols();
+
+            memory::shared_ptr<SpMatrixRowMajor> Bt( new SpMatrixRowMajor(B.transpose()) );
+            data->local   [k][i]     = B.moveToPtr();
+            data->prolong [k][d-1-i] = makeMatrixOp(data->local[k][i]);
+            data->restrict[k][d-1-i] = makeMatrixOp(Bt);
+        }
+
+        std::vector<index_t> & fineIdx = data->fineIdx[k];
+        fineIdx.resize(nFine);
+        for (index_t j = 0; j < nFine; ++j)
+        {
+            const index_t glob = fineMapper.index(j,k);
+            if ( fineMapper.is_free_index(glob) && !taken[glob] )
+            {
+                taken[glob] = true;
+                fineIdx[j] = glob;
+            }
+            else
+                fineIdx[j] = -1;
+        }
+
+        std::vector<index_t> & coarseIdx = data->coarseIdx[k];
+        coarseIdx.resize(nCoarse);
+        for (index_t j = 0; j < nCoarse; ++j)
+        {
+            const index_t glob = coarseMapper.index(j,k);
+            coarseIdx[j] = coarseMapper.is_free_index(glob) ? glob : -1;
+        }
+    }
+
+    m_data = data;
+}
+
+template<class T>
+void gsTensorTransferOp<T>::apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+{
+    GISMO_ASSERT( input.rows() == cols(), "The dimensions do not match." );
+    const Data & data = *m_data;
+    const index_t nPatches = data.fineIdx.size();
+    const index_t n = input.cols();
+
+    x.setZero(rows(), n);
+
+    // The fine functions belong to exactly one patch, so the patches
+    // only have to be synchronized for the restriction
+#   pragma omp parallel for schedule(dynamic) if (nPatches > 1)
+    for (index_t k = 0; k < nPatches; ++k)
+    {
+        const std::vector<index_t> & fineIdx   = data.fineIdx[k];
+        const std::vector<index_t> & coarseIdx = data.coarseIdx[k];
+        const index_t nFine = fineIdx.size(), nCoarse = coarseIdx.size();
+        gsMatrix<T> in, out;
+
+        if (!m_transposed)
+        {
+            in.resize(nCoarse, n);
+            for (index_t j = 0; j < nCoarse; ++j)
+                if (coarseIdx[j] >= 0)
+                    in.row(j) = input.row(coarseIdx[j]);
+                else
+                    in.row(j).setZero();
+
+            gsKroneckerOp<T>::apply(data.prolong[k], in, out);
+
+            for (index_t j = 0; j < nFine; ++j)
+                if (fineIdx[j] >= 0)
+                    x.row(fineIdx[j]) = out.row(j);
+        }
+        else
+        {
+            in.resize(nFine, n);
+            for (index_t j = 0; j < nFine; ++j)
+                if (fineIdx[j] >= 0)
+                    in.row(j) = input.row(fineIdx[j]);
+                else
+                    in.row(j).setZero();
+
+            gsKroneckerOp<T>::apply(data.restrict[k], in, out);
+
+#           pragma omp critical (gsTensorTransferOp_apply)
+            for (index_t j = 0; j < nCoarse; ++j)
+                if (coarseIdx[j] >= 0)
+                    x.row(coarseIdx[j]) += out.row(j);
+        }
+    }
+}
+
+template<class T>
+void gsTensorTransferOp<T>::rowEntries(index_t k, index_t j, std::vector<index_t>& pos,
+                                       std::vector< std::pair<index_t,T> >& entries) const
+{
+    const std::vector< memory::shared_ptr<SpMatrixRowMajor> > & B = m_data->local[k];
+    const std::vector<index_t> & fineSz    = m_data->fineSz[k];
+    const std::vector<index_t> & coarseSz  = m_data->coarseSz[k];
+    const std::vector<index_t> & coarseIdx = m_data->coarseIdx[k];
+    const index_t d = B.size();
+
+    entries.clear();
+
+    // Current, first and last entry of the rows of the univariate
+    // transfers; the first direction runs fastest
+    pos.resize(3*d);
+    for (index_t i = 0; i < d; ++i)
+    {
+        const index_t row = j % fineSz[i];
+        j /= fineSz[i];
+        pos[d+i]   = pos[i] = B[i]->outerIndexPtr()[row];
+        pos[2*d+i] = B[i]->outerIndexPtr()[row+1];
+        if (pos[i] == pos[2*d+i])
+            return;
+    }
+
+    for (;;)
+    {
+        index_t col = 0, stride = 1;
+        T value = 1;
+        for (index_t i = 0; i < d; ++i)
+        {
+            col    += stride * B[i]->innerIndexPtr()[pos[i]];
+            value  *= B[i]->valuePtr()[pos[i]];
+            stride *= coarseSz[i];
+        }
+        if (coarseIdx[col] >= 0)
+            entries.push_back( std::make_pair(coarseIdx[col], value) );
+
+        index_t i = 0;
+        while (i < d && ++pos[i] == pos[2*d+i])
+        {
+            pos[i] = pos[d+i];
+            ++i;
+        }
+        if (i == d)
+            break;
+    }
+
+    std::sort(entries.begin(), entries.end());
+}
+
+template<class T>
+void gsTensorTransferOp<T>::transferMatrix(SpMatrixRowMajor& result) const
+{
+    const Data & data = *m_data;
+    const index_t nPatches = data.fineIdx.size();
+
+    result.resize(data.nFine, data.nCoarse);
+    index_t * outer = result.outerIndexPtr();
+
+    // Number of entries per row
+    for (index_t k = 0; k < nPatches; ++k)
+    {
+        const std::vector<index_t> & fineIdx = data.fineIdx[k];
+        const index_t nFine = fineIdx.size();
+#       pragma omp parallel
+        {
+            std::vector<index_t> pos;
+            std::vector< std::pair<index_t,T> > entries;
+#           pragma omp for schedule(static)
+            for (index_t j = 0; j < nFine; ++j)
+                if (fineIdx[j] >= 0)
+                {
+                    rowEntries(k, j, pos, entries);
+                    outer[fineIdx[j]+1] = entries.size();
+                }
+        }
+    }
+    for (index_t r = 0; r < data.nFine; ++r)
+        outer[r+1] += outer[r];
+
+    result.resizeNonZeros(outer[data.nFine]);
+    index_t * inner = result.innerIndexPtr();
+    T * value = result.valuePtr();
+
+    // The entries
+    for (index_t k = 0; k < nPatches; ++k)
+    {
+        const std::vector<index_t> & fineIdx = data.fineIdx[k];
+        const index_t nFine = fineIdx.size();
+#       pragma omp parallel
+        {
+            std::vector<index_t> pos;
+            std::vector< std::pair<index_t,T> > entries;
+#           pragma omp for schedule(static)
+            for (index_t j = 0; j < nFine; ++j)
+                if (fineIdx[j] >= 0)
+                {
+                    rowEntries(k, j, pos, entries);
+                    index_t l = outer[fineIdx[j]];
+                    for (size_t e = 0; e < entries.size(); ++e, ++l)
+                    {
+                        inner[l] = entries[e].first;
+                        value[l] = entries[e].second;
+                    }
+                }
+        }
+    }
+}
+
+template<class T>
+bool gsTensorTransferOp<T>::isTensorBSpline(const gsMultiBasis<T>& mb)
+{
+    for (size_t k = 0; k < mb.nBases(); ++k)
+    {
+        const gsBasis<T> * basis = &mb[k];
+        bool tensor;
+        switch (basis->dim())
+        {
+        case 1: tensor = dynamic_cast< const gsTensorBSplineBasis<1,T>* >(basis) != NULL; break;
+        case 2: tensor = dynamic_cast< const gsTensorBSplineBasis<2,T>* >(basis) != NULL; break;
+        case 3: tensor = dynamic_cast< const gsTensorBSplineBasis<3,T>* >(basis) != NULL; break;
+        case 4: tensor = dynamic_cast< const gsTensorBSplineBasis<4,T>* >(basis) != NULL; break;
+        default: tensor = false;
+        }
+        if (!tensor)
+            return false;
+    }
+    return true;
+}
+
+template<class T>
+void gsTensorTransferOp<T>::uniformRefine(gsMultiBasis<T>& mb,
+                                          std::vector< std::vector<SpMatrixRowMajor> >& localTransfers,
+                                          int numKnots, int mul)
+{
+    GISMO_ASSERT( isTensorBSpline(mb), "The bases have to be tensor B-spline bases." );
+    localTransfers.resize(mb.nBases());
+    for (size_t k = 0; k < mb.nBases(); ++k)
+    {
+        gsBasis<T> & basis = mb.basis(k);
+        localTransfers[k].resize(basis.dim());
+        for (short_t i = 0; i < basis.dim(); ++i)
+            static_cast< gsBSplineBasis<T>& >( basis.component(i) )
+                .uniformRefine_withTransfer(localTransfers[k][i], numKnots, mul);
+    }
+}
+
+template<class T>
+void gsTensorTransferOp<T>::uniformCoarsen(gsMultiBasis<T>& mb,
+                                           std::vector< std::vector<SpMatrixRowMajor> >& localTransfers,
+                                           int numKnots)
+{
+    GISMO_ASSERT( isTensorBSpline(mb), "The bases have to be tensor B-spline bases." );
+    localTransfers.resize(mb.nBases());
+    for (size_t k = 0; k < mb.nBases(); ++k)
+    {
+        gsBasis<T> & basis = mb.basis(k);
+        localTransfers[k].resize(basis.dim());
+        for (short_t i = 0; i < basis.dim(); ++i)
+            static_cast< gsBSplineBasis<T>& >( basis.component(i) )
+                .uniformCoarsen_withTransfer(localTransfers[k][i], numKnots);
+    }
+}
+
+} // namespace gismo
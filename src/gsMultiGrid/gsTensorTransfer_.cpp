@@ -0,0 +1,20 @@
+/** @file gsTensorTransfer_.cpp
+
+    @brief Transfers between tensor B-spline bases, given by the
+    univariate transfers.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include <gsMultiGrid/gsTensorTransfer.hpp>
+
+namespace gismo
+{
+
+CLASS_TEMPLATE_INST gsTensorTransferOp<real_t>;
+
+}
@@ -67,6 +67,175 @@ namespace bspline
         }
     }
 
+    /// Evaluates the basis functions of degree \a deg which are active
+    /// on the knot span starting at iterator \a knot, at the \a nb
+    /// points \a u which all lie in this span.
+    ///
+    /// The values are stored in structure-of-arrays layout: entry
+    /// N[r*nb+k] is the r-th active function at point u[k]. Since the
+    /// knot differences are the same for all points of the span, the
+    /// recursion runs over contiguous lanes of points, which the
+    /// compiler vectorises. \a work must hold 2*(deg+2)*nb values.
+    template <class T, typename KnotIterator>
+    void evalBasisBlock( const T * u, const index_t nb,
+                         KnotIterator knot,
+                         int deg,
+                         T * work, T * N )
+    {
+        T * left  = work;                    // left[j*nb+k]
+        T * right = work + (deg+1)*nb;       // right[j*nb+k]
+        T * saved = work + 2*(deg+1)*nb;
+        T * temp  = saved + nb;
+
+        for (index_t k = 0; k < nb; ++k)
+            N[k] = T(1); // 0-th degree function value
+
+        for(int j=1; j<= deg; j++) // For all degrees
+        {
+            T * lj = left  + j*nb;
+            T * rj = right + j*nb;
+            const T kl = *(knot+1-j), kr = *(knot+j);
+            for (index_t k = 0; k < nb; ++k)
+            {
+                lj[k] = u[k] - kl;
+                rj[k] = kr - u[k];
+                saved[k] = T(0);
+            }
+
+            for(int r=0; r<j ; r++) // For all (except the last)  basis functions of degree j
+            {
+                // right[r+1] + left[j-r] is a knot difference
+                const T inv = T(1) / ( *(knot+r+1) - *(knot+r+1-j) );
+                T * Nr = N + r*nb;
+                const T * rr = right + (r+1)*nb;
+                const T * ll = left  + (j-r)*nb;
+                for (index_t k = 0; k < nb; ++k)
+                {
+                    temp[k]  = Nr[k] * inv;
+                    Nr[k]    = saved[k] + rr[k] * temp[k];
+                    saved[k] = ll[k] * temp[k];
+                }
+            }
+
+            T * Nj = N + j*nb;
+            for (index_t k = 0; k < nb; ++k)
+                Nj[k] = saved[k];
+        }
+    }
+
+    /// Returns the knot difference ndu[(pk+1)*(deg+1)+s] of
+    /// Algorithm A2.3, for the knot span starting at iterator \a knot
+    template <class T, typename KnotIterator>
+    inline T knotDiff(const KnotIterator knot, const int s, const int pk)
+    { return *(knot+s+1) - *(knot+s-pk); }
+
+    /// Evaluates the basis functions of degree \a deg which are active
+    /// on the knot span starting at iterator \a knot, and their
+    /// derivatives up to order \a n, at the \a nb points \a u which
+    /// all lie in this span (Algorithm A2.3 in the NURBS book,
+    /// vectorised over the points as in evalBasisBlock).
+    ///
+    /// Entry ders[(i*(deg+1)+r)*nb+k] is the i-th derivative of the
+    /// r-th active function at point u[k], without the factor
+    /// deg!/(deg-i)!. \a ndu must hold (deg+1)^2*nb values and \a work
+    /// 2*(deg+2)*nb values.
+    template <class T, typename KnotIterator>
+    void evalAllDersBlock( const T * u, const index_t nb,
+                           KnotIterator knot,
+                           int deg, int n,
+                           T * work, T * ndu, T * ders )
+    {
+        const int p1 = deg + 1;
+        T * left  = work;
+        T * right = work + p1*nb;
+
+        // Function values of degree j in ndu[(r*p1+j)*nb+k]
+        for (index_t k = 0; k < nb; ++k)
+            ndu[k] = T(1);
+        for(int j=1; j<= deg; j++)
+        {
+            T * lj = left  + j*nb;
+            T * rj = right + j*nb;
+            const T kl = *(knot+1-j), kr = *(knot+j);
+            for (index_t k = 0; k < nb; ++k)
+            {
+                lj[k] = u[k] - kl;
+                rj[k] = kr - u[k];
+            }
+
+            for(int r=0; r<j ; r++)
+            {
+                const T inv = T(1) / ( *(knot+r+1) - *(knot+r+1-j) );
+                const T * prev = ndu + (r*p1 + j-1)*nb;
+                const T * rr = right + (r+1)*nb;
+                const T * ll = left  + (j-r)*nb;
+                T * cur  = ndu + (r*p1 + j)*nb;
+                T * next = ndu + ((r+1)*p1 + j)*nb;
+                if ( 0 == r )
+                    for (index_t k = 0; k < nb; ++k)
+                        cur[k] = rr[k] * prev[k] * inv;
+                else
+                    for (index_t k = 0; k < nb; ++k)
+                        cur[k] += rr[k] * prev[k] * inv;
+                for (index_t k = 0; k < nb; ++k)
+                    next[k] = ll[k] * prev[k] * inv;
+            }
+        }
+
+        for(int r = 0; r <= deg; r++)
+        {
+            const T * val = ndu + (r*p1 + deg)*nb;
+            T * d0 = ders + r*nb;
+            for (index_t k = 0; k < nb; ++k)
+                d0[k] = val[k];
+        }
+
+        // The coefficients of the derivatives only depend on the knots
+        STACK_ARRAY(T, a, 2 * p1);
+        for(int r = 0; r <= deg; r++)
+        {
+            T* a1 = &a[0];
+            T* a2 = &a[p1];
+            a1[0] = T(1) ;
+
+            for(int k=1; k<=n; k++)
+            {
+                const int rk = r-k, pk = deg-k;
+                T * d = ders + (k*p1 + r)*nb;
+                for (index_t i = 0; i < nb; ++i)
+                    d[i] = T(0);
+
+                if(r >= k)
+                {
+                    a2[0] = a1[0] / knotDiff<T>(knot, rk, pk);
+                    const T * v = ndu + (rk*p1 + pk)*nb;
+                    for (index_t i = 0; i < nb; ++i)
+                        d[i] += a2[0] * v[i];
+                }
+
+                const int j1 = ( rk >= -1  ? 1   : -rk     );
+                const int j2 = ( r-1 <= pk ? k-1 : deg - r );
+                for(int j = j1; j <= j2; j++)
+                {
+                    a2[j] = (a1[j] - a1[j-1]) / knotDiff<T>(knot, rk+j, pk);
+                    const T * v = ndu + ((rk+j)*p1 + pk)*nb;
+                    for (index_t i = 0; i < nb; ++i)
+                        d[i] += a2[j] * v[i];
+                }
+
+                if(r <= pk)
+                {
+                    a2[k] = -a1[k-1] / knotDiff<T>(knot, r, pk);
+                    const T * v = ndu + (r*p1 + pk)*nb;
+                    for (index_t i = 0; i < nb; ++i)
+                        d[i] += a2[k] * v[i];
+                }
+
+                std::swap(a1, a2); // Switch rows
+            }
+        }
+    }
+
     /// Evaluation for degree 1 B-spline basis
     template <class T, typename KnotIterator, typename Derived>
     void evalDeg1Basis(  const T & u,
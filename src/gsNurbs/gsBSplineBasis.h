@@ -594,6 +594,19 @@ protected:
     /// @brief Adjusts endknots so that the knot vector can be made periodic.
     void _stretchEndKnots();
 
+    /// @brief Returns one past the last column of \a u, starting from
+    /// column \a v, whose point lies in the knot span [*span,
+    /// *(span+1)). Runs of points in the same span are evaluated at
+    /// once, and they are limited to a block of 128 points.
+    index_t _spanBlockEnd(const gsMatrix<T> & u, index_t v,
+                          typename KnotVectorType::iterator span) const
+    {
+        const index_t end = math::min(static_cast<index_t>(u.cols()), v + 128);
+        const T a = *span, b = *(span+1);
+        for (++v; v < end && a <= u(0,v) && u(0,v) < b; ++v) ;
+        return v;
+    }
+
 public:
 
     /// @brief Helper function for evaluation with periodic basis.
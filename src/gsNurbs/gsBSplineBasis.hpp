@@ -236,6 +236,7 @@ index_t gsTensorBSplineBasis<1,T>::twin(index_t i) const
 template <class T>
 void gsTensorBSplineBasis<1,T>::eval_into(const gsMatrix<T> & u, gsMatrix<T>& result) const
 {
+    GISMO_ASSERT( u.rows() == 1 , "gsBSplineBasis accepts points with one coordinate.");
     result.resize(m_p+1, u.cols() );
 
 #if (FALSE)
@@ -304,6 +305,7 @@ void gsTensorBSplineBasis<1,T>::eval_into(const gsMatrix<T> & u, gsMatrix<T>& re
 //#if (FALSE)
     STACK_ARRAY(T, left, m_p + 1);
     STACK_ARRAY(T, right, m_p + 1);
+    gsMatrix<T> work, N; // workspace for runs of points in the same span
 
     for (index_t v = 0; v < u.cols(); ++v) // for all columns of u
     {
@@ -320,6 +322,22 @@ void gsTensorBSplineBasis<1,T>::eval_into(const gsMatrix<T> & u, gsMatrix<T>& re
         // Get span of absissae
         unsigned span = m_knots.iFind( u(0,v) ) - m_knots.begin() ;
 
+        // Evaluate the following points of the same span at once
+        const index_t nb = _spanBlockEnd(u, v, m_knots.begin() + span) - v;
+        if ( nb > 3 )
+        {
+            if ( N.rows() < (m_p+1)*nb )
+            {
+                work.resize(2*(m_p+2)*nb, 1);
+                N   .resize((m_p+1)*nb, 1);
+            }
+            bspline::evalBasisBlock(&u(0,v), nb, m_knots.begin() + span, m_p,
+                                    work.data(), N.data());
+            result.middleCols(v, nb) = gsAsConstMatrix<T>(N.data(), nb, m_p+1).transpose();
+            v += nb - 1;
+            continue;
+        }
+
         //ndu[0]   = T(1);  // 0-th degree function value
         result(0,v)= T(1);  // 0-th degree function value
 
@@ -580,6 +598,7 @@ void gsTensorBSplineBasis<1,T>::deriv_into(const gsMatrix<T> & u, gsMatrix<T>& r
     STACK_ARRAY(T, right, p1 );
 
     result.resize( m_p + 1, u.cols() ) ;
+    gsMatrix<T> work, ndus, ders; // workspace for runs of points in the same span
 
     for (index_t v = 0; v < u.cols(); ++v) // for all columns of u
     {
@@ -596,6 +615,24 @@ void gsTensorBSplineBasis<1,T>::deriv_into(const gsMatrix<T> & u, gsMatrix<T>& r
         // Get span of absissae
         typename KnotVectorType::iterator span = m_knots.iFind( u(0,v) );
 
+        // Evaluate the following points of the same span at once
+        const index_t nb = _spanBlockEnd(u, v, span) - v;
+        if ( nb > 3 )
+        {
+            if ( ders.rows() < 2*p1*nb )
+            {
+                work.resize(2*(m_p+2)*nb, 1);
+                ndus.resize(p1*p1*nb, 1);
+                ders.resize(2*p1*nb, 1);
+            }
+            bspline::evalAllDersBlock(&u(0,v), nb, span, m_p, 1,
+                                      work.data(), ndus.data(), ders.data());
+            result.middleCols(v, nb) = T(m_p) *
+                gsAsConstMatrix<T>(ders.data() + p1*nb, nb, p1).transpose();
+            v += nb - 1;
+            continue;
+        }
+
         ndu[0]  = T(1); // 0-th degree function value
         left[0] = 0;
 
@@ -883,6 +920,7 @@ evalAllDers_into(const gsMatrix<T> & u, int n,
     result.resize(n+1);
     for(int k=0; k<=n; k++)
         result[k].resize(m_p + 1, u.cols());
+    gsMatrix<T> work, ndus, ders; // workspace for runs of points in the same span
 
 #if FALSE
 
@@ -952,6 +990,25 @@ evalAllDers_into(const gsMatrix<T> & u, int n,
         // Run evaluation algorithm and keep the function values triangle & the knot differences
         typename KnotVectorType::iterator span = m_knots.iFind( u(0,v) );
 
+        // Evaluate the following points of the same span at once
+        const index_t nb = _spanBlockEnd(u, v, span) - v;
+        if ( nb > 3 )
+        {
+            if ( ders.rows() < (n+1)*p1*nb )
+            {
+                work.resize(2*(m_p+2)*nb, 1);
+                ndus.resize(p1*p1*nb, 1);
+                ders.resize((n+1)*p1*nb, 1);
+            }
+            bspline::evalAllDersBlock(&u(0,v), nb, span, m_p, n,
+                                      work.data(), ndus.data(), ders.data());
+            for(int k=0; k<=n; k++)
+                result[k].middleCols(v, nb) =
+                    gsAsConstMatrix<T>(ders.data() + k*p1*nb, nb, p1).transpose();
+            v += nb - 1;
+            continue;
+        }
+
         ndu[0] = T(1) ; // 0-th degree function value
         for(int j=1; j<= m_p; j++) // For all degrees ( ndu column)
         {
@@ -47,9 +47,25 @@ public:
 
         typename gsKnotVector<T>::knotContainer knotValues;
 
-        std::istringstream str;
-        str.str( node->value() );
-        for (T knot; gsGetReal(str, knot);)
+        if ( isBinaryValue(node) )
+        {
+            std::vector<char> bytes;
+            const int sz = getBinaryValue(node, bytes);
+            if ( 0 == sz || 0 != bytes.size() % sz )
+            {
+                gsWarn<<"XML Warning: Reading binary knot vector failed.\n";
+                gsWarn<<"Tag: "<< node->name() <<".\n";
+                return;
+            }
+            knotValues.reserve(bytes.size() / sz);
+            for (size_t k = 0; k != bytes.size(); k += sz)
+                knotValues.push_back( binaryScalar<T>(&bytes[k], sz) );
+            result = gsKnotVector<T>(give(knotValues), p);
+            return;
+        }
+
+        const char * str = node->value(), * end = str + node->value_size();
+        for (T knot; gsGetReal(str, end, knot);)
             knotValues.push_back(knot);
 
         result = gsKnotVector<T>(give(knotValues), p);
@@ -59,6 +75,17 @@ public:
     {
         // Write the knot values (for now WITH multiplicities)
         std::ostringstream str;
+        if ( useBinaryValue<T>(data) )
+        {
+            const typename gsKnotVector<T>::knotContainer & knots = obj;
+            gsXmlNode * tmp = internal::makeNode("KnotVector", data);
+            putBinaryValue(tmp, reinterpret_cast<const char*>(knots.data()),
+                           knots.size() * sizeof(T), sizeof(T), data);
+            str<< obj.m_deg;
+            tmp->append_attribute( makeAttribute("degree", str.str(),data) );
+            return tmp;
+        }
+
         str << std::setprecision(REAL_DIG+1);
 
         for ( typename gsKnotVector<T>::iterator it = obj.begin();
@@ -44,6 +44,14 @@ namespace gismo
 ///
 /// but much faster.
 ///
+/// If OpenMP is enabled and setParallel(true) has been called, the
+/// subspaces are processed concurrently. The operators \f$ A_i \f$
+/// are then applied by several threads at the same time, so they must
+/// not modify shared state (like the workspaces of gsPreconditionerFromOp
+/// or gsChebyshevOp), and no operator may be used for several subspaces
+/// unless it is thread-safe. The corrections are summed up in the order
+/// of the subspaces in any case.
+///
 /// @ingroup Solvers
 
 template<class T>
@@ -63,7 +71,7 @@ public:
     typedef memory::unique_ptr<gsAdditiveOp> uPtr;
 
     /// Default Constructor
-    gsAdditiveOp() : m_transfers(), m_ops() {}
+    gsAdditiveOp() : m_transfers(), m_ops(), m_parallel(false) {}
 
     /// @brief Constructor
     ///
@@ -72,7 +80,7 @@ public:
     /// @param transfers  transfer matrices \f$ T_i \f$
     /// @param ops        local operators \f$ A_i \f$
     gsAdditiveOp(TransferContainer transfers, OpContainer ops)
-    : m_transfers(give(transfers)), m_ops(give(ops))
+    : m_transfers(give(transfers)), m_ops(give(ops)), m_parallel(false)
     {
 #ifndef NDEBUG
         GISMO_ASSERT( m_transfers.size() == m_ops.size(), "Sizes do not agree" );
@@ -112,6 +120,12 @@ public:
 
     void apply(const gsMatrix<T>& input, gsMatrix<T>& x) const;
 
+    /// Sets whether the subspaces are processed concurrently (see above)
+    void setParallel(bool parallel) { m_parallel = parallel; }
+
+    /// Returns true if the subspaces are processed concurrently
+    bool parallel() const { return m_parallel; }
+
     index_t rows() const
     {
         GISMO_ASSERT( !m_transfers.empty(), "gsAdditiveOp::rows does not work for 0 operators." );
@@ -127,6 +141,7 @@ public:
 protected:
     TransferContainer m_transfers;   ///< Transfer matrices
     OpContainer m_ops;               ///< Operators to be applied in the subspaces
+    bool m_parallel;                 ///< Process the subspaces concurrently
 
 };
 
@@ -22,14 +22,23 @@ void gsAdditiveOp<T>::apply(const gsMatrix<T>& input, gsMatrix<T>& x) const
     x.setZero( input.rows(), input.cols() );
 
     const index_t n = m_ops.size();
-    gsMatrix<T> res_local, corr_local;
 
-    for (index_t i=0; i<n; ++i)
+    // The subspaces might be processed concurrently; the corrections
+    // are added afterwards in a fixed order, for reproducible results
+    std::vector< gsMatrix<T> > corr(n);
+#   pragma omp parallel if (m_parallel && n > 1)
     {
-        res_local.noalias() = m_transfers[i].transpose()*input;
-        m_ops[i]->apply(res_local, corr_local);
-        x.noalias() += m_transfers[i]*corr_local;
+        gsMatrix<T> res_local;
+#       pragma omp for schedule(dynamic)
+        for (index_t i=0; i<n; ++i)
+        {
+            res_local.noalias() = m_transfers[i].transpose()*input;
+            m_ops[i]->apply(res_local, corr[i]);
+        }
     }
+
+    for (index_t i=0; i<n; ++i)
+        x.noalias() += m_transfers[i]*corr[i];
 }
 
 } // namespace gismo
@@ -41,12 +41,12 @@ bool gsConjugateGradient<T>::initIteration( const typename gsConjugateGradient<T
     m_mat->apply(x,m_tmp);                                              // apply the system matrix
     m_res = rhs - m_tmp;                                                // initial residual
 
-    m_error = m_res.norm() / m_rhs_norm;
+    m_error = parallelNorm(m_res) / m_rhs_norm;
     if (m_error < m_tol)
         return true;
 
     m_precond->apply(m_res,m_update);                                   // initial search direction
-    m_abs_new = m_res.col(0).dot(m_update.col(0));                      // the square of the absolute value of r scaled by invM
+    m_abs_new = parallelDot(m_res, m_update);                           // the square of the absolute value of r scaled by invM
 
     return false;
 }
@@ -56,14 +56,12 @@ bool gsConjugateGradient<T>::step( typename gsConjugateGradient<T>::VectorType&
 {
     m_mat->apply(m_update,m_tmp);                                      // apply system matrix
 
-    T alpha = m_abs_new / m_update.col(0).dot(m_tmp.col(0));           // the amount we travel on dir
+    T alpha = m_abs_new / parallelDot(m_update, m_tmp);                // the amount we travel on dir
     if (m_calcEigenvals)
         m_delta.back()+=(1./alpha);
 
-    x += alpha * m_update;                                             // update solution
-    m_res -= alpha * m_tmp;                                            // update residual
-
-    m_error = m_res.norm() / m_rhs_norm;
+    // update solution and residual
+    m_error = math::sqrt( parallelCgUpdate(x, m_res, m_update, m_tmp, alpha) ) / m_rhs_norm;
     if (m_error < m_tol)
         return true;
 
@@ -71,9 +69,9 @@ bool gsConjugateGradient<T>::step( typename gsConjugateGradient<T>::VectorType&
 
     T abs_old = m_abs_new;
 
-    m_abs_new = m_res.col(0).dot(m_tmp.col(0));                        // update the absolute value of r
+    m_abs_new = parallelDot(m_res, m_tmp);                             // update the absolute value of r
     T beta = m_abs_new / abs_old;                                      // calculate the Gram-Schmidt value used to create the new search direction
-    m_update = m_tmp + beta * m_update;                                // update search direction
+    parallelXpby(m_tmp, beta, m_update);                               // update search direction
 
     if (m_calcEigenvals)
     {
@@ -0,0 +1,128 @@
+/** @file gsDistributedOp.h
+
+    @brief Provides a sparse matrix whose rows are distributed over
+    the processes of a communicator.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#pragma once
+
+#include <gsSolver/gsLinearOperator.h>
+#include <gsAssembler/gsPatchPartition.h>
+#include <gsMpi/gsMpi.h>
+
+namespace gismo
+{
+
+/// @brief Sparse matrix whose rows are distributed over the processes
+/// of a communicator
+///
+/// Every process stores the rows of the degrees of freedom it owns,
+/// see gsPatchPartition. The columns are numbered locally: first the
+/// owned degrees of freedom, in the order of
+/// gsPatchPartition::ownedDofs(), then the degrees of freedom of other
+/// processes which the owned rows couple with (the halo).
+///
+/// The vectors passed to apply() are the owned parts. The values of
+/// the halo are received from their owners before the
+/// multiplication. Together with a solver which sums up its inner
+/// products over the communicator, eg. gsPipelinedConjugateGradient
+/// or gsSStepConjugateGradient after setCommunicator(), this solves a
+/// system distributed over the processes.
+///
+/// \ingroup Solver
+template <class T>
+class gsDistributedOp GISMO_FINAL : public gsLinearOperator<T>
+{
+public:
+
+    /// Shared pointer for gsDistributedOp
+    typedef memory::shared_ptr<gsDistributedOp> Ptr;
+
+    /// Unique pointer for gsDistributedOp
+    typedef memory::unique_ptr<gsDistributedOp> uPtr;
+
+    /// @brief Constructor from the owned rows of the matrix
+    ///
+    /// @param rows The rows of part.ownedDofs(), in this order, with
+    ///             the global column indices
+    /// @param part The partition of the degrees of freedom
+    /// @param comm The communicator
+    gsDistributedOp(const gsSparseMatrix<T,RowMajor> & rows,
+                    const gsPatchPartition & part, const gsMpiComm & comm);
+
+    /// @brief Sums up the matrices and right-hand sides assembled by
+    /// the processes on their patches
+    ///
+    /// Every process sends its contributions to the rows owned by
+    /// other processes to their owners.
+    ///
+    /// @param mat      The matrix assembled by this process, with the
+    ///                 global numbering
+    /// @param rhs      The right-hand side(s) assembled by this process
+    /// @param part     The partition of the degrees of freedom
+    /// @param comm     The communicator
+    /// @param localRhs The owned rows of the summed up right-hand side(s)
+    static uPtr make(const gsSparseMatrix<T> & mat, const gsMatrix<T> & rhs,
+                     const gsPatchPartition & part, const gsMpiComm & comm,
+                     gsMatrix<T> & localRhs);
+
+    virtual void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const;
+
+    virtual index_t rows() const { return m_matrix.rows(); }
+
+    virtual index_t cols() const { return m_matrix.rows(); }
+
+    /// Returns the owned rows, with the local column numbering
+    const gsSparseMatrix<T,RowMajor> & localMatrix() const { return m_matrix; }
+
+    /// Returns the number of degrees of freedom of the halo
+    index_t haloSize() const { return m_matrix.cols() - m_matrix.rows(); }
+
+    /// Gathers the owned parts \a local of a vector from all processes
+    /// into the whole vector \a global on every process
+    void gather(const gsMatrix<T> & local, gsMatrix<T> & global) const;
+
+    /// Returns in \a local the owned part of the whole vector \a global
+    void localPart(const gsMatrix<T> & global, gsMatrix<T> & local) const;
+
+private:
+
+    /// Copies \a input to the owned rows of \a ext and receives the
+    /// values of the halo in its remaining rows
+    void exchange(const gsMatrix<T> & input, gsMatrix<T> & ext) const;
+
+private:
+
+    gsMpiComm m_comm;
+
+    gsSparseMatrix<T,RowMajor> m_matrix;
+
+    /// Global indices of the owned degrees of freedom
+    std::vector<index_t> m_owned;
+
+    /// Global indices of the degrees of freedom of all processes, by
+    /// process, and their number and offset per process
+    std::vector<index_t> m_allOwned;
+    std::vector<int> m_counts, m_displs;
+
+    /// Processes which send values of the halo, and the halo rows
+    /// m_recvPtr[i],...,m_recvPtr[i+1]-1 received from m_recvRank[i]
+    std::vector<int> m_recvRank;
+    std::vector<index_t> m_recvPtr;
+
+    /// Processes which receive owned values, and the owned rows
+    /// m_sendIdx[m_sendPtr[i]],... sent to m_sendRank[i]
+    std::vector<int> m_sendRank;
+    std::vector<index_t> m_sendPtr, m_sendIdx;
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsDistributedOp.hpp)
+#endif
@@ -0,0 +1,307 @@
+/** @file gsDistributedOp.hpp
+
+    @brief Provides a sparse matrix whose rows are distributed over
+    the processes of a communicator.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+namespace gismo
+{
+
+template <class T>
+gsDistributedOp<T>::gsDistributedOp(const gsSparseMatrix<T,RowMajor> & rows,
+                                    const gsPatchPartition & part,
+                                    const gsMpiComm & comm)
+: m_comm(comm), m_owned(part.ownedDofs())
+{
+    const index_t n    = part.numDofs();
+    const index_t nLoc = m_owned.size();
+    const int np = comm.size();
+    GISMO_ENSURE(part.size() == np && part.rank() == comm.rank(),
+                 "The partition does not match the communicator.");
+    GISMO_ENSURE(rows.rows() == nLoc && rows.cols() == n,
+                 "The rows do not match the partition.");
+
+    const std::vector<int> & owner = part.dofOwners();
+
+    // The owned degrees of freedom of all processes
+    m_counts.assign(np, 0);
+    for (index_t i = 0; i != n; ++i)
+    {
+        GISMO_ASSERT(owner[i] < np, "The degree of freedom "<< i <<" has no owner.");
+        ++m_counts[owner[i]];
+    }
+    m_displs.assign(np, 0);
+    for (int q = 1; q < np; ++q)
+        m_displs[q] = m_displs[q-1] + m_counts[q-1];
+    m_allOwned.resize(n);
+    std::vector<int> pos(m_displs);
+    for (index_t i = 0; i != n; ++i)
+        m_allOwned[pos[owner[i]]++] = i;
+
+    // The halo, sorted by owner
+    std::vector<index_t> local(n, -1);
+    for (index_t i = 0; i != nLoc; ++i)
+        local[m_owned[i]] = i;
+    std::vector<std::pair<int,index_t> > halo;
+    for (index_t k = 0; k < rows.outerSize(); ++k)
+        for (typename gsSparseMatrix<T,RowMajor>::InnerIterator it(rows, k); it; ++it)
+            if ( -1 == local[it.col()] )
+            {
+                local[it.col()] = -2;
+                halo.push_back( std::make_pair(owner[it.col()], it.col()) );
+            }
+    std::sort(halo.begin(), halo.end());
+
+    const index_t nHalo = halo.size();
+    std::vector<index_t> haloIdx(nHalo);
+    std::vector<int> needCount(np, 0);
+    m_recvRank.clear();
+    m_recvPtr.assign(1, 0);
+    for (index_t h = 0; h != nHalo; ++h)
+    {
+        haloIdx[h] = halo[h].second;
+        local[haloIdx[h]] = nLoc + h;
+        ++needCount[halo[h].first];
+        if ( h + 1 == nHalo || halo[h+1].first != halo[h].first )
+        {
+            m_recvRank.push_back(halo[h].first);
+            m_recvPtr.push_back(h + 1);
+        }
+    }
+
+    // The owned rows, with the local column numbering
+    gsSparseEntries<T> entries;
+    entries.reserve(rows.nonZeros());
+    for (index_t k = 0; k < rows.outerSize(); ++k)
+        for (typename gsSparseMatrix<T,RowMajor>::InnerIterator it(rows, k); it; ++it)
+            entries.add(k, local[it.col()], it.value());
+    m_matrix.resize(nLoc, nLoc + nHalo);
+    m_matrix.setFrom(entries);
+    m_matrix.makeCompressed();
+
+    // Tell the owners which of their values are needed
+    std::vector<int> giveCount(np, 0), needDispl(np, 0), giveDispl(np, 0);
+    m_comm.alltoall(needCount.data(), giveCount.data(), 1, 1);
+    for (int q = 1; q < np; ++q)
+    {
+        needDispl[q] = needDispl[q-1] + needCount[q-1];
+        giveDispl[q] = giveDispl[q-1] + giveCount[q-1];
+    }
+    std::vector<index_t> giveIdx(giveDispl[np-1] + giveCount[np-1]);
+    m_comm.alltoallv(haloIdx.data(), needCount.data(), needDispl.data(),
+                     giveIdx.data(), giveCount.data(), giveDispl.data());
+
+    m_sendRank.clear();
+    m_sendPtr.assign(1, 0);
+    m_sendIdx.clear();
+    for (int q = 0; q != np; ++q)
+    {
+        if ( 0 == giveCount[q] )
+            continue;
+        m_sendRank.push_back(q);
+        for (int s = giveDispl[q]; s != giveDispl[q] + giveCount[q]; ++s)
+        {
+            GISMO_ASSERT(0 <= local[giveIdx[s]] && local[giveIdx[s]] < nLoc,
+                         "Requested a degree of freedom which is not owned.");
+            m_sendIdx.push_back(local[giveIdx[s]]);
+        }
+        m_sendPtr.push_back(m_sendIdx.size());
+    }
+}
+
+template <class T>
+typename gsDistributedOp<T>::uPtr
+gsDistributedOp<T>::make(const gsSparseMatrix<T> & mat, const gsMatrix<T> & rhs,
+                         const gsPatchPartition & part, const gsMpiComm & comm,
+                         gsMatrix<T> & localRhs)
+{
+    const index_t n = part.numDofs();
+    GISMO_ENSURE(mat.rows() == n && mat.cols() == n && rhs.rows() == n,
+                 "The system does not match the partition.");
+    const int np = comm.size(), rank = comm.rank();
+    const index_t nc = rhs.cols();
+    const std::vector<int> & owner = part.dofOwners();
+    const std::vector<index_t> & owned = part.ownedDofs();
+    const index_t nLoc = owned.size();
+    const gsSparseMatrix<T,RowMajor> A = mat;
+    typedef typename gsSparseMatrix<T,RowMajor>::InnerIterator RowIter;
+
+    // Pack the contributions to the rows of other processes: the row
+    // index, the number of entries and their columns, resp. their
+    // values and the right-hand side
+    std::vector<std::vector<index_t> > idx(np);
+    std::vector<std::vector<T> > val(np);
+    for (index_t i = 0; i != n; ++i)
+    {
+        const int q = owner[i];
+        if ( q == rank )
+            continue;
+        index_t nnz = 0;
+        for (RowIter it(A, i); it; ++it)
+            ++nnz;
+        if ( 0 == nnz && rhs.row(i).isZero() )
+            continue;
+        idx[q].push_back(i);
+        idx[q].push_back(nnz);
+        for (RowIter it(A, i); it; ++it)
+        {
+            idx[q].push_back(it.col());
+            val[q].push_back(it.value());
+        }
+        for (index_t j = 0; j != nc; ++j)
+            val[q].push_back(rhs(i, j));
+    }
+
+    std::vector<int> sendCount(2 * np), recvCount(2 * np);
+    for (int q = 0; q != np; ++q)
+    {
+        sendCount[2*q  ] = idx[q].size();
+        sendCount[2*q+1] = val[q].size();
+    }
+    comm.alltoall(sendCount.data(), recvCount.data(), 2, 2);
+
+    std::vector<int> sIdxCount(np), sValCount(np), rIdxCount(np), rValCount(np),
+        sIdxDispl(np, 0), sValDispl(np, 0), rIdxDispl(np, 0), rValDispl(np, 0);
+    for (int q = 0; q != np; ++q)
+    {
+        sIdxCount[q] = sendCount[2*q];
+        sValCount[q] = sendCount[2*q+1];
+        rIdxCount[q] = recvCount[2*q];
+        rValCount[q] = recvCount[2*q+1];
+        if ( q > 0 )
+        {
+            sIdxDispl[q] = sIdxDispl[q-1] + sIdxCount[q-1];
+            sValDispl[q] = sValDispl[q-1] + sValCount[q-1];
+            rIdxDispl[q] = rIdxDispl[q-1] + rIdxCount[q-1];
+            rValDispl[q] = rValDispl[q-1] + rValCount[q-1];
+        }
+    }
+
+    std::vector<index_t> sIdx, rIdx(rIdxDispl[np-1] + rIdxCount[np-1]);
+    std::vector<T>       sVal, rVal(rValDispl[np-1] + rValCount[np-1]);
+    for (int q = 0; q != np; ++q)
+    {
+        sIdx.insert(sIdx.end(), idx[q].begin(), idx[q].end());
+        sVal.insert(sVal.end(), val[q].begin(), val[q].end());
+    }
+    comm.alltoallv(sIdx.data(), sIdxCount.data(), sIdxDispl.data(),
+                   rIdx.data(), rIdxCount.data(), rIdxDispl.data());
+    comm.alltoallv(sVal.data(), sValCount.data(), sValDispl.data(),
+                   rVal.data(), rValCount.data(), rValDispl.data());
+
+    // Sum up the own and the received contributions to the owned rows
+    std::vector<index_t> local(n, -1);
+    for (index_t r = 0; r != nLoc; ++r)
+        local[owned[r]] = r;
+
+    gsSparseEntries<T> entries;
+    localRhs.resize(nLoc, nc);
+    for (index_t r = 0; r != nLoc; ++r)
+    {
+        for (RowIter it(A, owned[r]); it; ++it)
+            entries.add(r, it.col(), it.value());
+        localRhs.row(r) = rhs.row(owned[r]);
+    }
+
+    const index_t * pi = rIdx.data(), * iend = pi + rIdx.size();
+    const T * pv = rVal.data();
+    while ( pi != iend )
+    {
+        const index_t r = local[*pi++];
+        GISMO_ASSERT(-1 != r, "Received a row which is not owned.");
+        for (index_t k = *pi++; k != 0; --k)
+            entries.add(r, *pi++, *pv++);
+        for (index_t j = 0; j != nc; ++j)
+            localRhs(r, j) += *pv++;
+    }
+
+    gsSparseMatrix<T,RowMajor> rows(nLoc, n);
+    rows.setFrom(entries);
+    return uPtr( new gsDistributedOp(rows, part, comm) );
+}
+
+template <class T>
+void gsDistributedOp<T>::exchange(const gsMatrix<T> & input, gsMatrix<T> & ext) const
+{
+    const index_t nLoc = m_matrix.rows();
+    const index_t nc   = input.cols();
+    GISMO_ASSERT(input.rows() == nLoc, "Wrong input size "<< input.rows() <<" != "<< nLoc);
+
+    ext.resize(m_matrix.cols(), nc);
+    ext.topRows(nLoc) = input;
+    if ( m_recvRank.empty() && m_sendRank.empty() )
+        return;
+
+    // Every message holds all columns of the rows exchanged with one process
+    std::vector<T> recvBuf(haloSize() * nc), sendBuf(m_sendIdx.size() * nc);
+    std::vector<gsMpiRequest> req(m_recvRank.size() + m_sendRank.size());
+
+    for (size_t q = 0; q != m_recvRank.size(); ++q)
+        m_comm.irecv(recvBuf.data() + m_recvPtr[q] * nc,
+                     (m_recvPtr[q+1] - m_recvPtr[q]) * nc,
+                     m_recvRank[q], &req[q]);
+
+    T * buf = sendBuf.data();
+    for (size_t q = 0; q != m_sendRank.size(); ++q)
+    {
+        T * const start = buf;
+        for (index_t j = 0; j != nc; ++j)
+            for (index_t s = m_sendPtr[q]; s != m_sendPtr[q+1]; ++s)
+                *buf++ = input(m_sendIdx[s], j);
+        m_comm.isend(start, buf - start, m_sendRank[q], &req[m_recvRank.size() + q]);
+    }
+
+    for (size_t r = 0; r != req.size(); ++r)
+        req[r].wait();
+
+    const T * pv = recvBuf.data();
+    for (size_t q = 0; q != m_recvRank.size(); ++q)
+        for (index_t j = 0; j != nc; ++j)
+            for (index_t h = m_recvPtr[q]; h != m_recvPtr[q+1]; ++h)
+                ext(nLoc + h, j) = *pv++;
+}
+
+template <class T>
+void gsDistributedOp<T>::apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+{
+    gsMatrix<T> ext;
+    exchange(input, ext);
+    x.noalias() = m_matrix * ext;
+}
+
+template <class T>
+void gsDistributedOp<T>::gather(const gsMatrix<T> & local, gsMatrix<T> & global) const
+{
+    GISMO_ASSERT(local.rows() == m_matrix.rows(), "Wrong input size.");
+    const index_t n = m_allOwned.size();
+    global.resize(n, local.cols());
+
+    std::vector<int> counts(m_counts), displs(m_displs);
+    gsVector<T> in, all(n);
+    for (index_t j = 0; j != local.cols(); ++j)
+    {
+        in = local.col(j);
+        m_comm.allgatherv(in.data(), in.size(), all.data(), counts.data(), displs.data());
+        for (index_t p = 0; p != n; ++p)
+            global(m_allOwned[p], j) = all[p];
+    }
+}
+
+template <class T>
+void gsDistributedOp<T>::localPart(const gsMatrix<T> & global, gsMatrix<T> & local) const
+{
+    GISMO_ASSERT(global.rows() == static_cast<index_t>(m_allOwned.size()), "Wrong input size.");
+    local.resize(m_owned.size(), global.cols());
+    for (size_t r = 0; r != m_owned.size(); ++r)
+        local.row(r) = global.row(m_owned[r]);
+}
+
+} // namespace gismo
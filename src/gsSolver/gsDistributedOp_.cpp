@@ -0,0 +1,11 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsSolver/gsDistributedOp.h>
+#include <gsSolver/gsDistributedOp.hpp>
+
+namespace gismo
+{
+
+CLASS_TEMPLATE_INST gsDistributedOp<real_t>;
+
+} // namespace gismo
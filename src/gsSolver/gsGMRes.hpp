@@ -26,7 +26,7 @@ bool gsGMRes<T>::initIteration( const typename gsGMRes<T>::VectorType& rhs,
     m_mat->apply(x,tmp);
     tmp = rhs - tmp;
     m_precond->apply(tmp, residual);
-    beta = residual.norm(); // This is  ||r||
+    beta = parallelNorm(residual); // This is  ||r||
 
     m_error = beta/m_rhs_norm;
     if(m_error < m_tol)
@@ -98,10 +98,10 @@ bool gsGMRes<T>::step( typename gsGMRes<T>::VectorType& )
 
     for (index_t i = 0; i< k+1; ++i)
     {
-        h_tmp(i,0) = (w.transpose()*v[i]).value(); //Typo h_l,k
+        h_tmp(i,0) = parallelDot(w, v[i]); //Typo h_l,k
         w = w - h_tmp(i,0)*v[i];
     }
-    h_tmp(k+1,0) = w.norm();
+    h_tmp(k+1,0) = parallelNorm(w);
 
   //  if (math::abs(h_tmp(k+1,0)) < 1e-16) //If exact solution
   //      return true;
@@ -15,6 +15,7 @@
 #include <gsCore/gsExport.h>
 #include <gsCore/gsLinearAlgebra.h>
 #include <gsSolver/gsMatrixOp.h>
+#include <gsSolver/gsParallelKernels.h>
 #include <gsIO/gsOptionList.h>
 
 namespace gismo
@@ -179,7 +180,7 @@ public:
 
         m_num_iter = 0;
 
-        m_rhs_norm = rhs.norm();
+        m_rhs_norm = parallelNorm(rhs);
 
         if (0 == m_rhs_norm) // special case of zero rhs
         {
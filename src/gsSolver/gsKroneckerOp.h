@@ -13,6 +13,7 @@
 #pragma once
 
 #include <gsSolver/gsLinearOperator.h>
+#include <gsSolver/gsMatrixOp.h>
 
 namespace gismo
 {
@@ -23,6 +24,14 @@ namespace gismo
 ///
 /// where \f$ A \otimes B = ( a_{11} B \  a_{12} B \ ... ;  a_{21} B \  a_{22} B \ ... ; ... ) \f$.
 ///
+/// The factors are applied one after the other, each to all
+/// right-hand sides at once. Factors which are dense matrices (given
+/// by gsMatrixOp, also transposed) are applied by matrix-matrix
+/// products which write the reordered result directly, in parallel
+/// if OpenMP is enabled. The intermediate results are kept in
+/// workspaces of the operator, which are only reallocated if they
+/// grow. Within a parallel region, local workspaces are used instead.
+///
 /// \ingroup Solver
 template <class T>
 class gsKroneckerOp GISMO_FINAL : public gsLinearOperator<T>
@@ -81,8 +90,19 @@ public:
     /// Apply provided linear operators without the need of creating an object
     static void apply(const std::vector<BasePtr> & ops, const gsMatrix<T> & input, gsMatrix<T> & x);
 
+private:
+
+    /// Applies \a ops using the workspaces \a ws0, \a ws1 and \a wsIn
+    static void apply_impl(const std::vector<BasePtr> & ops, const gsMatrix<T> & input,
+                           gsMatrix<T> & x, gsVector<T> & ws0, gsVector<T> & ws1,
+                           gsMatrix<T> & wsIn);
+
 private:
     std::vector<BasePtr> m_ops;
+
+    // Workspaces for the intermediate results
+    mutable gsVector<T> m_ws0, m_ws1;
+    mutable gsMatrix<T> m_wsIn;
 };
 
 }
@@ -14,9 +14,66 @@
 namespace gismo
 {
 
+namespace internal
+{
+
+/// Returns the dense matrix of \a op if it is a gsMatrixOp of a dense
+/// matrix or of its transpose (then \a transposed is set), otherwise NULL
+template <typename T>
+const typename gsMatrix<T>::Base * denseKroneckerFactor(const gsLinearOperator<T> & op,
+                                                        bool & transposed)
+{
+    typedef typename gsMatrix<T>::Base Base;
+    transposed = false;
+    if ( const gsMatrixOp<gsMatrix<T> > * m =
+         dynamic_cast<const gsMatrixOp<gsMatrix<T> >*>(&op) )
+        return &m->matrix();
+    if ( const gsMatrixOp<Base> * m = dynamic_cast<const gsMatrixOp<Base>*>(&op) )
+        return &m->matrix();
+    transposed = true;
+    if ( const gsMatrixOp<Eigen::Transpose<const Base> > * m =
+         dynamic_cast<const gsMatrixOp<Eigen::Transpose<const Base> >*>(&op) )
+        return &m->matrix().nestedExpression();
+    if ( const gsMatrixOp<Eigen::Transpose<Base> > * m =
+         dynamic_cast<const gsMatrixOp<Eigen::Transpose<Base> >*>(&op) )
+        return &m->matrix().nestedExpression();
+    return NULL;
+}
+
+/// Writes the transpose of the \a rows x \a cols matrix \a a to \a b,
+/// tile by tile
+template <typename T>
+void tiledTranspose(const T * a, index_t rows, index_t cols, T * b)
+{
+    const index_t ts = 32;
+    for (index_t j0 = 0; j0 < cols; j0 += ts)
+    {
+        const index_t j1 = math::min(j0 + ts, cols);
+        for (index_t i0 = 0; i0 < rows; i0 += ts)
+        {
+            const index_t i1 = math::min(i0 + ts, rows);
+            for (index_t j = j0; j != j1; ++j)
+                for (index_t i = i0; i != i1; ++i)
+                    b[j + i * cols] = a[i + j * rows];
+        }
+    }
+}
+
+} // namespace internal
+
 /// @cond
 template <typename T>
 void gsKroneckerOp<T>::apply(const std::vector<typename gsLinearOperator<T>::Ptr> & ops, const gsMatrix<T> & input, gsMatrix<T> & x)
+{
+    gsVector<T> ws0, ws1;
+    gsMatrix<T> wsIn;
+    apply_impl(ops, input, x, ws0, ws1, wsIn);
+}
+
+template <typename T>
+void gsKroneckerOp<T>::apply_impl(const std::vector<typename gsLinearOperator<T>::Ptr> & ops,
+                                  const gsMatrix<T> & input, gsMatrix<T> & x,
+                                  gsVector<T> & ws0, gsVector<T> & ws1, gsMatrix<T> & wsIn)
 {
     GISMO_ASSERT( !ops.empty(), "Zero-term Kronecker product" );
     const index_t nrOps = ops.size();
@@ -27,65 +84,102 @@ void gsKroneckerOp<T>::apply(const std::vector<typename gsLinearOperator<T>::Ptr
         return;
     }
 
-    //index_t rows = 1; // we don't compute rows as we do not need it
     index_t sz = 1;
-
     for (index_t i = 0; i < nrOps; ++i)
-    {
-        //rows *= ops[i]->rows();
         sz *= ops[i]->cols();
-    }
 
     GISMO_ASSERT (sz == input.rows(), "The input matrix has wrong size.");
     const index_t n = input.cols();
 
-    // Note: algorithm relies on col-major matrices
-    gsMatrix<T, Dynamic, Dynamic, ColMajor> q0, q1;
-    gsMatrix<T> temp;
-
-    // size: sz x n
-    q0 = input;
+    // The workspaces hold the largest intermediate result
+    index_t maxSz = sz;
+    for (index_t i = nrOps - 1, s = sz; i >= 0; --i)
+    {
+        s = ( s / ops[i]->cols() ) * ops[i]->rows();
+        maxSz = math::max(maxSz, s);
+    }
+    if ( ws0.size() < n * maxSz )
+        ws0.resize(n * maxSz);
+    if ( ws1.size() < n * maxSz )
+        ws1.resize(n * maxSz);
+
+    // For right-hand side k, the block src_k is the current vector
+    // seen as cols_i x r_i matrix (col-major). The factor is applied
+    // from the left and the result is stored transposed, such that the
+    // next factor acts again on the rows.
+    const T * src = input.data();
+    T * dst = ws0.data();
 
     for (index_t i = nrOps - 1; i >= 0; --i)
     {
-
         const index_t cols_i = ops[i]->cols();
         const index_t rows_i = ops[i]->rows();
         const index_t r_i  = sz / cols_i;
+        const bool par = static_cast<double>(n) * r_i * cols_i * rows_i > 1e5;
+        GISMO_UNUSED(par); // without OpenMP
 
-        // Re-order right-hand sides
-        q0.resize(cols_i, n * r_i);
-
-        // Apply operator
-        ops[i]->apply(q0, temp);
-        GISMO_ASSERT (temp.rows() == rows_i && temp.cols() == n * r_i, "The linear operator returned a matrix with unexpected size.");
-
-        // Transpose solution component-wise
-        if (n == 1)
-            q1 = temp.transpose();
+        bool tr = false;
+        const typename gsMatrix<T>::Base * A = internal::denseKroneckerFactor(*ops[i], tr);
+        if ( A )
+        {
+            GISMO_ASSERT( (tr ? A->cols() : A->rows()) == rows_i, "Internal error." );
+            // dst_k = src_k^T A^T, computed by blocks of rows
+            const index_t bs = 128;
+            const index_t nb = (r_i + bs - 1) / bs;
+#           pragma omp parallel for if (par)
+            for (index_t b = 0; b < n * nb; ++b)
+            {
+                const index_t k = b / nb, first = (b % nb) * bs;
+                const index_t len = math::min(bs, r_i - first);
+                gsAsConstMatrix<T> src_k(src + k * cols_i * r_i, cols_i, r_i);
+                gsAsMatrix<T>      dst_k(dst + k * r_i * rows_i, r_i, rows_i);
+                if ( tr )
+                    dst_k.middleRows(first, len).noalias() =
+                        src_k.middleCols(first, len).transpose() * (*A);
+                else
+                    dst_k.middleRows(first, len).noalias() =
+                        src_k.middleCols(first, len).transpose() * A->transpose();
+            }
+        }
         else
         {
-            q1.resize(r_i, n * rows_i);
-            for (index_t k = 0; k != n; ++k)
-                q1.middleCols(k*rows_i, rows_i) = temp.middleCols(k*r_i, r_i).transpose();
+            // Apply operator to all right-hand sides at once, x is
+            // used as workspace for the result
+            wsIn = gsAsConstMatrix<T>(src, cols_i, n * r_i);
+            ops[i]->apply(wsIn, x);
+            GISMO_ASSERT (x.rows() == rows_i && x.cols() == n * r_i, "The linear operator returned a matrix with unexpected size.");
+
+            // Transpose solution component-wise
+            const T * res = x.data();
+#           pragma omp parallel for if (par)
+            for (index_t k = 0; k < n; ++k)
+                internal::tiledTranspose(res + k * rows_i * r_i, rows_i, r_i,
+                                         dst + k * r_i * rows_i);
         }
 
-        q1.swap( q0 ); // move solution as next right-hand side
-        sz = ( sz / cols_i) * rows_i; // update now the dimensionality such that in the end sz = rows
+        src = dst;
+        dst = ( dst == ws0.data() ? ws1.data() : ws0.data() );
+        sz = ( sz / cols_i ) * rows_i; // update now the dimensionality such that in the end sz = rows
         //sz % cols_i == 0, since sz *= ops[i]->cols();
     }
 
-    //GISMO_ASSERT (sz == rows, "Internal error."); // see one above
-
-    q0.resize(sz, n);
-    x.swap( q0 );
+    x = gsAsConstMatrix<T>(src, sz, n);
 }
 /// @endcond
 
 template <typename T>
 void gsKroneckerOp<T>::apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
 {
-    apply(m_ops, input, x);
+    // Inside a parallel region the operator might be applied by
+    // several threads at the same time
+#   ifdef _OPENMP
+    if ( omp_in_parallel() )
+    {
+        apply(m_ops, input, x);
+        return;
+    }
+#   endif
+    apply_impl(m_ops, input, x, m_ws0, m_ws1, m_wsIn);
 }
 
 template <typename T>
@@ -14,10 +14,26 @@
 
 #include <gsCore/gsLinearAlgebra.h>
 #include <gsSolver/gsLinearOperator.h>
+#include <gsSolver/gsParallelKernels.h>
 
 namespace gismo
 {
 
+namespace internal
+{
+/// Computes \a x = \a A * \a input
+template <class Derived>
+inline void matrixProduct(const Derived & A, const gsMatrix<typename Derived::Scalar> & input,
+                          gsMatrix<typename Derived::Scalar> & x)
+{ x.noalias() = A * input; }
+
+/// Computes \a x = \a A * \a input using all threads
+template <class T, int _Options, typename _Index>
+inline void matrixProduct(const gsSparseMatrix<T,_Options,_Index> & A, const gsMatrix<T> & input,
+                          gsMatrix<T> & x)
+{ parallelProduct(A, input, x); }
+} // namespace internal
+
 // left here for debugging purposes
 // template<typename T> struct is_ref { static const bool value = false; };
 // template<typename T> struct is_ref<T&> { static const bool value = true; };
@@ -72,7 +88,7 @@ public:
     { return uPtr( new gsMatrixOp(give(mat)) ); }
 
     void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
-    { x.noalias() = m_expr * input; }
+    { internal::matrixProduct(m_expr, input, x); }
 
     index_t rows() const
     { return m_expr.rows(); }
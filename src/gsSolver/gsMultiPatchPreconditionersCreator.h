@@ -0,0 +1,100 @@
+/** @file gsMultiPatchPreconditionersCreator.h
+
+    @brief Provides preconditioners for multipatch geometries based on
+    the single patch preconditioners.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#pragma once
+
+#include <gsSolver/gsPatchPreconditionersCreator.h>
+#include <gsCore/gsMultiBasis.h>
+
+namespace gismo
+{
+
+/// @brief Provides preconditioners for multipatch geometries.
+///
+/// The preconditioners are additive Schwarz methods which combine the
+/// single patch preconditioners of \a gsPatchPreconditionersCreator on
+/// the interiors of the patches with a direct solver on the interfaces.
+///
+/// The unknowns are numbered as by \a gsMultiBasis::getMapper for the
+/// given boundary conditions and options, which requires conforming
+/// tensor bases glued at the interfaces and the elimination of the
+/// Dirichlet values (as done by the assemblers by default).
+///
+/// @ingroup Solver
+template<typename T>
+class gsMultiPatchPreconditionersCreator
+{
+    typedef typename gsLinearOperator<T>::uPtr OpUPtr;
+    typedef typename gsLinearOperator<T>::Ptr  OpPtr;
+public:
+
+    /// Transfer matrix type, see \a gsAdditiveOp
+    typedef gsSparseMatrix<T,RowMajor> Transfer;
+
+    /// Provides the boundary conditions of patch \a k as seen from its
+    /// interior, ie., the Dirichlet sides and the interfaces become
+    /// Dirichlet sides. The conditions refer to patch 0, as required
+    /// by \a gsPatchPreconditionersCreator.
+    ///
+    /// \param mb     The multipatch basis
+    /// \param bc     Boundary conditions
+    /// \param k      The patch
+    static gsBoundaryConditions<T> localBoundaryConditions(
+        const gsMultiBasis<T>& mb,
+        const gsBoundaryConditions<T>& bc,
+        index_t k
+    );
+
+    /// Provides the transfer matrices of the subspaces: the
+    /// interiors of the patches, followed by the interface unknowns
+    /// (the latter is omitted if there are no interfaces).
+    ///
+    /// \param mb     The multipatch basis
+    /// \param bc     Boundary conditions
+    /// \param opt    Assembler options
+    static std::vector<Transfer> getTransfers(
+        const gsMultiBasis<T>& mb,
+        const gsBoundaryConditions<T>& bc,
+        const gsOptionList& opt = gsAssembler<T>::defaultOptions()
+    );
+
+    /// Provides \a gsLinearOperator representing an additive Schwarz
+    /// preconditioner for the matrix \a A, which represents
+    /// \f$ -\beta \Delta u + \alpha u \f$
+    ///
+    /// On the interior of each patch, the inverse of the stiffness
+    /// matrix on the parameter domain is applied by the fast
+    /// diagonalization method (see \a gsPatchPreconditionersCreator).
+    /// On the interfaces, the restriction of \a A is solved directly.
+    /// The patches are solved concurrently (see \a gsAdditiveOp::setParallel).
+    ///
+    /// \param A      The system matrix
+    /// \param mb     The multipatch basis
+    /// \param bc     Boundary conditions
+    /// \param opt    Assembler options
+    /// \param alpha  Scaling parameter (see above)
+    /// \param beta   Scaling parameter (see above)
+    static OpUPtr fastDiagonalizationOp(
+        const gsSparseMatrix<T>& A,
+        const gsMultiBasis<T>& mb,
+        const gsBoundaryConditions<T>& bc,
+        const gsOptionList& opt = gsAssembler<T>::defaultOptions(),
+        T alpha = 0,
+        T beta = 1
+    );
+
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsMultiPatchPreconditionersCreator.hpp)
+#endif
@@ -0,0 +1,200 @@
+/** @file gsMultiPatchPreconditionersCreator.hpp
+
+    @brief Provides preconditioners for multipatch geometries based on
+    the single patch preconditioners.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#pragma once
+
+#include <gsSolver/gsAdditiveOp.h>
+#include <gsSolver/gsMatrixOp.h>
+
+namespace gismo
+{
+
+namespace {
+
+template<typename T>
+void multiPatchMapper(const gsMultiBasis<T>& mb, const gsBoundaryConditions<T>& bc,
+                      const gsOptionList& opt, gsDofMapper& dm)
+{
+    const dirichlet::strategy ds = (dirichlet::strategy)opt.askInt("DirichletStrategy",dirichlet::elimination);
+    const iFace::strategy     is = (iFace::strategy    )opt.askInt("InterfaceStrategy",iFace::conforming);
+    GISMO_ENSURE( ds == dirichlet::elimination && is == iFace::conforming,
+                  "gsMultiPatchPreconditionersCreator requires the elimination of the "
+                  "Dirichlet values and conforming interfaces." );
+    mb.getMapper(ds, is, bc, dm, 0);
+}
+
+template<typename T>
+bool isDirichletSide(const gsBoundaryConditions<T>& bc, short_t s)
+{
+    const boundary_condition<T>* cond = bc.getConditionFromSide(patchSide(0,s));
+    return cond && cond->type() == condition_type::dirichlet;
+}
+
+} // anonymous namespace
+
+template<typename T>
+gsBoundaryConditions<T> gsMultiPatchPreconditionersCreator<T>::localBoundaryConditions(
+    const gsMultiBasis<T>& mb,
+    const gsBoundaryConditions<T>& bc,
+    index_t k
+    )
+{
+    gsBoundaryConditions<T> result;
+    const short_t nSides = 2 * mb.dim();
+    for (short_t s = 1; s <= nSides; ++s)
+    {
+        const patchSide ps(k,s);
+        const boundary_condition<T>* cond = bc.getConditionFromSide(ps);
+        if ( mb.topology().isInterface(ps)
+             || (cond && cond->type() == condition_type::dirichlet) )
+            result.addCondition(0, s, condition_type::dirichlet, NULL);
+        else if (cond)
+            result.addCondition(0, s, cond->type(), cond->function());
+    }
+    return result;
+}
+
+template<typename T>
+std::vector<typename gsMultiPatchPreconditionersCreator<T>::Transfer>
+gsMultiPatchPreconditionersCreator<T>::getTransfers(
+    const gsMultiBasis<T>& mb,
+    const gsBoundaryConditions<T>& bc,
+    const gsOptionList& opt
+    )
+{
+    gsDofMapper dm;
+    multiPatchMapper(mb, bc, opt, dm);
+    const index_t nDofs = dm.freeSize();
+    const index_t nPatches = mb.nBases();
+    const short_t d = mb.dim();
+
+    std::vector<Transfer> result;
+    result.reserve(nPatches+1);
+    gsSparseEntries<T> se;
+    std::vector<index_t> sz(d), lo(d), hi(d), idx(d);
+
+    // Interiors of the patches, numbered as the unknowns of the
+    // patch-local preconditioners
+    for (index_t k = 0; k < nPatches; ++k)
+    {
+        const gsBasis<T>& basis = mb[k];
+        const gsBoundaryConditions<T> lbc = localBoundaryConditions(mb, bc, k);
+        for (short_t i = 0; i < d; ++i)
+        {
+            sz[i] = basis.component(i).size();
+            lo[i] = isDirichletSide(lbc, 2*i+1) ? 1 : 0;
+            hi[i] = sz[i] - ( isDirichletSide(lbc, 2*i+2) ? 1 : 0 );
+        }
+
+        se.clear();
+        index_t local = 0;
+        const index_t n = basis.size();
+        for (index_t j = 0; j < n; ++j)
+        {
+            // Tensor index, the first component runs fastest
+            index_t r = j;
+            bool interior = true;
+            for (short_t i = 0; i < d; ++i)
+            {
+                idx[i] = r % sz[i];
+                r /= sz[i];
+                interior = interior && lo[i] <= idx[i] && idx[i] < hi[i];
+            }
+            if (!interior)
+                continue;
+
+            const index_t glob = dm.index(j,k);
+            GISMO_ENSURE( dm.is_free_index(glob) && !dm.is_coupled_index(glob),
+                          "Patch "<<k<<" has coupled unknowns in its interior." );
+            se.add(glob, local++, 1);
+        }
+        result.push_back(Transfer(nDofs, local));
+        result.back().setFrom(se);
+    }
+
+    // Unknowns on the interfaces
+    std::vector<index_t> iface(nDofs, -1);
+    for (index_t k = 0; k < nPatches; ++k)
+        for (index_t j = 0; j < mb[k].size(); ++j)
+        {
+            const index_t glob = dm.index(j,k);
+            if ( dm.is_free_index(glob) && dm.is_coupled_index(glob) )
+                iface[glob] = 0;
+        }
+
+    se.clear();
+    index_t local = 0;
+    for (index_t glob = 0; glob < nDofs; ++glob)
+        if ( iface[glob] == 0 )
+            se.add(glob, local++, 1);
+    if (local > 0)
+    {
+        result.push_back(Transfer(nDofs, local));
+        result.back().setFrom(se);
+    }
+
+    return result;
+}
+
+template<typename T>
+typename gsMultiPatchPreconditionersCreator<T>::OpUPtr
+gsMultiPatchPreconditionersCreator<T>::fastDiagonalizationOp(
+    const gsSparseMatrix<T>& A,
+    const gsMultiBasis<T>& mb,
+    const gsBoundaryConditions<T>& bc,
+    const gsOptionList& opt,
+    T alpha,
+    T beta
+    )
+{
+    std::vector<Transfer> transfers = getTransfers(mb, bc, opt);
+    GISMO_ASSERT( transfers[0].rows() == A.rows() && A.rows() == A.cols(),
+                  "The matrix does not fit to the multipatch basis." );
+
+    const index_t nPatches = mb.nBases();
+    std::vector<OpPtr> ops(transfers.size());
+
+    // The local problems are independent of each other. Exceptions
+    // must not leave the parallel region, so the first one is
+    // rethrown afterwards.
+    std::string error;
+#   pragma omp parallel for schedule(dynamic)
+    for (index_t k = 0; k < nPatches; ++k)
+    {
+        try
+        {
+            ops[k] = gsPatchPreconditionersCreator<T>::fastDiagonalizationOp(
+                mb[k], localBoundaryConditions(mb, bc, k), opt, alpha, beta);
+        }
+        catch (const std::exception & e)
+        {
+#           pragma omp critical (gsMultiPatchPreconditionersCreator_error)
+            if ( error.empty() )
+                error = e.what();
+        }
+    }
+    if ( !error.empty() )
+        throw std::runtime_error(error);
+
+    if ( (index_t)transfers.size() > nPatches )
+    {
+        const Transfer& tr = transfers.back();
+        gsSparseMatrix<T> Aiface = tr.transpose() * A * tr;
+        ops.back() = makeSparseCholeskySolver(Aiface);
+    }
+
+    // The local operators do not share any workspaces
+    typename gsAdditiveOp<T>::uPtr result = gsAdditiveOp<T>::make(give(transfers), give(ops));
+    result->setParallel(true);
+    return give(result);
+}
+
+} // namespace gismo
@@ -0,0 +1,11 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsSolver/gsMultiPatchPreconditionersCreator.h>
+#include <gsSolver/gsMultiPatchPreconditionersCreator.hpp>
+
+namespace gismo
+{
+
+CLASS_TEMPLATE_INST gsMultiPatchPreconditionersCreator<real_t>;
+
+} // namespace gismo
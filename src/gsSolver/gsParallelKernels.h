@@ -0,0 +1,205 @@
+/** @file gsParallelKernels.h
+
+    @brief Thread-parallel sparse matrix-vector products and vector
+    kernels used by the iterative solvers
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+
+namespace gismo
+{
+
+namespace internal
+{
+
+/// Smaller problems are computed by a single thread
+const index_t parallelKernelMinSize = 20000;
+
+/// Returns the range [\a begin, \a end) of [0, \a n) which is
+/// processed by the calling thread of a parallel region
+inline void threadRange(const index_t n, index_t & begin, index_t & end)
+{
+#   ifdef _OPENMP
+    const size_t nt = omp_get_num_threads(), tid = omp_get_thread_num();
+#   else
+    const size_t nt = 1, tid = 0;
+#   endif
+    begin = static_cast<index_t>( n * tid / nt );
+    end   = static_cast<index_t>( n * (tid+1) / nt );
+}
+
+} // namespace internal
+
+/// @brief Returns the dot product of the first columns of \a a and \a b
+///
+/// \ingroup Solver
+template <class T>
+T parallelDot(const gsMatrix<T> & a, const gsMatrix<T> & b)
+{
+    GISMO_ASSERT( a.rows() == b.rows(), "Dimensions do not match.");
+    const index_t n = a.rows();
+    T result = 0;
+#   pragma omp parallel reduction(+:result) if (n > internal::parallelKernelMinSize)
+    {
+        index_t i0, i1;
+        internal::threadRange(n, i0, i1);
+        result += a.col(0).segment(i0, i1-i0).dot( b.col(0).segment(i0, i1-i0) );
+    }
+    return result;
+}
+
+/// @brief Returns the Euclidean norm of the first column of \a a
+///
+/// \ingroup Solver
+template <class T>
+T parallelNorm(const gsMatrix<T> & a)
+{ return math::sqrt( parallelDot(a, a) ); }
+
+/// @brief Performs the updates \f$ x \mathrel{+}= \alpha p \f$ and
+/// \f$ r \mathrel{-}= \alpha q \f$ of the conjugate gradient method
+/// in one pass and returns \f$ |r|^2 \f$
+///
+/// \ingroup Solver
+template <class T>
+T parallelCgUpdate(gsMatrix<T> & x, gsMatrix<T> & r,
+                   const gsMatrix<T> & p, const gsMatrix<T> & q, const T alpha)
+{
+    GISMO_ASSERT( x.rows() == r.rows() && p.rows() == r.rows() && q.rows() == r.rows(),
+                  "Dimensions do not match.");
+    const index_t n = r.rows();
+    T result = 0;
+#   pragma omp parallel reduction(+:result) if (n > internal::parallelKernelMinSize)
+    {
+        index_t i0, i1;
+        internal::threadRange(n, i0, i1);
+        x.col(0).segment(i0, i1-i0) += alpha * p.col(0).segment(i0, i1-i0);
+        r.col(0).segment(i0, i1-i0) -= alpha * q.col(0).segment(i0, i1-i0);
+        result += r.col(0).segment(i0, i1-i0).squaredNorm();
+    }
+    return result;
+}
+
+/// @brief Computes \f$ y = x + \beta y \f$ for the first columns
+///
+/// \ingroup Solver
+template <class T>
+void parallelXpby(const gsMatrix<T> & x, const T beta, gsMatrix<T> & y)
+{
+    GISMO_ASSERT( x.rows() == y.rows(), "Dimensions do not match.");
+    const index_t n = x.rows();
+#   pragma omp parallel if (n > internal::parallelKernelMinSize)
+    {
+        index_t i0, i1;
+        internal::threadRange(n, i0, i1);
+        y.col(0).segment(i0, i1-i0) = x.col(0).segment(i0, i1-i0)
+            + beta * y.col(0).segment(i0, i1-i0);
+    }
+}
+
+/// @brief Computes the product \f$ y = A x \f$ of a sparse matrix with
+/// a dense matrix using all threads.
+///
+/// For row-major matrices every thread computes a block of rows of
+/// \a y. For column-major matrices every thread multiplies a block
+/// of columns of \a A into a private buffer, which only spans the
+/// rows touched by these columns; the buffers are summed up
+/// afterwards. For banded matrices, as they arise from the
+/// discretization of PDEs, the buffers are hardly larger than the
+/// blocks, thus the memory traffic is close to that of the serial
+/// product.
+///
+/// \ingroup Solver
+template <class T, int _Options, typename _Index>
+void parallelProduct(const gsSparseMatrix<T,_Options,_Index> & A,
+                     const gsMatrix<T> & x, gsMatrix<T> & y)
+{
+    GISMO_ASSERT( A.cols() == x.rows(), "Dimensions do not match.");
+    typedef typename gsSparseMatrix<T,_Options,_Index>::InnerIterator InnerIterator;
+
+#   ifdef _OPENMP
+    const index_t nnz = A.nonZeros();
+    if ( nnz > internal::parallelKernelMinSize && A.isCompressed()
+         && omp_get_max_threads() > 1 )
+    {
+        const index_t nc = x.cols();
+        y.resize(A.rows(), nc);
+
+        if ( _Options & RowMajor )
+        {
+#           pragma omp parallel for schedule(static)
+            for (index_t i = 0; i < A.outerSize(); ++i)
+            {
+                y.row(i).setZero();
+                for (InnerIterator it(A,i); it; ++it)
+                    y.row(i) += it.value() * x.row(it.index());
+            }
+            return;
+        }
+
+        const _Index * outer = A.outerIndexPtr();
+        const _Index * inner = A.innerIndexPtr();
+        const index_t n = A.outerSize();
+        const int nt = omp_get_max_threads();
+        std::vector<gsMatrix<T> > buf(nt);
+        std::vector<index_t> rmin(nt), rmax(nt);
+
+#       pragma omp parallel num_threads(nt)
+        {
+            const int tid = omp_get_thread_num();
+            const int nth = omp_get_num_threads();
+
+            // Columns of this thread, balanced by the number of non-zeros
+            const index_t c0 = std::upper_bound(outer, outer + n,
+                static_cast<_Index>(static_cast<size_t>(nnz) * tid / nth)) - outer - 1;
+            const index_t c1 = std::upper_bound(outer, outer + n,
+                static_cast<_Index>(static_cast<size_t>(nnz) * (tid+1) / nth)) - outer - 1;
+            const index_t cEnd = ( tid + 1 == nth ? n : c1 );
+            const index_t cBeg = ( 0 == tid ? 0 : c0 );
+
+            // Rows touched by these columns
+            index_t r0 = A.rows(), r1 = 0;
+            for (index_t j = cBeg; j < cEnd; ++j)
+                if ( outer[j] != outer[j+1] )
+                {
+                    r0 = math::min(r0, static_cast<index_t>(inner[outer[j]]));
+                    r1 = math::max(r1, static_cast<index_t>(inner[outer[j+1]-1]) + 1);
+                }
+            r1 = math::max(r0, r1);
+            rmin[tid] = r0;
+            rmax[tid] = r1;
+
+            gsMatrix<T> & b = buf[tid];
+            b.setZero(r1 - r0, nc);
+            for (index_t j = cBeg; j < cEnd; ++j)
+                for (InnerIterator it(A,j); it; ++it)
+                    b.row(it.index() - r0) += it.value() * x.row(j);
+
+#           pragma omp barrier
+
+            // Sum the buffers on the rows of this thread
+            index_t i0, i1;
+            internal::threadRange(A.rows(), i0, i1);
+            y.middleRows(i0, i1-i0).setZero();
+            for (int s = 0; s < nth; ++s)
+            {
+                const index_t a0 = math::max(i0, rmin[s]);
+                const index_t a1 = math::min(i1, rmax[s]);
+                if ( a0 < a1 )
+                    y.middleRows(a0, a1-a0) += buf[s].middleRows(a0 - rmin[s], a1-a0);
+            }
+        }
+        return;
+    }
+#   endif
+
+    y.noalias() = A * x;
+}
+
+} // namespace gismo
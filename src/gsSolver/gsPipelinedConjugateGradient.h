@@ -0,0 +1,145 @@
+/** @file gsPipelinedConjugateGradient.h
+
+    @brief Pipelined conjugate gradient solver
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsSolver/gsIterativeSolver.h>
+#include <gsMpi/gsMpi.h>
+
+namespace gismo
+{
+
+/// @brief The pipelined conjugate gradient method (Ghysels and
+/// Vanroose, Parallel Computing 40(7), 2014).
+///
+/// Mathematically equivalent to gsConjugateGradient, but all inner
+/// products of an iteration are combined into a single global
+/// reduction, which is started non-blocking and overlapped with the
+/// application of the preconditioner and of the operator. This hides
+/// the latency of the reduction if the data is distributed over many
+/// processes. The price are four additional vectors, a few more
+/// vector updates, and a worse attainable accuracy. To counter the
+/// latter, the residual and the recurrences for its images are
+/// recomputed periodically (option "ResidualReplacement") and before
+/// convergence is reported.
+///
+/// If a communicator is set by setCommunicator(), the vectors passed
+/// to solve() and to the operators are the parts owned by the
+/// respective process, and the local inner products are summed up
+/// over the communicator. The operators are responsible for the
+/// exchange of the data they need from other processes.
+///
+/// \ingroup Solver
+template<class T = real_t>
+class gsPipelinedConjugateGradient : public gsIterativeSolver<T>
+{
+public:
+    typedef gsIterativeSolver<T> Base;
+
+    typedef gsMatrix<T>  VectorType;
+
+    typedef typename Base::LinOpPtr LinOpPtr;
+
+    typedef memory::shared_ptr<gsPipelinedConjugateGradient> Ptr;
+    typedef memory::unique_ptr<gsPipelinedConjugateGradient> uPtr;
+
+    /// @brief Constructor using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    explicit gsPipelinedConjugateGradient( const OperatorType& mat,
+                                           const LinOpPtr& precond = LinOpPtr() )
+    : Base(mat, precond), m_replace(50), m_distributed(false) {}
+
+    /// @brief Make function using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    static uPtr make( const OperatorType& mat, const LinOpPtr& precond = LinOpPtr() )
+    { return uPtr( new gsPipelinedConjugateGradient(mat, precond) ); }
+
+    /// @brief Returns a list of default options
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt = Base::defaultOptions();
+        opt.addInt("ResidualReplacement", "Number of iterations after which the residual"
+                   " is recomputed, 0 for never", 50 );
+        return opt;
+    }
+
+    /// @brief Set the options based on a gsOptionList
+    gsPipelinedConjugateGradient& setOptions(const gsOptionList& opt)
+    {
+        Base::setOptions(opt);
+        m_replace = opt.askInt("ResidualReplacement", m_replace);
+        return *this;
+    }
+
+    /// @brief Sets the communicator over which the inner products are summed up
+    void setCommunicator(const gsMpiComm & comm)
+    {
+        m_comm = comm;
+        m_distributed = true;
+    }
+
+    bool initIteration( const VectorType& rhs, VectorType& x );
+    bool step( VectorType& x );
+
+    /// Prints the object as a string.
+    std::ostream &print(std::ostream &os) const
+    {
+        os << "gsPipelinedConjugateGradient\n";
+        return os;
+    }
+
+private:
+
+    /// Computes the local parts of the inner products and the
+    /// preconditioned and multiplied vectors m and n, and sums up the
+    /// inner products while doing the latter. Returns true if the
+    /// iteration has converged.
+    bool reduceAndApply();
+
+    /// Recomputes the residual, its images and the images of the
+    /// search direction from their definitions
+    void replaceResidual(const VectorType& x);
+
+private:
+    using Base::m_mat;
+    using Base::m_precond;
+    using Base::m_tol;
+    using Base::m_num_iter;
+    using Base::m_rhs_norm;
+    using Base::m_error;
+
+    index_t m_replace;
+
+    gsMpiComm m_comm;
+    bool m_distributed;
+
+    VectorType m_rhs;
+
+    // Residual, preconditioned residual and its image, search
+    // direction and the recurrences for its images
+    VectorType m_r, m_u, m_w, m_m, m_n, m_p, m_s, m_q, m_z;
+
+    // Reduced values: (r,u), (w,u), (r,r)
+    T m_dots[3];
+    T m_gamma_old, m_alpha_old;
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsPipelinedConjugateGradient.hpp)
+#endif
@@ -0,0 +1,159 @@
+/** @file gsPipelinedConjugateGradient.hpp
+
+    @brief Pipelined conjugate gradient solver
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+namespace gismo
+{
+
+template<class T>
+bool gsPipelinedConjugateGradient<T>::initIteration( const typename gsPipelinedConjugateGradient<T>::VectorType& rhs,
+                                                     typename gsPipelinedConjugateGradient<T>::VectorType& x )
+{
+    GISMO_ASSERT( rhs.cols() == 1,
+                  "Iterative solvers only work for single column right-hand side." );
+    GISMO_ASSERT( rhs.rows() == m_mat->rows(),
+                  "The right-hand side does not match the matrix: "
+                  << rhs.rows() <<"!="<< m_mat->rows() );
+
+    m_num_iter = 0;
+
+    // The norm of the right-hand side is needed on all processes
+    T rhs_norm2 = parallelDot(rhs, rhs);
+    if (m_distributed)
+        rhs_norm2 = m_comm.sum(rhs_norm2);
+    m_rhs_norm = math::sqrt(rhs_norm2);
+
+    if (0 == m_rhs_norm) // special case of zero rhs
+    {
+        x.setZero(rhs.rows(),rhs.cols()); // for sure zero is a solution
+        m_error = 0.;
+        return true; // iteration is finished
+    }
+
+    if ( 0 == x.size() ) // if no initial solution, start with zeros
+        x.setZero(rhs.rows(), rhs.cols());
+    else
+    {
+        GISMO_ASSERT( x.rows() == m_mat->cols() && x.cols() == 1,
+                      "The initial guess does not match the matrix: "
+                      << x.rows() <<"!="<< m_mat->cols() );
+    }
+
+    m_rhs = rhs;
+    const index_t n = rhs.rows();
+    m_p.setZero(n,1);
+    m_s.setZero(n,1);
+    m_q.setZero(n,1);
+    m_z.setZero(n,1);
+    m_gamma_old = m_alpha_old = 0;
+    replaceResidual(x);                                                // initial residual
+
+    return reduceAndApply();
+}
+
+template<class T>
+bool gsPipelinedConjugateGradient<T>::step( typename gsPipelinedConjugateGradient<T>::VectorType& x )
+{
+    const T gamma = m_dots[0], delta = m_dots[1];
+    T alpha, beta;
+    if (0 == m_gamma_old)
+    {
+        beta  = 0;
+        alpha = gamma / delta;
+    }
+    else
+    {
+        beta  = gamma / m_gamma_old;
+        alpha = gamma / (delta - beta * gamma / m_alpha_old);
+    }
+    m_gamma_old = gamma;
+    m_alpha_old = alpha;
+
+    // Update the recurrences, the search direction and the iterates
+    // in one pass
+    const index_t n = x.rows();
+#   pragma omp parallel if (n > internal::parallelKernelMinSize)
+    {
+        index_t i0, i1;
+        internal::threadRange(n, i0, i1);
+        for (index_t i = i0; i < i1; ++i)
+        {
+            m_z(i,0) = m_n(i,0) + beta * m_z(i,0);
+            m_q(i,0) = m_m(i,0) + beta * m_q(i,0);
+            m_s(i,0) = m_w(i,0) + beta * m_s(i,0);
+            m_p(i,0) = m_u(i,0) + beta * m_p(i,0);
+            x  (i,0) += alpha * m_p(i,0);
+            m_r(i,0) -= alpha * m_s(i,0);
+            m_u(i,0) -= alpha * m_q(i,0);
+            m_w(i,0) -= alpha * m_z(i,0);
+        }
+    }
+
+    const bool replaced = m_replace > 0 && 0 == m_num_iter % m_replace;
+    if (replaced)
+        replaceResidual(x);
+
+    if (!reduceAndApply())
+        return false;
+
+    // Check that the true residual has converged as well
+    if (replaced)
+        return true;
+    replaceResidual(x);
+    return reduceAndApply();
+}
+
+template<class T>
+void gsPipelinedConjugateGradient<T>::replaceResidual( const typename gsPipelinedConjugateGradient<T>::VectorType& x )
+{
+    m_mat->apply(x, m_r);
+    m_r = m_rhs - m_r;
+    m_precond->apply(m_r, m_u);
+    m_mat->apply(m_u, m_w);
+    if (0 != m_gamma_old)
+    {
+        m_mat->apply(m_p, m_s);
+        m_precond->apply(m_s, m_q);
+        m_mat->apply(m_q, m_z);
+    }
+}
+
+template<class T>
+bool gsPipelinedConjugateGradient<T>::reduceAndApply()
+{
+    const index_t n = m_r.rows();
+    T gamma = 0, delta = 0, rr = 0;
+#   pragma omp parallel for reduction(+:gamma,delta,rr) if (n > internal::parallelKernelMinSize)
+    for (index_t i = 0; i < n; ++i)
+    {
+        gamma += m_r(i,0) * m_u(i,0);
+        delta += m_w(i,0) * m_u(i,0);
+        rr    += m_r(i,0) * m_r(i,0);
+    }
+    m_dots[0] = gamma;
+    m_dots[1] = delta;
+    m_dots[2] = rr;
+
+    // Overlap the reduction with m = M w and n = A m
+    gsMpiRequest req;
+    if (m_distributed)
+        m_comm.isum(m_dots, 3, &req);
+
+    m_precond->apply(m_w, m_m);
+    m_mat->apply(m_m, m_n);
+
+    if (m_distributed)
+        req.wait();
+
+    m_error = math::sqrt(m_dots[2]) / m_rhs_norm;
+    return m_error < m_tol;
+}
+
+} // end namespace gismo
@@ -0,0 +1,157 @@
+/** @file gsSStepConjugateGradient.h
+
+    @brief s-step conjugate gradient solver
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsSolver/gsIterativeSolver.h>
+#include <gsMpi/gsMpi.h>
+
+namespace gismo
+{
+
+/// @brief The s-step conjugate gradient method (Chronopoulos and
+/// Gear, J. Comput. Appl. Math. 25(2), 1989).
+///
+/// Every step of the method builds a basis of the Krylov space
+/// \f$ \operatorname{span}\{ z, (MA)z, \dots, (MA)^{s-1}z \} \f$
+/// of the preconditioned residual \f$ z = Mr \f$, makes it
+/// A-orthogonal to the directions of the previous step and minimizes
+/// the energy norm of the error over these directions. All inner
+/// products of a step are combined in a single global reduction, and
+/// a second one provides the norm of the updated residual, so that the
+/// number of reductions is reduced by the factor \a s / 2 compared to
+/// gsConjugateGradient.
+///
+/// As the monomial basis becomes ill-conditioned quickly, it is only
+/// used in the first step, which also provides an estimate of the
+/// largest eigenvalue of MA. The following steps use the basis of
+/// Chebyshev polynomials on the interval from 0 to that estimate.
+/// Still, \a s should be small (the default is 4). The number of
+/// iterations counts the individual Krylov steps, hence it grows by
+/// \a s in every step.
+///
+/// If a communicator is set by setCommunicator(), the vectors passed
+/// to solve() and to the operators are the parts owned by the
+/// respective process, and the local inner products are summed up
+/// over the communicator.
+///
+/// \ingroup Solver
+template<class T = real_t>
+class gsSStepConjugateGradient : public gsIterativeSolver<T>
+{
+public:
+    typedef gsIterativeSolver<T> Base;
+
+    typedef gsMatrix<T>  VectorType;
+
+    typedef typename Base::LinOpPtr LinOpPtr;
+
+    typedef memory::shared_ptr<gsSStepConjugateGradient> Ptr;
+    typedef memory::unique_ptr<gsSStepConjugateGradient> uPtr;
+
+    /// @brief Constructor using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    explicit gsSStepConjugateGradient( const OperatorType& mat,
+                                       const LinOpPtr& precond = LinOpPtr() )
+    : Base(mat, precond), m_s(4), m_iters(0), m_lmax(0), m_distributed(false) {}
+
+    /// @brief Make function using a matrix (operator) and optionally a preconditionner
+    ///
+    /// @param mat     The operator to be solved for, see gsIterativeSolver for details
+    /// @param precond The preconditioner, defaulted to the identity
+    template< typename OperatorType >
+    static uPtr make( const OperatorType& mat, const LinOpPtr& precond = LinOpPtr() )
+    { return uPtr( new gsSStepConjugateGradient(mat, precond) ); }
+
+    /// @brief Returns a list of default options
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt = Base::defaultOptions();
+        opt.addInt("Steps", "Number of Krylov steps combined in one step", 4 );
+        return opt;
+    }
+
+    /// @brief Set the options based on a gsOptionList
+    gsSStepConjugateGradient& setOptions(const gsOptionList& opt)
+    {
+        Base::setOptions(opt);
+        setSteps( opt.askInt("Steps", m_s) );
+        return *this;
+    }
+
+    /// @brief Sets the number of Krylov steps combined in one step
+    void setSteps(index_t s)
+    {
+        GISMO_ASSERT( s > 0, "The number of steps must be positive." );
+        m_s = s;
+    }
+
+    /// @brief Sets the communicator over which the inner products are summed up
+    void setCommunicator(const gsMpiComm & comm)
+    {
+        m_comm = comm;
+        m_distributed = true;
+    }
+
+    bool initIteration( const VectorType& rhs, VectorType& x );
+    bool step( VectorType& x );
+
+    /// Prints the object as a string.
+    std::ostream &print(std::ostream &os) const
+    {
+        os << "gsSStepConjugateGradient\n";
+        return os;
+    }
+
+private:
+
+    /// Returns the coefficients of the recurrence \f$ R_{j+1} = a M A
+    /// R_j + b R_j + c R_{j-1} \f$ of the Krylov basis
+    void basisCoefs(const index_t j, T & a, T & b, T & c) const;
+
+    /// Estimates the largest eigenvalue of MA from the inner products
+    /// of the monomial basis
+    void estimateLargestEigenvalue(const gsMatrix<T> & RAR, const gsMatrix<T> & Rr);
+
+    /// Solves the system with the symmetric positive (semi-)definite
+    /// matrix \a W after scaling it to unit diagonal
+    static void solveGram(const gsMatrix<T> & W, const gsMatrix<T> & rhs, gsMatrix<T> & result);
+
+private:
+    using Base::m_mat;
+    using Base::m_precond;
+    using Base::m_tol;
+    using Base::m_num_iter;
+    using Base::m_rhs_norm;
+    using Base::m_error;
+
+    index_t m_s;
+    index_t m_iters; // Number of Krylov steps performed
+    T m_lmax;  // Estimate of the largest eigenvalue of MA, 0 if unknown
+
+    gsMpiComm m_comm;
+    bool m_distributed;
+
+    VectorType m_res;
+    VectorType m_R, m_AR;  // Krylov basis and its image
+    VectorType m_P, m_AP;  // Search directions and their image
+    VectorType m_W;        // Gram matrix P^T A P of the search directions
+    VectorType m_tmp, m_z;
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsSStepConjugateGradient.hpp)
+#endif
@@ -0,0 +1,227 @@
+/** @file gsSStepConjugateGradient.hpp
+
+    @brief s-step conjugate gradient solver
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+namespace gismo
+{
+
+template<class T>
+bool gsSStepConjugateGradient<T>::initIteration( const typename gsSStepConjugateGradient<T>::VectorType& rhs,
+                                                 typename gsSStepConjugateGradient<T>::VectorType& x )
+{
+    GISMO_ASSERT( rhs.cols() == 1,
+                  "Iterative solvers only work for single column right-hand side." );
+    GISMO_ASSERT( rhs.rows() == m_mat->rows(),
+                  "The right-hand side does not match the matrix: "
+                  << rhs.rows() <<"!="<< m_mat->rows() );
+
+    m_num_iter = m_iters = 0;
+
+    // The norm of the right-hand side is needed on all processes
+    T rhs_norm2 = parallelDot(rhs, rhs);
+    if (m_distributed)
+        rhs_norm2 = m_comm.sum(rhs_norm2);
+    m_rhs_norm = math::sqrt(rhs_norm2);
+
+    if (0 == m_rhs_norm) // special case of zero rhs
+    {
+        x.setZero(rhs.rows(),rhs.cols()); // for sure zero is a solution
+        m_error = 0.;
+        return true; // iteration is finished
+    }
+
+    if ( 0 == x.size() ) // if no initial solution, start with zeros
+        x.setZero(rhs.rows(), rhs.cols());
+    else
+    {
+        GISMO_ASSERT( x.rows() == m_mat->cols() && x.cols() == 1,
+                      "The initial guess does not match the matrix: "
+                      << x.rows() <<"!="<< m_mat->cols() );
+    }
+
+    m_mat->apply(x, m_tmp);
+    m_res = rhs - m_tmp;                                               // initial residual
+
+    T res_norm2 = parallelDot(m_res, m_res);
+    if (m_distributed)
+        res_norm2 = m_comm.sum(res_norm2);
+    m_error = math::sqrt(res_norm2) / m_rhs_norm;
+
+    m_P.resize(rhs.rows(), 0);                                         // no previous directions
+    m_lmax = 0;
+    return m_error < m_tol;
+}
+
+template<class T>
+bool gsSStepConjugateGradient<T>::step( typename gsSStepConjugateGradient<T>::VectorType& x )
+{
+    const index_t n = x.rows(), s = m_s;
+    const bool first = 0 == m_P.cols();
+
+    // Basis of the Krylov space of MA and z = Mr, and its image. The
+    // first step uses the monomial basis z, (MA)z, ..., (MA)^{s-1}z,
+    // the following steps the Chebyshev basis for [0, m_lmax]
+    m_R.resize(n, s);
+    m_AR.resize(n, s);
+    m_precond->apply(m_res, m_z);
+    m_R.col(0) = m_z;
+    for (index_t j = 0; j != s; ++j)
+    {
+        m_mat->apply(m_R.col(j), m_tmp);
+        m_AR.col(j) = m_tmp;
+        if (j + 1 != s)
+        {
+            m_precond->apply(m_tmp, m_z);
+            T a, b, c;
+            basisCoefs(j, a, b, c);
+            m_R.col(j+1) = a * m_z.col(0) + b * m_R.col(j);
+            if (j > 0)
+                m_R.col(j+1) += c * m_R.col(j-1);
+        }
+    }
+
+    // All inner products of the step: R^T A R, (AP)^T R, R^T r and
+    // P^T r, where P are the directions of the previous step
+    gsMatrix<T> dots;
+    dots.setZero(s, 2*s + 2);
+    dots.leftCols(s).noalias() = m_R.transpose() * m_AR;
+    dots.col(2*s).noalias() = m_R.transpose() * m_res;
+    if (!first)
+    {
+        dots.middleCols(s, s).noalias() = m_AP.transpose() * m_R;
+        dots.col(2*s+1).noalias() = m_P.transpose() * m_res;
+    }
+    if (m_distributed)
+        m_comm.sum(dots.data(), static_cast<int>(dots.size()));
+
+    gsMatrix<T> W = ( dots.leftCols(s) + dots.leftCols(s).transpose() ) / 2;
+    if (0 == m_lmax)
+        estimateLargestEigenvalue(W, dots.col(2*s));
+
+    gsMatrix<T> g = dots.col(2*s);
+    if (first)
+    {
+        m_P.swap(m_R);
+        m_AP.swap(m_AR);
+    }
+    else
+    {
+        // Make the new directions A-orthogonal to the previous ones,
+        // P_new = R + P B. The terms which vanish in exact arithmetic
+        // are kept, since this improves the stability.
+        const gsMatrix<T> C = dots.middleCols(s, s);
+        gsMatrix<T> B;
+        solveGram(m_W, C, B);
+        B = -B;
+        const gsMatrix<T> CB = C.transpose() * B;
+        W += CB + CB.transpose();
+        W.noalias() += B.transpose() * m_W * B;
+        g.noalias() += B.transpose() * dots.col(2*s+1);
+        m_R.noalias()  += m_P * B;
+        m_AR.noalias() += m_AP * B;
+        m_P.swap(m_R);
+        m_AP.swap(m_AR);
+    }
+    m_W.swap(W);
+
+    // Minimize the energy norm of the error over the new directions
+    gsMatrix<T> a;
+    solveGram(m_W, g, a);
+    x.noalias()     += m_P  * a;
+    m_res.noalias() -= m_AP * a;
+
+    // The solver loop counts one iteration per step
+    m_iters += s;
+    m_num_iter = m_iters;
+
+    T res_norm2 = parallelDot(m_res, m_res);
+    if (m_distributed)
+        res_norm2 = m_comm.sum(res_norm2);
+    m_error = math::sqrt(res_norm2) / m_rhs_norm;
+    return m_error < m_tol;
+}
+
+template<class T>
+void gsSStepConjugateGradient<T>::basisCoefs(const index_t j, T & a, T & b, T & c) const
+{
+    if (0 == m_lmax)    // monomial basis
+    {
+        a = 1;
+        b = c = 0;
+    }
+    else if (0 == j)    // T_1(t) = t, where t = 2x / m_lmax - 1
+    {
+        a = 2 / m_lmax;
+        b = -1;
+        c = 0;
+    }
+    else                // T_{j+1}(t) = 2t T_j(t) - T_{j-1}(t)
+    {
+        a = 4 / m_lmax;
+        b = -2;
+        c = -1;
+    }
+}
+
+template<class T>
+void gsSStepConjugateGradient<T>::estimateLargestEigenvalue(const gsMatrix<T> & RAR,
+                                                            const gsMatrix<T> & Rr)
+{
+    // As R_{j+1} = a_j MA R_j + b_j R_j + c_j R_{j-1} and R_0 = Mr,
+    // the Gram matrix R^T M^{-1} R can be computed from R^T A R and R^T r
+    const index_t s = RAR.rows();
+    gsMatrix<T> G(s, s);
+    G.col(0) = Rr;
+    for (index_t j = 0; j + 1 < s; ++j)
+    {
+        T a, b, c;
+        basisCoefs(j, a, b, c);
+        G.col(j+1) = a * RAR.col(j) + b * G.col(j);
+        if (j > 0)
+            G.col(j+1) += c * G.col(j-1);
+    }
+    G = ( G + G.transpose() ) / 2;
+
+    // Largest Ritz value, slightly enlarged as it is a lower bound
+    T lmax = 0;
+    Eigen::GeneralizedSelfAdjointEigenSolver<typename gsMatrix<T>::Base> eig(RAR, G, Eigen::EigenvaluesOnly);
+    if ( Eigen::Success == eig.info() && (eig.eigenvalues().array() > 0).all() )
+        lmax = eig.eigenvalues().maxCoeff();
+    else
+        for (index_t i = 0; i != s; ++i)
+            if ( G(i,i) > 0 )
+                lmax = math::max(lmax, RAR(i,i) / G(i,i));
+    m_lmax = (T)(1.1) * lmax;
+}
+
+template<class T>
+void gsSStepConjugateGradient<T>::solveGram(const gsMatrix<T> & W, const gsMatrix<T> & rhs,
+                                            gsMatrix<T> & result)
+{
+    // Scale to unit diagonal, as the columns of the monomial basis
+    // differ by orders of magnitude
+    gsVector<T> scale(W.rows());
+    for (index_t i = 0; i != W.rows(); ++i)
+        scale[i] = W(i,i) > 0 ? 1 / math::sqrt(W(i,i)) : 0;
+    const gsMatrix<T> Ws = scale.asDiagonal() * W * scale.asDiagonal();
+
+    // Pseudo-inverse, as the basis can be (numerically) linearly dependent
+    typename gsMatrix<T>::SelfAdjEigenSolver eig(Ws);
+    const gsVector<T> & ev = eig.eigenvalues();
+    const T cut = ev.cwiseAbs().maxCoeff() * W.rows() * std::numeric_limits<T>::epsilon() * 100;
+    gsVector<T> inv(ev.size());
+    for (index_t i = 0; i != ev.size(); ++i)
+        inv[i] = ev[i] > cut ? 1 / ev[i] : 0;
+
+    result.noalias() = scale.asDiagonal() * ( eig.eigenvectors() * ( inv.asDiagonal()
+        * ( eig.eigenvectors().transpose() * ( scale.asDiagonal() * rhs ) ) ) );
+}
+
+} // end namespace gismo
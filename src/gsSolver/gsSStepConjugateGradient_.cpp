@@ -0,0 +1,9 @@
+#include <gsSolver/gsSStepConjugateGradient.h>
+#include <gsSolver/gsSStepConjugateGradient.hpp>
+
+namespace gismo
+{
+
+CLASS_TEMPLATE_INST gsSStepConjugateGradient<real_t>;
+
+} // namespace gismo
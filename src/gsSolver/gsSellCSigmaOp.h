@@ -0,0 +1,175 @@
+/** @file gsSellCSigmaOp.h
+
+    @brief Sparse matrix in SELL-C-sigma storage as a linear operator
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+#include <gsSolver/gsLinearOperator.h>
+#include <gsSolver/gsParallelKernels.h>
+
+namespace gismo
+{
+
+/** @brief Stores a sparse matrix in the SELL-C-\f$\sigma\f$ format
+    (Kreutzer et al., SIAM J. Sci. Comput. 36(5), 2014) and applies
+    it in parallel.
+
+    The rows are grouped into chunks of \a C consecutive rows, and the
+    entries of a chunk are stored column by column, padded to the
+    longest row of the chunk. Hence the inner loop of the product runs
+    over the \a C rows of a chunk with unit stride and is vectorised
+    by the compiler. To reduce the padding, the rows are sorted by
+    length within windows of \f$\sigma\f$ rows before the chunks are
+    formed. The chunks are distributed among the threads.
+
+    The operator keeps its own copy of the matrix, and can be used in
+    place of gsMatrixOp in the iterative solvers.
+
+    \ingroup Solver
+*/
+template <class T>
+class gsSellCSigmaOp GISMO_FINAL : public gsLinearOperator<T>
+{
+public:
+
+    /// Shared pointer for gsSellCSigmaOp
+    typedef memory::shared_ptr<gsSellCSigmaOp> Ptr;
+
+    /// Unique pointer for gsSellCSigmaOp
+    typedef memory::unique_ptr<gsSellCSigmaOp> uPtr;
+
+    /// @brief Constructor taking a sparse matrix, the chunk height \a C
+    /// and the sorting scope \a sigma (a multiple of \a C)
+    template <int _Options, typename _Index>
+    explicit gsSellCSigmaOp(const gsSparseMatrix<T,_Options,_Index> & mat,
+                            index_t C = 8, index_t sigma = 256)
+    : m_rows(mat.rows()), m_cols(mat.cols()), m_C(C)
+    {
+        GISMO_ASSERT( C > 0 && sigma > 0 && sigma % C == 0, "Invalid chunk size or sorting scope." );
+        const gsSparseMatrix<T,RowMajor,index_t> A = mat;
+
+        // Sort the rows by decreasing length within windows of sigma rows
+        m_perm.resize(m_rows);
+        for (index_t i = 0; i != m_rows; ++i)
+            m_perm[i] = i;
+        for (index_t w = 0; w < m_rows; w += sigma)
+            std::stable_sort(m_perm.begin() + w, m_perm.begin() + math::min(w + sigma, m_rows),
+                             rowLengthGreater(A));
+
+        // Chunk lengths and offsets
+        const index_t nChunks = (m_rows + C - 1) / C;
+        m_chunkLen.resize(nChunks);
+        m_chunkPtr.resize(nChunks + 1);
+        m_chunkPtr[0] = 0;
+        for (index_t k = 0; k != nChunks; ++k)
+        {
+            index_t len = 0;
+            for (index_t l = k*C; l < math::min((k+1)*C, m_rows); ++l)
+                len = math::max(len, rowLength(A, m_perm[l]));
+            m_chunkLen[k] = len;
+            m_chunkPtr[k+1] = m_chunkPtr[k] + len * C;
+        }
+
+        // Fill the chunks column by column, padding with zeros
+        m_values.setZero(m_chunkPtr[nChunks]);
+        m_indices.setZero(m_chunkPtr[nChunks]);
+        for (index_t k = 0; k != nChunks; ++k)
+            for (index_t l = k*C; l < math::min((k+1)*C, m_rows); ++l)
+            {
+                index_t j = 0;
+                for (typename gsSparseMatrix<T,RowMajor,index_t>::InnerIterator it(A, m_perm[l]); it; ++it, ++j)
+                {
+                    const index_t pos = m_chunkPtr[k] + j*C + (l - k*C);
+                    m_values[pos]  = it.value();
+                    m_indices[pos] = it.index();
+                }
+            }
+    }
+
+    /// Make function returning a smart pointer
+    template <int _Options, typename _Index>
+    static uPtr make(const gsSparseMatrix<T,_Options,_Index> & mat,
+                     index_t C = 8, index_t sigma = 256)
+    { return uPtr( new gsSellCSigmaOp(mat, C, sigma) ); }
+
+    void apply(const gsMatrix<T> & input, gsMatrix<T> & x) const
+    {
+        GISMO_ASSERT( input.rows() == m_cols, "Dimensions do not match.");
+        x.resize(m_rows, input.cols());
+        const index_t C = m_C;
+        const index_t nChunks = m_chunkLen.size();
+
+        for (index_t c = 0; c != input.cols(); ++c)
+        {
+            const T * in = input.col(c).data();
+#           pragma omp parallel if (m_values.size() > internal::parallelKernelMinSize)
+            {
+                gsVector<T> sum(C);
+#               pragma omp for schedule(static)
+                for (index_t k = 0; k < nChunks; ++k)
+                {
+                    sum.setZero();
+                    const T * val = m_values.data() + m_chunkPtr[k];
+                    const index_t * ind = m_indices.data() + m_chunkPtr[k];
+                    for (index_t j = 0; j != m_chunkLen[k]; ++j, val += C, ind += C)
+                        for (index_t l = 0; l != C; ++l)
+                            sum[l] += val[l] * in[ind[l]];
+
+                    const index_t end = math::min(C, m_rows - k*C);
+                    for (index_t l = 0; l != end; ++l)
+                        x(m_perm[k*C + l], c) = sum[l];
+                }
+            }
+        }
+    }
+
+    index_t rows() const { return m_rows; }
+    index_t cols() const { return m_cols; }
+
+    /// Returns the ratio of the stored entries (including padding)
+    /// and the non-zero entries
+    T fillRatio() const
+    {
+        index_t nz = 0;
+        for (index_t i = 0; i != m_values.size(); ++i)
+            nz += ( 0 != m_values[i] );
+        return nz ? (T)(m_values.size()) / nz : 1;
+    }
+
+private:
+
+    template <class Mat>
+    static index_t rowLength(const Mat & A, index_t i)
+    { return A.outerIndexPtr()[i+1] - A.outerIndexPtr()[i]; }
+
+    template <class Mat>
+    struct rowLengthGreaterImpl
+    {
+        explicit rowLengthGreaterImpl(const Mat & A) : m_A(A) { }
+        bool operator()(index_t a, index_t b) const
+        { return rowLength(m_A, a) > rowLength(m_A, b); }
+        const Mat & m_A;
+    };
+
+    template <class Mat>
+    static rowLengthGreaterImpl<Mat> rowLengthGreater(const Mat & A)
+    { return rowLengthGreaterImpl<Mat>(A); }
+
+private:
+
+    index_t m_rows, m_cols, m_C;
+    gsVector<T>       m_values;   ///< Entries of the chunks, column by column
+    gsVector<index_t> m_indices;  ///< Column indices of the entries
+    std::vector<index_t> m_perm;     ///< Original index of the sorted rows
+    std::vector<index_t> m_chunkLen; ///< Length of the chunks
+    std::vector<index_t> m_chunkPtr; ///< Start of the chunks in m_values
+};
+
+} // namespace gismo
@@ -14,6 +14,7 @@
 
 #include <gsCore/gsLinearAlgebra.h>
 #include <gsSolver/gsPreconditioner.h>
+#include <gsSolver/gsMatrixOp.h>
 
 namespace gismo
 {
@@ -24,6 +25,17 @@ template<typename T>
 void gaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const gsMatrix<T>& f);
 template<typename T>
 void reverseGaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const gsMatrix<T>& f);
+template<typename T>
+void multiColorOrdering(const gsSparseMatrix<T> & A, std::vector<index_t> & rows, std::vector<index_t> & colorPtr);
+template<typename T>
+void multiColorGaussSeidelSweep(const gsSparseMatrix<T> & A, const std::vector<index_t> & rows,
+                                const std::vector<index_t> & colorPtr, gsMatrix<T>& x, const gsMatrix<T>& f,
+                                bool reverse);
+template<typename T>
+void jacobiResidual(const gsSparseMatrix<T> & A, const gsMatrix<T> & invDiag, const gsMatrix<T>& x,
+                    const gsMatrix<T>& f, gsMatrix<T>& r);
+template<typename T>
+T estimateJacobiEigenvalue(const gsSparseMatrix<T> & A, index_t steps);
 } // namespace internal
 
 /// @brief Richardson preconditioner
@@ -402,6 +414,279 @@ template <class Derived>
 typename gsGaussSeidelOp<Derived,gsGaussSeidel::symmetric>::uPtr makeSymmetricGaussSeidelOp(const memory::shared_ptr<Derived>& mat)
 { return gsGaussSeidelOp<Derived,gsGaussSeidel::symmetric>::make(mat); }
 
+/// @brief Multi-color Gauss-Seidel preconditioner
+///
+/// The rows are colored such that no two rows of the same color are
+/// coupled by the matrix. The Gauss-Seidel sweep visits the colors
+/// one after the other, and the rows of one color are relaxed in
+/// parallel. Therefore the result does not depend on the number of
+/// threads, but differs from the lexicographic gsGaussSeidelOp.
+///
+/// Requires a positive definite matrix with symmetric sparsity pattern.
+///
+/// \ingroup Solver
+template <typename MatrixType, gsGaussSeidel::ordering ordering = gsGaussSeidel::forward>
+class gsMultiColorGaussSeidelOp GISMO_FINAL : public gsPreconditionerOp<typename MatrixType::Scalar>
+{
+    typedef memory::shared_ptr<MatrixType>          MatrixPtr;
+    typedef typename MatrixType::Nested             NestedMatrix;
+
+public:
+    /// Scalar type
+    typedef typename MatrixType::Scalar T;
+
+    /// Shared pointer for gsMultiColorGaussSeidelOp
+    typedef memory::shared_ptr< gsMultiColorGaussSeidelOp > Ptr;
+
+    /// Unique pointer for gsMultiColorGaussSeidelOp
+    typedef memory::unique_ptr< gsMultiColorGaussSeidelOp > uPtr;
+
+    /// Base class
+    typedef gsPreconditionerOp<T> Base;
+
+    /// @brief Constructor with given matrix
+    explicit gsMultiColorGaussSeidelOp(const MatrixType& _mat)
+    : m_mat(), m_expr(_mat.derived())
+    { internal::multiColorOrdering<T>(m_expr, m_rows, m_colorPtr); }
+
+    /// @brief Constructor with shared pointer to matrix
+    explicit gsMultiColorGaussSeidelOp(const MatrixPtr& _mat)
+    : m_mat(_mat), m_expr(m_mat->derived())
+    { internal::multiColorOrdering<T>(m_expr, m_rows, m_colorPtr); }
+
+    static uPtr make(const MatrixType& _mat)
+    { return memory::make_unique( new gsMultiColorGaussSeidelOp(_mat) ); }
+
+    static uPtr make(const MatrixPtr& _mat)
+    { return memory::make_unique( new gsMultiColorGaussSeidelOp(_mat) ); }
+
+    void step(const gsMatrix<T> & rhs, gsMatrix<T> & x) const
+    {
+        if (ordering != gsGaussSeidel::reverse )
+            internal::multiColorGaussSeidelSweep<T>(m_expr,m_rows,m_colorPtr,x,rhs,false);
+        if (ordering != gsGaussSeidel::forward )
+            internal::multiColorGaussSeidelSweep<T>(m_expr,m_rows,m_colorPtr,x,rhs,true);
+    }
+
+    void stepT(const gsMatrix<T> & rhs, gsMatrix<T> & x) const
+    {
+        if ( ordering == gsGaussSeidel::forward )
+            internal::multiColorGaussSeidelSweep<T>(m_expr,m_rows,m_colorPtr,x,rhs,true);
+        if ( ordering == gsGaussSeidel::reverse )
+            internal::multiColorGaussSeidelSweep<T>(m_expr,m_rows,m_colorPtr,x,rhs,false);
+        if ( ordering == gsGaussSeidel::symmetric )
+            step(rhs,x);
+    }
+
+    index_t rows() const {return m_expr.rows();}
+    index_t cols() const {return m_expr.cols();}
+
+    /// Returns the number of colors
+    index_t numColors() const { return m_colorPtr.size() - 1; }
+
+    /// Returns the matrix
+    NestedMatrix matrix() const { return m_expr; }
+
+    /// Returns a shared pinter to the matrix
+    MatrixPtr    matrixPtr() const {
+        GISMO_ENSURE( m_mat, "A shared pointer is only available if it was provided to gsMultiColorGaussSeidelOp." );
+        return m_mat;
+    }
+
+    typename gsLinearOperator<T>::Ptr underlyingOp() const { return makeMatrixOp(m_mat); }
+
+private:
+    const MatrixPtr m_mat;  ///< Shared pointer to matrix (if needed)
+    NestedMatrix    m_expr; ///< Nested Eigen expression
+    std::vector<index_t> m_rows;     ///< Rows sorted by color
+    std::vector<index_t> m_colorPtr; ///< Start of the colors in m_rows
+};
+
+/**
+   \brief Returns a smart pointer to a multi-color Gauss-Seidel operator referring on \a mat
+*/
+template <class Derived>
+typename gsMultiColorGaussSeidelOp<Derived>::uPtr makeMultiColorGaussSeidelOp(const Eigen::EigenBase<Derived>& mat)
+{ return gsMultiColorGaussSeidelOp<Derived>::make(mat.derived()); }
+
+/**
+   \brief Returns a smart pointer to a multi-color Gauss-Seidel operator referring on \a mat
+*/
+template <class Derived>
+typename gsMultiColorGaussSeidelOp<Derived>::uPtr makeMultiColorGaussSeidelOp(const memory::shared_ptr<Derived>& mat)
+{ return gsMultiColorGaussSeidelOp<Derived>::make(mat); }
+
+/**
+   \brief Returns a smart pointer to a symmetric multi-color Gauss-Seidel operator referring on \a mat
+*/
+template <class Derived>
+typename gsMultiColorGaussSeidelOp<Derived,gsGaussSeidel::symmetric>::uPtr makeSymmetricMultiColorGaussSeidelOp(const Eigen::EigenBase<Derived>& mat)
+{ return gsMultiColorGaussSeidelOp<Derived,gsGaussSeidel::symmetric>::make(mat.derived()); }
+
+/**
+   \brief Returns a smart pointer to a symmetric multi-color Gauss-Seidel operator referring on \a mat
+*/
+template <class Derived>
+typename gsMultiColorGaussSeidelOp<Derived,gsGaussSeidel::symmetric>::uPtr makeSymmetricMultiColorGaussSeidelOp(const memory::shared_ptr<Derived>& mat)
+{ return gsMultiColorGaussSeidelOp<Derived,gsGaussSeidel::symmetric>::make(mat); }
+
+/// @brief Chebyshev smoother
+///
+/// One step applies the Chebyshev polynomial of the given degree in
+/// the Jacobi preconditioned matrix \f$ D^{-1}A \f$ which is smallest
+/// on the interval \f$ [\lambda_{max}/r, \lambda_{max}] \f$, where
+/// \f$ r \f$ is the eigenvalue ratio. The largest eigenvalue is
+/// estimated by some Lanczos steps when the operator is
+/// constructed, see setEigenvalueBounds() to provide it.
+///
+/// Only products with the matrix and vector operations are needed,
+/// which are performed in parallel.
+///
+/// Requires a symmetric positive definite matrix.
+///
+/// \ingroup Solver
+template <typename MatrixType>
+class gsChebyshevOp GISMO_FINAL : public gsPreconditionerOp<typename MatrixType::Scalar>
+{
+    typedef memory::shared_ptr<MatrixType>          MatrixPtr;
+    typedef typename MatrixType::Nested             NestedMatrix;
+
+public:
+    /// Scalar type
+    typedef typename MatrixType::Scalar T;
+
+    /// Shared pointer for gsChebyshevOp
+    typedef memory::shared_ptr< gsChebyshevOp > Ptr;
+
+    /// Unique pointer for gsChebyshevOp
+    typedef memory::unique_ptr< gsChebyshevOp > uPtr;
+
+    /// Base class
+    typedef gsPreconditionerOp<T> Base;
+
+    /// @brief Constructor with given matrix
+    explicit gsChebyshevOp(const MatrixType& _mat, index_t degree = 2)
+    : m_mat(), m_expr(_mat.derived()), m_degree(degree), m_ratio(30)
+    { init(); }
+
+    /// @brief Constructor with shared pointer to matrix
+    explicit gsChebyshevOp(const MatrixPtr& _mat, index_t degree = 2)
+    : m_mat(_mat), m_expr(m_mat->derived()), m_degree(degree), m_ratio(30)
+    { init(); }
+
+    static uPtr make(const MatrixType& _mat, index_t degree = 2)
+    { return memory::make_unique( new gsChebyshevOp(_mat, degree) ); }
+
+    static uPtr make(const MatrixPtr& _mat, index_t degree = 2)
+    { return memory::make_unique( new gsChebyshevOp(_mat, degree) ); }
+
+    void step(const gsMatrix<T> & rhs, gsMatrix<T> & x) const
+    {
+        GISMO_ASSERT( m_expr.rows() == rhs.rows() && m_expr.cols() == m_expr.rows(),
+                      "Dimensions do not match.");
+
+        GISMO_ASSERT( rhs.cols() == 1, "This operator is only implemented for a single right-hand side." );
+
+        const T lmin  = m_lmax / m_ratio;
+        const T theta = (m_lmax + lmin) / 2;
+        const T delta = (m_lmax - lmin) / 2;
+        const T sigma = theta / delta;
+        T rho = 1 / sigma;
+
+        internal::jacobiResidual<T>(m_expr, m_invDiag, x, rhs, m_res);
+        m_dir = m_res / theta;
+        for (index_t k = 1; k < m_degree; ++k)
+        {
+            x += m_dir;
+            internal::jacobiResidual<T>(m_expr, m_invDiag, x, rhs, m_res);
+            const T rhoNew = 1 / (2 * sigma - rho);
+            m_dir = (rhoNew * rho) * m_dir + (2 * rhoNew / delta) * m_res;
+            rho = rhoNew;
+        }
+        x += m_dir;
+    }
+
+    index_t rows() const {return m_expr.rows();}
+    index_t cols() const {return m_expr.cols();}
+
+    /// Sets the degree of the polynomial applied in one step
+    void setDegree(index_t degree)
+    {
+        GISMO_ASSERT( degree > 0, "The degree needs to be positive." );
+        m_degree = degree;
+    }
+
+    /// @brief Sets the largest eigenvalue of \f$ D^{-1}A \f$ and the
+    /// ratio of the largest and the smallest eigenvalue to be smoothed
+    void setEigenvalueBounds(T lmax, T ratio)
+    {
+        GISMO_ASSERT( lmax > 0 && ratio > 1, "Invalid eigenvalue bounds." );
+        m_lmax = lmax;
+        m_ratio = ratio;
+    }
+
+    /// Returns the (estimated) largest eigenvalue of \f$ D^{-1}A \f$
+    T largestEigenvalue() const { return m_lmax; }
+
+    /// Get the default options as gsOptionList object
+    static gsOptionList defaultOptions()
+    {
+        gsOptionList opt = Base::defaultOptions();
+        opt.addInt ( "Degree", "Degree of the Chebyshev polynomial applied in one step", 2 );
+        opt.addReal( "EigenvalueRatio", "Ratio of the largest and the smallest eigenvalue to be smoothed", 30 );
+        return opt;
+    }
+
+    /// Set options based on a gsOptionList object
+    virtual void setOptions(const gsOptionList & opt)
+    {
+        Base::setOptions(opt);
+        setDegree( opt.askInt( "Degree", m_degree ) );
+        m_ratio = opt.askReal( "EigenvalueRatio", m_ratio );
+    }
+
+    /// Returns the matrix
+    NestedMatrix matrix() const { return m_expr; }
+
+    /// Returns a shared pinter to the matrix
+    MatrixPtr    matrixPtr() const {
+        GISMO_ENSURE( m_mat, "A shared pointer is only available if it was provided to gsChebyshevOp." );
+        return m_mat;
+    }
+
+    typename gsLinearOperator<T>::Ptr underlyingOp() const { return makeMatrixOp(m_mat); }
+
+private:
+    void init()
+    {
+        m_invDiag = m_expr.diagonal().cwiseInverse();
+        // The Lanczos estimate is a lower bound, add a safety margin
+        m_lmax = T(1.1) * internal::estimateJacobiEigenvalue<T>(m_expr, 15);
+    }
+
+private:
+    const MatrixPtr m_mat;  ///< Shared pointer to matrix (if needed)
+    NestedMatrix    m_expr; ///< Nested Eigen expression
+    gsMatrix<T>     m_invDiag;
+    index_t m_degree;
+    T m_lmax, m_ratio;
+    mutable gsMatrix<T> m_res, m_dir;
+};
+
+/**
+   \brief Returns a smart pointer to a Chebyshev smoother referring on \a mat
+*/
+template <class Derived>
+typename gsChebyshevOp<Derived>::uPtr makeChebyshevOp(const Eigen::EigenBase<Derived>& mat, index_t degree = 2)
+{ return gsChebyshevOp<Derived>::make(mat.derived(), degree); }
+
+/**
+   \brief Returns a smart pointer to a Chebyshev smoother referring on \a mat
+*/
+template <class Derived>
+typename gsChebyshevOp<Derived>::uPtr makeChebyshevOp(const memory::shared_ptr<Derived>& mat, index_t degree = 2)
+{ return gsChebyshevOp<Derived>::make(mat, degree); }
+
 } // namespace gismo
 
 #ifndef GISMO_BUILD_LIB
@@ -11,6 +11,8 @@
     Author(s): C. Hofreither
 */
 
+#include <gsSolver/gsConjugateGradient.h>
+
 namespace gismo
 {
 
@@ -67,6 +69,149 @@ void reverseGaussSeidelSweep(const gsSparseMatrix<T> & A, gsMatrix<T>& x, const
     }
 }
 
+template<typename T>
+void multiColorOrdering(const gsSparseMatrix<T> & A, std::vector<index_t> & rows, std::vector<index_t> & colorPtr)
+{
+    GISMO_ASSERT( A.cols() == A.rows(), "Dimensions do not match.");
+
+    // Greedy coloring of the graph of A, which is supposed to have a
+    // symmetric sparsity pattern
+    const index_t n = A.outerSize();
+    std::vector<index_t> color(n, -1), mark, count;
+    for (index_t i = 0; i < n; ++i)
+    {
+        for (typename gsSparseMatrix<T>::InnerIterator it(A,i); it; ++it)
+            if ( -1 != color[it.index()] )
+                mark[color[it.index()]] = i;
+
+        index_t c = 0;
+        while ( c < static_cast<index_t>(mark.size()) && mark[c] == i ) ++c;
+        if ( c == static_cast<index_t>(count.size()) )
+        {
+            mark.push_back(-1);
+            count.push_back(0);
+        }
+        color[i] = c;
+        ++count[c];
+    }
+
+    // Sort the rows by color
+    colorPtr.assign(count.size() + 1, 0);
+    for (size_t c = 0; c != count.size(); ++c)
+        colorPtr[c+1] = colorPtr[c] + count[c];
+    std::vector<index_t> pos(colorPtr.begin(), colorPtr.end() - 1);
+    rows.resize(n);
+    for (index_t i = 0; i < n; ++i)
+        rows[pos[color[i]]++] = i;
+}
+
+template<typename T>
+void multiColorGaussSeidelSweep(const gsSparseMatrix<T> & A, const std::vector<index_t> & rows,
+                                const std::vector<index_t> & colorPtr, gsMatrix<T>& x, const gsMatrix<T>& f,
+                                bool reverse)
+{
+    GISMO_ASSERT( A.rows() == x.rows() && x.rows() == f.rows() && A.cols() == A.rows() && x.cols() == f.cols(),
+        "Dimensions do not match.");
+
+    GISMO_ASSERT( f.cols() == 1, "This operator is only implemented for a single right-hand side." );
+
+    const index_t nc = colorPtr.size() - 1;
+    for (index_t k = 0; k < nc; ++k)
+    {
+        const index_t c = reverse ? nc - 1 - k : k;
+        const index_t end = colorPtr[c+1];
+
+        // The rows of one color are not coupled
+#       pragma omp parallel for
+        for (index_t r = colorPtr[c]; r < end; ++r)
+        {
+            const index_t i = rows[r];
+            T diag = 0;
+            T sum  = 0;
+
+            for (typename gsSparseMatrix<T>::InnerIterator it(A,i); it; ++it)
+            {
+                sum += it.value() * x( it.index() );        // compute A.x
+                if (it.index() == i)
+                    diag = it.value();
+            }
+
+            x(i) += (f(i) - sum) / diag;
+        }
+    }
+}
+
+template<typename T>
+void jacobiResidual(const gsSparseMatrix<T> & A, const gsMatrix<T> & invDiag, const gsMatrix<T>& x,
+                    const gsMatrix<T>& f, gsMatrix<T>& r)
+{
+    GISMO_ASSERT( A.rows() == x.rows() && x.rows() == f.rows() && A.cols() == A.rows() && x.cols() == f.cols(),
+        "Dimensions do not match.");
+
+    GISMO_ASSERT( f.cols() == 1, "This operator is only implemented for a single right-hand side." );
+
+    const index_t n = A.outerSize();
+    r.resize(n, 1);
+
+    // A is supposed to be symmetric, so it doesn't matter if it's stored in row- or column-major order
+#   pragma omp parallel for
+    for (index_t i = 0; i < n; ++i)
+    {
+        T sum = 0;
+        for (typename gsSparseMatrix<T>::InnerIterator it(A,i); it; ++it)
+            sum += it.value() * x( it.index() );
+        r(i) = invDiag(i) * (f(i) - sum);
+    }
+}
+
+template<typename T>
+T estimateJacobiEigenvalue(const gsSparseMatrix<T> & A, index_t steps)
+{
+    const index_t n = A.rows();
+
+    // Gershgorin bound for the eigenvalues of D^{-1}A, used if the
+    // Lanczos estimate is not available
+    T bound = 0;
+    for (index_t i = 0; i < A.outerSize(); ++i)
+    {
+        T sum = 0, diag = 0;
+        for (typename gsSparseMatrix<T>::InnerIterator it(A,i); it; ++it)
+        {
+            sum += math::abs(it.value());
+            if (it.index() == i)
+                diag = math::abs(it.value());
+        }
+        bound = math::max(bound, sum / diag);
+    }
+
+    // The CG run stops if the Krylov space is exhausted, which would
+    // otherwise lead to a breakdown
+    gsConjugateGradient<T> cg(A, makeJacobiOp(A));
+    cg.setCalcEigenvalues(true);
+    cg.setMaxIterations(math::min(steps, n));
+    cg.setTolerance(100 * std::numeric_limits<T>::epsilon());
+
+    // Fixed pseudo-random start vector, for reproducible results
+    gsMatrix<T> rhs(n, 1), x;
+    unsigned seed = 12345u;
+    for (index_t i = 0; i < n; ++i)
+    {
+        seed = 1103515245u * seed + 12345u;
+        rhs(i,0) = T((seed >> 16) & 0x7fffu) / T(0x8000u) + T(0.5);
+    }
+    x.setZero(n, 1);
+    cg.solve(rhs, x);
+
+    if ( cg.iterations() == 0 )
+        return bound;
+
+    gsMatrix<T> eigs;
+    cg.getEigenvalues(eigs);
+    if ( eigs.size() == 0 || !(eigs.maxCoeff() > 0) || !(eigs.maxCoeff() <= bound * (1 + 1e-8)) )
+        return bound;
+    return eigs.maxCoeff();
+}
+
 } // namespace internal
 
 } // namespace gismo
@@ -9,6 +9,13 @@ namespace internal
 
 TEMPLATE_INST void gaussSeidelSweep(const gsSparseMatrix<real_t> & A, gsMatrix<real_t>& x, const gsMatrix<real_t>& f);
 TEMPLATE_INST void reverseGaussSeidelSweep(const gsSparseMatrix<real_t> & A, gsMatrix<real_t>& x, const gsMatrix<real_t>& f);
+TEMPLATE_INST void multiColorOrdering(const gsSparseMatrix<real_t> & A, std::vector<index_t> & rows, std::vector<index_t> & colorPtr);
+TEMPLATE_INST void multiColorGaussSeidelSweep(const gsSparseMatrix<real_t> & A, const std::vector<index_t> & rows,
+                                              const std::vector<index_t> & colorPtr, gsMatrix<real_t>& x,
+                                              const gsMatrix<real_t>& f, bool reverse);
+TEMPLATE_INST void jacobiResidual(const gsSparseMatrix<real_t> & A, const gsMatrix<real_t> & invDiag,
+                                  const gsMatrix<real_t>& x, const gsMatrix<real_t>& f, gsMatrix<real_t>& r);
+TEMPLATE_INST real_t estimateJacobiEigenvalue(const gsSparseMatrix<real_t> & A, index_t steps);
 
 } // namespace internal
 
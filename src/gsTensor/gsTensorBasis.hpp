@@ -505,10 +505,8 @@ void gsTensorBasis<d,T>::eval_into(const gsMatrix<T> & u,
     GISMO_ASSERT( u.rows() == d, 
                   "Attempted to evaluate the tensor-basis on points with the wrong dimension" );
 
-    /// \todo more efficient ?
-
     gsMatrix<T> ev[d];
-    gsVector<unsigned, d> v, size;
+    gsVector<index_t, d> size;
 
     // Evaluate univariate basis functions
     unsigned nb = 1;
@@ -522,17 +520,23 @@ void gsTensorBasis<d,T>::eval_into(const gsMatrix<T> & u,
     // initialize result
     result.resize( nb, u.cols() );
 
-    // iterate over all tensor product basis functions
-    v.setZero();
-    unsigned r = 0;
-    do {
-        // Multiply BSplines to get the value of basis function v
-        result.row( r )=  ev[0].row( v(0) );
+    // Form the tensor products point by point, so that every column
+    // of the result is written contiguously: the column is built as a
+    // Kronecker product, the first direction running fastest
+    for (index_t j = 0; j < u.cols(); ++j)
+    {
+        typename gsMatrix<T>::ColXpr col = result.col(j);
+        index_t len = size[0];
+        col.head(len) = ev[0].col(j);
         for ( short_t i=1; i<d; ++i)
-            result.row( r )= result.row( r ).cwiseProduct( ev[i].row( v(i) ) ) ;
-      
-        ++r ;
-    } while (nextLexicographic(v, size));
+        {
+            // Block b is the current head times function b of direction i
+            for (index_t b = size[i] - 1; b > 0; --b)
+                col.segment(b*len, len) = ev[i](b,j) * col.head(len);
+            col.head(len) *= ev[i](0,j);
+            len *= size[i];
+        }
+    }
 };
 
 template<short_t d, class T>
@@ -0,0 +1,131 @@
+/** @file gsBoxTree.h
+
+    @brief Provides a bounding volume hierarchy of axis-aligned boxes.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <gsCore/gsLinearAlgebra.h>
+
+namespace gismo
+{
+
+/**
+   @brief Bounding volume hierarchy of axis-aligned boxes
+
+   The boxes are split recursively at the median of their centers
+   along the longest side of the enclosing box, until at most
+   leafSize boxes remain. The nodes are stored in depth-first order
+   in flat arrays: the left child of a node follows it directly.
+
+   A query returns the boxes which contain a given point, eg. the
+   candidate patches or elements of a point in a multipatch domain
+   (see gsMultiPatch::locatePoints).
+
+   \ingroup Utils
+*/
+template<class T>
+class gsBoxTree
+{
+public:
+
+    /// Empty tree
+    gsBoxTree() { }
+
+    /// Builds the hierarchy of the boxes with lower corners \a lower
+    /// and upper corners \a upper (one box per column)
+    gsBoxTree(const gsMatrix<T> & lower, const gsMatrix<T> & upper,
+              index_t leafSize = 4)
+    { build(lower, upper, leafSize); }
+
+    /// Builds the hierarchy of the boxes with lower corners \a lower
+    /// and upper corners \a upper (one box per column)
+    void build(const gsMatrix<T> & lower, const gsMatrix<T> & upper,
+               index_t leafSize = 4);
+
+    /// Returns the number of boxes
+    index_t size() const { return m_index.size(); }
+
+    /// Returns the number of nodes of the hierarchy
+    index_t numNodes() const { return m_right.size(); }
+
+    /// Returns the dimension of the boxes
+    index_t dim() const { return m_lower.rows(); }
+
+    /// Writes in \a result the indices of the boxes which contain the
+    /// point \a pt, after enlarging them by \a tol
+    template<class Derived>
+    void query(const Eigen::MatrixBase<Derived> & pt, std::vector<index_t> & result,
+               const T tol = 0) const
+    {
+        GISMO_ASSERT(pt.size() == dim(), "Wrong point dimension.");
+        result.clear();
+        if ( m_right.empty() )
+            return;
+
+        index_t stack[64];
+        index_t top = 0;
+        stack[top++] = 0;
+        while ( top )
+        {
+            const index_t n = stack[--top];
+            if ( !contains(m_nodeLower.col(n), m_nodeUpper.col(n), pt, tol) )
+                continue;
+
+            if ( -1 == m_right[n] ) // leaf
+            {
+                for (index_t i = m_begin[n]; i != m_end[n]; ++i)
+                    if ( contains(m_lower.col(i), m_upper.col(i), pt, tol) )
+                        result.push_back(m_index[i]);
+            }
+            else
+            {
+                stack[top++] = m_right[n];
+                stack[top++] = n + 1;
+            }
+        }
+    }
+
+private:
+
+    template<class D1, class D2, class D3>
+    static bool contains(const Eigen::MatrixBase<D1> & lo, const Eigen::MatrixBase<D2> & up,
+                         const Eigen::MatrixBase<D3> & pt, const T tol)
+    {
+        for (index_t k = 0; k != pt.size(); ++k)
+            if ( pt[k] < lo[k] - tol || up[k] + tol < pt[k] )
+                return false;
+        return true;
+    }
+
+    /// Builds the subtree of the boxes begin,...,end-1 of m_index,
+    /// returns the depth of the subtree
+    index_t buildNode(const gsMatrix<T> & lower, const gsMatrix<T> & upper,
+                      index_t begin, index_t end, index_t leafSize);
+
+private:
+
+    /// The boxes, ordered such that the boxes of a leaf are
+    /// contiguous, and their original indices
+    gsMatrix<T> m_lower, m_upper;
+    std::vector<index_t> m_index;
+
+    /// The enclosing boxes of the nodes
+    gsMatrix<T> m_nodeLower, m_nodeUpper;
+
+    /// The boxes m_begin[n],...,m_end[n]-1 are below node n. The right
+    /// child of node n is m_right[n], or -1 for a leaf.
+    std::vector<index_t> m_begin, m_end, m_right;
+};
+
+} // namespace gismo
+
+#ifndef GISMO_BUILD_LIB
+#include GISMO_HPP_HEADER(gsBoxTree.hpp)
+#endif
@@ -0,0 +1,112 @@
+/** @file gsBoxTree.hpp
+
+    @brief Provides a bounding volume hierarchy of axis-aligned boxes.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+namespace gismo
+{
+
+namespace internal
+{
+
+/// Compares boxes by the coordinate \a k of their centers
+template<class T>
+struct boxCenterLess
+{
+    boxCenterLess(const gsMatrix<T> & lower, const gsMatrix<T> & upper, index_t k)
+    : lo(lower), up(upper), dir(k) { }
+
+    bool operator()(index_t a, index_t b) const
+    { return lo(dir,a) + up(dir,a) < lo(dir,b) + up(dir,b); }
+
+    const gsMatrix<T> & lo, & up;
+    index_t dir;
+};
+
+}
+
+template<class T>
+void gsBoxTree<T>::build(const gsMatrix<T> & lower, const gsMatrix<T> & upper,
+                         index_t leafSize)
+{
+    GISMO_ASSERT(lower.rows() == upper.rows() && lower.cols() == upper.cols(),
+                 "The corners of the boxes do not match.");
+    GISMO_ASSERT(leafSize > 0, "The leaves must contain boxes.");
+
+    const index_t n = lower.cols();
+    m_index.resize(n);
+    for (index_t i = 0; i != n; ++i)
+        m_index[i] = i;
+
+    m_begin.clear();
+    m_end  .clear();
+    m_right.clear();
+    // A median split gives at most 2n-1 nodes
+    m_nodeLower.resize(lower.rows(), 2 * n);
+    m_nodeUpper.resize(lower.rows(), 2 * n);
+    if ( n > 0 )
+    {
+        const index_t depth = buildNode(lower, upper, 0, n, leafSize);
+        GISMO_ENSURE(depth < 60, "The hierarchy is too deep.");
+    }
+    m_nodeLower.conservativeResize(Eigen::NoChange, numNodes());
+    m_nodeUpper.conservativeResize(Eigen::NoChange, numNodes());
+
+    m_lower.resize(lower.rows(), n);
+    m_upper.resize(lower.rows(), n);
+    for (index_t i = 0; i != n; ++i)
+    {
+        m_lower.col(i) = lower.col(m_index[i]);
+        m_upper.col(i) = upper.col(m_index[i]);
+    }
+}
+
+template<class T>
+index_t gsBoxTree<T>::buildNode(const gsMatrix<T> & lower, const gsMatrix<T> & upper,
+                                index_t begin, index_t end, index_t leafSize)
+{
+    const index_t node = numNodes();
+    m_begin.push_back(begin);
+    m_end  .push_back(end);
+    m_right.push_back(-1);
+
+    // Enclosing box, and extent of the centers
+    m_nodeLower.col(node) = lower.col(m_index[begin]);
+    m_nodeUpper.col(node) = upper.col(m_index[begin]);
+    gsVector<T> cmin = lower.col(m_index[begin]) + upper.col(m_index[begin]);
+    gsVector<T> cmax = cmin;
+    for (index_t i = begin + 1; i < end; ++i)
+    {
+        const index_t b = m_index[i];
+        m_nodeLower.col(node) = m_nodeLower.col(node).cwiseMin(lower.col(b));
+        m_nodeUpper.col(node) = m_nodeUpper.col(node).cwiseMax(upper.col(b));
+        cmin = cmin.cwiseMin(lower.col(b) + upper.col(b));
+        cmax = cmax.cwiseMax(lower.col(b) + upper.col(b));
+    }
+
+    if ( end - begin <= leafSize )
+        return 1;
+
+    // Split at the median of the centers along their longest extent
+    index_t dir;
+    (cmax - cmin).maxCoeff(&dir);
+    const index_t mid = (begin + end) / 2;
+    std::nth_element(m_index.begin() + begin, m_index.begin() + mid,
+                     m_index.begin() + end,
+                     internal::boxCenterLess<T>(lower, upper, dir));
+
+    const index_t dl = buildNode(lower, upper, begin, mid, leafSize);
+    m_right[node] = numNodes();
+    const index_t dr = buildNode(lower, upper, mid, end, leafSize);
+    return 1 + math::max(dl, dr);
+}
+
+} // namespace gismo
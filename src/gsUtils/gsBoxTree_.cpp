@@ -0,0 +1,11 @@
+#include <gsCore/gsTemplateTools.h>
+
+#include <gsUtils/gsBoxTree.h>
+#include <gsUtils/gsBoxTree.hpp>
+
+namespace gismo
+{
+
+CLASS_TEMPLATE_INST gsBoxTree<real_t>;
+
+} // namespace gismo
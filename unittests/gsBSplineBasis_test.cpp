@@ -0,0 +1,70 @@
+/** @file gsBSplineBasis_test.cpp
+
+    @brief test evaluation of B-spline bases on many points
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+**/
+
+#include "gismo_unittest.h"
+
+SUITE(gsBSplineBasis_test)
+{
+    // Points which are evaluated together run through the batched
+    // kernels, single points through the scalar ones
+    TEST(batched_eval)
+    {
+        for (int p = 0; p <= 4; ++p)
+        {
+            gsKnotVector<> kv(0, 1, 7, p+1);
+            kv.insert(0.5); // repeated interior knot
+            gsBSplineBasis<> basis(kv);
+
+            gsMatrix<> u(1, 300);
+            for (index_t i = 0; i != u.cols(); ++i)
+                u(0,i) = (real_t)(i) / (u.cols()-1);
+            u(0,100) = 0.5;
+
+            gsMatrix<> val, der, val1, der1;
+            std::vector<gsMatrix<> > all, all1;
+            basis.eval_into(u, val);
+            basis.deriv_into(u, der);
+            basis.evalAllDers_into(u, 2, all);
+
+            for (index_t i = 0; i != u.cols(); ++i)
+            {
+                const gsMatrix<> pt = u.col(i);
+                basis.eval_into(pt, val1);
+                basis.deriv_into(pt, der1);
+                basis.evalAllDers_into(pt, 2, all1);
+                CHECK( (val.col(i) - val1).norm() < 1e-12 );
+                CHECK( (der.col(i) - der1).norm() < 1e-10 );
+                for (int k = 0; k <= 2; ++k)
+                    CHECK( (all[k].col(i) - all1[k]).norm() < 1e-10 * (1 + all1[k].norm()) );
+            }
+        }
+    }
+
+    TEST(tensor_eval)
+    {
+        gsTensorBSplineBasis<3> basis(gsKnotVector<>(0, 1, 3, 4),
+                                      gsKnotVector<>(0, 1, 2, 3),
+                                      gsKnotVector<>(0, 1, 1, 2));
+        gsMatrix<> u(3, 50), val, single;
+        u.setRandom();
+        u.array() = (u.array() + 1) / 2;
+        basis.eval_into(u, val);
+
+        gsMatrix<index_t> act;
+        basis.active_into(u, act);
+        for (index_t j = 0; j != u.cols(); ++j)
+            for (index_t i = 0; i != act.rows(); ++i)
+            {
+                basis.evalSingle_into(act(i,j), u.col(j), single);
+                CHECK_CLOSE( single(0,0), val(i,j), 1e-12 );
+            }
+    }
+}
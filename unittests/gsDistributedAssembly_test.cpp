@@ -0,0 +1,166 @@
+/** @file gsDistributedAssembly_test.cpp
+
+    @brief Tests for the assembly on the patches of a gsPatchPartition
+    and for gsDistributedOp
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "gismo_unittest.h"
+
+SUITE(gsDistributedAssembly_test)
+{
+
+void setupProblem(gsMultiPatch<> & patches, gsMultiBasis<> & mb,
+                  gsBoundaryConditions<> & bc, gsFunction<> & g)
+{
+    patches = gsNurbsCreator<>::BSplineSquareGrid(3, 2, 1);
+    mb = gsMultiBasis<>(patches);
+    mb.uniformRefine(2);
+    for (gsMultiPatch<>::const_biterator bit = patches.bBegin();
+         bit != patches.bEnd(); ++bit)
+        bc.addCondition(*bit, condition_type::dirichlet, &g);
+}
+
+TEST(owners)
+{
+    gsMultiPatch<> patches;
+    gsMultiBasis<> mb;
+    gsBoundaryConditions<> bc;
+    gsFunctionExpr<> g("x^2+y^2", 2);
+    setupProblem(patches, mb, bc, g);
+
+    gsDofMapper mapper;
+    mb.getMapper(dirichlet::elimination, iFace::glue, bc, mapper, 0);
+
+    const int np = 4;
+    std::vector<int> count(mapper.freeSize(), 0);
+    for (int r = 0; r != np; ++r)
+    {
+        gsPatchPartition part(mb, r, np);
+        part.addDofs(mapper);
+        CHECK_EQUAL(mapper.freeSize(), part.numDofs());
+        for (size_t i = 0; i != part.ownedDofs().size(); ++i)
+        {
+            const index_t ii = part.ownedDofs()[i];
+            ++count[ii];
+            CHECK_EQUAL(r, part.dofOwner(ii));
+        }
+        // Every process has some patches
+        index_t nLocal = 0;
+        for (size_t k = 0; k != patches.nPatches(); ++k)
+            nLocal += part.isLocal(k);
+        CHECK(nLocal > 0);
+    }
+    CHECK_EQUAL( static_cast<int>(mapper.freeSize()),
+                 static_cast<int>(std::count(count.begin(), count.end(), 1)) );
+}
+
+TEST(assembler_sum)
+{
+    gsMultiPatch<> patches;
+    gsMultiBasis<> mb;
+    gsBoundaryConditions<> bc;
+    gsFunctionExpr<> g("x^2+y^2", 2), f("-4", 2);
+    setupProblem(patches, mb, bc, g);
+
+    gsPoissonAssembler<> full(patches, mb, bc, f, dirichlet::elimination, iFace::glue);
+    full.assemble();
+
+    const int np = 3;
+    gsSparseMatrix<> K(full.matrix().rows(), full.matrix().cols());
+    gsMatrix<> rhs = gsMatrix<>::Zero(full.rhs().rows(), full.rhs().cols());
+    for (int r = 0; r != np; ++r)
+    {
+        gsPoissonAssembler<> A(patches, mb, bc, f, dirichlet::elimination, iFace::glue);
+        A.setPartition(gsPatchPartition(mb, r, np));
+        A.assemble();
+        K   += A.matrix();
+        rhs += A.rhs();
+    }
+
+    CHECK( (gsMatrix<>(K - full.matrix())).norm() < 1e-10 );
+    CHECK( (rhs - full.rhs()).norm() < 1e-10 );
+}
+
+TEST(expr_assembler_sum)
+{
+    gsMultiPatch<> patches;
+    gsMultiBasis<> mb;
+    gsBoundaryConditions<> bc;
+    gsFunctionExpr<> g("x^2+y^2", 2), ff("-4", 2);
+    setupProblem(patches, mb, bc, g);
+
+    const int np = 3;
+    gsSparseMatrix<> K, Ksum;
+    gsMatrix<> rhs, rhsSum;
+    for (int r = -1; r != np; ++r)
+    {
+        gsExprAssembler<> A(1,1);
+        A.setIntegrationElements(mb);
+        gsExprAssembler<>::geometryMap G = A.getMap(patches);
+        gsExprAssembler<>::space u = A.getSpace(mb);
+        u.setInterfaceCont(0);
+        u.addBc( bc.get("Dirichlet") );
+        gsExprAssembler<>::variable f = A.getCoeff(ff, G);
+        if ( r >= 0 ) // r == -1: the whole system
+            A.setPartition(gsPatchPartition(mb, r, np));
+        A.initSystem();
+        A.assemble( igrad(u, G) * igrad(u, G).tr() * meas(G), u * f * meas(G) );
+
+        if ( r < 0 )
+        {
+            K = A.matrix();
+            rhs = A.rhs();
+            Ksum.resize(K.rows(), K.cols());
+            rhsSum.setZero(rhs.rows(), rhs.cols());
+        }
+        else
+        {
+            Ksum   += A.matrix();
+            rhsSum += A.rhs();
+        }
+    }
+
+    CHECK( (gsMatrix<>(Ksum - K)).norm() < 1e-10 );
+    CHECK( (rhsSum - rhs).norm() < 1e-10 );
+}
+
+TEST(distributed_op_single_process)
+{
+    gsMultiPatch<> patches;
+    gsMultiBasis<> mb;
+    gsBoundaryConditions<> bc;
+    gsFunctionExpr<> g("x^2+y^2", 2), f("-4", 2);
+    setupProblem(patches, mb, bc, g);
+
+    gsPoissonAssembler<> A(patches, mb, bc, f, dirichlet::elimination, iFace::glue);
+    gsPatchPartition part(mb, 0, 1);
+    part.addDofs(A.system().colMapper(0));
+    A.setPartition(part);
+    A.assemble();
+
+    const gsMpiComm comm = gsMpi::worldComm();
+    gsMatrix<> localRhs;
+    gsDistributedOp<real_t>::uPtr op =
+        gsDistributedOp<real_t>::make(A.matrix(), A.rhs(), part, comm, localRhs);
+
+    CHECK_EQUAL(A.matrix().rows(), op->rows());
+    CHECK_EQUAL(0, op->haloSize());
+    CHECK( (localRhs - A.rhs()).norm() < 1e-12 );
+
+    const gsMatrix<> x = gsMatrix<>::Random(A.matrix().rows(), 2);
+    gsMatrix<> y, xl, xg;
+    op->apply(x, y);
+    CHECK( (y - A.matrix() * x).norm() < 1e-10 );
+
+    op->localPart(x, xl);
+    op->gather(xl, xg);
+    CHECK( (xg - x).norm() == 0 );
+}
+
+}
@@ -41,4 +41,64 @@ SUITE(gsExprAssembler_test)
                     const real_t v = ev.value();
                     CHECK( v*v < 1e-10 );
                 }
+
+         // Assembles and evaluates with nt threads (if OpenMP is enabled)
+         void assembleThreaded(const int nt, gsSparseMatrix<> & K, gsMatrix<> & rhs,
+                               real_t & l2, real_t & mx, std::vector<real_t> & elWise)
+                {
+#ifdef _OPENMP
+                    const int maxThreads = omp_get_max_threads();
+                    omp_set_num_threads(nt);
+#else
+                    GISMO_UNUSED(nt);
+#endif
+                    gsMultiPatch<> patches = gsNurbsCreator<>::BSplineSquareGrid(2,2,1);
+                    gsMultiBasis<> mb(patches);
+                    mb.setDegree(2);
+                    mb.uniformRefine(3);
+
+                    gsFunctionExpr<> ff("2*pi^2*sin(pi*x)*sin(pi*y)", 2);
+                    gsBoundaryConditions<> bc;
+                    for (gsMultiPatch<>::const_biterator bit = patches.bBegin();
+                         bit != patches.bEnd(); ++bit)
+                        bc.addCondition(*bit, condition_type::dirichlet, 0);
+
+                    gsExprAssembler<> A(1,1);
+                    A.setIntegrationElements(mb);
+                    gsExprAssembler<>::geometryMap G = A.getMap(patches);
+                    gsExprAssembler<>::space u = A.getSpace(mb);
+                    u.setInterfaceCont(0);
+                    u.addBc( bc.get("Dirichlet") );
+                    gsExprAssembler<>::variable f = A.getCoeff(ff, G);
+                    A.initSystem();
+                    A.assemble( igrad(u, G) * igrad(u, G).tr() * meas(G), u * f * meas(G) );
+                    K   = A.matrix();
+                    rhs = A.rhs();
+
+                    gsExprEvaluator<> ev(A);
+                    ev.setIntegrationElements(mb);
+                    l2 = ev.integral( f.sqNorm() * meas(G) );
+                    mx = ev.maxElWise( f.sqNorm() );
+                    elWise = ev.elementwise();
+#ifdef _OPENMP
+                    omp_set_num_threads(maxThreads);
+#endif
+                }
+
+         TEST(ThreadedAssembly)
+                {
+                    gsSparseMatrix<> K1, K4;
+                    gsMatrix<> rhs1, rhs4;
+                    real_t l21, l24, mx1, mx4;
+                    std::vector<real_t> el1, el4;
+                    assembleThreaded(1, K1, rhs1, l21, mx1, el1);
+                    assembleThreaded(4, K4, rhs4, l24, mx4, el4);
+
+                    CHECK( (K1 - K4).norm() <= 1e-12 * K1.norm() );
+                    CHECK( (rhs1 - rhs4).norm() <= 1e-12 * rhs1.norm() );
+                    // Reductions are deterministic across thread counts
+                    CHECK_EQUAL( l21, l24 );
+                    CHECK_EQUAL( mx1, mx4 );
+                    CHECK( el1 == el4 );
+                }
         }
@@ -0,0 +1,236 @@
+/** @file gsFileData_test.cpp
+
+    @brief Tests reading and writing objects by gsFileData
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+**/
+
+#include "gismo_unittest.h"
+
+using namespace gismo;
+
+SUITE(gsFileData_test)
+{
+
+TEST(base64_roundtrip)
+{
+    gsMatrix<real_t> mat(7,5);
+    mat.setRandom();
+    mat(0,0) = 1.0 / 3.0;
+
+    gsSparseMatrix<real_t> smat(6,4);
+    smat.insert(0,0) = 2.0 / 3.0;
+    smat.insert(5,1) = -1e-300;
+    smat.insert(2,3) = 4.0;
+    smat.makeCompressed();
+
+    gsKnotVector<real_t> kv(0.0, 1.0, 3, 3);
+    kv.insert(1.0 / 7.0);
+    gsBSplineBasis<real_t> basis(kv);
+    gsMatrix<real_t> coefs(basis.size(), 2);
+    coefs.setRandom();
+    gsBSpline<real_t> curve(basis, give(coefs));
+
+    const std::string fn = gsFileManager::getTempPath() + "gsFileData_test_base64.xml";
+    gsFileData<real_t> out;
+    out.setBinaryEncoding(true);
+    out << mat;
+    out << smat;
+    out << curve;
+    out.save(fn);
+
+    gsFileData<real_t> in(fn);
+    gsMatrix<real_t> mat2;
+    in.getFirst(mat2);
+    CHECK( mat2 == mat );
+
+    gsSparseMatrix<real_t> smat2;
+    in.getFirst(smat2);
+    CHECK_EQUAL( smat.nonZeros(), smat2.nonZeros() );
+    CHECK( gsMatrix<real_t>(smat2) == gsMatrix<real_t>(smat) );
+
+    gsGeometry<real_t>::uPtr curve2 = in.getFirst< gsGeometry<real_t> >();
+    CHECK( curve2->coefs() == curve.coefs() );
+    const gsBSplineBasis<real_t> * basis2 =
+        dynamic_cast<const gsBSplineBasis<real_t>*>(&curve2->basis());
+    CHECK( basis2 && basis2->knots() == kv );
+
+    // The values are encoded
+    std::ifstream file(fn.c_str());
+    const std::string contents( (std::istreambuf_iterator<char>(file)),
+                                std::istreambuf_iterator<char>() );
+    CHECK( std::string::npos != contents.find("format=\"base64\"") );
+
+    file.close();
+    std::remove(fn.c_str());
+}
+
+TEST(lazy_read)
+{
+    gsMatrix<real_t> mat(3,4);
+    mat.setRandom();
+    gsMultiPatch<real_t> mp = gsNurbsCreator<real_t>::BSplineSquareGrid(3, 2);
+
+    const std::string fn = gsFileManager::getTempPath() + "gsFileData_test_lazy.xml";
+    gsFileData<real_t> out;
+    out << mat;
+    out << mp;
+    out.save(fn);
+
+    gsFileData<real_t> eager(fn), lazy(fn, true);
+
+    // A single patch, the matrix has id 0
+    gsGeometry<real_t>::uPtr g1 = eager.getId< gsGeometry<real_t> >(4);
+    gsGeometry<real_t>::uPtr g2 = lazy.getId< gsGeometry<real_t> >(4);
+    CHECK( g1->coefs() == g2->coefs() );
+
+    // The patches of the multipatch are parsed along with it
+    gsMultiPatch<real_t> mp2;
+    CHECK( lazy.getFirst(mp2) );
+    CHECK_EQUAL( mp.nPatches(), mp2.nPatches() );
+    CHECK_EQUAL( mp.nInterfaces(), mp2.nInterfaces() );
+    for (size_t i = 0; i != mp.nPatches(); ++i)
+        CHECK( mp.patch(i).coefs() == mp2.patch(i).coefs() );
+
+    // A nested object
+    gsBasis<real_t>::uPtr b1 = eager.getAnyFirst< gsBasis<real_t> >();
+    gsBasis<real_t>::uPtr b2 = lazy.getAnyFirst< gsBasis<real_t> >();
+    CHECK( b2 && b1->size() == b2->size() );
+
+    gsMatrix<real_t> mat1, mat2;
+    CHECK( eager.getFirst(mat1) );
+    CHECK( lazy.getFirst(mat2) );
+    CHECK( mat2 == mat1 );
+
+    // All objects, in the order of the file
+    CHECK_EQUAL( eager.contents(), lazy.contents() );
+
+    // Objects parsed after an addition precede the added object
+    gsFileData<real_t> lazy2(fn, true);
+    CHECK( lazy2.getFirst(mat2) );
+    gsMatrix<real_t> mat3(2,2);
+    mat3.setIdentity();
+    eager << mat3;
+    lazy2 << mat3;
+    CHECK_EQUAL( eager.contents(), lazy2.contents() );
+
+    // Reading another file drops the index, the objects are kept
+    const std::string off = gsFileManager::getTempPath() + "gsFileData_test_lazy.off";
+    std::ofstream(off.c_str()) << "OFF\n3 1 0\n0 0 0\n1 0 0\n0 1 0\n3 0 1 2\n";
+    gsFileData<real_t> lazy3(fn, true);
+    CHECK( lazy3.read(off) );
+    CHECK_EQUAL( 1, lazy3.count< gsMesh<real_t> >() );
+    CHECK( lazy3.getFirst(mat2) );
+    CHECK( mat2 == mat1 );
+
+    // The attributes of the root tag are kept
+    const std::string fn2 = gsFileManager::getTempPath() + "gsFileData_test_root.xml";
+    std::ofstream(fn2.c_str()) << "<?xml version=\"1.0\"?>\n<xml author=\"G+Smo\">\n"
+                               << "<Matrix rows=\"1\" cols=\"1\">2</Matrix>\n</xml>\n";
+    gsFileData<real_t> lazy4(fn2, true);
+    std::ostringstream os;
+    lazy4.print(os);
+    CHECK( std::string::npos != os.str().find("author=\"G+Smo\"") );
+
+    std::remove(fn.c_str());
+    std::remove(off.c_str());
+    std::remove(fn2.c_str());
+}
+
+TEST(parse_numbers)
+{
+    const char * numbers[] = { "0", "-0.5", "0.1", "1e-300", "4.9e-324",
+                               "3.14159265358979323846", "123456789012345678901234",
+                               "1.7976931348623157e308", "+2.5E+3", "0.000123",
+                               "0x1p4", "inf" };
+    for (size_t i = 0; i != sizeof(numbers) / sizeof(numbers[0]); ++i)
+    {
+        const char * p = numbers[i], * end = p + strlen(p);
+        double val = 0;
+        CHECK( gsGetReal(p, end, val) );
+        CHECK( p == end );
+        CHECK_EQUAL( strtod(numbers[i], NULL), val );
+    }
+
+    const std::string text = " 1/3\n-17\t2.5e1 x";
+    const char * p = text.data(), * end = p + text.size();
+    double a = 0, c = 0;
+    int b = 0;
+    CHECK( gsGetReal(p, end, a) );
+    CHECK( gsGetInt(p, end, b) );
+    CHECK( gsGetReal(p, end, c) );
+    CHECK_EQUAL( 1.0 / 3.0, a );
+    CHECK_EQUAL( -17, b );
+    CHECK_EQUAL( 25.0, c );
+    CHECK( !gsGetReal(p, end, a) );
+}
+
+TEST(mesh_and_csv_files)
+{
+    const std::string path = gsFileManager::getTempPath();
+    std::ofstream(path + "gsFileData_test.csv")
+        << "1,2.5,3\n4,5,-6e-3\n";
+    std::ofstream(path + "gsFileData_test.off")
+        << "OFF\n4 2 0\n0 0 0\n1 0 0\n1 1 0\n0 1 0\n3 0 1 2\n3 0 2 3\n";
+    std::ofstream(path + "gsFileData_test_ascii.stl")
+        << "solid square\n"
+        << " facet normal 0 0 1\n  outer loop\n   vertex 0 0 0\n   vertex 0.5 0 0\n"
+        << "   vertex 0.5 0.1 0\n  endloop\n endfacet\n"
+        << " FACET NORMAL 0 0 1\n  OUTER LOOP\n   VERTEX 0 0 0\n   VERTEX 0.5 0.1 0\n"
+        << "   VERTEX 0 0.1 0\n  ENDLOOP\n ENDFACET\nendsolid square\n";
+
+    // The same triangles in a binary file
+    {
+        std::ofstream file((path + "gsFileData_test_binary.stl").c_str(), std::ios::binary);
+        const char header[80] = "binary square";
+        file.write(header, 80);
+        const uint32_t ntri = 2;
+        file.write(reinterpret_cast<const char*>(&ntri), 4);
+        const float tri[2][12] = { {0,0,1, 0,0,0, 0.5f,0,0, 0.5f,0.1f,0},
+                                   {0,0,1, 0,0,0, 0.5f,0.1f,0, 0,0.1f,0} };
+        const uint16_t attr = 0;
+        for (int t = 0; t != 2; ++t)
+        {
+            file.write(reinterpret_cast<const char*>(tri[t]), sizeof(tri[t]));
+            file.write(reinterpret_cast<const char*>(&attr), 2);
+        }
+    }
+
+    gsFileData<real_t> csv(path + "gsFileData_test.csv");
+    gsMatrix<real_t> mat;
+    CHECK( csv.getFirst(mat) );
+    CHECK_EQUAL( 2, mat.rows() );
+    CHECK_EQUAL( 3, mat.cols() );
+    CHECK_EQUAL( 2.5, mat(0,1) );
+    CHECK_EQUAL( -6e-3, mat(1,2) );
+
+    gsFileData<real_t> off(path + "gsFileData_test.off");
+    gsMesh<real_t>::uPtr mesh = off.getFirst< gsMesh<real_t> >();
+    CHECK_EQUAL( 4u, mesh->numVertices() );
+    CHECK_EQUAL( 2u, mesh->numFaces() );
+
+    gsFileData<real_t> ascii (path + "gsFileData_test_ascii.stl");
+    gsFileData<real_t> binary(path + "gsFileData_test_binary.stl");
+    gsMesh<real_t>::uPtr m1 = ascii .getFirst< gsMesh<real_t> >();
+    gsMesh<real_t>::uPtr m2 = binary.getFirst< gsMesh<real_t> >();
+    CHECK_EQUAL( 2u, m1->numFaces() );
+    CHECK_EQUAL( 2u, m2->numFaces() );
+    CHECK_EQUAL( m1->numVertices(), m2->numVertices() );
+
+    // The binary coordinates are read exactly
+    bool found = false;
+    for (size_t i = 0; i != m2->numVertices(); ++i)
+        found = found || m2->vertex(i)[1] == static_cast<real_t>(0.1f);
+    CHECK( found );
+
+    std::remove((path + "gsFileData_test.csv").c_str());
+    std::remove((path + "gsFileData_test.off").c_str());
+    std::remove((path + "gsFileData_test_ascii.stl").c_str());
+    std::remove((path + "gsFileData_test_binary.stl").c_str());
+}
+
+}
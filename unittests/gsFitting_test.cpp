@@ -0,0 +1,107 @@
+/** @file gsFitting_test.cpp
+
+    @brief Tests the least squares fitting of point clouds.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "gismo_unittest.h"
+
+// Assembles the least squares system point by point
+void naiveSystem(const gsBasis<>& basis, const gsMatrix<>& uv, const gsMatrix<>& xyz,
+                 gsMatrix<>& A, gsMatrix<>& B)
+{
+    A.setZero(basis.size(), basis.size());
+    B.setZero(basis.size(), xyz.rows());
+    gsMatrix<> values;
+    gsMatrix<index_t> actives;
+    for (index_t k = 0; k < uv.cols(); ++k)
+    {
+        basis.eval_into(uv.col(k), values);
+        basis.active_into(uv.col(k), actives);
+        for (index_t i = 0; i < actives.rows(); ++i)
+        {
+            B.row(actives(i,0)) += values(i,0) * xyz.col(k).transpose();
+            for (index_t j = 0; j < actives.rows(); ++j)
+                A(actives(i,0), actives(j,0)) += values(i,0) * values(j,0);
+        }
+    }
+}
+
+gsMatrix<> samplePoints(const gsMatrix<>& uv)
+{
+    gsMatrix<> xyz(3, uv.cols());
+    xyz.row(0) = uv.row(0);
+    xyz.row(1) = uv.row(1);
+    xyz.row(2) = (uv.row(0).array() * 3).sin() * (uv.row(1).array() * 2).cos();
+    return xyz;
+}
+
+SUITE(gsFitting_test)
+{
+
+TEST(assembly)
+{
+    const gsMatrix<> uv = ( gsMatrix<>::Random(2, 2000).array() + 1 ) / 2;
+    const gsMatrix<> xyz = samplePoints(uv);
+
+    gsKnotVector<> kv(0, 1, 3, 3);
+    gsTensorBSplineBasis<2> tbasis(kv, kv);
+    gsTHBSplineBasis<2> basis(tbasis);
+    gsFitting<> fitting(uv, xyz, basis);
+
+    for (index_t iter = 0; iter < 3; ++iter)
+    {
+        gsMatrix<> Aref, Bref;
+        naiveSystem(basis, uv, xyz, Aref, Bref);
+
+        gsSparseMatrix<> A(basis.size(), basis.size());
+        gsMatrix<> B;
+        B.setZero(basis.size(), 3);
+        fitting.assembleSystem(A, B);
+        CHECK( (gsMatrix<>(A) - Aref).norm() < 1e-10 * Aref.norm() );
+        CHECK( (B - Bref).norm() < 1e-10 * Bref.norm() );
+
+        // Refine a corner; the grouping of the points is reused
+        std::vector<index_t> box(5);
+        box[0] = iter + 1;
+        box[1] = box[2] = 0;
+        box[3] = box[4] = 1 << iter;
+        basis.refineElements(box);
+    }
+}
+
+TEST(solvers)
+{
+    const gsMatrix<> uv = ( gsMatrix<>::Random(2, 1000).array() + 1 ) / 2;
+    const gsMatrix<> xyz = samplePoints(uv);
+
+    gsKnotVector<> kv(0, 1, 7, 4);
+    gsTensorBSplineBasis<2> basis(kv, kv);
+
+    gsFitting<> ref(uv, xyz, basis);
+    ref.setSolver(gsFitting<>::cholesky);
+    ref.compute(1e-6);
+    CHECK( ref.result() != NULL );
+
+    const gsFitting<>::solver solvers[] = { gsFitting<>::bicgstabILUT,
+                                            gsFitting<>::cgDiagonal,
+                                            gsFitting<>::cgIncompleteCholesky };
+    for (index_t i = 0; i < 3; ++i)
+    {
+        gsFitting<> fitting(uv, xyz, basis);
+        fitting.setSolver(solvers[i]);
+        CHECK_EQUAL( solvers[i], fitting.getSolver() );
+        fitting.compute(1e-6);
+        CHECK( fitting.result() != NULL );
+        if ( fitting.result() != NULL )
+            CHECK( (fitting.result()->coefs() - ref.result()->coefs()).norm()
+                   < 1e-6 * ref.result()->coefs().norm() );
+    }
+}
+
+}
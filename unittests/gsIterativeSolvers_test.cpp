@@ -327,4 +327,65 @@ SUITE(gsIterativeSolvers_test)
         CHECK( (mat*x-rhs).norm()/rhs.norm() <= tol );
     }
 
+    TEST(PipelinedCG_Jacobi_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.75);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+        gsMatrix<>       x;
+
+        poissonDiscretization(mat, rhs, N);
+
+        gsOptionList opt = gsPipelinedConjugateGradient<>::defaultOptions();
+        opt.setInt ("MaxIterations", N  );
+        opt.setReal("Tolerance"    , tol);
+
+        gsLinearOperator<>::Ptr preConMat = makeJacobiOp(mat);
+        gsPipelinedConjugateGradient<> solver(mat,preConMat);
+        solver.setOptions(opt);
+        solver.setCommunicator(gsMpi::init().worldComm());
+
+        x.setZero(N,1);
+        solver.solve(rhs,x);
+
+        CHECK( (mat*x-rhs).norm()/rhs.norm() <= tol );
+    }
+
+    TEST(SStepCG_Jacobi_test)
+    {
+        index_t          N = 100;
+        real_t           tol = std::pow(10.0, - REAL_DIG * 0.75);
+
+        gsSparseMatrix<> mat;
+        gsMatrix<>       rhs;
+        gsMatrix<>       x;
+
+        poissonDiscretization(mat, rhs, N);
+
+        gsOptionList opt = gsSStepConjugateGradient<>::defaultOptions();
+        opt.setInt ("MaxIterations", N  );
+        opt.setReal("Tolerance"    , tol);
+        opt.setInt ("Steps"        , 3  );
+
+        gsLinearOperator<>::Ptr preConMat = makeJacobiOp(mat);
+        gsSStepConjugateGradient<> solver(mat,preConMat);
+        solver.setOptions(opt);
+
+        x.setZero(N,1);
+        solver.solve(rhs,x);
+
+        CHECK( (mat*x-rhs).norm()/rhs.norm() <= tol );
+
+        // The error is the one of the final residual, also if the
+        // solver stops at the maximum number of iterations
+        opt.setReal("Tolerance", 0);
+        solver.setOptions(opt);
+        x.setZero(N,1);
+        solver.solve(rhs,x);
+        CHECK( solver.iterations() >= N );
+        CHECK( math::abs( solver.error() - (mat*x-rhs).norm()/rhs.norm() ) <= 1e-8 );
+    }
+
 }
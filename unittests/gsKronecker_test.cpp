@@ -61,6 +61,36 @@ SUITE(gsKronecker_test)
         CHECK_EQUAL ( y, KP * x );
     }
 
+    TEST(gsKroneckerOpMixed)
+    {
+        // Dense, transposed dense and sparse (generic) factors of
+        // different sizes
+        const gsMatrix<> D1 = gsMatrix<>::Random(4,3);
+        const gsMatrix<> D2 = gsMatrix<>::Random(5,2);
+        const gsSparseMatrix<> S = B.sparseView();
+        gsKroneckerOp<> kron( makeMatrixOp(D1), makeMatrixOp(D2.transpose()),
+                              makeMatrixOp(S) );
+        const gsMatrix<> K = D1.kron( gsMatrix<>(D2.transpose()).kron(B) );
+        CHECK_EQUAL( K.rows(), kron.rows() );
+        CHECK_EQUAL( K.cols(), kron.cols() );
+
+        gsMatrix<> y, x = gsMatrix<>::Random(K.cols(), 4);
+        for (index_t r = 0; r != 2; ++r) // second time with the workspaces
+        {
+            kron.apply(x, y);
+            CHECK( (y - K * x).norm() < 1e-10 );
+            x.col(r).setRandom();
+        }
+
+        gsKroneckerOp<>::apply(kron.getOps(), x, y);
+        CHECK( (y - K * x).norm() < 1e-10 );
+
+        gsKroneckerOp<> kron2( makeMatrixOp(S), makeMatrixOp(D1) );
+        x.setRandom(9, 3);
+        kron2.apply(x, y);
+        CHECK( (y - B.kron(D1) * x).norm() < 1e-10 );
+    }
+
     TEST(DenseKronecker)
     {        
         gsMatrix<> C = A.kron(B);
@@ -46,4 +46,35 @@ SUITE(gsMatrixOp_test)
         CHECK( ( A.transpose() - C ).norm() <= 1.e-10 );
     }
 
+    // Large enough to use the parallel kernels if OpenMP is enabled
+    TEST(SparseProduct)
+    {
+        const index_t n = 25000;
+        gsSparseEntries<> entries;
+        for (index_t i = 0; i < n; ++i)
+        {
+            entries.add(i, i, 4 + i % 5);
+            if ( i > 0     ) entries.add(i, i-1, -1);
+            if ( i + 1 < n ) entries.add(i, i+1, -1);
+            if ( i % 3 == 0 && i + 100 < n ) entries.add(i, i+100, -0.5);
+        }
+        gsSparseMatrix<> A(n,n);
+        A.setFrom(entries);
+        A.makeCompressed();
+        const gsSparseMatrix<real_t,RowMajor> B = A;
+
+        const gsMatrix<> x = gsMatrix<>::Random(n,2);
+        const gsMatrix<> y = A * x;
+        gsMatrix<> z;
+
+        makeMatrixOp(A)->apply(x, z);
+        CHECK( ( y - z ).norm() <= 1.e-10 );
+        makeMatrixOp(B)->apply(x, z);
+        CHECK( ( y - z ).norm() <= 1.e-10 );
+        gsSellCSigmaOp<real_t>::make(A)->apply(x, z);
+        CHECK( ( y - z ).norm() <= 1.e-10 );
+        gsSellCSigmaOp<real_t>::make(A, 4, 32)->apply(x, z);
+        CHECK( ( y - z ).norm() <= 1.e-10 );
+    }
+
 }
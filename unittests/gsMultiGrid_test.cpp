@@ -0,0 +1,228 @@
+/** @file gsMultiGrid_test.cpp
+
+    @brief Tests for algebraic multigrid and for updating the matrices
+    of gsMultiGridOp.
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "gismo_unittest.h"
+
+// Assembles the stiffness and the mass matrix on the unit square
+void assembleSquare(index_t degree, index_t numRefine, gsMultiBasis<>& mb,
+                    gsBoundaryConditions<>& bc, gsSparseMatrix<>& stiff,
+                    gsSparseMatrix<>& mass)
+{
+    gsMultiPatch<> mp( *gsNurbsCreator<>::BSplineSquare() );
+    mb = gsMultiBasis<>(mp);
+    mb.setDegree(degree);
+    for (index_t i = 0; i < numRefine; ++i)
+        mb.uniformRefine();
+
+    static gsConstantFunction<> one(1,2);
+    bc = gsBoundaryConditions<>();
+    for (gsMultiPatch<>::const_biterator it = mp.bBegin(); it < mp.bEnd(); ++it)
+        bc.addCondition( *it, condition_type::dirichlet, &one );
+
+    gsOptionList opt = gsAssembler<>::defaultOptions();
+    gsPoissonAssembler<> assembler(mp, mb, bc, one,
+                                   dirichlet::elimination, iFace::conforming);
+    assembler.assemble();
+    stiff = assembler.matrix();
+
+    gsGenericAssembler<> gAssembler(mp, mb, opt, &bc);
+    mass = gAssembler.assembleMass();
+}
+
+SUITE(gsMultiGrid_test)
+{
+
+TEST(aggregation_amg)
+{
+    gsMultiBasis<> mb;
+    gsBoundaryConditions<> bc;
+    gsSparseMatrix<> stiff, mass;
+    assembleSquare(2, 5, mb, bc, stiff, mass);
+
+    // Every unknown belongs to an aggregate
+    std::vector<index_t> agg;
+    const index_t nAgg = gsAggregationAmgOp<>::aggregate(stiff, 0.08, agg);
+    CHECK( 0 < nAgg && nAgg < stiff.rows() / 2 );
+    CHECK( *std::min_element(agg.begin(), agg.end()) == 0 );
+    CHECK( *std::max_element(agg.begin(), agg.end()) == nAgg - 1 );
+
+    // The smoothed prolongation preserves constants away from the boundary
+    const gsSparseMatrix<real_t,RowMajor> P =
+        gsAggregationAmgOp<>::prolongation(stiff, 0.08, agg, nAgg);
+    const gsMatrix<> ones = P * gsMatrix<>::Ones(nAgg, 1);
+    const gsMatrix<> rowSums = stiff * gsMatrix<>::Ones(stiff.rows(), 1);
+    for (index_t i = 0; i < stiff.rows(); ++i)
+        if ( math::abs(rowSums(i,0)) < 1e-12 )
+            CHECK( math::abs(ones(i,0) - 1) < 1e-10 );
+
+    gsOptionList opt = gsAggregationAmgOp<>::defaultOptions();
+    opt.setInt("CoarseSize", 50);
+    gsAggregationAmgOp<>::Ptr amg = gsAggregationAmgOp<>::make(stiff, opt);
+    CHECK( amg->numLevels() > 2 );
+
+    const gsMatrix<> rhs = gsMatrix<>::Ones(stiff.rows(), 1);
+    gsMatrix<> sol;
+    sol.setZero(stiff.rows(), 1);
+    gsConjugateGradient<> solver(stiff, amg);
+    solver.setTolerance(1e-8);
+    solver.setMaxIterations(40);
+    solver.solve(rhs, sol);
+    CHECK( solver.error() <= solver.tolerance() );
+
+    // After an update of the values, the hierarchy is reused
+    const gsSparseMatrix<> mat2 = stiff + 100 * mass;
+    amg->updateMatrix(mat2);
+    sol.setZero(stiff.rows(), 1);
+    gsConjugateGradient<> solver2(mat2, amg);
+    solver2.setTolerance(1e-8);
+    solver2.setMaxIterations(40);
+    solver2.solve(rhs, sol);
+    CHECK( solver2.error() <= solver2.tolerance() );
+    CHECK( (mat2 * sol - rhs).norm() <= 1e-6 * rhs.norm() );
+}
+
+TEST(multigrid_update)
+{
+    gsMultiBasis<> mb;
+    gsBoundaryConditions<> bc;
+    gsSparseMatrix<> stiff, mass;
+    assembleSquare(3, 4, mb, bc, stiff, mass);
+
+    std::vector< gsSparseMatrix<real_t,RowMajor> > transfers;
+    gsGridHierarchy<>::buildByCoarsening(give(mb), bc, gsAssembler<>::defaultOptions(), 3)
+        .moveTransferMatricesTo(transfers)
+        .clear();
+
+    gsMultiGridOp<>::Ptr mg = gsMultiGridOp<>::make(stiff, transfers);
+    for (index_t i = 1; i < mg->numLevels(); ++i)
+        mg->setSmoother(i, makeGaussSeidelOp(mg->matrix(i)));
+
+    // Twice, as the first update sets up the patterns
+    for (index_t k = 1; k <= 2; ++k)
+    {
+        const gsSparseMatrix<> mat = stiff + (10 * k) * mass;
+        mg->updateMatrix(mat);
+
+        const gsMultiGridOp<>::Ptr ref = gsMultiGridOp<>::make(mat, transfers);
+        for (index_t i = 0; i < mg->numLevels(); ++i)
+            CHECK( (mg->matrix(i) - ref->matrix(i)).norm() < 1e-10 * ref->matrix(i).norm() );
+
+        // The coarse solver is updated as well
+        const gsMatrix<> rhs = gsMatrix<>::Random(mg->nDofs(0), 1);
+        gsMatrix<> x, y;
+        mg->solveCoarse(rhs, x);
+        ref->solveCoarse(rhs, y);
+        CHECK( (x - y).norm() < 1e-8 * y.norm() );
+    }
+
+    // Algebraic multigrid as coarse solver
+    gsOptionList opt = gsAggregationAmgOp<>::defaultOptions();
+    opt.setInt("CoarseSize", 20);
+    gsAggregationAmgOp<>::Ptr amg = gsAggregationAmgOp<>::make(mg->matrix(0), opt);
+    CHECK( amg->numLevels() > 1 );
+    mg->setCoarseSolver(amg);
+    mg->updateMatrix(stiff);
+    const gsMatrix<> rhs = gsMatrix<>::Ones(stiff.rows(), 1);
+    gsMatrix<> sol;
+    sol.setZero(stiff.rows(), 1);
+    gsConjugateGradient<> solver(stiff, mg);
+    solver.setTolerance(1e-8);
+    solver.setMaxIterations(30);
+    solver.solve(rhs, sol);
+    CHECK( solver.error() <= solver.tolerance() );
+}
+
+// Compares the transfers from the univariate transfers with the generic ones
+void checkTensorTransfers(const gsMultiBasis<>& mb, const gsBoundaryConditions<>& bc)
+{
+    gsOptionList opt = gsGridHierarchy<>::defaultOptions();
+    opt.setInt("Levels", 3);
+
+    for (index_t refine = 0; refine < 2; ++refine)
+    {
+        opt.setSwitch("TensorTransfers", false);
+        const gsGridHierarchy<> ref = refine
+            ? gsGridHierarchy<>::buildByRefinement(mb, bc, opt)
+            : gsGridHierarchy<>::buildByCoarsening(mb, bc, opt);
+        opt.setSwitch("TensorTransfers", true);
+        const gsGridHierarchy<> tensor = refine
+            ? gsGridHierarchy<>::buildByRefinement(mb, bc, opt)
+            : gsGridHierarchy<>::buildByCoarsening(mb, bc, opt);
+        opt.setSwitch("AssembleTransfers", false);
+        const gsGridHierarchy<> lean = refine
+            ? gsGridHierarchy<>::buildByRefinement(mb, bc, opt)
+            : gsGridHierarchy<>::buildByCoarsening(mb, bc, opt);
+        opt.setSwitch("AssembleTransfers", true);
+
+        const std::vector< gsSparseMatrix<real_t,RowMajor> > & T0 = ref.getTransferMatrices();
+        const std::vector< gsSparseMatrix<real_t,RowMajor> > & T1 = tensor.getTransferMatrices();
+        CHECK_EQUAL( 2u, T0.size() );
+        CHECK_EQUAL( T0.size(), T1.size() );
+        CHECK( lean.getTransferMatrices().empty() );
+        CHECK_EQUAL( T0.size(), lean.getProlongations().size() );
+        CHECK_EQUAL( T0.size(), lean.getRestrictions().size() );
+        for (size_t i = 0; i < T0.size() && i < T1.size(); ++i)
+        {
+            CHECK_EQUAL( T0[i].rows(), T1[i].rows() );
+            CHECK_EQUAL( T0[i].cols(), T1[i].cols() );
+            CHECK( (T0[i] - T1[i]).norm() < 1e-12 * T0[i].norm() );
+
+            const gsMatrix<> xc = gsMatrix<>::Random(T0[i].cols(), 2);
+            const gsMatrix<> xf = gsMatrix<>::Random(T0[i].rows(), 2);
+            gsMatrix<> yf, yc;
+            lean.getProlongations()[i]->apply(xc, yf);
+            lean.getRestrictions()[i]->apply(xf, yc);
+            CHECK( (yf - T0[i] * xc).norm() < 1e-12 * yf.norm() );
+            CHECK( (yc - T0[i].transpose() * xf).norm() < 1e-12 * yc.norm() );
+        }
+    }
+}
+
+TEST(tensor_transfers)
+{
+    // Single patch with Dirichlet conditions
+    {
+        gsMultiBasis<> mb;
+        gsBoundaryConditions<> bc;
+        gsSparseMatrix<> stiff, mass;
+        assembleSquare(3, 3, mb, bc, stiff, mass);
+        checkTensorTransfers(mb, bc);
+    }
+
+    // Multipatch with Dirichlet and Neumann conditions
+    {
+        gsMultiPatch<> mp = gsNurbsCreator<>::BSplineSquareGrid(2, 2, 0.5);
+        gsMultiBasis<> mb(mp);
+        mb.setDegree(2);
+        mb.uniformRefine(2);
+        gsConstantFunction<> zero(0, 2);
+        gsBoundaryConditions<> bc;
+        for (gsMultiPatch<>::const_biterator it = mp.bBegin(); it < mp.bEnd(); ++it)
+            bc.addCondition( *it, it->side() == boundary::west ? condition_type::dirichlet
+                                                               : condition_type::neumann, &zero );
+        checkTensorTransfers(mb, bc);
+    }
+
+    // Three dimensions
+    {
+        gsMultiPatch<> mp( *gsNurbsCreator<>::BSplineCube(2) );
+        gsMultiBasis<> mb(mp);
+        mb.uniformRefine(2);
+        gsConstantFunction<> zero(0, 3);
+        gsBoundaryConditions<> bc;
+        for (gsMultiPatch<>::const_biterator it = mp.bBegin(); it < mp.bEnd(); ++it)
+            bc.addCondition( *it, condition_type::dirichlet, &zero );
+        checkTensorTransfers(mb, bc);
+    }
+}
+
+}
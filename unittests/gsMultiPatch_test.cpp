@@ -0,0 +1,87 @@
+/** @file gsMultiPatch_test.cpp
+
+    @brief Tests for locating points in a gsMultiPatch and for gsBoxTree
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#include "gismo_unittest.h"
+
+SUITE(gsMultiPatch_test)
+{
+
+TEST(box_tree)
+{
+    const index_t n = 500;
+    gsMatrix<> lower = gsMatrix<>::Random(3, n);
+    gsMatrix<> upper = lower + 0.2 * (gsMatrix<>::Random(3, n).array() + 1).matrix();
+    const gsBoxTree<real_t> tree(lower, upper, 3);
+    CHECK_EQUAL(n, tree.size());
+
+    const gsMatrix<> pts = gsMatrix<>::Random(3, 200);
+    std::vector<index_t> found, brute;
+    for (index_t i = 0; i != pts.cols(); ++i)
+    {
+        tree.query(pts.col(i), found, 0.01);
+        std::sort(found.begin(), found.end());
+
+        brute.clear();
+        for (index_t j = 0; j != n; ++j)
+            if ( (pts.col(i).array() >= lower.col(j).array() - 0.01).all() &&
+                 (pts.col(i).array() <= upper.col(j).array() + 0.01).all() )
+                brute.push_back(j);
+        CHECK(found == brute);
+    }
+}
+
+TEST(locatePoints)
+{
+    // Curved patches, refined
+    gsMultiPatch<> mp = gsNurbsCreator<>::BSplineSquareGrid(3, 2, 1);
+    for (size_t k = 0; k != mp.nPatches(); ++k)
+    {
+        mp.patch(k).uniformRefine(3);
+        gsMatrix<> & c = mp.patch(k).coefs();
+        for (index_t i = 0; i != c.rows(); ++i)
+            c(i,1) += 0.1 * math::sin(3 * c(i,0));
+    }
+
+    // Images of random parameters, and points outside
+    const index_t n = 300;
+    gsMatrix<> pts(2, n + 2), par;
+    gsVector<index_t> pid(n);
+    for (index_t i = 0; i != n; ++i)
+    {
+        pid[i] = i % mp.nPatches();
+        par = 0.5 * (gsMatrix<>::Random(2, 1).array() + 1);
+        pts.col(i) = mp.patch(pid[i]).eval(par);
+    }
+    pts.col(n) << 10, 10;
+    pts.col(n+1) << -0.5, 0.5;
+
+    gsVector<index_t> pids;
+    gsMatrix<> preim;
+    mp.locatePoints(pts, pids, preim);
+    CHECK_EQUAL(-1, pids[n]);
+    CHECK_EQUAL(-1, pids[n+1]);
+    for (index_t i = 0; i != n; ++i)
+    {
+        CHECK(pids[i] >= 0);
+        if ( pids[i] < 0 )
+            continue;
+        par = preim.col(i);
+        CHECK( (mp.patch(pids[i]).eval(par) - pts.col(i)).norm() < 1e-5 );
+    }
+
+    // Skipping the patch of the points, only interface points are found
+    gsVector<index_t> pid2;
+    gsMatrix<> pts0 = pts.leftCols(n);
+    mp.locatePoints(pts0.leftCols(1), pid[0], pid2, preim);
+    CHECK(pid2[0] == -1 || pid2[0] != pid[0]);
+}
+
+}
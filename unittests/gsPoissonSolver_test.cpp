@@ -142,6 +142,224 @@ void runPoissonSolverTest( dirichlet::strategy Dstrategy, iFace::strategy Istrat
     h_list.clear();
 }
 
+void runParallelScatterTest( parallelScatter::strategy scatter )
+{
+    gsFunctionExpr<> f("((pi*1)^2 + (pi*2)^2)*sin(pi*x*1)*sin(pi*y*2)",2);
+    gsFunctionExpr<> g("sin(pi*x*1)*sin(pi*y*2)+pi/10",2);
+
+    gsMultiPatch<> patches = gsNurbsCreator<>::BSplineSquareGrid(2, 2, 0.5);
+    gsBoundaryConditions<> bcInfo;
+    for (gsMultiPatch<>::const_biterator bit = patches.bBegin(); bit != patches.bEnd(); ++bit)
+        bcInfo.addCondition(*bit, condition_type::dirichlet, &g);
+
+    gsMultiBasis<> bases( patches );
+    bases.setDegree(3);
+    bases.uniformRefine(3);
+
+    gsPoissonPde<> pde(patches, bcInfo, f);
+
+    gsPoissonAssembler<real_t> reference(pde, bases);
+    reference.assemble();
+
+    gsOptionList opt = gsAssembler<>::defaultOptions();
+    opt.setInt("ParallelScatter", scatter);
+    gsPoissonAssembler<real_t> poisson;
+    poisson.initialize(pde, bases, opt);
+    poisson.assemble();
+
+    const real_t tol = 1e-10;
+    CHECK( (reference.matrix() - poisson.matrix()).norm() < tol * reference.matrix().norm() );
+    CHECK( (reference.rhs()    - poisson.rhs()   ).norm() < tol * reference.rhs().norm() );
+}
+
+void runExactPatternTest( dirichlet::strategy dirStrategy )
+{
+    gsFunctionExpr<> f("((pi*1)^2 + (pi*2)^2)*sin(pi*x*1)*sin(pi*y*2)",2);
+    gsFunctionExpr<> g("sin(pi*x*1)*sin(pi*y*2)+pi/10",2);
+
+    gsMultiPatch<> patches = gsNurbsCreator<>::BSplineSquareGrid(2, 2, 0.5);
+    gsBoundaryConditions<> bcInfo;
+    for (gsMultiPatch<>::const_biterator bit = patches.bBegin(); bit != patches.bEnd(); ++bit)
+        bcInfo.addCondition(*bit, condition_type::dirichlet, &g);
+
+    gsMultiBasis<> bases( patches );
+    bases.setDegree(2);
+    bases.uniformRefine(3);
+
+    gsPoissonPde<> pde(patches, bcInfo, f);
+
+    gsOptionList opt = gsAssembler<>::defaultOptions();
+    opt.setInt("DirichletStrategy", dirStrategy);
+    opt.setSwitch("ExactPattern", false);
+    gsPoissonAssembler<real_t> reference;
+    reference.initialize(pde, bases, opt);
+    reference.assemble();
+
+    opt.setSwitch("ExactPattern", true);
+    gsPoissonAssembler<real_t> poisson;
+    poisson.initialize(pde, bases, opt);
+    poisson.assemble();
+
+    const real_t tol = 1e-10;
+    CHECK( (reference.matrix() - poisson.matrix()).norm() < tol * reference.matrix().norm() );
+    CHECK( (reference.rhs()    - poisson.rhs()   ).norm() < tol * reference.rhs().norm() );
+    CHECK( poisson.matrix().nonZeros() <= reference.matrix().nonZeros() );
+
+    // Numeric re-assembly re-uses the pattern
+    const index_t nnz = poisson.matrix().nonZeros();
+    const real_t * values = poisson.matrix().valuePtr();
+    poisson.assemble();
+    CHECK_EQUAL( nnz, poisson.matrix().nonZeros() );
+    CHECK( values == poisson.matrix().valuePtr() );
+    CHECK( (reference.matrix() - poisson.matrix()).norm() < tol * reference.matrix().norm() );
+    CHECK( (reference.rhs()    - poisson.rhs()   ).norm() < tol * reference.rhs().norm() );
+}
+
+void runSumFactorizationTest( const gsMultiPatch<> & patches, short_t degree )
+{
+    const short_t d = patches.parDim();
+    gsFunctionExpr<> f(d == 2 ? "sin(x)*(y+1)" : "sin(x)*(y+1)*z", d);
+    gsFunctionExpr<> g(d == 2 ? "x*y" : "x*y*z", d);
+
+    gsBoundaryConditions<> bcInfo;
+    for (gsMultiPatch<>::const_biterator bit = patches.bBegin(); bit != patches.bEnd(); ++bit)
+        bcInfo.addCondition(*bit, condition_type::dirichlet, &g);
+
+    gsMultiBasis<> bases( patches );
+    bases.setDegree(degree);
+    bases.uniformRefine(1);
+
+    gsPoissonPde<> pde(patches, bcInfo, f);
+
+    gsOptionList opt = gsAssembler<>::defaultOptions();
+    opt.setSwitch("SumFactorization", false);
+    gsPoissonAssembler<real_t> reference;
+    reference.initialize(pde, bases, opt);
+    reference.assemble();
+    gsGenericAssembler<real_t> refGeneric(patches, bases, opt);
+    const gsSparseMatrix<> refMass  = refGeneric.assembleMass();
+    const gsSparseMatrix<> refStiff = refGeneric.assembleStiffness();
+
+    opt.setSwitch("SumFactorization", true);
+    gsPoissonAssembler<real_t> poisson;
+    poisson.initialize(pde, bases, opt);
+    poisson.assemble();
+    gsGenericAssembler<real_t> generic(patches, bases, opt);
+    const gsSparseMatrix<> mass  = generic.assembleMass();
+    const gsSparseMatrix<> stiff = generic.assembleStiffness();
+
+    const real_t tol = 1e-10;
+    CHECK( (reference.matrix() - poisson.matrix()).norm() < tol * reference.matrix().norm() );
+    CHECK( (reference.rhs()    - poisson.rhs()   ).norm() < tol * reference.rhs().norm() );
+    CHECK( (refMass  - mass ).norm() < tol * refMass.norm()  );
+    CHECK( (refStiff - stiff).norm() < tol * refStiff.norm() );
+}
+
+void runMatrixFreeTest( bool sumFact )
+{
+    gsFunctionExpr<> f("((pi*1)^2 + (pi*2)^2)*sin(pi*x*1)*sin(pi*y*2)",2);
+    gsFunctionExpr<> g("sin(pi*x*1)*sin(pi*y*2)+pi/10",2);
+    gsFunctionExpr<> zero("0",2);
+
+    gsMultiPatch<> patches = gsNurbsCreator<>::BSplineSquareGrid(2, 1, 0.5);
+    patches.patch(1).coefs().col(1) += 0.1 * patches.patch(1).coefs().col(0).array().square().matrix();
+    gsBoundaryConditions<> bcInfo, bcZero;
+    for (gsMultiPatch<>::const_biterator bit = patches.bBegin(); bit != patches.bEnd(); ++bit)
+    {
+        bcInfo.addCondition(*bit, condition_type::dirichlet, &g);
+        bcZero.addCondition(*bit, condition_type::dirichlet, &zero);
+    }
+
+    gsMultiBasis<> bases( patches );
+    bases.setDegree(3);
+    bases.uniformRefine(2);
+
+    gsOptionList opt = gsAssembler<>::defaultOptions();
+    opt.setSwitch("SumFactorization", sumFact);
+    gsPoissonPde<> pde(patches, bcInfo, f), pdeZero(patches, bcZero, f);
+    gsPoissonAssembler<real_t> poisson, load;
+    poisson.initialize(pde, bases, opt);
+    poisson.assemble();
+    load.initialize(pdeZero, bases, opt);
+    load.assemble();
+
+    gsMatrixFreeOp<real_t>::Ptr op = gsMatrixFreeOp<real_t>::make(poisson);
+    CHECK_EQUAL( poisson.matrix().rows(), op->rows() );
+
+    const real_t tol = 1e-10;
+    gsMatrix<> x, y, diag;
+    x.setRandom(op->cols(), 2);
+    op->apply(x, y);
+    CHECK( (poisson.matrix() * x - y).norm() < tol * y.norm() );
+
+    op->diagonal(diag);
+    CHECK( (poisson.matrix().diagonal() - diag).norm() < tol * diag.norm() );
+
+    // The eliminated dofs enter the right-hand side
+    op->applyFixed(poisson.fixedDofs(), y);
+    CHECK( (load.rhs() - y - poisson.rhs()).norm() < tol * poisson.rhs().norm() );
+
+    // Solve without forming the matrix
+    gsMatrix<> solution, reference;
+    gsSparseSolver<>::LU solver(poisson.matrix());
+    reference = solver.solve(poisson.rhs());
+    solution.setZero(op->rows(), 1);
+    gsConjugateGradient<> cg(op, makeMatrixFreeJacobiOp(op));
+    cg.setTolerance(1e-12);
+    cg.solve(poisson.rhs(), solution);
+    CHECK( (reference - solution).norm() < 1e-8 * reference.norm() );
+}
+
+void runElementCacheTest( bool sumFact )
+{
+    gsFunctionExpr<> f("((pi*1)^2 + (pi*2)^2)*sin(pi*x*1)*sin(pi*y*2)",2);
+    gsFunctionExpr<> g("sin(pi*x*1)*sin(pi*y*2)+pi/10",2);
+
+    gsMultiPatch<> patches( *gsNurbsCreator<>::BSplineFatQuarterAnnulus() );
+    gsBoundaryConditions<> bcInfo;
+    for (gsMultiPatch<>::const_biterator bit = patches.bBegin(); bit != patches.bEnd(); ++bit)
+        bcInfo.addCondition(*bit, condition_type::dirichlet, &g);
+
+    gsMultiBasis<> bases( patches );
+    bases.setDegree(3);
+    bases.uniformRefine(2);
+
+    gsPoissonPde<> pde(patches, bcInfo, f);
+
+    gsOptionList opt = gsAssembler<>::defaultOptions();
+    opt.setSwitch("SumFactorization", sumFact);
+    gsPoissonAssembler<real_t> reference;
+    reference.initialize(pde, bases, opt);
+    reference.assemble();
+    gsGenericAssembler<real_t> refGeneric(patches, bases, opt);
+    const gsSparseMatrix<> refMass = refGeneric.assembleMass();
+
+    opt.setInt("ElementCache", 16);
+    gsPoissonAssembler<real_t> poisson;
+    poisson.initialize(pde, bases, opt);
+    gsGenericAssembler<real_t> generic(patches, bases, opt);
+
+    // The second assembly uses the cached evaluations
+    const real_t tol = 1e-12;
+    for (index_t i = 0; i != 2; ++i)
+    {
+        poisson.assemble();
+        CHECK( (reference.matrix() - poisson.matrix()).norm() < tol * reference.matrix().norm() );
+        CHECK( (reference.rhs()    - poisson.rhs()   ).norm() < tol * reference.rhs().norm() );
+        const gsSparseMatrix<> mass = generic.assembleMass();
+        CHECK( (refMass - mass).norm() < tol * refMass.norm() );
+    }
+
+    // Refinement invalidates the cache
+    bases.uniformRefine();
+    reference.initialize(pde, bases, reference.options());
+    reference.assemble();
+    poisson.multiBasis().uniformRefine();
+    poisson.refresh();
+    poisson.assemble();
+    CHECK( (reference.matrix() - poisson.matrix()).norm() < tol * reference.matrix().norm() );
+    CHECK( (reference.rhs()    - poisson.rhs()   ).norm() < tol * reference.rhs().norm() );
+}
 
 SUITE(gsPoissonSolver_test)
 {
@@ -160,6 +378,46 @@ SUITE(gsPoissonSolver_test)
     {
         runPoissonSolverTest(dirichlet::nitsche, iFace::dg);
     }
+
+    TEST(ParallelScatter_coloring_test)
+    {
+        runParallelScatterTest(parallelScatter::coloring);
+    }
+
+    TEST(ExactPattern_elimination_test)
+    {
+        runExactPatternTest(dirichlet::elimination);
+    }
+
+    TEST(ExactPattern_nitsche_test)
+    {
+        runExactPatternTest(dirichlet::nitsche);
+    }
+
+    TEST(SumFactorization_2d_test)
+    {
+        gsMultiPatch<> patches( *gsNurbsCreator<>::BSplineFatQuarterAnnulus() );
+        runSumFactorizationTest(patches, 4);
+    }
+
+    TEST(SumFactorization_3d_test)
+    {
+        gsMultiPatch<> patches( *gsNurbsCreator<>::BSplineCube(2) );
+        patches.patch(0).coefs().col(0) += 0.2 * patches.patch(0).coefs().col(1).array().square().matrix();
+        runSumFactorizationTest(patches, 3);
+    }
+
+    TEST(MatrixFree_test)
+    {
+        runMatrixFreeTest(true);
+        runMatrixFreeTest(false);
+    }
+
+    TEST(ElementCache_test)
+    {
+        runElementCacheTest(true);
+        runElementCacheTest(false);
+    }
     
 }
 
@@ -87,6 +87,22 @@ void runPreconditionerTest( index_t testcase )
         solver.solve(rhs,sol);
         CHECK ( solver.error() <= solver.tolerance() );
     }
+    else if (testcase==4)
+    {
+        gsConjugateGradient<> solver(mat, makeSymmetricMultiColorGaussSeidelOp(mat));
+        solver.setTolerance( 1.e-8 );
+        solver.setMaxIterations( 50 );
+        solver.solve(rhs,sol);
+        CHECK ( solver.error() <= solver.tolerance() );
+    }
+    else if (testcase==5)
+    {
+        gsConjugateGradient<> solver(mat, makeChebyshevOp(mat, 3));
+        solver.setTolerance( 1.e-8 );
+        solver.setMaxIterations( 60 );
+        solver.solve(rhs,sol);
+        CHECK ( solver.error() <= solver.tolerance() );
+    }
 }
 
 
@@ -109,6 +125,28 @@ SUITE(gsPreconditioner_test)
     {
         runPreconditionerTest(3);
     }
+    TEST(gsMultiColorGaussSeidelPreconditioner_test)
+    {
+        runPreconditionerTest(4);
+    }
+    TEST(gsChebyshevPreconditioner_test)
+    {
+        runPreconditionerTest(5);
+
+        // The Krylov space is exhausted after one step
+        for (index_t n = 2; n <= 20; n += 9)
+        {
+            gsSparseMatrix<> diag(n, n);
+            for (index_t i = 0; i < n; ++i)
+                diag.insert(i, i) = 4;
+            const gsMatrix<> rhs = gsMatrix<>::Ones(n, 1);
+            gsMatrix<> x;
+            x.setZero(n, 1);
+            makeChebyshevOp(diag)->step(rhs, x);
+            CHECK( x.allFinite() );
+            CHECK( (diag * x - rhs).norm() < rhs.norm() );
+        }
+    }
 
     TEST(gsPatchPreconditioner_stiff_test)
     {
@@ -263,8 +301,72 @@ SUITE(gsPreconditioner_test)
             gsMatrix<> res;
             a.apply( in, res );
             CHECK ( (res-out).norm() < 1/real_t(10000) );
+
+            // Concurrent processing of the subspaces gives the same result
+            a.setParallel(true);
+            gsMatrix<> res2;
+            a.apply( in, res2 );
+            CHECK ( res2 == res );
         }
     }
 
+    TEST(gsMultiPatchFastDiagonalization_test)
+    {
+        // Define Geometry
+        gsMultiPatch<> mp = gsNurbsCreator<>::BSplineSquareGrid(2, 2, 1);
+
+        // Create mulibasis
+        gsMultiBasis<> mb(mp);
+        mb.setDegree(3);
+        for (int i = 0; i < 3; ++i)
+            mb.uniformRefine();
+
+        // Define Boundary conditions
+        gsConstantFunction<> one(1,mp.geoDim());
+        gsBoundaryConditions<> bc;
+        for (gsMultiPatch<>::const_biterator it = mp.bBegin(); it < mp.bEnd(); ++it)
+            bc.addCondition( *it, it->side().index() == boundary::north
+                             ? condition_type::neumann : condition_type::dirichlet, &one );
+
+        // Initilize Assembler and assemble
+        gsOptionList opt = gsAssembler<>::defaultOptions();
+        gsPoissonAssembler<> assembler(
+            mp,
+            mb,
+            bc,
+            one,
+            (dirichlet::strategy) opt.getInt("DirichletStrategy"),
+            (iFace::strategy) opt.getInt("InterfaceStrategy")
+            );
+        assembler.assemble();
+        const gsSparseMatrix<>& mat = assembler.matrix();
+
+        // Every unknown belongs to exactly one subspace
+        std::vector< gsMultiPatchPreconditionersCreator<>::Transfer > t =
+            gsMultiPatchPreconditionersCreator<>::getTransfers(mb,bc,opt);
+        CHECK_EQUAL ( mp.nPatches() + 1, t.size() );
+        gsMatrix<> count;
+        count.setZero(mat.rows(), 1);
+        for (size_t i=0; i<t.size(); ++i)
+            count += t[i] * gsMatrix<>::Ones(t[i].cols(), 1);
+        CHECK ( (count.array() == 1).all() );
+
+        // On the patch interiors, the preconditioner is exact
+        gsLinearOperator<>::Ptr pc =
+            gsMultiPatchPreconditionersCreator<>::fastDiagonalizationOp(mat,mb,bc,opt);
+        gsMatrix<> in = t[0] * gsMatrix<>::Random(t[0].cols(), 1), out;
+        pc->apply(mat * in, out);
+        CHECK ( (t[0].transpose() * (out - in)).norm() < (t[0].transpose() * in).norm() * 1e-8 );
+
+        gsMatrix<> rhs = assembler.rhs();
+        gsMatrix<> sol;
+        sol.setRandom(rhs.rows(), rhs.cols());
+        gsConjugateGradient<> solver(mat, pc);
+        solver.setTolerance( 1.e-8 );
+        solver.setMaxIterations( 60 );
+        solver.solve(rhs,sol);
+        CHECK ( solver.error() <= solver.tolerance() );
+    }
+
 
 }
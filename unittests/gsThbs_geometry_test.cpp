@@ -208,4 +208,153 @@ SUITE(gsThbs_geometry_test)
 
     }
 
+    TEST(incremental_truncation)
+    {
+        gsKnotVector<> kv(0, 1, 7, 3);
+        gsTensorBSplineBasis<2> tbasis(kv, kv);
+
+        // Refine step by step, updating the truncation each time
+        const index_t steps[5][5] = { {1, 0, 0, 8, 8},
+                                      {2, 4, 4, 12, 12},
+                                      {1, 10, 2, 16, 10},
+                                      {3, 10, 10, 20, 20},
+                                      {2, 20, 0, 32, 12} };
+        gsTHBSplineBasis<2> thb(tbasis);
+        std::vector<index_t> boxes;
+        for (index_t i = 0; i != 5; ++i)
+        {
+            const std::vector<index_t> box(steps[i], steps[i] + 5);
+            thb.refineElements(box);
+            boxes.insert(boxes.end(), box.begin(), box.end());
+        }
+
+        // Computed at once
+        gsTHBSplineBasis<2> full(tbasis, boxes);
+
+        CHECK_EQUAL(full.size(), thb.size());
+        CHECK_EQUAL(full.numTruncated(), thb.numTruncated());
+        for (index_t i = 0; i != thb.size(); ++i)
+        {
+            CHECK_EQUAL(full.isTruncated(i), thb.isTruncated(i));
+            if (full.isTruncated(i) && thb.isTruncated(i))
+            {
+                CHECK_EQUAL(full.getCoefs(i).size(), thb.getCoefs(i).size());
+                CHECK( (full.getCoefs(i) - thb.getCoefs(i)).norm() < 1e-12 );
+            }
+        }
+
+        // The fast evaluation uses the compact layout
+        gsMatrix<> u = gsMatrix<>::Random(2, 50);
+        u.array() = (u.array() + 1) / 2;
+        gsMatrix<> val, fval;
+        thb.eval_into(u, val);
+        thb.fastEval_into(u, fval);
+        CHECK( (val - fval).norm() < 1e-12 );
+        thb.deriv_into(u, val);
+        thb.fastDeriv_into(u, fval);
+        CHECK( (val - fval).norm() < 1e-10 );
+        thb.deriv2_into(u, val);
+        thb.fastDeriv2_into(u, fval);
+        CHECK( (val - fval).norm() < 1e-8 );
+    }
+
+    TEST(flat_tree_queries)
+    {
+        gsKnotVector<> kv(0, 1, 7, 3);
+        gsTensorBSplineBasis<2> tbasis(kv, kv);
+        gsTHBSplineBasis<2> thb(tbasis);
+        const index_t boxes[] = { 1, 0, 0, 8, 8,
+                                  2, 4, 4, 12, 12,
+                                  3, 10, 10, 20, 20,
+                                  4, 22, 26, 38, 34,
+                                  1, 10, 2, 16, 10 };
+        thb.refineElements(std::vector<index_t>(boxes, boxes + 25));
+
+        // The linearised tree is used by the queries of the basis tree,
+        // a changed copy uses the tree itself
+        const gsHDomain<2> & flat = thb.tree();
+        gsHDomain<2> tree = flat;
+        tree.beginLeafIterator();
+
+        const index_t lvl = flat.getMaxInsLevel();
+        const index_t n = 8 << lvl;
+        gsMatrix<index_t> low(2, 100), upp(2, 100);
+        gsHDomain<2>::point k1, k2;
+        for (index_t i = 0; i != low.cols(); ++i)
+        {
+            for (index_t j = 0; j != 2; ++j)
+            {
+                low(j, i) = rand() % (n - 1);
+                upp(j, i) = low(j, i) + 1 + rand() % (n - low(j, i) - 1);
+            }
+            k1 = low.col(i);
+            k2 = upp.col(i);
+            CHECK_EQUAL(tree.query2(k1, k2, lvl - 1), flat.query2(k1, k2, lvl - 1));
+            CHECK_EQUAL(tree.query3(k1, k2, lvl), flat.query3(k1, k2, lvl));
+            CHECK_EQUAL(tree.query4(k1, k2, lvl), flat.query4(k1, k2, lvl));
+            CHECK_EQUAL(tree.levelOf(k1, lvl), flat.levelOf(k1, lvl));
+        }
+
+        // Batch queries
+        gsVector<index_t> res, fres;
+        tree.query3(low, upp, lvl, res);
+        flat.query3(low, upp, lvl, fres);
+        CHECK(res == fres);
+        tree.query4(low, upp, lvl, res);
+        flat.query4(low, upp, lvl, fres);
+        CHECK(res == fres);
+        tree.levelOf(low, lvl, res);
+        flat.levelOf(low, lvl, fres);
+        CHECK(res == fres);
+    }
+
+
+    TEST(grouped_evaluation)
+    {
+        gsKnotVector<> kv(0, 1, 7, 3);
+        gsTensorBSplineBasis<2> tbasis(kv, kv);
+        gsTHBSplineBasis<2> thb(tbasis);
+        const index_t boxes[] = { 1, 0, 0, 8, 8,
+                                  2, 4, 4, 12, 12,
+                                  3, 10, 10, 20, 20,
+                                  1, 10, 2, 16, 10 };
+        thb.refineElements(std::vector<index_t>(boxes, boxes + 20));
+
+        // Random points, several of them in the same element
+        gsMatrix<> u = gsMatrix<>::Random(2, 200);
+        u.array() = (u.array() + 1) / 2;
+        u.rightCols(100) = (u.leftCols(100).array() + 1e-4).min(1).matrix();
+
+        gsMatrix<index_t> act, act1;
+        thb.active_into(u, act);
+        std::vector<gsMatrix<> > all;
+        thb.evalAllDers_into(u, 2, all);
+        CHECK_EQUAL(act.rows() * 3, all[2].rows());
+
+        gsMatrix<> val, der, der2, res;
+        thb.eval_into(u, val);
+        thb.deriv_into(u, der);
+        thb.deriv2_into(u, der2);
+        CHECK( (val - all[0]).norm() < 1e-12 );
+        CHECK( (der - all[1]).norm() < 1e-12 );
+        CHECK( (der2 - all[2]).norm() < 1e-12 );
+
+        // Point by point
+        for (index_t p = 0; p != u.cols(); ++p)
+        {
+            thb.active_into(u.col(p), act1);
+            CHECK( act1 == act.col(p).topRows(act1.rows()) );
+            CHECK( act.col(p).bottomRows(act.rows() - act1.rows()).isZero() );
+            for (index_t i = 0; i != act1.rows(); ++i)
+            {
+                thb.evalSingle_into(act1(i), u.col(p), res);
+                CHECK( math::abs(res(0) - val(i, p)) < 1e-12 );
+                thb.derivSingle_into(act1(i), u.col(p), res);
+                CHECK( (res - der.block(2 * i, p, 2, 1)).norm() < 1e-10 );
+                thb.deriv2Single_into(act1(i), u.col(p), res);
+                CHECK( (res - der2.block(3 * i, p, 3, 1)).norm() < 1e-8 );
+            }
+        }
+    }
+
 }
@@ -0,0 +1,155 @@
+/** @file gsWriteParaview_test.cpp
+
+    @brief Tests the formats of the data arrays written by gsWriteParaview
+
+    This file is part of the G+Smo library.
+
+    This Source Code Form is subject to the terms of the Mozilla Public
+    License, v. 2.0. If a copy of the MPL was not distributed with this
+    file, You can obtain one at http://mozilla.org/MPL/2.0/.
+**/
+
+#include "gismo_unittest.h"
+
+using namespace gismo;
+
+namespace
+{
+
+std::string readWhole(const std::string & fn)
+{
+    std::ifstream in(fn.c_str(), std::ios::binary);
+    return std::string( (std::istreambuf_iterator<char>(in)),
+                        std::istreambuf_iterator<char>() );
+}
+
+// Writes a 3x2 grid with a scalar field and returns the written file
+std::string writeGrid(gsMatrix<real_t> & field, gsParaviewFormat::format fmt)
+{
+    gsMatrix<real_t> pts(3,6);
+    pts << 0, 1, 2, 0, 1, 2,
+           0, 0, 0, 1, 1, 1,
+           0, 0, 0, 0, 0, 0;
+    field.resize(1,6);
+    field << 0.5, 1.5, 2.5, 3.5, 4.5, 5.5;
+    gsVector<index_t> np(2);
+    np << 3, 2;
+
+    const std::string fn = gsFileManager::getTempPath() + "gsWriteParaview_test";
+    gsWriteParaviewTPgrid(pts, field, np, fn, fmt);
+    const std::string file = readWhole(fn + ".vts");
+    std::remove((fn + ".vts").c_str());
+    return file;
+}
+
+// Returns the appended data, starting after the underscore
+std::string appendedData(const std::string & file)
+{
+    const std::string tag("<AppendedData encoding=\"raw\">\n_");
+    const size_t pos = file.find(tag);
+    if ( std::string::npos == pos )
+        return std::string();
+    return file.substr(pos + tag.size());
+}
+
+// Returns the offset of the \a k-th DataArray element
+size_t arrayOffset(const std::string & file, index_t k)
+{
+    size_t pos = 0;
+    for (index_t i = 0; i <= k; ++i)
+        pos = file.find("offset=\"", pos) + 8;
+    std::istringstream str(file.substr(pos, 24));
+    size_t offset;
+    str >> offset;
+    return offset;
+}
+
+uint64_t readUInt64(const std::string & data, size_t pos)
+{
+    uint64_t val;
+    std::memcpy(&val, data.data() + pos, sizeof(uint64_t));
+    return val;
+}
+
+}
+
+SUITE(gsWriteParaview_test)
+{
+
+TEST(ascii)
+{
+    gsMatrix<real_t> field;
+    const std::string file = writeGrid(field, gsParaviewFormat::ascii);
+    CHECK( std::string::npos != file.find("format=\"ascii\"") );
+    CHECK( appendedData(file).empty() );
+}
+
+TEST(binary)
+{
+    gsMatrix<real_t> field;
+    const std::string file = writeGrid(field, gsParaviewFormat::binary);
+    CHECK( std::string::npos != file.find("header_type=\"UInt64\"") );
+    CHECK( std::string::npos != file.find("format=\"appended\" offset=\"0\"") );
+
+    // The field is the first array
+    const std::string data = appendedData(file);
+    CHECK_EQUAL( 6 * sizeof(float), readUInt64(data, 0) );
+    float vals[6];
+    std::memcpy(vals, data.data() + sizeof(uint64_t), 6 * sizeof(float));
+    for (index_t i = 0; i != 6; ++i)
+        CHECK_EQUAL( static_cast<float>(field(0,i)), vals[i] );
+}
+
+TEST(compressed)
+{
+    gsMatrix<real_t> field;
+    const std::string file = writeGrid(field, gsParaviewFormat::compressed);
+    CHECK( std::string::npos != file.find("compressor=\"vtkZLibDataCompressor\"") );
+
+    // One block, which is not full, followed by the compressed data
+    const std::string data = appendedData(file);
+    CHECK_EQUAL( 1u, readUInt64(data, 0) );
+    CHECK_EQUAL( 32768u, readUInt64(data, 8) );
+    CHECK_EQUAL( 6 * sizeof(float), readUInt64(data, 16) );
+    const uint64_t csize = readUInt64(data, 24);
+    CHECK( csize > 0 );
+    CHECK( data.size() > 32 + csize );
+}
+
+TEST(global)
+{
+    gsMatrix<real_t> field;
+    gsParaviewFormat::setGlobal(gsParaviewFormat::binary);
+    const std::string file = writeGrid(field, gsParaviewFormat::global);
+    gsParaviewFormat::setGlobal(gsParaviewFormat::ascii);
+    CHECK( !appendedData(file).empty() );
+}
+
+TEST(streamedField)
+{
+    gsMultiPatch<> mp( *gsNurbsCreator<>::BSplineSquare() );
+    gsFunctionExpr<> f("x+y", 2);
+    gsField<> field(mp, f, true);
+    const std::string fn = gsFileManager::getTempPath() + "gsWriteParaview_test_field";
+    gsWriteParaview(field, fn, 100, false, gsParaviewFormat::binary);
+
+    // A 10x10 grid, the values are followed by the points
+    const std::string file = readWhole(fn + "0.vts");
+    std::remove((fn + "0.vts").c_str());
+    std::remove((fn + ".pvd").c_str());
+    const std::string data = appendedData(file);
+    CHECK_EQUAL( 0u, arrayOffset(file, 0) );
+    CHECK_EQUAL( 100 * sizeof(float), readUInt64(data, 0) );
+    const size_t pts = arrayOffset(file, 1);
+    CHECK_EQUAL( sizeof(uint64_t) + 100 * sizeof(float), pts );
+    CHECK_EQUAL( 300 * sizeof(float), readUInt64(data, pts) );
+
+    // The last point is the corner (1,1)
+    float corner[3];
+    std::memcpy(corner, data.data() + pts + sizeof(uint64_t) + 297 * sizeof(float), sizeof(corner));
+    CHECK_EQUAL( 1.0f, corner[0] );
+    CHECK_EQUAL( 1.0f, corner[1] );
+    CHECK_EQUAL( 0.0f, corner[2] );
+}
+
+}